@@ -10,9 +10,17 @@
 
 namespace benchmarking {
 
+static const fml::CommandLine* g_command_line = nullptr;
+
+const fml::CommandLine& GetCommandLine() {
+  static const fml::CommandLine empty_command_line;
+  return g_command_line ? *g_command_line : empty_command_line;
+}
+
 int Main(int argc, char** argv) {
   fml::InstallCrashHandler();
   fml::CommandLine cmd = fml::CommandLineFromArgcArgv(argc, argv);
+  g_command_line = &cmd;
   benchmark::Initialize(&argc, argv);
   std::string icudtl_path =
       cmd.GetOptionValueWithDefault("icu-data-file-path", "icudtl.dat");
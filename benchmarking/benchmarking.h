@@ -6,9 +6,15 @@
 #define FLUTTER_BENCHMARKING_BENCHMARKING_H_
 
 #include "benchmark/benchmark.h"
+#include "flutter/fml/command_line.h"
 
 namespace benchmarking {
 
+// The command line that the benchmarks were run with, for benchmarks that
+// take their own options. Empty if the benchmarks were not run through
+// |Main|.
+const fml::CommandLine& GetCommandLine();
+
 class ScopedPauseTiming {
  public:
   explicit ScopedPauseTiming(::benchmark::State& state, bool enabled = true)
@@ -192,6 +192,34 @@ struct Settings {
   // Selects the DisplayList for storage of rendering operations.
   bool enable_display_list = true;
 
+  // Start frames as late as the timings of recent frames allow instead of at
+  // vsync, so that frames pick up the most recent input.
+  bool enable_predictive_frame_scheduling = false;
+
+  // Read the pages of the Dart snapshots into memory on a background thread
+  // during startup, so that the first frames do not wait on page faults.
+  bool prefetch_snapshot_pages = false;
+
+  // Where the snapshot pages used by the first frames are recorded, so that
+  // later runs only prefetch those. Only used with |prefetch_snapshot_pages|.
+  std::string snapshot_page_profile_path;
+
+  // When non-zero, the raster caches of this shell and of the shells spawned
+  // from it share a budget of this many bytes, instead of each growing
+  // without bound.
+  size_t shared_raster_cache_max_bytes = 0;
+
+  // When greater than 1, display lists that are drawn at nearby scales share
+  // raster cache entries rasterized at scales that are powers of this step,
+  // e.g. 2 or 1.1, instead of missing the cache during zoom animations.
+  float raster_cache_scale_bucket_step = 0;
+
+  // Whether the raster cache decides which display lists to cache by their
+  // estimated rendering cost on the backend instead of by their op count.
+  // Off until the cost tables are calibrated with measurements of each
+  // backend.
+  bool raster_cache_admit_display_lists_by_cost = false;
+
   // Data set by platform-specific embedders for use in font initialization.
   uint32_t font_initialization_data = 0;
 
@@ -26,6 +26,7 @@ DisplayList::DisplayList()
       nested_byte_count_(0),
       nested_op_count_(0),
       unique_id_(0),
+      content_hash_(kDisplayListHashSeed),
       bounds_({0, 0, 0, 0}),
       bounds_cull_({0, 0, 0, 0}),
       can_apply_group_opacity_(true) {}
@@ -35,6 +36,7 @@ DisplayList::DisplayList(uint8_t* ptr,
                          int op_count,
                          size_t nested_byte_count,
                          int nested_op_count,
+                         uint64_t content_hash,
                          const SkRect& cull_rect,
                          bool can_apply_group_opacity)
     : storage_(ptr),
@@ -42,6 +44,7 @@ DisplayList::DisplayList(uint8_t* ptr,
       op_count_(op_count),
       nested_byte_count_(nested_byte_count),
       nested_op_count_(nested_op_count),
+      content_hash_(content_hash),
       bounds_({0, 0, -1, -1}),
       bounds_cull_(cull_rect),
       can_apply_group_opacity_(can_apply_group_opacity) {
@@ -110,6 +113,29 @@ void DisplayList::DisposeOps(uint8_t* ptr, uint8_t* end) {
   }
 }
 
+uint64_t DisplayList::HashOps(uint64_t hash, uint8_t* ptr, uint8_t* end) {
+  while (ptr < end) {
+    auto op = reinterpret_cast<const DLOp*>(ptr);
+    ptr += op->size;
+    FML_DCHECK(ptr <= end);
+    switch (op->type) {
+#define DL_OP_HASH(name)                                 \
+  case DisplayListOpType::k##name:                       \
+    hash = static_cast<const name##Op*>(op)->hash(hash); \
+    break;
+
+      FOR_EACH_DISPLAY_LIST_OP(DL_OP_HASH)
+
+#undef DL_OP_HASH
+
+      default:
+        FML_DCHECK(false);
+        return hash;
+    }
+  }
+  return hash;
+}
+
 static bool CompareOps(uint8_t* ptrA,
                        uint8_t* endA,
                        uint8_t* ptrB,
@@ -176,13 +202,16 @@ static bool CompareOps(uint8_t* ptrA,
   return true;
 }
 
-void DisplayList::RenderTo(SkCanvas* canvas, SkScalar opacity) const {
-  DisplayListCanvasDispatcher dispatcher(canvas, opacity);
+void DisplayList::RenderTo(SkCanvas* canvas,
+                           SkScalar opacity,
+                           DisplayListPathCache* path_cache) const {
+  DisplayListCanvasDispatcher dispatcher(canvas, opacity, path_cache);
   Dispatch(dispatcher);
 }
 
 bool DisplayList::Equals(const DisplayList& other) const {
-  if (byte_count_ != other.byte_count_ || op_count_ != other.op_count_) {
+  if (byte_count_ != other.byte_count_ || op_count_ != other.op_count_ ||
+      content_hash_ != other.content_hash_) {
     return false;
   }
   uint8_t* ptr = storage_.get();
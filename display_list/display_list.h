@@ -149,6 +149,7 @@ enum class DisplayListOpType { FOR_EACH_DISPLAY_LIST_OP(DL_OP_TO_ENUM_VALUE) };
 
 class Dispatcher;
 class DisplayListBuilder;
+class DisplayListPathCache;
 
 // The base class that contains a sequence of rendering operations
 // for dispatch to a Dispatcher. These objects must be instantiated
@@ -169,7 +170,11 @@ class DisplayList : public SkRefCnt {
     Dispatch(ctx, ptr, ptr + byte_count_);
   }
 
-  void RenderTo(SkCanvas* canvas, SkScalar opacity = SK_Scalar1) const;
+  // Renders the list onto |canvas|. Paths are drawn from the coverage masks
+  // of |path_cache| where it can, see |DisplayListPathCache|.
+  void RenderTo(SkCanvas* canvas,
+                SkScalar opacity = SK_Scalar1,
+                DisplayListPathCache* path_cache = nullptr) const;
 
   // SkPicture always includes nested bytes, but nested ops are
   // only included if requested. The defaults used here for these
@@ -185,6 +190,12 @@ class DisplayList : public SkRefCnt {
 
   uint32_t unique_id() const { return unique_id_; }
 
+  // A hash of the ops, computed by the DisplayListBuilder as they are
+  // recorded. Display lists that are Equals() have the same content hash,
+  // so it can be used to match a display list that was recorded again with
+  // the same content, such as after a rebuild of the framework widgets.
+  uint64_t content_hash() const { return content_hash_; }
+
   const SkRect& bounds() {
     if (bounds_.width() < 0.0) {
       // ComputeBounds() will leave the variable with a
@@ -200,12 +211,15 @@ class DisplayList : public SkRefCnt {
 
   static void DisposeOps(uint8_t* ptr, uint8_t* end);
 
+  static uint64_t HashOps(uint64_t hash, uint8_t* ptr, uint8_t* end);
+
  private:
   DisplayList(uint8_t* ptr,
               size_t byte_count,
               int op_count,
               size_t nested_byte_count,
               int nested_op_count,
+              uint64_t content_hash,
               const SkRect& cull_rect,
               bool can_apply_group_opacity);
 
@@ -217,6 +231,7 @@ class DisplayList : public SkRefCnt {
   int nested_op_count_;
 
   uint32_t unique_id_;
+  uint64_t content_hash_;
   SkRect bounds_;
 
   // Only used for drawPaint() and drawColor()
@@ -4,9 +4,15 @@
 
 #include "flutter/display_list/display_list_benchmarks.h"
 #include "flutter/display_list/display_list_builder.h"
+#include "flutter/display_list/display_list_canvas_dispatcher.h"
+#include "flutter/display_list/display_list_complexity.h"
+#include "flutter/display_list/display_list_optimizer.h"
+#include "flutter/display_list/display_list_path_cache.h"
+#include "flutter/display_list/display_list_utils.h"
 
 #include "third_party/skia/include/core/SkPoint.h"
 #include "third_party/skia/include/core/SkTextBlob.h"
+#include "third_party/skia/include/gpu/GrRecordingContext.h"
 
 namespace flutter {
 namespace testing {
@@ -19,6 +25,7 @@ constexpr size_t kCirclesToDraw = 5000;
 constexpr size_t kRRectsToDraw = 5000;
 constexpr size_t kArcSweepSetsToDraw = 1000;
 constexpr size_t kImagesToDraw = 500;
+constexpr size_t kListItemsToDraw = 5000;
 constexpr size_t kFixedCanvasSize = 1024;
 
 // Draw a series of diagonal lines across a square canvas of width/height of
@@ -448,9 +455,14 @@ std::string VerbToString(SkPath::Verb type) {
 // with approximately 20*N verbs, so we can get an idea of the fixed
 // cost of using drawPath as well as an idea of how the cost varies according
 // to the verb count.
+//
+// With `use_path_cache` set, the path is drawn through a DisplayListPathCache,
+// which draws it from a coverage mask on the software backend once it has
+// been drawn before, as the paths of retained display lists are.
 void BM_DrawPath(benchmark::State& state,
                  std::unique_ptr<CanvasProvider> canvas_provider,
-                 SkPath::Verb type) {
+                 SkPath::Verb type,
+                 bool use_path_cache) {
   DisplayListBuilder builder;
   size_t length = kFixedCanvasSize;
   canvas_provider->InitializeSurface(length, length);
@@ -470,13 +482,16 @@ void BM_DrawPath(benchmark::State& state,
   builder.drawPath(path);
   auto display_list = builder.Build();
 
+  DisplayListPathCache path_cache;
   // We only want to time the actual rasterization.
   for (auto _ : state) {
-    display_list->RenderTo(canvas);
+    display_list->RenderTo(canvas, SK_Scalar1,
+                           use_path_cache ? &path_cache : nullptr);
     canvas_provider->GetSurface()->flushAndSubmit(true);
   }
 
-  auto filename = canvas_provider->BackendName() + "-DrawPath-" + label + "-" +
+  auto filename = canvas_provider->BackendName() + "-DrawPath-" +
+                  (use_path_cache ? "Cached-" : "") + label + "-" +
                   std::to_string(state.range(0)) + ".png";
   canvas_provider->Snapshot(filename);
 }
@@ -1031,5 +1046,254 @@ void BM_DrawShadow(benchmark::State& state,
   canvas_provider->Snapshot(filename);
 }
 
+// Draws a list of `kListItemsToDraw` items into a square canvas of the
+// requested size, as a scrolled list would. Each item has its own save,
+// transform, clip and colors, and only the items that lie within the canvas
+// are visible.
+//
+// If |optimize| is true, the DisplayList is rewritten by the
+// DisplayListOptimizer before it is rendered, which drops the hidden items.
+void BM_DrawScrolledList(benchmark::State& state,
+                         std::unique_ptr<CanvasProvider> canvas_provider,
+                         bool optimize) {
+  DisplayListBuilder builder;
+  size_t length = state.range(0);
+  canvas_provider->InitializeSurface(length, length);
+  auto canvas = canvas_provider->GetSurface()->getCanvas();
+
+  const SkScalar item_height = 32.0f;
+  const SkRect item_bounds = SkRect::MakeWH(length, item_height);
+  const SkRRect icon = SkRRect::MakeRectXY(
+      SkRect::MakeXYWH(4.0f, 4.0f, item_height - 8.0f, item_height - 8.0f),
+      4.0f, 4.0f);
+
+  builder.clipRect(SkRect::MakeWH(length, length), SkClipOp::kIntersect,
+                   false);
+  for (size_t i = 0; i < kListItemsToDraw; i++) {
+    builder.save();
+    builder.translate(0.0f, i * item_height);
+    builder.clipRect(item_bounds, SkClipOp::kIntersect, false);
+    builder.setColor(i % 2 ? SK_ColorLTGRAY : SK_ColorWHITE);
+    builder.drawRect(item_bounds);
+    builder.setColor(SK_ColorBLUE);
+    builder.drawRRect(icon);
+    builder.restore();
+  }
+
+  auto display_list = builder.Build();
+  if (optimize) {
+    display_list = DisplayListOptimizer::Optimize(display_list);
+  }
+
+  // We only want to time the actual rasterization.
+  for (auto _ : state) {
+    display_list->RenderTo(canvas);
+    canvas_provider->GetSurface()->flushAndSubmit(true);
+  }
+
+  auto filename = canvas_provider->BackendName() + "-DrawScrolledList-" +
+                  (optimize ? "Optimized-" : "") + std::to_string(length) +
+                  ".png";
+  canvas_provider->Snapshot(filename);
+}
+
+// Draws the requested number of small display lists, of which one in four
+// is a single blurred circle and the others draw a few cheap rects, as a
+// raster cache would: a list is either rendered, or drawn from an image if
+// the admission policy decided to cache it. The images are rendered before
+// the timed loop, so the benchmark measures the steady state.
+//
+// If |use_cost_model| is false, lists with more than 5 ops are cached, which
+// is the op count heuristic that the raster cache used to apply. Otherwise
+// the lists are cached as decided by the DisplayListComplexityCalculator of
+// the backend.
+void BM_RasterCacheAdmission(benchmark::State& state,
+                             std::unique_ptr<CanvasProvider> canvas_provider,
+                             bool use_cost_model) {
+  size_t length = kFixedCanvasSize;
+  size_t list_count = state.range(0);
+  canvas_provider->InitializeSurface(length, length);
+  auto surface = canvas_provider->GetSurface();
+  auto canvas = surface->getCanvas();
+
+  std::vector<sk_sp<DisplayList>> display_lists;
+  for (size_t i = 0; i < list_count; i++) {
+    DisplayListBuilder builder;
+    if (i % 4 == 0) {
+      builder.setMaskBlurFilter(kNormal_SkBlurStyle, 8.0f);
+      builder.drawCircle(SkPoint::Make(32.0f, 32.0f), 24.0f);
+    } else {
+      for (size_t j = 0; j < 4; j++) {
+        builder.setColor(j % 2 ? SK_ColorRED : SK_ColorBLUE);
+        builder.drawRect(SkRect::MakeXYWH(j * 16.0f, 0.0f, 12.0f, 12.0f));
+      }
+    }
+    display_lists.push_back(builder.Build());
+  }
+
+  auto context = surface->recordingContext();
+  const DisplayListComplexityCalculator& calculator =
+      context ? DisplayListComplexityCalculator::GetForBackend(
+                    context->backend())
+              : DisplayListComplexityCalculator::GetForSoftware();
+  // The default access threshold of the raster cache.
+  const size_t access_count = 3;
+
+  std::vector<sk_sp<SkImage>> images(list_count);
+  size_t cached_count = 0;
+  for (size_t i = 0; i < list_count; i++) {
+    auto& display_list = display_lists[i];
+    SkIRect bounds = display_list->bounds().roundOut();
+    bool cache;
+    if (use_cost_model) {
+      uint64_t pixel_count =
+          static_cast<uint64_t>(bounds.width()) * bounds.height();
+      cache = calculator.ShouldBeCached(calculator.Compute(display_list.get()),
+                                        pixel_count, access_count);
+    } else {
+      cache = display_list->op_count(true) > 5;
+    }
+    if (cache) {
+      auto offscreen = canvas_provider->MakeOffscreenSurface(
+          bounds.width(), bounds.height());
+      offscreen->getCanvas()->translate(-bounds.fLeft, -bounds.fTop);
+      display_list->RenderTo(offscreen->getCanvas());
+      images[i] = offscreen->makeImageSnapshot();
+      cached_count++;
+    }
+  }
+  state.counters["CachedLists"] = cached_count;
+
+  const size_t lists_per_row = length / 64;
+  for (auto _ : state) {
+    for (size_t i = 0; i < list_count; i++) {
+      canvas->save();
+      canvas->translate((i % lists_per_row) * 64.0f,
+                        (i / lists_per_row % lists_per_row) * 64.0f);
+      if (images[i]) {
+        SkIRect bounds = display_lists[i]->bounds().roundOut();
+        canvas->drawImage(images[i], bounds.fLeft, bounds.fTop);
+      } else {
+        display_lists[i]->RenderTo(canvas);
+      }
+      canvas->restore();
+    }
+    surface->flushAndSubmit(true);
+  }
+
+  auto filename = canvas_provider->BackendName() + "-RasterCacheAdmission-" +
+                  (use_cost_model ? "CostModel-" : "OpCount-") +
+                  std::to_string(list_count) + ".png";
+  canvas_provider->Snapshot(filename);
+}
+
+// Draws `state.range(0)` elevated cards in a grid, as a Material UI would.
+// Every card draws the shadow of the same rounded rect at its own position.
+//
+// With `cached` set, the shadow is rendered into an image once, and every
+// card draws the image instead of its shadow, as the raster cache does with
+// the shadows of PhysicalShapeLayers.
+void BM_DrawShadowCardGrid(benchmark::State& state,
+                           std::unique_ptr<CanvasProvider> canvas_provider,
+                           bool cached) {
+  size_t length = kFixedCanvasSize;
+  size_t card_count = state.range(0);
+  canvas_provider->InitializeSurface(length, length);
+  auto surface = canvas_provider->GetSurface();
+  auto canvas = surface->getCanvas();
+
+  const float card_size = 48.0f;
+  const float elevation = 4.0f;
+  const float dpr = 2.0f;
+  SkPath card = SkPath::RRect(SkRRect::MakeRectXY(
+      SkRect::MakeWH(card_size, card_size), 4.0f, 4.0f));
+
+  sk_sp<SkImage> shadow_image;
+  SkIRect shadow_bounds;
+  if (cached) {
+    DisplayListCanvasDispatcher::ComputeShadowBounds(card, elevation, dpr,
+                                                     SkMatrix::I())
+        .roundOut(&shadow_bounds);
+    auto offscreen = canvas_provider->MakeOffscreenSurface(
+        shadow_bounds.width(), shadow_bounds.height());
+    offscreen->getCanvas()->translate(-shadow_bounds.fLeft,
+                                      -shadow_bounds.fTop);
+    DisplayListCanvasDispatcher::DrawShadow(offscreen->getCanvas(), card,
+                                            SK_ColorBLACK, elevation, false,
+                                            dpr);
+    shadow_image = offscreen->makeImageSnapshot();
+  }
+
+  SkPaint card_paint;
+  card_paint.setColor(SK_ColorWHITE);
+  card_paint.setAntiAlias(true);
+  const size_t cards_per_row = length / 64;
+  for (auto _ : state) {
+    for (size_t i = 0; i < card_count; i++) {
+      canvas->save();
+      canvas->translate((i % cards_per_row) * 64.0f + 8.0f,
+                        (i / cards_per_row % cards_per_row) * 64.0f + 8.0f);
+      if (shadow_image) {
+        canvas->drawImage(shadow_image, shadow_bounds.fLeft,
+                          shadow_bounds.fTop);
+      } else {
+        DisplayListCanvasDispatcher::DrawShadow(canvas, card, SK_ColorBLACK,
+                                                elevation, false, dpr);
+      }
+      canvas->drawPath(card, card_paint);
+      canvas->restore();
+    }
+    surface->flushAndSubmit(true);
+  }
+
+  auto filename = canvas_provider->BackendName() + "-DrawShadowCardGrid-" +
+                  (cached ? "Cached-" : "") + std::to_string(card_count) +
+                  ".png";
+  canvas_provider->Snapshot(filename);
+}
+
+// Measures how long it takes to compute the bounds of a DisplayList that
+// draws `state.range(0)` points or atlas sprites, as every DisplayListLayer
+// does the first time it is prerolled. Nothing is rendered.
+void BM_ComputeBounds(benchmark::State& state,
+                      std::unique_ptr<CanvasProvider> canvas_provider,
+                      DisplayListOpType type) {
+  const size_t count = state.range(0);
+  const SkScalar length = kFixedCanvasSize;
+  DisplayListBuilder builder;
+  if (type == DisplayListOpType::kDrawPoints) {
+    std::vector<SkPoint> points(count);
+    for (size_t i = 0; i < count; i++) {
+      points[i] = SkPoint::Make((i * 37) % kFixedCanvasSize,
+                                (i * 101) % kFixedCanvasSize);
+    }
+    builder.drawPoints(SkCanvas::kPoints_PointMode, count, points.data());
+  } else {
+    auto offscreen = canvas_provider->MakeOffscreenSurface(64, 64);
+    offscreen->getCanvas()->clear(SK_ColorRED);
+    auto atlas = offscreen->makeImageSnapshot();
+    std::vector<SkRSXform> xforms(count);
+    std::vector<SkRect> tex(count, SkRect::MakeWH(16, 16));
+    for (size_t i = 0; i < count; i++) {
+      xforms[i] = SkRSXform::MakeFromRadians(
+          1.0f, i * 0.1f, (i * 37) % kFixedCanvasSize,
+          (i * 101) % kFixedCanvasSize, 8.0f, 8.0f);
+    }
+    builder.drawAtlas(atlas, xforms.data(), tex.data(), nullptr, count,
+                      SkBlendMode::kSrcOver, DisplayList::NearestSampling,
+                      nullptr, false);
+  }
+  auto display_list = builder.Build();
+
+  // DisplayList::bounds() only computes the bounds once, so dispatch to a
+  // new calculator every iteration instead.
+  const SkRect cull = SkRect::MakeWH(length, length);
+  for (auto _ : state) {
+    DisplayListBoundsCalculator calculator(&cull);
+    display_list->Dispatch(calculator);
+    benchmark::DoNotOptimize(calculator.bounds());
+  }
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -5,6 +5,7 @@
 #ifndef FLUTTER_FLOW_DISPLAY_LIST_BENCHMARKS_H_
 #define FLUTTER_FLOW_DISPLAY_LIST_BENCHMARKS_H_
 
+#include "flutter/display_list/display_list.h"
 #include "flutter/fml/mapping.h"
 #include "flutter/testing/testing.h"
 
@@ -63,7 +64,8 @@ void BM_DrawRRect(benchmark::State& state,
                   SkRRect::Type type);
 void BM_DrawPath(benchmark::State& state,
                  std::unique_ptr<CanvasProvider> canvas_provider,
-                 SkPath::Verb type);
+                 SkPath::Verb type,
+                 bool use_path_cache);
 void BM_DrawPoints(benchmark::State& state,
                    std::unique_ptr<CanvasProvider> canvas_provider,
                    SkCanvas::PointMode mode);
@@ -89,6 +91,18 @@ void BM_DrawShadow(benchmark::State& state,
                    std::unique_ptr<CanvasProvider> canvas_provider,
                    bool transparent_occluder,
                    SkPath::Verb type);
+void BM_DrawScrolledList(benchmark::State& state,
+                         std::unique_ptr<CanvasProvider> canvas_provider,
+                         bool optimize);
+void BM_RasterCacheAdmission(benchmark::State& state,
+                             std::unique_ptr<CanvasProvider> canvas_provider,
+                             bool use_cost_model);
+void BM_DrawShadowCardGrid(benchmark::State& state,
+                           std::unique_ptr<CanvasProvider> canvas_provider,
+                           bool cached);
+void BM_ComputeBounds(benchmark::State& state,
+                      std::unique_ptr<CanvasProvider> canvas_provider,
+                      DisplayListOpType type);
 
 // clang-format off
 
@@ -150,7 +164,7 @@ void BM_DrawShadow(benchmark::State& state,
   BENCHMARK_CAPTURE(BM_DrawPath,                                        \
                     Lines/BACKEND,                                      \
                     std::make_unique<BACKEND##CanvasProvider>(),        \
-                    SkPath::Verb::kLine_Verb)                           \
+                    SkPath::Verb::kLine_Verb, false)                    \
       ->RangeMultiplier(2)                                              \
       ->Range(8, 1024)                                                  \
       ->UseRealTime()                                                   \
@@ -160,7 +174,7 @@ void BM_DrawShadow(benchmark::State& state,
   BENCHMARK_CAPTURE(BM_DrawPath,                                        \
                     Quads/BACKEND,                                      \
                     std::make_unique<BACKEND##CanvasProvider>(),        \
-                    SkPath::Verb::kQuad_Verb)                           \
+                    SkPath::Verb::kQuad_Verb, false)                    \
       ->RangeMultiplier(2)                                              \
       ->Range(8, 1024)                                                  \
       ->UseRealTime()                                                   \
@@ -170,7 +184,7 @@ void BM_DrawShadow(benchmark::State& state,
   BENCHMARK_CAPTURE(BM_DrawPath,                                        \
                     Conics/BACKEND,                                     \
                     std::make_unique<BACKEND##CanvasProvider>(),        \
-                    SkPath::Verb::kConic_Verb)                          \
+                    SkPath::Verb::kConic_Verb, false)                   \
       ->RangeMultiplier(2)                                              \
       ->Range(8, 1024)                                                  \
       ->UseRealTime()                                                   \
@@ -180,7 +194,27 @@ void BM_DrawShadow(benchmark::State& state,
   BENCHMARK_CAPTURE(BM_DrawPath,                                        \
                     Cubics/BACKEND,                                     \
                     std::make_unique<BACKEND##CanvasProvider>(),        \
-                    SkPath::Verb::kCubic_Verb)                          \
+                    SkPath::Verb::kCubic_Verb, false)                   \
+      ->RangeMultiplier(2)                                              \
+      ->Range(8, 1024)                                                  \
+      ->UseRealTime()                                                   \
+      ->Unit(benchmark::kMillisecond)                                   \
+      ->Complexity();                                                   \
+                                                                        \
+  BENCHMARK_CAPTURE(BM_DrawPath,                                        \
+                    CachedLines/BACKEND,                                \
+                    std::make_unique<BACKEND##CanvasProvider>(),        \
+                    SkPath::Verb::kLine_Verb, true)                     \
+      ->RangeMultiplier(2)                                              \
+      ->Range(8, 1024)                                                  \
+      ->UseRealTime()                                                   \
+      ->Unit(benchmark::kMillisecond)                                   \
+      ->Complexity();                                                   \
+                                                                        \
+  BENCHMARK_CAPTURE(BM_DrawPath,                                        \
+                    CachedCubics/BACKEND,                               \
+                    std::make_unique<BACKEND##CanvasProvider>(),        \
+                    SkPath::Verb::kCubic_Verb, true)                    \
       ->RangeMultiplier(2)                                              \
       ->Range(8, 1024)                                                  \
       ->UseRealTime()                                                   \
@@ -443,7 +477,75 @@ void BM_DrawShadow(benchmark::State& state,
       ->RangeMultiplier(2)                                              \
       ->Range(1, 32)                                                    \
       ->UseRealTime()                                                   \
-      ->Unit(benchmark::kMillisecond);
+      ->Unit(benchmark::kMillisecond);                                  \
+                                                                        \
+  /*                                                                    \
+   *  DrawScrolledList                                                  \
+   */                                                                   \
+  BENCHMARK_CAPTURE(BM_DrawScrolledList, BACKEND,                       \
+                    std::make_unique<BACKEND##CanvasProvider>(), false) \
+      ->RangeMultiplier(2)                                              \
+      ->Range(16, 2048)                                                 \
+      ->UseRealTime()                                                   \
+      ->Unit(benchmark::kMillisecond);                                  \
+                                                                        \
+  BENCHMARK_CAPTURE(BM_DrawScrolledList, Optimized/BACKEND,             \
+                    std::make_unique<BACKEND##CanvasProvider>(), true)  \
+      ->RangeMultiplier(2)                                              \
+      ->Range(16, 2048)                                                 \
+      ->UseRealTime()                                                   \
+      ->Unit(benchmark::kMillisecond);                                  \
+                                                                        \
+  /*                                                                    \
+   *  RasterCacheAdmission                                              \
+   */                                                                   \
+  BENCHMARK_CAPTURE(BM_RasterCacheAdmission, OpCount/BACKEND,           \
+                    std::make_unique<BACKEND##CanvasProvider>(), false) \
+      ->RangeMultiplier(2)                                              \
+      ->Range(16, 256)                                                  \
+      ->UseRealTime()                                                   \
+      ->Unit(benchmark::kMillisecond);                                  \
+                                                                        \
+  BENCHMARK_CAPTURE(BM_RasterCacheAdmission, CostModel/BACKEND,         \
+                    std::make_unique<BACKEND##CanvasProvider>(), true)  \
+      ->RangeMultiplier(2)                                              \
+      ->Range(16, 256)                                                  \
+      ->UseRealTime()                                                   \
+      ->Unit(benchmark::kMillisecond);                                  \
+                                                                        \
+  /*                                                                    \
+   *  DrawShadowCardGrid                                                \
+   */                                                                   \
+  BENCHMARK_CAPTURE(BM_DrawShadowCardGrid, BACKEND,                     \
+                    std::make_unique<BACKEND##CanvasProvider>(), false) \
+      ->RangeMultiplier(2)                                              \
+      ->Range(16, 256)                                                  \
+      ->UseRealTime()                                                   \
+      ->Unit(benchmark::kMillisecond);                                  \
+                                                                        \
+  BENCHMARK_CAPTURE(BM_DrawShadowCardGrid, Cached/BACKEND,              \
+                    std::make_unique<BACKEND##CanvasProvider>(), true)  \
+      ->RangeMultiplier(2)                                              \
+      ->Range(16, 256)                                                  \
+      ->UseRealTime()                                                   \
+      ->Unit(benchmark::kMillisecond);                                  \
+                                                                        \
+  /*                                                                    \
+   *  ComputeBounds                                                     \
+   */                                                                   \
+  BENCHMARK_CAPTURE(BM_ComputeBounds, Points/BACKEND,                   \
+                    std::make_unique<BACKEND##CanvasProvider>(),        \
+                    DisplayListOpType::kDrawPoints)                     \
+      ->RangeMultiplier(4)                                              \
+      ->Range(256, 65536)                                               \
+      ->Unit(benchmark::kMicrosecond);                                  \
+                                                                        \
+  BENCHMARK_CAPTURE(BM_ComputeBounds, Atlas/BACKEND,                    \
+                    std::make_unique<BACKEND##CanvasProvider>(),        \
+                    DisplayListOpType::kDrawAtlas)                      \
+      ->RangeMultiplier(4)                                              \
+      ->Range(256, 65536)                                               \
+      ->Unit(benchmark::kMicrosecond);
 
 // clang-format on
 
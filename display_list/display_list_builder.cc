@@ -24,6 +24,8 @@ static void CopyV(void* dst, const S* src, int n, Rest&&... rest) {
 
 template <typename T, typename... Args>
 void* DisplayListBuilder::Push(size_t pod, int op_inc, Args&&... args) {
+  // The payload of the previous op is written after it was pushed.
+  HashPendingOps();
   size_t size = SkAlignPtr(sizeof(T) + pod);
   FML_DCHECK(size < (1 << 24));
   if (used_ + size > allocated_) {
@@ -49,21 +51,32 @@ sk_sp<DisplayList> DisplayListBuilder::Build() {
   while (layer_stack_.size() > 1) {
     restore();
   }
+  HashPendingOps();
   size_t bytes = used_;
   int count = op_count_;
   size_t nested_bytes = nested_bytes_;
   int nested_count = nested_op_count_;
+  uint64_t content_hash = content_hash_;
   used_ = allocated_ = op_count_ = 0;
   nested_bytes_ = nested_op_count_ = 0;
+  hashed_ = 0;
+  content_hash_ = kDisplayListHashSeed;
   storage_.realloc(bytes);
   bool compatible = layer_stack_.back().is_group_opacity_compatible();
-  return sk_sp<DisplayList>(new DisplayList(storage_.release(), bytes, count,
-                                            nested_bytes, nested_count,
-                                            cull_rect_, compatible));
+  return sk_sp<DisplayList>(new DisplayList(
+      storage_.release(), bytes, count, nested_bytes, nested_count,
+      content_hash, cull_rect_, compatible));
+}
+
+void DisplayListBuilder::HashPendingOps() {
+  uint8_t* ptr = storage_.get();
+  content_hash_ = DisplayList::HashOps(content_hash_, ptr + hashed_,
+                                       ptr + used_);
+  hashed_ = used_;
 }
 
 DisplayListBuilder::DisplayListBuilder(const SkRect& cull_rect)
-    : cull_rect_(cull_rect) {
+    : content_hash_(kDisplayListHashSeed), cull_rect_(cull_rect) {
   layer_stack_.emplace_back();
   current_layer_ = &layer_stack_.back();
 }
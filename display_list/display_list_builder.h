@@ -257,6 +257,11 @@ class DisplayListBuilder final : public virtual Dispatcher,
   size_t nested_bytes_ = 0;
   int nested_op_count_ = 0;
 
+  // The hash of the ops up to |hashed_|. An op is only hashed once the next
+  // op is pushed or the list is built, after its payload has been copied.
+  uint64_t content_hash_;
+  size_t hashed_ = 0;
+
   SkRect cull_rect_;
   static constexpr SkRect kMaxCullRect_ =
       SkRect::MakeLTRB(-1E9F, -1E9F, 1E9F, 1E9F);
@@ -264,6 +269,8 @@ class DisplayListBuilder final : public virtual Dispatcher,
   template <typename T, typename... Args>
   void* Push(size_t extra, int op_inc, Args&&... args);
 
+  void HashPendingOps();
+
   // kInvalidSigma is used to indicate that no MaskBlur is currently set.
   static constexpr SkScalar kInvalidSigma = 0.0;
   static bool mask_sigma_valid(SkScalar sigma) {
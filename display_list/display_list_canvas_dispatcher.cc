@@ -131,6 +131,9 @@ void DisplayListCanvasDispatcher::drawDRRect(const SkRRect& outer,
   canvas_->drawDRRect(outer, inner, paint());
 }
 void DisplayListCanvasDispatcher::drawPath(const SkPath& path) {
+  if (path_cache_ && path_cache_->DrawPath(canvas_, path, paint())) {
+    return;
+  }
   canvas_->drawPath(path, paint());
 }
 void DisplayListCanvasDispatcher::drawArc(const SkRect& bounds,
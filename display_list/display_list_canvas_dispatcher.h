@@ -7,6 +7,7 @@
 
 #include "flutter/display_list/display_list.h"
 #include "flutter/display_list/display_list_dispatcher.h"
+#include "flutter/display_list/display_list_path_cache.h"
 #include "flutter/display_list/display_list_utils.h"
 #include "flutter/fml/macros.h"
 
@@ -21,9 +22,13 @@ namespace flutter {
 class DisplayListCanvasDispatcher : public virtual Dispatcher,
                                     public SkPaintDispatchHelper {
  public:
-  explicit DisplayListCanvasDispatcher(SkCanvas* canvas,
-                                       SkScalar opacity = SK_Scalar1)
-      : SkPaintDispatchHelper(opacity), canvas_(canvas) {}
+  explicit DisplayListCanvasDispatcher(
+      SkCanvas* canvas,
+      SkScalar opacity = SK_Scalar1,
+      DisplayListPathCache* path_cache = nullptr)
+      : SkPaintDispatchHelper(opacity),
+        canvas_(canvas),
+        path_cache_(path_cache) {}
 
   const SkPaint* safe_paint(bool use_attributes);
 
@@ -125,6 +130,7 @@ class DisplayListCanvasDispatcher : public virtual Dispatcher,
 
  private:
   SkCanvas* canvas_;
+  DisplayListPathCache* path_cache_;
   SkPaint temp_paint_;
 };
 
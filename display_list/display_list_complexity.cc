@@ -0,0 +1,373 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/display_list_complexity.h"
+
+#include <algorithm>
+
+#include "flutter/display_list/display_list_utils.h"
+#include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/core/SkTextBlob.h"
+#include "third_party/skia/include/core/SkVertices.h"
+
+namespace flutter {
+
+namespace {
+
+using Costs = DisplayListComplexityCalculator::Costs;
+
+// clang-format off
+
+// The CPU renders every pixel, but has no per-op setup to speak of.
+constexpr Costs kSoftwareCosts = {
+    /* op_ns         */ 20,
+    /* draw_ns       */ 150,
+    /* save_layer_ns */ 2000,
+    /* path_verb_ns  */ 60,
+    /* fill_kpx_ns   */ 900,
+    /* path_kpx_ns   */ 1800,
+    /* image_kpx_ns  */ 1500,
+    /* text_kpx_ns   */ 2500,
+    /* layer_kpx_ns  */ 1200,
+    /* blur_kpx_ns   */ 12000,
+};
+
+// GPUs fill pixels cheaply, but every draw has to be recorded and batched,
+// paths have to be tessellated or masked, and layers need a render pass.
+constexpr Costs kOpenGLCosts = {
+    /* op_ns         */ 15,
+    /* draw_ns       */ 700,
+    /* save_layer_ns */ 30000,
+    /* path_verb_ns  */ 250,
+    /* fill_kpx_ns   */ 20,
+    /* path_kpx_ns   */ 60,
+    /* image_kpx_ns  */ 30,
+    /* text_kpx_ns   */ 100,
+    /* layer_kpx_ns  */ 80,
+    /* blur_kpx_ns   */ 600,
+};
+
+constexpr Costs kMetalCosts = {
+    /* op_ns         */ 15,
+    /* draw_ns       */ 600,
+    /* save_layer_ns */ 25000,
+    /* path_verb_ns  */ 200,
+    /* fill_kpx_ns   */ 15,
+    /* path_kpx_ns   */ 50,
+    /* image_kpx_ns  */ 25,
+    /* text_kpx_ns   */ 80,
+    /* layer_kpx_ns  */ 60,
+    /* blur_kpx_ns   */ 500,
+};
+
+// clang-format on
+
+uint64_t ComputeCost(const Costs& costs,
+                     const DisplayList* display_list,
+                     const SkM44& matrix,
+                     const SkRect& device_clip);
+
+// Adds up the costs of the ops of a DisplayList that is rendered with a
+// given transform and clip.
+class CostAccumulator final : public virtual Dispatcher,
+                              public virtual IgnoreAttributeDispatchHelper,
+                              public virtual SkMatrixDispatchHelper,
+                              public virtual ClipBoundsDispatchHelper {
+ public:
+  CostAccumulator(const Costs& costs,
+                  const SkM44& matrix,
+                  const SkRect& device_clip)
+      : ClipBoundsDispatchHelper(&device_clip), costs_(costs) {
+    // clang-format off
+    SkMatrixDispatchHelper::transformFullPerspective(
+        matrix.rc(0, 0), matrix.rc(0, 1), matrix.rc(0, 2), matrix.rc(0, 3),
+        matrix.rc(1, 0), matrix.rc(1, 1), matrix.rc(1, 2), matrix.rc(1, 3),
+        matrix.rc(2, 0), matrix.rc(2, 1), matrix.rc(2, 2), matrix.rc(2, 3),
+        matrix.rc(3, 0), matrix.rc(3, 1), matrix.rc(3, 2), matrix.rc(3, 3));
+    // clang-format on
+  }
+
+  uint64_t cost() const { return cost_; }
+
+  void setStyle(SkPaint::Style style) override { style_ = style; }
+  void setPathEffect(sk_sp<SkPathEffect> effect) override {
+    has_path_effect_ = effect != nullptr;
+  }
+  void setMaskFilter(sk_sp<SkMaskFilter> filter) override {
+    has_mask_filter_ = filter != nullptr;
+  }
+  void setMaskBlurFilter(SkBlurStyle style, SkScalar sigma) override {
+    has_mask_filter_ = true;
+  }
+  void setImageFilter(sk_sp<SkImageFilter> filter) override {
+    has_image_filter_ = filter != nullptr;
+  }
+
+  void save() override {
+    SkMatrixDispatchHelper::save();
+    ClipBoundsDispatchHelper::save();
+  }
+  void saveLayer(const SkRect* bounds, bool restore_with_paint) override {
+    const uint64_t pixels = bounds ? LocalPixels(*bounds) : ClipPixels();
+    cost_ += costs_.save_layer_ns;
+    Accumulate(pixels, costs_.layer_kpx_ns, restore_with_paint);
+    SkMatrixDispatchHelper::save();
+    ClipBoundsDispatchHelper::save();
+  }
+  void restore() override {
+    SkMatrixDispatchHelper::restore();
+    ClipBoundsDispatchHelper::restore();
+  }
+
+  void clipPath(const SkPath& path, SkClipOp clip_op, bool is_aa) override {
+    ClipBoundsDispatchHelper::clipPath(path, clip_op, is_aa);
+    cost_ += static_cast<uint64_t>(path.countVerbs()) * costs_.path_verb_ns;
+  }
+
+  void drawColor(SkColor color, SkBlendMode mode) override {
+    cost_ += costs_.draw_ns;
+    Accumulate(ClipPixels(), costs_.fill_kpx_ns, false);
+  }
+  void drawPaint() override {
+    cost_ += costs_.draw_ns;
+    Accumulate(ClipPixels(), costs_.fill_kpx_ns, true);
+  }
+  void drawLine(const SkPoint& p0, const SkPoint& p1) override {
+    AccumulateDraw(SkRect::MakeLTRB(p0.fX, p0.fY, p1.fX, p1.fY).makeSorted(),
+                   costs_.path_kpx_ns);
+  }
+  void drawRect(const SkRect& rect) override {
+    AccumulateDraw(rect, GeometryCost());
+  }
+  void drawOval(const SkRect& bounds) override {
+    AccumulateDraw(bounds, GeometryCost());
+  }
+  void drawCircle(const SkPoint& center, SkScalar radius) override {
+    AccumulateDraw(SkRect::MakeLTRB(center.fX - radius, center.fY - radius,
+                                    center.fX + radius, center.fY + radius),
+                   GeometryCost());
+  }
+  void drawRRect(const SkRRect& rrect) override {
+    AccumulateDraw(rrect.getBounds(), GeometryCost());
+  }
+  void drawDRRect(const SkRRect& outer, const SkRRect& inner) override {
+    AccumulateDraw(outer.getBounds(), GeometryCost());
+  }
+  void drawPath(const SkPath& path) override {
+    cost_ += static_cast<uint64_t>(path.countVerbs()) * costs_.path_verb_ns;
+    if (path.isInverseFillType()) {
+      cost_ += costs_.draw_ns;
+      Accumulate(ClipPixels(), costs_.path_kpx_ns, true);
+    } else {
+      AccumulateDraw(path.getBounds(), costs_.path_kpx_ns);
+    }
+  }
+  void drawArc(const SkRect& oval_bounds,
+               SkScalar start_degrees,
+               SkScalar sweep_degrees,
+               bool use_center) override {
+    AccumulateDraw(oval_bounds, costs_.path_kpx_ns);
+  }
+  void drawPoints(SkCanvas::PointMode mode,
+                  uint32_t count,
+                  const SkPoint points[]) override {
+    SkRect bounds;
+    bounds.setBounds(points, count);
+    cost_ += static_cast<uint64_t>(count) * costs_.op_ns;
+    AccumulateDraw(bounds, costs_.path_kpx_ns);
+  }
+  void drawVertices(const sk_sp<SkVertices> vertices,
+                    SkBlendMode mode) override {
+    AccumulateDraw(vertices->bounds(), costs_.image_kpx_ns);
+  }
+  void drawImage(const sk_sp<SkImage> image,
+                 const SkPoint point,
+                 const SkSamplingOptions& sampling,
+                 bool render_with_attributes) override {
+    AccumulateDraw(SkRect::MakeXYWH(point.fX, point.fY, image->width(),
+                                    image->height()),
+                   costs_.image_kpx_ns, render_with_attributes);
+  }
+  void drawImageRect(const sk_sp<SkImage> image,
+                     const SkRect& src,
+                     const SkRect& dst,
+                     const SkSamplingOptions& sampling,
+                     bool render_with_attributes,
+                     SkCanvas::SrcRectConstraint constraint) override {
+    AccumulateDraw(dst, costs_.image_kpx_ns, render_with_attributes);
+  }
+  void drawImageNine(const sk_sp<SkImage> image,
+                     const SkIRect& center,
+                     const SkRect& dst,
+                     SkFilterMode filter,
+                     bool render_with_attributes) override {
+    AccumulateDraw(dst, costs_.image_kpx_ns, render_with_attributes);
+  }
+  void drawImageLattice(const sk_sp<SkImage> image,
+                        const SkCanvas::Lattice& lattice,
+                        const SkRect& dst,
+                        SkFilterMode filter,
+                        bool render_with_attributes) override {
+    AccumulateDraw(dst, costs_.image_kpx_ns, render_with_attributes);
+  }
+  void drawAtlas(const sk_sp<SkImage> atlas,
+                 const SkRSXform xform[],
+                 const SkRect tex[],
+                 const SkColor colors[],
+                 int count,
+                 SkBlendMode mode,
+                 const SkSamplingOptions& sampling,
+                 const SkRect* cull_rect,
+                 bool render_with_attributes) override {
+    cost_ += static_cast<uint64_t>(std::max(count, 0)) * costs_.op_ns;
+    cost_ += costs_.draw_ns;
+    Accumulate(cull_rect ? LocalPixels(*cull_rect) : ClipPixels(),
+               costs_.image_kpx_ns, render_with_attributes);
+  }
+  void drawPicture(const sk_sp<SkPicture> picture,
+                   const SkMatrix* matrix,
+                   bool render_with_attributes) override {
+    const SkRect bounds =
+        matrix ? matrix->mapRect(picture->cullRect()) : picture->cullRect();
+    cost_ += static_cast<uint64_t>(picture->approximateOpCount(true)) *
+             costs_.draw_ns;
+    Accumulate(LocalPixels(bounds), costs_.image_kpx_ns,
+               render_with_attributes);
+  }
+  void drawDisplayList(const sk_sp<DisplayList> display_list) override {
+    if (has_clip()) {
+      cost_ += ComputeCost(costs_, display_list.get(), m44(), clip_bounds());
+    }
+  }
+  void drawTextBlob(const sk_sp<SkTextBlob> blob,
+                    SkScalar x,
+                    SkScalar y) override {
+    AccumulateDraw(blob->bounds().makeOffset(x, y), costs_.text_kpx_ns);
+  }
+  void drawShadow(const SkPath& path,
+                  const SkColor color,
+                  const SkScalar elevation,
+                  bool transparent_occluder,
+                  SkScalar dpr) override {
+    const SkScalar spread = elevation * dpr;
+    cost_ += static_cast<uint64_t>(path.countVerbs()) * costs_.path_verb_ns;
+    cost_ += costs_.draw_ns;
+    Accumulate(LocalPixels(path.getBounds().makeOutset(spread, spread)),
+               costs_.blur_kpx_ns, false);
+  }
+
+ private:
+  const Costs& costs_;
+  uint64_t cost_ = 0;
+
+  SkPaint::Style style_ = SkPaint::kFill_Style;
+  bool has_path_effect_ = false;
+  bool has_mask_filter_ = false;
+  bool has_image_filter_ = false;
+
+  // The cost per thousand pixels of the simple shapes, which are more
+  // expensive once they are stroked.
+  uint32_t GeometryCost() const {
+    return style_ != SkPaint::kFill_Style || has_path_effect_
+               ? costs_.path_kpx_ns
+               : costs_.fill_kpx_ns;
+  }
+
+  // The number of device pixels that |bounds| covers within the clip.
+  uint64_t LocalPixels(const SkRect& bounds) const {
+    SkRect device_bounds = matrix().mapRect(bounds);
+    if (!device_bounds.isFinite() ||
+        (has_clip() && !device_bounds.intersect(clip_bounds()))) {
+      return 0;
+    }
+    return static_cast<uint64_t>(device_bounds.width()) *
+           static_cast<uint64_t>(device_bounds.height());
+  }
+
+  uint64_t ClipPixels() const {
+    if (!has_clip()) {
+      return 0;
+    }
+    return static_cast<uint64_t>(clip_bounds().width()) *
+           static_cast<uint64_t>(clip_bounds().height());
+  }
+
+  void Accumulate(uint64_t pixels, uint32_t kpx_ns, bool uses_filters) {
+    uint64_t cost_per_kpx = kpx_ns;
+    if (uses_filters && (has_mask_filter_ || has_image_filter_)) {
+      cost_per_kpx += costs_.blur_kpx_ns;
+    }
+    cost_ += pixels * cost_per_kpx / 1000;
+  }
+
+  void AccumulateDraw(const SkRect& bounds,
+                      uint32_t kpx_ns,
+                      bool uses_filters = true) {
+    cost_ += costs_.draw_ns;
+    Accumulate(LocalPixels(bounds), kpx_ns, uses_filters);
+  }
+};
+
+uint64_t ComputeCost(const Costs& costs,
+                     const DisplayList* display_list,
+                     const SkM44& matrix,
+                     const SkRect& device_clip) {
+  CostAccumulator accumulator(costs, matrix, device_clip);
+  display_list->Dispatch(accumulator);
+  return static_cast<uint64_t>(display_list->op_count()) * costs.op_ns +
+         accumulator.cost();
+}
+
+}  // namespace
+
+const DisplayListComplexityCalculator&
+DisplayListComplexityCalculator::GetForSoftware() {
+  static const DisplayListComplexityCalculator calculator(kSoftwareCosts);
+  return calculator;
+}
+
+const DisplayListComplexityCalculator&
+DisplayListComplexityCalculator::GetForBackend(GrBackendApi backend) {
+  static const DisplayListComplexityCalculator opengl(kOpenGLCosts);
+  static const DisplayListComplexityCalculator metal(kMetalCosts);
+  switch (backend) {
+    case GrBackendApi::kMetal:
+      return metal;
+    default:
+      return opengl;
+  }
+}
+
+DisplayListComplexityCalculator::DisplayListComplexityCalculator(
+    const Costs& costs)
+    : costs_(costs) {}
+
+uint64_t DisplayListComplexityCalculator::Compute(
+    const DisplayList* display_list,
+    const SkMatrix& matrix) const {
+  const SkRect device_bounds = matrix.mapRect(display_list->bounds());
+  return ComputeCost(costs_, display_list, SkM44(matrix), device_bounds);
+}
+
+uint64_t DisplayListComplexityCalculator::ComputeImageDrawCost(
+    uint64_t pixel_count) const {
+  return costs_.draw_ns + pixel_count * costs_.image_kpx_ns / 1000;
+}
+
+bool DisplayListComplexityCalculator::ShouldBeCached(
+    uint64_t cost,
+    uint64_t pixel_count,
+    size_t access_count) const {
+  const uint64_t image_cost = ComputeImageDrawCost(pixel_count);
+  if (cost <= image_cost) {
+    return false;
+  }
+  // Rendering the list into the image costs about as much as rendering it
+  // to the screen, plus setting up the image.
+  const uint64_t cache_cost =
+      cost + costs_.save_layer_ns + pixel_count * costs_.layer_kpx_ns / 1000;
+  return (cost - image_cost) * access_count >= cache_cost;
+}
+
+}  // namespace flutter
@@ -0,0 +1,104 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_DISPLAY_LIST_DISPLAY_LIST_COMPLEXITY_H_
+#define FLUTTER_DISPLAY_LIST_DISPLAY_LIST_COMPLEXITY_H_
+
+#include <cstdint>
+
+#include "flutter/display_list/display_list.h"
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/gpu/GrTypes.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Estimates how long a backend takes to render a DisplayList, so
+///             that cheap lists can be told apart from expensive ones
+///             regardless of how many ops they have.
+///
+///             The estimate adds up a fixed cost for every op and a cost for
+///             every thousand device pixels that each rendering op touches,
+///             which depends on the kind of op and on its attributes. The
+///             costs are kept in a table per backend (see |Costs|).
+///
+///             The tables are meant to be calibrated with the BM_Draw*
+///             benchmarks in display_list_benchmarks.cc, run on the backend's
+///             reference devices: the fixed cost of an op is its time per
+///             op at the smallest size, and its pixel cost is the slope of
+///             its time per op over the larger sizes. Until they are, the
+///             raster cache only admits display lists by these estimates
+///             when |RasterCache::SetAdmitDisplayListsByCost| enables it.
+///
+class DisplayListComplexityCalculator {
+ public:
+  /// The costs of rendering operations on a backend, in nanoseconds.
+  struct Costs {
+    // Fixed costs.
+    uint32_t op_ns;          // Every op, including attributes and transforms.
+    uint32_t draw_ns;        // Every rendering op.
+    uint32_t save_layer_ns;  // Allocating and compositing a layer.
+    uint32_t path_verb_ns;   // Every verb of a drawn or clipped path.
+
+    // Costs per thousand device pixels.
+    uint32_t fill_kpx_ns;   // Colors, rects, rrects, ovals and circles.
+    uint32_t path_kpx_ns;   // Paths, arcs, lines, points and any stroke.
+    uint32_t image_kpx_ns;  // Images, atlases, vertices and pictures.
+    uint32_t text_kpx_ns;   // Text blobs.
+    uint32_t layer_kpx_ns;  // Save layers.
+    uint32_t blur_kpx_ns;   // Mask filters, image filters and shadows.
+  };
+
+  //----------------------------------------------------------------------------
+  /// @brief      The calculator for the software backend, which is used when
+  ///             there is no GrDirectContext.
+  ///
+  static const DisplayListComplexityCalculator& GetForSoftware();
+
+  //----------------------------------------------------------------------------
+  /// @brief      The calculator for a GPU backend. Backends that have no
+  ///             table of their own use the one of the OpenGL backend.
+  ///
+  static const DisplayListComplexityCalculator& GetForBackend(
+      GrBackendApi backend);
+
+  explicit DisplayListComplexityCalculator(const Costs& costs);
+
+  const Costs& costs() const { return costs_; }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Estimates the time it takes to render |display_list| with
+  ///             the given transform, in nanoseconds.
+  ///
+  uint64_t Compute(const DisplayList* display_list,
+                   const SkMatrix& matrix = SkMatrix::I()) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Estimates the time it takes to draw an image of
+  ///             |pixel_count| pixels, such as a raster cache entry, in
+  ///             nanoseconds.
+  ///
+  uint64_t ComputeImageDrawCost(uint64_t pixel_count) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether drawing a cached image of |pixel_count| pixels
+  ///             instead of rendering a list that costs |cost| is expected to
+  ///             save time, given that the list has been drawn
+  ///             |access_count| times. The time saved every time the image
+  ///             is drawn must pay for rendering the list into the image
+  ///             within that many accesses.
+  ///
+  bool ShouldBeCached(uint64_t cost,
+                      uint64_t pixel_count,
+                      size_t access_count) const;
+
+ private:
+  const Costs costs_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DisplayListComplexityCalculator);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_DISPLAY_LIST_DISPLAY_LIST_COMPLEXITY_H_
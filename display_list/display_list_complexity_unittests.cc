@@ -0,0 +1,120 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/display_list_complexity.h"
+
+#include "flutter/display_list/display_list.h"
+#include "flutter/display_list/display_list_builder.h"
+#include "flutter/testing/testing.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+std::vector<const DisplayListComplexityCalculator*> AllCalculators() {
+  return {
+      &DisplayListComplexityCalculator::GetForSoftware(),
+      &DisplayListComplexityCalculator::GetForBackend(GrBackendApi::kOpenGL),
+      &DisplayListComplexityCalculator::GetForBackend(GrBackendApi::kMetal),
+  };
+}
+
+sk_sp<DisplayList> MakeRects(int count, SkScalar size) {
+  DisplayListBuilder builder;
+  for (int i = 0; i < count; i++) {
+    builder.setColor(i % 2 ? SK_ColorRED : SK_ColorBLUE);
+    builder.drawRect(SkRect::MakeXYWH(i, i, size, size));
+  }
+  return builder.Build();
+}
+
+}  // namespace
+
+TEST(DisplayListComplexity, EmptyListIsFree) {
+  auto display_list = DisplayListBuilder().Build();
+  for (auto calculator : AllCalculators()) {
+    EXPECT_EQ(calculator->Compute(display_list.get()), 0u);
+  }
+}
+
+TEST(DisplayListComplexity, CostGrowsWithOpsAndPixels) {
+  auto few_small = MakeRects(2, 10);
+  auto many_small = MakeRects(20, 10);
+  auto few_large = MakeRects(2, 500);
+  for (auto calculator : AllCalculators()) {
+    EXPECT_LT(calculator->Compute(few_small.get()),
+              calculator->Compute(many_small.get()));
+    EXPECT_LT(calculator->Compute(few_small.get()),
+              calculator->Compute(few_large.get()));
+  }
+}
+
+TEST(DisplayListComplexity, CostFollowsTransform) {
+  auto display_list = MakeRects(2, 100);
+  for (auto calculator : AllCalculators()) {
+    EXPECT_LT(calculator->Compute(display_list.get()),
+              calculator->Compute(display_list.get(), SkMatrix::Scale(4, 4)));
+  }
+}
+
+TEST(DisplayListComplexity, ClippedPixelsAreFree) {
+  DisplayListBuilder clipped_builder;
+  clipped_builder.clipRect(SkRect::MakeWH(10, 10), SkClipOp::kIntersect,
+                           false);
+  clipped_builder.drawRect(SkRect::MakeWH(500, 500));
+  auto clipped = clipped_builder.Build();
+
+  DisplayListBuilder unclipped_builder;
+  unclipped_builder.drawRect(SkRect::MakeWH(500, 500));
+  auto unclipped = unclipped_builder.Build();
+
+  for (auto calculator : AllCalculators()) {
+    EXPECT_LT(calculator->Compute(clipped.get()),
+              calculator->Compute(unclipped.get()));
+  }
+}
+
+TEST(DisplayListComplexity, BlurIsMoreExpensiveThanFill) {
+  DisplayListBuilder fill_builder;
+  fill_builder.drawPath(SkPath::Circle(100, 100, 100));
+  auto fill = fill_builder.Build();
+
+  DisplayListBuilder blur_builder;
+  blur_builder.setMaskBlurFilter(kNormal_SkBlurStyle, 10);
+  blur_builder.drawPath(SkPath::Circle(100, 100, 100));
+  auto blur = blur_builder.Build();
+
+  for (auto calculator : AllCalculators()) {
+    EXPECT_LT(calculator->Compute(fill.get()), calculator->Compute(blur.get()));
+  }
+}
+
+TEST(DisplayListComplexity, NestedListsAreIncluded) {
+  auto nested = MakeRects(10, 100);
+  DisplayListBuilder builder;
+  builder.drawDisplayList(nested);
+  builder.drawDisplayList(nested);
+  auto display_list = builder.Build();
+  for (auto calculator : AllCalculators()) {
+    EXPECT_GT(calculator->Compute(display_list.get()),
+              calculator->Compute(nested.get()));
+  }
+}
+
+TEST(DisplayListComplexity, ShouldBeCachedWeighsCostAgainstImage) {
+  for (auto calculator : AllCalculators()) {
+    const uint64_t pixels = 100 * 100;
+    const uint64_t image_cost = calculator->ComputeImageDrawCost(pixels);
+    // Never worth it if drawing the image is not cheaper.
+    EXPECT_FALSE(calculator->ShouldBeCached(image_cost, pixels, 1000));
+    // An expensive list pays off after a few accesses, but not right away.
+    const uint64_t cost = image_cost * 100;
+    EXPECT_FALSE(calculator->ShouldBeCached(cost, pixels, 0));
+    EXPECT_TRUE(calculator->ShouldBeCached(cost, pixels, 2));
+  }
+}
+
+}  // namespace testing
+}  // namespace flutter
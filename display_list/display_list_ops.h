@@ -9,6 +9,7 @@
 #include "flutter/display_list/display_list_dispatcher.h"
 #include "flutter/display_list/types.h"
 #include "flutter/fml/macros.h"
+#include "third_party/skia/include/private/SkTemplates.h"
 
 namespace flutter {
 
@@ -34,6 +35,46 @@ enum class DisplayListCompare {
   kEqual,
 };
 
+// The content hash of a DisplayList is built from the hashes of its ops,
+// which must be consistent with how the ops are compared above: ops that
+// are bulk compared hash their bytes and ops that do a deep compare hash
+// the values that they compare.
+static constexpr uint64_t kDisplayListHashSeed = 0xcbf29ce484222325;
+static constexpr uint64_t kDisplayListHashPrime = 0x100000001b3;
+
+// Mixes |bytes| bytes of |data| into |hash|. Both |data| and |bytes| must
+// be aligned to 4 bytes, which holds for the ops and their payloads.
+inline uint64_t DisplayListHashWords(uint64_t hash,
+                                     const void* data,
+                                     size_t bytes) {
+  FML_DCHECK((reinterpret_cast<uintptr_t>(data) & 3) == 0 && (bytes & 3) == 0);
+  const uint32_t* words = static_cast<const uint32_t*>(data);
+  for (size_t i = 0; i < bytes / sizeof(uint32_t); i++) {
+    hash = (hash ^ words[i]) * kDisplayListHashPrime;
+  }
+  return hash;
+}
+
+// Mixes the values of |path| that SkPath::operator== compares into |hash|.
+inline uint64_t DisplayListHashPath(uint64_t hash, const SkPath& path) {
+  const int point_count = path.countPoints();
+  const int verb_count = path.countVerbs();
+  const uint32_t header[] = {static_cast<uint32_t>(path.getFillType()),
+                             static_cast<uint32_t>(point_count),
+                             static_cast<uint32_t>(verb_count)};
+  hash = DisplayListHashWords(hash, header, sizeof(header));
+  SkAutoSTMalloc<32, SkPoint> points(point_count);
+  path.getPoints(points.get(), point_count);
+  hash = DisplayListHashWords(hash, points.get(),
+                              point_count * sizeof(SkPoint));
+  SkAutoSTMalloc<32, uint8_t> verbs(verb_count);
+  path.getVerbs(verbs.get(), verb_count);
+  for (int i = 0; i < verb_count; i++) {
+    hash = (hash ^ verbs[i]) * kDisplayListHashPrime;
+  }
+  return hash;
+}
+
 // "DLOpPackLabel" is just a label for the pack pragma so it can be popped
 // later.
 #pragma pack(push, DLOpPackLabel, 8)
@@ -55,6 +96,12 @@ struct DLOp {
   DisplayListCompare equals(const DLOp* other) const {
     return DisplayListCompare::kUseBulkCompare;
   }
+
+  // An Op that overrides equals() must also override hash() to only hash
+  // the values that it compares.
+  uint64_t hash(uint64_t seed) const {
+    return DisplayListHashWords(seed, this, size);
+  }
 };
 
 // 4 byte header + 4 byte payload packs into minimum 8 bytes
@@ -389,6 +436,12 @@ DEFINE_CLIP_SHAPE_OP(RRect, Difference)
       return is_aa == other->is_aa && path == other->path                \
                  ? DisplayListCompare::kEqual                            \
                  : DisplayListCompare::kNotEqual;                        \
+    }                                                                    \
+                                                                         \
+    uint64_t hash(uint64_t seed) const {                                 \
+      const uint32_t header[] = {static_cast<uint32_t>(type), is_aa};    \
+      seed = DisplayListHashWords(seed, header, sizeof(header));         \
+      return DisplayListHashPath(seed, path);                            \
     }                                                                    \
   };
 DEFINE_CLIP_PATH_OP(Intersect)
@@ -455,6 +508,12 @@ struct DrawPathOp final : DLOp {
     return path == other->path ? DisplayListCompare::kEqual
                                : DisplayListCompare::kNotEqual;
   }
+
+  uint64_t hash(uint64_t seed) const {
+    const uint32_t header[] = {static_cast<uint32_t>(type)};
+    seed = DisplayListHashWords(seed, header, sizeof(header));
+    return DisplayListHashPath(seed, path);
+  }
 };
 
 // The common data is a 4 byte header with an unused 4 bytes
@@ -841,6 +900,21 @@ struct DrawTextBlobOp final : DLOp {
     void dispatch(Dispatcher& dispatcher) const {                         \
       dispatcher.drawShadow(path, color, elevation, transparent_occluder, \
                             dpr);                                         \
+    }                                                                     \
+                                                                          \
+    DisplayListCompare equals(const Draw##name##Op* other) const {        \
+      return color == other->color && elevation == other->elevation &&    \
+                     dpr == other->dpr && path == other->path             \
+                 ? DisplayListCompare::kEqual                             \
+                 : DisplayListCompare::kNotEqual;                         \
+    }                                                                     \
+                                                                          \
+    uint64_t hash(uint64_t seed) const {                                  \
+      const uint32_t header[] = {static_cast<uint32_t>(type), color};     \
+      const SkScalar scalars[] = {elevation, dpr};                        \
+      seed = DisplayListHashWords(seed, header, sizeof(header));          \
+      seed = DisplayListHashWords(seed, scalars, sizeof(scalars));        \
+      return DisplayListHashPath(seed, path);                             \
     }                                                                     \
   };
 DEFINE_DRAW_SHADOW_OP(Shadow, false)
@@ -0,0 +1,558 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/display_list_optimizer.h"
+
+#include <algorithm>
+
+#include "third_party/skia/include/core/SkRSXform.h"
+#include "third_party/skia/include/core/SkTextBlob.h"
+#include "third_party/skia/include/core/SkVertices.h"
+
+namespace flutter {
+
+namespace {
+
+// Records |m| with the smallest transform op that represents it.
+void RecordTransform(DisplayListBuilder& builder, const SkM44& m) {
+  // clang-format off
+  if (                                  m.rc(0, 2) == 0 &&
+                                        m.rc(1, 2) == 0 &&
+      m.rc(2, 0) == 0 && m.rc(2, 1) == 0 && m.rc(2, 2) == 1 &&
+      m.rc(2, 3) == 0 &&
+      m.rc(3, 0) == 0 && m.rc(3, 1) == 0 && m.rc(3, 2) == 0 &&
+      m.rc(3, 3) == 1) {
+    if (m.rc(0, 0) == 1 && m.rc(0, 1) == 0 &&
+        m.rc(1, 0) == 0 && m.rc(1, 1) == 1) {
+      builder.translate(m.rc(0, 3), m.rc(1, 3));
+    } else if (m.rc(0, 1) == 0 && m.rc(0, 3) == 0 &&
+               m.rc(1, 0) == 0 && m.rc(1, 3) == 0) {
+      builder.scale(m.rc(0, 0), m.rc(1, 1));
+    } else {
+      builder.transform2DAffine(m.rc(0, 0), m.rc(0, 1), m.rc(0, 3),
+                                m.rc(1, 0), m.rc(1, 1), m.rc(1, 3));
+    }
+  } else {
+    builder.transformFullPerspective(
+        m.rc(0, 0), m.rc(0, 1), m.rc(0, 2), m.rc(0, 3),
+        m.rc(1, 0), m.rc(1, 1), m.rc(1, 2), m.rc(1, 3),
+        m.rc(2, 0), m.rc(2, 1), m.rc(2, 2), m.rc(2, 3),
+        m.rc(3, 0), m.rc(3, 1), m.rc(3, 2), m.rc(3, 3));
+  }
+  // clang-format on
+}
+
+}  // namespace
+
+sk_sp<DisplayList> DisplayListOptimizer::Optimize(
+    const sk_sp<DisplayList>& display_list) {
+  DisplayListOptimizer optimizer(display_list->bounds());
+  display_list->Dispatch(optimizer);
+  return optimizer.Build();
+}
+
+DisplayListOptimizer::DisplayListOptimizer(const SkRect& cull_rect)
+    : builder_(cull_rect) {}
+
+DisplayListOptimizer::~DisplayListOptimizer() = default;
+
+void DisplayListOptimizer::setAntiAlias(bool aa) {
+  SetAttribute(Attribute::kAntiAlias,
+               [aa](DisplayListBuilder& builder) { builder.setAntiAlias(aa); });
+}
+void DisplayListOptimizer::setDither(bool dither) {
+  SetAttribute(Attribute::kDither, [dither](DisplayListBuilder& builder) {
+    builder.setDither(dither);
+  });
+}
+void DisplayListOptimizer::setStyle(SkPaint::Style style) {
+  style_ = style;
+  SetAttribute(Attribute::kStyle, [style](DisplayListBuilder& builder) {
+    builder.setStyle(style);
+  });
+}
+void DisplayListOptimizer::setColor(SkColor color) {
+  SetAttribute(Attribute::kColor, [color](DisplayListBuilder& builder) {
+    builder.setColor(color);
+  });
+}
+void DisplayListOptimizer::setStrokeWidth(SkScalar width) {
+  stroke_width_ = width;
+  SetAttribute(Attribute::kStrokeWidth, [width](DisplayListBuilder& builder) {
+    builder.setStrokeWidth(width);
+  });
+}
+void DisplayListOptimizer::setStrokeMiter(SkScalar limit) {
+  stroke_miter_ = limit;
+  SetAttribute(Attribute::kStrokeMiter, [limit](DisplayListBuilder& builder) {
+    builder.setStrokeMiter(limit);
+  });
+}
+void DisplayListOptimizer::setStrokeCap(SkPaint::Cap cap) {
+  SetAttribute(Attribute::kStrokeCap, [cap](DisplayListBuilder& builder) {
+    builder.setStrokeCap(cap);
+  });
+}
+void DisplayListOptimizer::setStrokeJoin(SkPaint::Join join) {
+  stroke_join_ = join;
+  SetAttribute(Attribute::kStrokeJoin, [join](DisplayListBuilder& builder) {
+    builder.setStrokeJoin(join);
+  });
+}
+void DisplayListOptimizer::setShader(sk_sp<SkShader> shader) {
+  SetAttribute(Attribute::kShader, [shader](DisplayListBuilder& builder) {
+    builder.setShader(shader);
+  });
+}
+void DisplayListOptimizer::setColorFilter(sk_sp<SkColorFilter> filter) {
+  SetAttribute(Attribute::kColorFilter, [filter](DisplayListBuilder& builder) {
+    builder.setColorFilter(filter);
+  });
+}
+void DisplayListOptimizer::setInvertColors(bool invert) {
+  SetAttribute(Attribute::kInvertColors, [invert](DisplayListBuilder& builder) {
+    builder.setInvertColors(invert);
+  });
+}
+void DisplayListOptimizer::setBlendMode(SkBlendMode mode) {
+  SetAttribute(Attribute::kBlend, [mode](DisplayListBuilder& builder) {
+    builder.setBlendMode(mode);
+  });
+}
+void DisplayListOptimizer::setBlender(sk_sp<SkBlender> blender) {
+  SetAttribute(Attribute::kBlend, [blender](DisplayListBuilder& builder) {
+    builder.setBlender(blender);
+  });
+}
+void DisplayListOptimizer::setPathEffect(sk_sp<SkPathEffect> effect) {
+  has_path_effect_ = effect != nullptr;
+  SetAttribute(Attribute::kPathEffect, [effect](DisplayListBuilder& builder) {
+    builder.setPathEffect(effect);
+  });
+}
+void DisplayListOptimizer::setMaskFilter(sk_sp<SkMaskFilter> filter) {
+  has_mask_filter_ = filter != nullptr;
+  SetAttribute(Attribute::kMaskFilter, [filter](DisplayListBuilder& builder) {
+    builder.setMaskFilter(filter);
+  });
+}
+void DisplayListOptimizer::setMaskBlurFilter(SkBlurStyle style,
+                                             SkScalar sigma) {
+  has_mask_filter_ = true;
+  SetAttribute(Attribute::kMaskFilter,
+               [style, sigma](DisplayListBuilder& builder) {
+                 builder.setMaskBlurFilter(style, sigma);
+               });
+}
+void DisplayListOptimizer::setImageFilter(sk_sp<SkImageFilter> filter) {
+  has_image_filter_ = filter != nullptr;
+  SetAttribute(Attribute::kImageFilter, [filter](DisplayListBuilder& builder) {
+    builder.setImageFilter(filter);
+  });
+}
+
+void DisplayListOptimizer::save() {
+  SkMatrixDispatchHelper::save();
+  ClipBoundsDispatchHelper::save();
+  FlushTransforms();
+  save_stack_.push_back({true, deferred_ops_.size(), false});
+  deferred_ops_.emplace_back([](DisplayListBuilder& builder) {  //
+    builder.save();
+  });
+}
+void DisplayListOptimizer::saveLayer(const SkRect* bounds,
+                                     bool restore_with_paint) {
+  SkMatrixDispatchHelper::save();
+  ClipBoundsDispatchHelper::save();
+  Flush([bounds, restore_with_paint](DisplayListBuilder& builder) {
+    builder.saveLayer(bounds, restore_with_paint);
+  });
+  // The layer of an image filter is not limited to the clip, as the filter
+  // may move content into it.
+  const bool filtered_layer = restore_with_paint && has_image_filter_;
+  if (filtered_layer) {
+    filtered_layer_depth_++;
+  }
+  save_stack_.push_back({false, 0, filtered_layer});
+}
+void DisplayListOptimizer::restore() {
+  if (save_stack_.empty()) {
+    return;
+  }
+  SkMatrixDispatchHelper::restore();
+  ClipBoundsDispatchHelper::restore();
+  const SaveInfo info = save_stack_.back();
+  save_stack_.pop_back();
+  if (info.filtered_layer) {
+    filtered_layer_depth_--;
+  }
+  // Nothing was rendered since the transforms and clips that are still
+  // pending, so they can be dropped.
+  pending_transforms_.clear();
+  pending_matrix_.setIdentity();
+  if (info.deferred) {
+    deferred_ops_.resize(info.deferred_index);
+  } else {
+    deferred_ops_.clear();
+    builder_.restore();
+  }
+}
+
+void DisplayListOptimizer::translate(SkScalar tx, SkScalar ty) {
+  SkMatrixDispatchHelper::translate(tx, ty);
+  AddTransform(SkM44::Translate(tx, ty), [tx, ty](DisplayListBuilder& builder) {
+    builder.translate(tx, ty);
+  });
+}
+void DisplayListOptimizer::scale(SkScalar sx, SkScalar sy) {
+  SkMatrixDispatchHelper::scale(sx, sy);
+  AddTransform(SkM44::Scale(sx, sy), [sx, sy](DisplayListBuilder& builder) {
+    builder.scale(sx, sy);
+  });
+}
+void DisplayListOptimizer::rotate(SkScalar degrees) {
+  SkMatrixDispatchHelper::rotate(degrees);
+  AddTransform(SkM44(SkMatrix::RotateDeg(degrees)),
+               [degrees](DisplayListBuilder& builder) {
+                 builder.rotate(degrees);
+               });
+}
+void DisplayListOptimizer::skew(SkScalar sx, SkScalar sy) {
+  SkMatrixDispatchHelper::skew(sx, sy);
+  AddTransform(SkM44(SkMatrix::Skew(sx, sy)),
+               [sx, sy](DisplayListBuilder& builder) {
+                 builder.skew(sx, sy);
+               });
+}
+
+// clang-format off
+
+// 2x3 2D affine subset of a 4x4 transform in row major order
+void DisplayListOptimizer::transform2DAffine(
+    SkScalar mxx, SkScalar mxy, SkScalar mxt,
+    SkScalar myx, SkScalar myy, SkScalar myt) {
+  SkMatrixDispatchHelper::transform2DAffine(mxx, mxy, mxt,
+                                            myx, myy, myt);
+  AddTransform({
+                   mxx, mxy,  0 , mxt,
+                   myx, myy,  0 , myt,
+                    0 ,  0 ,  1 ,  0 ,
+                    0 ,  0 ,  0 ,  1 ,
+               },
+               [=](DisplayListBuilder& builder) {
+                 builder.transform2DAffine(mxx, mxy, mxt,
+                                           myx, myy, myt);
+               });
+}
+// full 4x4 transform in row major order
+void DisplayListOptimizer::transformFullPerspective(
+    SkScalar mxx, SkScalar mxy, SkScalar mxz, SkScalar mxt,
+    SkScalar myx, SkScalar myy, SkScalar myz, SkScalar myt,
+    SkScalar mzx, SkScalar mzy, SkScalar mzz, SkScalar mzt,
+    SkScalar mwx, SkScalar mwy, SkScalar mwz, SkScalar mwt) {
+  SkMatrixDispatchHelper::transformFullPerspective(mxx, mxy, mxz, mxt,
+                                                   myx, myy, myz, myt,
+                                                   mzx, mzy, mzz, mzt,
+                                                   mwx, mwy, mwz, mwt);
+  AddTransform({
+                   mxx, mxy, mxz, mxt,
+                   myx, myy, myz, myt,
+                   mzx, mzy, mzz, mzt,
+                   mwx, mwy, mwz, mwt,
+               },
+               [=](DisplayListBuilder& builder) {
+                 builder.transformFullPerspective(mxx, mxy, mxz, mxt,
+                                                  myx, myy, myz, myt,
+                                                  mzx, mzy, mzz, mzt,
+                                                  mwx, mwy, mwz, mwt);
+               });
+}
+
+// clang-format on
+
+void DisplayListOptimizer::clipRect(const SkRect& rect,
+                                    SkClipOp clip_op,
+                                    bool is_aa) {
+  ClipBoundsDispatchHelper::clipRect(rect, clip_op, is_aa);
+  FlushTransforms();
+  deferred_ops_.emplace_back(
+      [rect, clip_op, is_aa](DisplayListBuilder& builder) {
+        builder.clipRect(rect, clip_op, is_aa);
+      });
+}
+void DisplayListOptimizer::clipRRect(const SkRRect& rrect,
+                                     SkClipOp clip_op,
+                                     bool is_aa) {
+  ClipBoundsDispatchHelper::clipRRect(rrect, clip_op, is_aa);
+  FlushTransforms();
+  deferred_ops_.emplace_back(
+      [rrect, clip_op, is_aa](DisplayListBuilder& builder) {
+        builder.clipRRect(rrect, clip_op, is_aa);
+      });
+}
+void DisplayListOptimizer::clipPath(const SkPath& path,
+                                    SkClipOp clip_op,
+                                    bool is_aa) {
+  ClipBoundsDispatchHelper::clipPath(path, clip_op, is_aa);
+  FlushTransforms();
+  deferred_ops_.emplace_back(
+      [path, clip_op, is_aa](DisplayListBuilder& builder) {
+        builder.clipPath(path, clip_op, is_aa);
+      });
+}
+
+void DisplayListOptimizer::drawColor(SkColor color, SkBlendMode mode) {
+  DrawUnbounded([color, mode](DisplayListBuilder& builder) {
+    builder.drawColor(color, mode);
+  });
+}
+void DisplayListOptimizer::drawPaint() {
+  DrawUnbounded([](DisplayListBuilder& builder) { builder.drawPaint(); });
+}
+void DisplayListOptimizer::drawLine(const SkPoint& p0, const SkPoint& p1) {
+  // Lines are always stroked.
+  Draw(SkRect::MakeLTRB(p0.fX, p0.fY, p1.fX, p1.fY), true,
+       [&](DisplayListBuilder& builder) { builder.drawLine(p0, p1); });
+}
+void DisplayListOptimizer::drawRect(const SkRect& rect) {
+  Draw(rect, IsStroked(),
+       [&](DisplayListBuilder& builder) { builder.drawRect(rect); });
+}
+void DisplayListOptimizer::drawOval(const SkRect& bounds) {
+  Draw(bounds, IsStroked(),
+       [&](DisplayListBuilder& builder) { builder.drawOval(bounds); });
+}
+void DisplayListOptimizer::drawCircle(const SkPoint& center, SkScalar radius) {
+  Draw(SkRect::MakeLTRB(center.fX - radius, center.fY - radius,
+                        center.fX + radius, center.fY + radius),
+       IsStroked(), [&](DisplayListBuilder& builder) {
+         builder.drawCircle(center, radius);
+       });
+}
+void DisplayListOptimizer::drawRRect(const SkRRect& rrect) {
+  Draw(rrect.getBounds(), IsStroked(),
+       [&](DisplayListBuilder& builder) { builder.drawRRect(rrect); });
+}
+void DisplayListOptimizer::drawDRRect(const SkRRect& outer,
+                                      const SkRRect& inner) {
+  Draw(outer.getBounds(), IsStroked(), [&](DisplayListBuilder& builder) {
+    builder.drawDRRect(outer, inner);
+  });
+}
+void DisplayListOptimizer::drawPath(const SkPath& path) {
+  auto op = [&](DisplayListBuilder& builder) { builder.drawPath(path); };
+  if (path.isInverseFillType()) {
+    DrawUnbounded(op);
+  } else {
+    Draw(path.getBounds(), IsStroked(), op);
+  }
+}
+void DisplayListOptimizer::drawArc(const SkRect& oval_bounds,
+                                   SkScalar start_degrees,
+                                   SkScalar sweep_degrees,
+                                   bool use_center) {
+  Draw(oval_bounds, IsStroked(), [&](DisplayListBuilder& builder) {
+    builder.drawArc(oval_bounds, start_degrees, sweep_degrees, use_center);
+  });
+}
+void DisplayListOptimizer::drawPoints(SkCanvas::PointMode mode,
+                                      uint32_t count,
+                                      const SkPoint points[]) {
+  SkRect bounds;
+  bounds.setBounds(points, count);
+  // Points are always stroked.
+  Draw(bounds, true, [&](DisplayListBuilder& builder) {
+    builder.drawPoints(mode, count, points);
+  });
+}
+void DisplayListOptimizer::drawVertices(const sk_sp<SkVertices> vertices,
+                                        SkBlendMode mode) {
+  Draw(vertices->bounds(), false, [&](DisplayListBuilder& builder) {
+    builder.drawVertices(vertices, mode);
+  });
+}
+void DisplayListOptimizer::drawImage(const sk_sp<SkImage> image,
+                                     const SkPoint point,
+                                     const SkSamplingOptions& sampling,
+                                     bool render_with_attributes) {
+  Draw(SkRect::MakeXYWH(point.fX, point.fY, image->width(), image->height()),
+       false, [&](DisplayListBuilder& builder) {
+         builder.drawImage(image, point, sampling, render_with_attributes);
+       });
+}
+void DisplayListOptimizer::drawImageRect(
+    const sk_sp<SkImage> image,
+    const SkRect& src,
+    const SkRect& dst,
+    const SkSamplingOptions& sampling,
+    bool render_with_attributes,
+    SkCanvas::SrcRectConstraint constraint) {
+  Draw(dst, false, [&](DisplayListBuilder& builder) {
+    builder.drawImageRect(image, src, dst, sampling, render_with_attributes,
+                          constraint);
+  });
+}
+void DisplayListOptimizer::drawImageNine(const sk_sp<SkImage> image,
+                                         const SkIRect& center,
+                                         const SkRect& dst,
+                                         SkFilterMode filter,
+                                         bool render_with_attributes) {
+  Draw(dst, false, [&](DisplayListBuilder& builder) {
+    builder.drawImageNine(image, center, dst, filter, render_with_attributes);
+  });
+}
+void DisplayListOptimizer::drawImageLattice(const sk_sp<SkImage> image,
+                                            const SkCanvas::Lattice& lattice,
+                                            const SkRect& dst,
+                                            SkFilterMode filter,
+                                            bool render_with_attributes) {
+  Draw(dst, false, [&](DisplayListBuilder& builder) {
+    builder.drawImageLattice(image, lattice, dst, filter,
+                             render_with_attributes);
+  });
+}
+void DisplayListOptimizer::drawAtlas(const sk_sp<SkImage> atlas,
+                                     const SkRSXform xform[],
+                                     const SkRect tex[],
+                                     const SkColor colors[],
+                                     int count,
+                                     SkBlendMode mode,
+                                     const SkSamplingOptions& sampling,
+                                     const SkRect* cull_rect,
+                                     bool render_with_attributes) {
+  auto op = [&](DisplayListBuilder& builder) {
+    builder.drawAtlas(atlas, xform, tex, colors, count, mode, sampling,
+                      cull_rect, render_with_attributes);
+  };
+  if (cull_rect) {
+    Draw(*cull_rect, false, op);
+  } else {
+    DrawUnbounded(op);
+  }
+}
+void DisplayListOptimizer::drawPicture(const sk_sp<SkPicture> picture,
+                                       const SkMatrix* matrix,
+                                       bool render_with_attributes) {
+  // The cull rect of a picture is only a hint.
+  DrawUnbounded([&](DisplayListBuilder& builder) {
+    builder.drawPicture(picture, matrix, render_with_attributes);
+  });
+}
+void DisplayListOptimizer::drawDisplayList(
+    const sk_sp<DisplayList> display_list) {
+  Draw(display_list->bounds(), false, [&](DisplayListBuilder& builder) {
+    builder.drawDisplayList(display_list);
+  });
+}
+void DisplayListOptimizer::drawTextBlob(const sk_sp<SkTextBlob> blob,
+                                        SkScalar x,
+                                        SkScalar y) {
+  Draw(blob->bounds().makeOffset(x, y), IsStroked(),
+       [&](DisplayListBuilder& builder) { builder.drawTextBlob(blob, x, y); });
+}
+void DisplayListOptimizer::drawShadow(const SkPath& path,
+                                      const SkColor color,
+                                      const SkScalar elevation,
+                                      bool transparent_occluder,
+                                      SkScalar dpr) {
+  DrawUnbounded([&](DisplayListBuilder& builder) {
+    builder.drawShadow(path, color, elevation, transparent_occluder, dpr);
+  });
+}
+
+sk_sp<DisplayList> DisplayListOptimizer::Build() {
+  // Whatever is still pending is not followed by any rendering operation.
+  deferred_ops_.clear();
+  pending_transforms_.clear();
+  return builder_.Build();
+}
+
+void DisplayListOptimizer::SetAttribute(Attribute attribute, Op op) {
+  pending_attributes_[static_cast<size_t>(attribute)] = std::move(op);
+}
+
+void DisplayListOptimizer::AddTransform(const SkM44& transform, Op op) {
+  pending_matrix_.preConcat(transform);
+  pending_transforms_.push_back(std::move(op));
+  if (matrix().hasPerspective()) {
+    has_perspective_ = true;
+  }
+}
+
+void DisplayListOptimizer::FlushTransforms() {
+  if (pending_transforms_.empty()) {
+    return;
+  }
+  if (pending_transforms_.size() == 1) {
+    deferred_ops_.push_back(std::move(pending_transforms_.front()));
+  } else {
+    deferred_ops_.emplace_back(
+        [transform = pending_matrix_](DisplayListBuilder& builder) {
+          RecordTransform(builder, transform);
+        });
+  }
+  pending_transforms_.clear();
+  pending_matrix_.setIdentity();
+}
+
+void DisplayListOptimizer::Flush(const Op& op) {
+  FlushTransforms();
+  for (auto& attribute : pending_attributes_) {
+    if (attribute) {
+      attribute(builder_);
+      attribute = nullptr;
+    }
+  }
+  for (const auto& deferred_op : deferred_ops_) {
+    deferred_op(builder_);
+  }
+  deferred_ops_.clear();
+  // Saves are recorded in order, so only the innermost ones can still be
+  // deferred.
+  for (auto it = save_stack_.rbegin(); it != save_stack_.rend(); ++it) {
+    if (!it->deferred) {
+      break;
+    }
+    it->deferred = false;
+  }
+  op(builder_);
+}
+
+void DisplayListOptimizer::Draw(const SkRect& bounds,
+                                bool is_stroked,
+                                const Op& op) {
+  if (CanCull() && bounds.isFinite()) {
+    SkRect local_bounds = bounds.makeSorted();
+    if (is_stroked) {
+      // Miter joins and square caps extend past half of the stroke width.
+      SkScalar pad = stroke_width_ * 0.5f;
+      if (stroke_join_ == SkPaint::kMiter_Join) {
+        pad *= std::max(stroke_miter_, SK_ScalarSqrt2);
+      } else {
+        pad *= SK_ScalarSqrt2;
+      }
+      local_bounds.outset(pad, pad);
+    }
+    SkRect device_bounds = matrix().mapRect(local_bounds);
+    device_bounds.outset(1, 1);
+    if (!device_bounds.intersects(clip_bounds())) {
+      return;
+    }
+  }
+  Flush(op);
+}
+
+void DisplayListOptimizer::DrawUnbounded(const Op& op) {
+  if (CanCull() && clip_bounds().isEmpty()) {
+    return;
+  }
+  Flush(op);
+}
+
+bool DisplayListOptimizer::CanCull() const {
+  return has_clip() && !has_perspective_ && filtered_layer_depth_ == 0 &&
+         !has_path_effect_ && !has_mask_filter_ && !has_image_filter_;
+}
+
+}  // namespace flutter
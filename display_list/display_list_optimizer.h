@@ -0,0 +1,261 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_DISPLAY_LIST_DISPLAY_LIST_OPTIMIZER_H_
+#define FLUTTER_DISPLAY_LIST_DISPLAY_LIST_OPTIMIZER_H_
+
+#include <array>
+#include <functional>
+#include <vector>
+
+#include "flutter/display_list/display_list.h"
+#include "flutter/display_list/display_list_builder.h"
+#include "flutter/display_list/display_list_utils.h"
+#include "flutter/fml/macros.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Rewrites a DisplayList into an equivalent one that is cheaper
+///             to dispatch. Dispatch a DisplayList to an instance and then
+///             call |Build|, or use the static |Optimize| method.
+///
+///             The following rewrites are performed:
+///
+///             - Attribute values are only recorded right before the
+///               rendering operation that uses them, so values that are
+///               overwritten before being used are dropped. Values that
+///               are equal to the current ones are then elided by the
+///               |DisplayListBuilder|.
+///             - Consecutive transforms are folded into a single transform.
+///             - Transforms and clips that are followed by no rendering
+///               operation before the enclosing restore are dropped, along
+///               with |save|/|restore| pairs that end up empty.
+///             - Rendering operations whose bounds lie entirely outside of
+///               the clip are dropped.
+///
+///             Culling works in the coordinate space of the DisplayList and
+///             pads the bounds of every operation by 1 unit to account for
+///             anti-aliasing and clip rounding, which assumes that the list
+///             is not rendered scaled down. Operations whose bounds cannot
+///             be determined precisely (e.g. with a mask filter, path effect
+///             or image filter, under a perspective transform, or within a
+///             layer that applies an image filter) are never culled.
+///
+class DisplayListOptimizer final : public virtual Dispatcher,
+                                   public virtual SkMatrixDispatchHelper,
+                                   public virtual ClipBoundsDispatchHelper {
+ public:
+  //----------------------------------------------------------------------------
+  /// @brief      Returns an optimized copy of |display_list|.
+  ///
+  static sk_sp<DisplayList> Optimize(const sk_sp<DisplayList>& display_list);
+
+  //----------------------------------------------------------------------------
+  /// @param[in]  cull_rect  The cull rect of the optimized DisplayList, which
+  ///                        is typically the bounds of the one that will be
+  ///                        dispatched to this optimizer.
+  ///
+  explicit DisplayListOptimizer(const SkRect& cull_rect);
+
+  ~DisplayListOptimizer();
+
+  void setAntiAlias(bool aa) override;
+  void setDither(bool dither) override;
+  void setStyle(SkPaint::Style style) override;
+  void setColor(SkColor color) override;
+  void setStrokeWidth(SkScalar width) override;
+  void setStrokeMiter(SkScalar limit) override;
+  void setStrokeCap(SkPaint::Cap cap) override;
+  void setStrokeJoin(SkPaint::Join join) override;
+  void setShader(sk_sp<SkShader> shader) override;
+  void setColorFilter(sk_sp<SkColorFilter> filter) override;
+  void setInvertColors(bool invert) override;
+  void setBlendMode(SkBlendMode mode) override;
+  void setBlender(sk_sp<SkBlender> blender) override;
+  void setPathEffect(sk_sp<SkPathEffect> effect) override;
+  void setMaskFilter(sk_sp<SkMaskFilter> filter) override;
+  void setMaskBlurFilter(SkBlurStyle style, SkScalar sigma) override;
+  void setImageFilter(sk_sp<SkImageFilter> filter) override;
+
+  void save() override;
+  void saveLayer(const SkRect* bounds, bool restore_with_paint) override;
+  void restore() override;
+
+  void translate(SkScalar tx, SkScalar ty) override;
+  void scale(SkScalar sx, SkScalar sy) override;
+  void rotate(SkScalar degrees) override;
+  void skew(SkScalar sx, SkScalar sy) override;
+
+  // clang-format off
+
+  // 2x3 2D affine subset of a 4x4 transform in row major order
+  void transform2DAffine(SkScalar mxx, SkScalar mxy, SkScalar mxt,
+                         SkScalar myx, SkScalar myy, SkScalar myt) override;
+  // full 4x4 transform in row major order
+  void transformFullPerspective(
+      SkScalar mxx, SkScalar mxy, SkScalar mxz, SkScalar mxt,
+      SkScalar myx, SkScalar myy, SkScalar myz, SkScalar myt,
+      SkScalar mzx, SkScalar mzy, SkScalar mzz, SkScalar mzt,
+      SkScalar mwx, SkScalar mwy, SkScalar mwz, SkScalar mwt) override;
+
+  // clang-format on
+
+  void clipRect(const SkRect& rect, SkClipOp clip_op, bool is_aa) override;
+  void clipRRect(const SkRRect& rrect, SkClipOp clip_op, bool is_aa) override;
+  void clipPath(const SkPath& path, SkClipOp clip_op, bool is_aa) override;
+
+  void drawColor(SkColor color, SkBlendMode mode) override;
+  void drawPaint() override;
+  void drawLine(const SkPoint& p0, const SkPoint& p1) override;
+  void drawRect(const SkRect& rect) override;
+  void drawOval(const SkRect& bounds) override;
+  void drawCircle(const SkPoint& center, SkScalar radius) override;
+  void drawRRect(const SkRRect& rrect) override;
+  void drawDRRect(const SkRRect& outer, const SkRRect& inner) override;
+  void drawPath(const SkPath& path) override;
+  void drawArc(const SkRect& oval_bounds,
+               SkScalar start_degrees,
+               SkScalar sweep_degrees,
+               bool use_center) override;
+  void drawPoints(SkCanvas::PointMode mode,
+                  uint32_t count,
+                  const SkPoint points[]) override;
+  void drawVertices(const sk_sp<SkVertices> vertices,
+                    SkBlendMode mode) override;
+  void drawImage(const sk_sp<SkImage> image,
+                 const SkPoint point,
+                 const SkSamplingOptions& sampling,
+                 bool render_with_attributes) override;
+  void drawImageRect(const sk_sp<SkImage> image,
+                     const SkRect& src,
+                     const SkRect& dst,
+                     const SkSamplingOptions& sampling,
+                     bool render_with_attributes,
+                     SkCanvas::SrcRectConstraint constraint) override;
+  void drawImageNine(const sk_sp<SkImage> image,
+                     const SkIRect& center,
+                     const SkRect& dst,
+                     SkFilterMode filter,
+                     bool render_with_attributes) override;
+  void drawImageLattice(const sk_sp<SkImage> image,
+                        const SkCanvas::Lattice& lattice,
+                        const SkRect& dst,
+                        SkFilterMode filter,
+                        bool render_with_attributes) override;
+  void drawAtlas(const sk_sp<SkImage> atlas,
+                 const SkRSXform xform[],
+                 const SkRect tex[],
+                 const SkColor colors[],
+                 int count,
+                 SkBlendMode mode,
+                 const SkSamplingOptions& sampling,
+                 const SkRect* cull_rect,
+                 bool render_with_attributes) override;
+  void drawPicture(const sk_sp<SkPicture> picture,
+                   const SkMatrix* matrix,
+                   bool render_with_attributes) override;
+  void drawDisplayList(const sk_sp<DisplayList> display_list) override;
+  void drawTextBlob(const sk_sp<SkTextBlob> blob,
+                    SkScalar x,
+                    SkScalar y) override;
+  void drawShadow(const SkPath& path,
+                  const SkColor color,
+                  const SkScalar elevation,
+                  bool transparent_occluder,
+                  SkScalar dpr) override;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns the optimized DisplayList. The optimizer should not
+  ///             be used afterwards.
+  ///
+  sk_sp<DisplayList> Build();
+
+ private:
+  using Op = std::function<void(DisplayListBuilder&)>;
+
+  // The attributes that are recorded lazily, each of which is set by a
+  // different group of methods.
+  enum class Attribute {
+    kAntiAlias,
+    kDither,
+    kStyle,
+    kColor,
+    kStrokeWidth,
+    kStrokeMiter,
+    kStrokeCap,
+    kStrokeJoin,
+    kShader,
+    kColorFilter,
+    kInvertColors,
+    kBlend,
+    kPathEffect,
+    kMaskFilter,
+    kImageFilter,
+    kCount,
+  };
+
+  // The state of a |save| or |saveLayer|.
+  struct SaveInfo {
+    // Whether the save has not been recorded yet, in which case it is the
+    // entry at |deferred_index| in |deferred_ops_|.
+    bool deferred;
+    size_t deferred_index;
+    // Whether the save is a layer that applies an image filter.
+    bool filtered_layer;
+  };
+
+  DisplayListBuilder builder_;
+
+  // The attribute setters that have not been recorded yet.
+  std::array<Op, static_cast<size_t>(Attribute::kCount)> pending_attributes_;
+
+  // The saves, transforms and clips that have not been recorded yet.
+  std::vector<Op> deferred_ops_;
+
+  // The run of transforms that has not been added to |deferred_ops_| yet,
+  // and the matrix that they concatenate to.
+  std::vector<Op> pending_transforms_;
+  SkM44 pending_matrix_;
+
+  std::vector<SaveInfo> save_stack_;
+  int filtered_layer_depth_ = 0;
+  bool has_perspective_ = false;
+
+  // The attributes that determine the bounds of the rendering operations.
+  SkPaint::Style style_ = SkPaint::kFill_Style;
+  SkScalar stroke_width_ = 0;
+  SkScalar stroke_miter_ = 4;
+  SkPaint::Join stroke_join_ = SkPaint::kMiter_Join;
+  bool has_path_effect_ = false;
+  bool has_mask_filter_ = false;
+  bool has_image_filter_ = false;
+
+  void SetAttribute(Attribute attribute, Op op);
+
+  void AddTransform(const SkM44& matrix, Op op);
+
+  void FlushTransforms();
+
+  // Records the pending attributes and all deferred operations, which is
+  // needed before |op| can be recorded.
+  void Flush(const Op& op);
+
+  // Records |op| unless |bounds|, padded for the stroke if |is_stroked|, lie
+  // entirely outside of the clip.
+  void Draw(const SkRect& bounds, bool is_stroked, const Op& op);
+
+  // Records |op| unless the clip is empty.
+  void DrawUnbounded(const Op& op);
+
+  bool CanCull() const;
+
+  bool IsStroked() const { return style_ != SkPaint::kFill_Style; }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DisplayListOptimizer);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_DISPLAY_LIST_DISPLAY_LIST_OPTIMIZER_H_
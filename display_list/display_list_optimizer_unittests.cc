@@ -0,0 +1,206 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/display_list_optimizer.h"
+
+#include "flutter/display_list/display_list.h"
+#include "flutter/display_list/display_list_builder.h"
+#include "flutter/testing/testing.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/effects/SkImageFilters.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+constexpr int kRenderSize = 100;
+
+SkBitmap Render(const sk_sp<DisplayList>& display_list) {
+  auto surface = SkSurface::MakeRasterN32Premul(kRenderSize, kRenderSize);
+  surface->getCanvas()->clear(SK_ColorTRANSPARENT);
+  display_list->RenderTo(surface->getCanvas());
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(kRenderSize, kRenderSize);
+  EXPECT_TRUE(surface->readPixels(bitmap, 0, 0));
+  return bitmap;
+}
+
+// Optimizes |display_list|, checks that the result renders the same pixels
+// and returns it.
+sk_sp<DisplayList> OptimizeAndCompare(const sk_sp<DisplayList>& display_list) {
+  auto optimized = DisplayListOptimizer::Optimize(display_list);
+  EXPECT_LE(optimized->op_count(), display_list->op_count());
+  SkBitmap expected = Render(display_list);
+  SkBitmap actual = Render(optimized);
+  for (int y = 0; y < kRenderSize; y++) {
+    for (int x = 0; x < kRenderSize; x++) {
+      if (expected.getColor(x, y) != actual.getColor(x, y)) {
+        ADD_FAILURE() << "Pixel mismatch at " << x << ", " << y;
+        return optimized;
+      }
+    }
+  }
+  return optimized;
+}
+
+}  // namespace
+
+TEST(DisplayListOptimizer, DropsEmptySaveRestore) {
+  DisplayListBuilder builder;
+  builder.save();
+  builder.translate(10, 10);
+  builder.clipRect({0, 0, 20, 20}, SkClipOp::kIntersect, false);
+  builder.restore();
+  builder.drawRect({10, 10, 30, 30});
+  auto display_list = builder.Build();
+  ASSERT_EQ(display_list->op_count(), 5);
+
+  auto optimized = OptimizeAndCompare(display_list);
+  EXPECT_EQ(optimized->op_count(), 1);
+}
+
+TEST(DisplayListOptimizer, KeepsSaveRestoreAroundRenderedOps) {
+  DisplayListBuilder builder;
+  builder.save();
+  builder.translate(10, 10);
+  builder.drawRect({0, 0, 20, 20});
+  builder.restore();
+  builder.drawRect({50, 50, 70, 70});
+  auto display_list = builder.Build();
+
+  auto optimized = OptimizeAndCompare(display_list);
+  EXPECT_EQ(optimized->op_count(), display_list->op_count());
+}
+
+TEST(DisplayListOptimizer, DropsOverwrittenAttributes) {
+  DisplayListBuilder builder;
+  builder.setColor(SK_ColorRED);
+  builder.setStrokeWidth(5);
+  builder.setColor(SK_ColorBLUE);
+  builder.drawRect({10, 10, 30, 30});
+  builder.setColor(SK_ColorGREEN);
+  auto display_list = builder.Build();
+  ASSERT_EQ(display_list->op_count(), 5);
+
+  auto optimized = OptimizeAndCompare(display_list);
+  // The stroke width is unused, but it may apply to the rect, so only the
+  // red and green colors can be dropped.
+  EXPECT_EQ(optimized->op_count(), 3);
+}
+
+TEST(DisplayListOptimizer, FoldsConsecutiveTransforms) {
+  DisplayListBuilder builder;
+  builder.translate(10, 10);
+  builder.scale(2, 2);
+  builder.translate(5, 5);
+  builder.drawRect({0, 0, 10, 10});
+  auto display_list = builder.Build();
+  ASSERT_EQ(display_list->op_count(), 4);
+
+  auto optimized = OptimizeAndCompare(display_list);
+  EXPECT_EQ(optimized->op_count(), 2);
+}
+
+TEST(DisplayListOptimizer, DropsTransformsThatCancelOut) {
+  DisplayListBuilder builder;
+  builder.translate(10, 10);
+  builder.translate(-10, -10);
+  builder.drawRect({0, 0, 10, 10});
+  auto display_list = builder.Build();
+  ASSERT_EQ(display_list->op_count(), 3);
+
+  auto optimized = OptimizeAndCompare(display_list);
+  EXPECT_EQ(optimized->op_count(), 1);
+}
+
+TEST(DisplayListOptimizer, CullsOpsOutsideOfClip) {
+  DisplayListBuilder builder;
+  builder.clipRect({0, 0, 50, 50}, SkClipOp::kIntersect, true);
+  builder.drawRect({10, 10, 40, 40});
+  builder.drawRect({60, 60, 90, 90});
+  builder.drawCircle({80, 20}, 10);
+  builder.translate(50, 50);
+  builder.drawOval({10, 10, 40, 40});
+  auto display_list = builder.Build();
+  ASSERT_EQ(display_list->op_count(), 6);
+
+  auto optimized = OptimizeAndCompare(display_list);
+  EXPECT_EQ(optimized->op_count(), 2);
+}
+
+TEST(DisplayListOptimizer, CullsEverythingWithinEmptyClip) {
+  DisplayListBuilder builder;
+  builder.drawRect({0, 0, 10, 10});
+  builder.save();
+  builder.clipRect({0, 0, 50, 50}, SkClipOp::kIntersect, false);
+  builder.clipRect({60, 60, 90, 90}, SkClipOp::kIntersect, false);
+  builder.drawPaint();
+  builder.drawColor(SK_ColorRED, SkBlendMode::kSrcOver);
+  builder.restore();
+  auto display_list = builder.Build();
+
+  auto optimized = OptimizeAndCompare(display_list);
+  EXPECT_EQ(optimized->op_count(), 1);
+}
+
+TEST(DisplayListOptimizer, KeepsStrokesThatReachIntoClip) {
+  DisplayListBuilder builder;
+  builder.clipRect({0, 0, 50, 50}, SkClipOp::kIntersect, false);
+  builder.setStyle(SkPaint::kStroke_Style);
+  builder.setStrokeWidth(20);
+  builder.drawRect({55, 10, 80, 40});
+  builder.drawLine({10, 55}, {40, 55});
+  auto display_list = builder.Build();
+
+  auto optimized = OptimizeAndCompare(display_list);
+  EXPECT_EQ(optimized->op_count(), display_list->op_count());
+}
+
+TEST(DisplayListOptimizer, DoesNotCullWithinFilteredLayer) {
+  DisplayListBuilder builder;
+  builder.clipRect({0, 0, 50, 50}, SkClipOp::kIntersect, false);
+  builder.setImageFilter(SkImageFilters::Offset(-30, -30, nullptr));
+  builder.saveLayer(nullptr, true);
+  builder.setImageFilter(nullptr);
+  builder.drawRect({60, 60, 70, 70});
+  builder.restore();
+  auto display_list = builder.Build();
+
+  auto optimized = OptimizeAndCompare(display_list);
+  EXPECT_EQ(optimized->op_count(), display_list->op_count());
+}
+
+TEST(DisplayListOptimizer, PreservesNestedState) {
+  DisplayListBuilder builder;
+  builder.setAntiAlias(true);
+  builder.setColor(SK_ColorBLUE);
+  builder.save();
+  builder.translate(20, 20);
+  builder.rotate(30);
+  builder.save();
+  builder.clipRect({0, 0, 10, 10}, SkClipOp::kIntersect, true);
+  builder.restore();
+  builder.clipRRect(SkRRect::MakeRectXY({-20, -20, 40, 40}, 5, 5),
+                    SkClipOp::kIntersect, true);
+  builder.drawCircle({10, 10}, 25);
+  builder.setColor(SK_ColorRED);
+  builder.drawRect({200, 200, 300, 300});
+  builder.restore();
+  builder.setColor(SK_ColorGREEN);
+  builder.saveLayer(nullptr, false);
+  builder.drawRect({60, 60, 90, 90});
+  builder.save();
+  builder.scale(2, 2);
+  builder.restore();
+  builder.restore();
+  auto display_list = builder.Build();
+
+  auto optimized = OptimizeAndCompare(display_list);
+  EXPECT_LT(optimized->op_count(), display_list->op_count());
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -0,0 +1,186 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/display_list_path_cache.h"
+
+#include "flutter/fml/hash_combine.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/core/SkShader.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+
+// Translations are rounded to this many steps per pixel.
+static constexpr int kSubpixelSteps = 4;
+
+// No mask may take more than this fraction of the budget, so that a large
+// path does not evict all of the others.
+static constexpr size_t kMaxMaskFraction = 4;
+
+bool DisplayListPathCache::Key::operator==(const Key& other) const {
+  return generation_id == other.generation_id &&
+         fill_type == other.fill_type && anti_alias == other.anti_alias &&
+         scale_x == other.scale_x && skew_x == other.skew_x &&
+         skew_y == other.skew_y && scale_y == other.scale_y &&
+         subpixel_x == other.subpixel_x && subpixel_y == other.subpixel_y;
+}
+
+size_t DisplayListPathCache::KeyHash::operator()(const Key& key) const {
+  return fml::HashCombine(key.generation_id, static_cast<int>(key.fill_type),
+                          key.anti_alias, key.scale_x, key.skew_x, key.skew_y,
+                          key.scale_y, key.subpixel_x, key.subpixel_y);
+}
+
+DisplayListPathCache::DisplayListPathCache(size_t max_bytes)
+    : max_bytes_(max_bytes) {}
+
+DisplayListPathCache::~DisplayListPathCache() = default;
+
+// Splits |translation| into a whole pixel and a fraction in subpixel steps.
+static uint8_t SplitTranslation(SkScalar translation, SkScalar* whole) {
+  *whole = SkScalarFloorToScalar(translation);
+  int steps = SkScalarRoundToInt((translation - *whole) * kSubpixelSteps);
+  if (steps == kSubpixelSteps) {
+    *whole += 1;
+    steps = 0;
+  }
+  return static_cast<uint8_t>(steps);
+}
+
+bool DisplayListPathCache::DrawPath(SkCanvas* canvas,
+                                    const SkPath& path,
+                                    const SkPaint& paint) {
+  if (!CanCache(canvas, path, paint)) {
+    return false;
+  }
+
+  const SkMatrix matrix = canvas->getTotalMatrix();
+  SkScalar whole_x;
+  SkScalar whole_y;
+  Key key = {path.getGenerationID(),
+             path.getFillType(),
+             paint.isAntiAlias(),
+             matrix.getScaleX(),
+             matrix.getSkewX(),
+             matrix.getSkewY(),
+             matrix.getScaleY(),
+             SplitTranslation(matrix.getTranslateX(), &whole_x),
+             SplitTranslation(matrix.getTranslateY(), &whole_y)};
+
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    // Paths that are drawn only once are not worth a mask.
+    entries_.push_front({key, nullptr, SkIPoint::Make(0, 0)});
+    index_[key] = entries_.begin();
+    EvictToBudget();
+    return false;
+  }
+  entries_.splice(entries_.begin(), entries_, it->second);
+  Entry& entry = entries_.front();
+
+  if (!entry.mask) {
+    SkMatrix mask_matrix = matrix;
+    mask_matrix.setTranslateX(SkIntToScalar(key.subpixel_x) / kSubpixelSteps);
+    mask_matrix.setTranslateY(SkIntToScalar(key.subpixel_y) / kSubpixelSteps);
+    SkIRect mask_bounds;
+    mask_matrix.mapRect(path.getBounds()).roundOut(&mask_bounds);
+    // Leave room for anti-aliasing.
+    mask_bounds.outset(1, 1);
+    const size_t mask_bytes = static_cast<size_t>(mask_bounds.width()) *
+                              static_cast<size_t>(mask_bounds.height());
+    if (mask_bytes > max_bytes_ / kMaxMaskFraction) {
+      return false;
+    }
+    entry.mask = RasterizeMask(path, mask_matrix, key.anti_alias, mask_bounds);
+    if (!entry.mask) {
+      return false;
+    }
+    entry.mask_origin = SkIPoint::Make(mask_bounds.fLeft, mask_bounds.fTop);
+    byte_size_ += entry.mask->imageInfo().computeMinByteSize();
+    EvictToBudget();
+  }
+
+  hit_count_++;
+  SkPaint mask_paint = paint;
+  if (paint.getShader()) {
+    // Keep the shader where it was before the matrix is reset.
+    mask_paint.setShader(paint.refShader()->makeWithLocalMatrix(matrix));
+  }
+  SkAutoCanvasRestore auto_restore(canvas, true);
+  canvas->resetMatrix();
+  // Alpha only images are drawn as a coverage mask for the paint.
+  canvas->drawImage(entry.mask, whole_x + entry.mask_origin.x(),
+                    whole_y + entry.mask_origin.y(), SkSamplingOptions(),
+                    &mask_paint);
+  return true;
+}
+
+bool DisplayListPathCache::CanCache(SkCanvas* canvas,
+                                    const SkPath& path,
+                                    const SkPaint& paint) {
+  if (canvas->recordingContext() ||
+      canvas->imageInfo().colorType() == kUnknown_SkColorType) {
+    // GPU canvases keep their own geometry, and canvases that record or
+    // forward draws must not get a mask for a single resolution.
+    return false;
+  }
+  if (path.isVolatile() || path.isInverseFillType() || !path.isFinite() ||
+      path.isEmpty()) {
+    return false;
+  }
+  if (path.isRect(nullptr) || path.isOval(nullptr) || path.isRRect(nullptr)) {
+    // Skia draws these analytically, which is cheaper than a mask.
+    return false;
+  }
+  if (paint.getStyle() != SkPaint::kFill_Style || paint.getPathEffect() ||
+      paint.getMaskFilter() || paint.getImageFilter()) {
+    // The mask only holds the coverage of the filled path, and image
+    // filters would be applied in device space.
+    return false;
+  }
+  return !canvas->getTotalMatrix().hasPerspective();
+}
+
+sk_sp<SkImage> DisplayListPathCache::RasterizeMask(
+    const SkPath& path,
+    const SkMatrix& matrix,
+    bool anti_alias,
+    const SkIRect& mask_bounds) {
+  TRACE_EVENT0("flutter", "DisplayListPathCache::RasterizeMask");
+  sk_sp<SkSurface> surface = SkSurface::MakeRaster(
+      SkImageInfo::MakeA8(mask_bounds.width(), mask_bounds.height()));
+  if (!surface) {
+    return nullptr;
+  }
+  SkCanvas* canvas = surface->getCanvas();
+  canvas->clear(SK_ColorTRANSPARENT);
+  canvas->translate(-mask_bounds.fLeft, -mask_bounds.fTop);
+  canvas->concat(matrix);
+  SkPaint paint;
+  paint.setAntiAlias(anti_alias);
+  canvas->drawPath(path, paint);
+  return surface->makeImageSnapshot();
+}
+
+void DisplayListPathCache::EvictToBudget() {
+  // The most recently used entry is kept even if it is over the budget on
+  // its own, as it is about to be drawn.
+  while ((byte_size_ > max_bytes_ || entries_.size() > kMaxEntries) &&
+         entries_.size() > 1) {
+    const Entry& entry = entries_.back();
+    if (entry.mask) {
+      byte_size_ -= entry.mask->imageInfo().computeMinByteSize();
+    }
+    index_.erase(entry.key);
+    entries_.pop_back();
+  }
+}
+
+void DisplayListPathCache::Clear() {
+  entries_.clear();
+  index_.clear();
+  byte_size_ = 0;
+}
+
+}  // namespace flutter
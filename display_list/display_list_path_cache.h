@@ -0,0 +1,136 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_DISPLAY_LIST_DISPLAY_LIST_PATH_CACHE_H_
+#define FLUTTER_DISPLAY_LIST_DISPLAY_LIST_PATH_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkPaint.h"
+#include "third_party/skia/include/core/SkPath.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Caches the coverage masks of filled paths that are drawn onto
+///             raster canvases, so that paths that are drawn again in later
+///             frames, e.g. by a PhysicalShapeLayer or by a retained
+///             DisplayList, are not scan converted again.
+///
+///             Entries are keyed by the generation ID and fill type of the
+///             path and by the class of the matrix that it is drawn with:
+///             the scale, skew and the fraction of the translation, rounded
+///             to a quarter of a pixel, so that a path keeps its entry while
+///             it moves by whole pixels.
+///             The mask of an entry is only rasterized the second time that
+///             it is drawn, and the least recently used entries are evicted
+///             to stay within a byte budget.
+///
+///             GPU canvases are left alone, as Skia already keeps the
+///             tessellations of non-volatile paths. Volatile paths, which
+///             the VolatilePathTracker keeps volatile while they are still
+///             changing, are not cached either.
+///
+///             This class is not thread safe.
+///
+class DisplayListPathCache {
+ public:
+  static constexpr size_t kDefaultMaxBytes = 4 * 1024 * 1024;
+
+  // The most entries that are tracked, including those that have no mask
+  // yet because they were drawn only once.
+  static constexpr size_t kMaxEntries = 1024;
+
+  explicit DisplayListPathCache(size_t max_bytes = kDefaultMaxBytes);
+
+  ~DisplayListPathCache();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Draws |path| with |paint| onto |canvas| from the mask of
+  ///             its entry, if it can be cached and has a mask.
+  ///
+  /// @return     Whether the path was drawn. If not, the caller must draw
+  ///             it.
+  ///
+  bool DrawPath(SkCanvas* canvas, const SkPath& path, const SkPaint& paint);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Drops all of the entries.
+  ///
+  void Clear();
+
+  size_t max_bytes() const { return max_bytes_; }
+
+  /// The bytes of the masks of all of the entries.
+  size_t GetByteSize() const { return byte_size_; }
+
+  size_t GetEntryCount() const { return entries_.size(); }
+
+  /// The number of paths drawn from a mask since the cache was created.
+  size_t hit_count() const { return hit_count_; }
+
+ private:
+  struct Key {
+    uint32_t generation_id;
+    // Paths that share their points, and so their generation ID, may still
+    // be filled with different rules.
+    SkPathFillType fill_type;
+    bool anti_alias;
+    SkScalar scale_x;
+    SkScalar skew_x;
+    SkScalar skew_y;
+    SkScalar scale_y;
+    // The fraction of the translation, in quarters of a pixel.
+    uint8_t subpixel_x;
+    uint8_t subpixel_y;
+
+    bool operator==(const Key& other) const;
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+
+  struct Entry {
+    Key key;
+    sk_sp<SkImage> mask;
+    // The bounds of the mask relative to the whole pixel that the path is
+    // translated to.
+    SkIPoint mask_origin;
+  };
+
+  using EntryList = std::list<Entry>;
+
+  // Returns whether drawing |path| with |paint| onto |canvas| can be cached.
+  static bool CanCache(SkCanvas* canvas,
+                       const SkPath& path,
+                       const SkPaint& paint);
+
+  // Rasterizes the coverage of |path| within |mask_bounds| with |matrix|,
+  // which has no translation other than the rounded fraction of the key.
+  static sk_sp<SkImage> RasterizeMask(const SkPath& path,
+                                      const SkMatrix& matrix,
+                                      bool anti_alias,
+                                      const SkIRect& mask_bounds);
+
+  void EvictToBudget();
+
+  const size_t max_bytes_;
+  // The least recently used entry is the last one.
+  EntryList entries_;
+  std::unordered_map<Key, EntryList::iterator, KeyHash> index_;
+  size_t byte_size_ = 0;
+  size_t hit_count_ = 0;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DisplayListPathCache);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_DISPLAY_LIST_DISPLAY_LIST_PATH_CACHE_H_
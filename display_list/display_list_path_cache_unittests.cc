@@ -0,0 +1,200 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/display_list_path_cache.h"
+
+#include <cmath>
+#include <vector>
+
+#include "flutter/display_list/display_list.h"
+#include "flutter/display_list/display_list_builder.h"
+#include "flutter/testing/testing.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+constexpr int kRenderSize = 100;
+
+// A five pointed star, which is neither convex nor a simple shape.
+SkPath MakeStar(SkScalar x, SkScalar y, SkScalar radius) {
+  SkPath path;
+  for (int i = 0; i < 5; i++) {
+    SkScalar angle = SK_ScalarPI * (0.5f + i * 0.8f);
+    SkPoint point = SkPoint::Make(x + radius * std::cos(angle),
+                                  y - radius * std::sin(angle));
+    if (i == 0) {
+      path.moveTo(point);
+    } else {
+      path.lineTo(point);
+    }
+  }
+  path.close();
+  return path;
+}
+
+SkBitmap Render(const sk_sp<DisplayList>& display_list,
+                DisplayListPathCache* path_cache) {
+  auto surface = SkSurface::MakeRasterN32Premul(kRenderSize, kRenderSize);
+  surface->getCanvas()->clear(SK_ColorTRANSPARENT);
+  surface->getCanvas()->translate(10.25, 5.5);
+  display_list->RenderTo(surface->getCanvas(), SK_Scalar1, path_cache);
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(kRenderSize, kRenderSize);
+  EXPECT_TRUE(surface->readPixels(bitmap, 0, 0));
+  return bitmap;
+}
+
+}  // namespace
+
+TEST(DisplayListPathCache, MasksRepeatedPathsWithTheSamePixels) {
+  DisplayListBuilder builder;
+  builder.setAntiAlias(true);
+  builder.setColor(SK_ColorBLUE);
+  builder.drawPath(MakeStar(40, 40, 30));
+  auto display_list = builder.Build();
+  SkBitmap expected = Render(display_list, nullptr);
+
+  DisplayListPathCache path_cache;
+  Render(display_list, &path_cache);
+  EXPECT_EQ(path_cache.GetEntryCount(), 1u);
+  EXPECT_EQ(path_cache.GetByteSize(), 0u);
+  EXPECT_EQ(path_cache.hit_count(), 0u);
+
+  SkBitmap actual = Render(display_list, &path_cache);
+  EXPECT_EQ(path_cache.GetEntryCount(), 1u);
+  EXPECT_GT(path_cache.GetByteSize(), 0u);
+  EXPECT_EQ(path_cache.hit_count(), 1u);
+
+  // The translation is a whole number of quarter pixels, so the mask covers
+  // the same pixels as the path, up to rounding of the blend.
+  for (int y = 0; y < kRenderSize; y++) {
+    for (int x = 0; x < kRenderSize; x++) {
+      SkColor a = expected.getColor(x, y);
+      SkColor b = actual.getColor(x, y);
+      ASSERT_LE(std::abs(static_cast<int>(SkColorGetA(a) - SkColorGetA(b))), 1)
+          << "at " << x << ", " << y;
+      ASSERT_LE(std::abs(static_cast<int>(SkColorGetB(a) - SkColorGetB(b))), 1)
+          << "at " << x << ", " << y;
+    }
+  }
+}
+
+TEST(DisplayListPathCache, LeavesUncacheableDrawsAlone) {
+  DisplayListPathCache path_cache;
+  SkPath star = MakeStar(40, 40, 30);
+  SkPaint paint;
+  auto surface = SkSurface::MakeRasterN32Premul(kRenderSize, kRenderSize);
+  SkCanvas* canvas = surface->getCanvas();
+
+  SkPath volatile_star = star;
+  volatile_star.setIsVolatile(true);
+  SkPath rect = SkPath().addRect(SkRect::MakeWH(10, 10));
+  SkPaint stroke;
+  stroke.setStyle(SkPaint::kStroke_Style);
+  for (int i = 0; i < 2; i++) {
+    EXPECT_FALSE(path_cache.DrawPath(canvas, volatile_star, paint));
+    EXPECT_FALSE(path_cache.DrawPath(canvas, rect, paint));
+    EXPECT_FALSE(path_cache.DrawPath(canvas, star, stroke));
+  }
+  EXPECT_EQ(path_cache.GetEntryCount(), 0u);
+
+  // Recorded draws must stay resolution independent.
+  SkPictureRecorder recorder;
+  SkCanvas* recording_canvas =
+      recorder.beginRecording(kRenderSize, kRenderSize);
+  for (int i = 0; i < 2; i++) {
+    EXPECT_FALSE(path_cache.DrawPath(recording_canvas, star, paint));
+  }
+  EXPECT_EQ(path_cache.GetEntryCount(), 0u);
+}
+
+TEST(DisplayListPathCache, EvictsLeastRecentlyUsedMasks) {
+  // Room for four masks of the stars below, but not for five.
+  DisplayListPathCache path_cache(2000);
+  SkPaint paint;
+  paint.setAntiAlias(true);
+  auto surface = SkSurface::MakeRasterN32Premul(kRenderSize, kRenderSize);
+  SkCanvas* canvas = surface->getCanvas();
+
+  std::vector<SkPath> stars;
+  for (int i = 0; i < 5; i++) {
+    stars.push_back(MakeStar(10 + i * 20, 10, 10));
+    EXPECT_FALSE(path_cache.DrawPath(canvas, stars.back(), paint));
+    EXPECT_TRUE(path_cache.DrawPath(canvas, stars.back(), paint));
+    EXPECT_LE(path_cache.GetByteSize(), path_cache.max_bytes());
+  }
+  EXPECT_EQ(path_cache.GetEntryCount(), 4u);
+
+  // The first star was evicted, the last one was not.
+  EXPECT_TRUE(path_cache.DrawPath(canvas, stars.back(), paint));
+  EXPECT_FALSE(path_cache.DrawPath(canvas, stars.front(), paint));
+
+  path_cache.Clear();
+  EXPECT_EQ(path_cache.GetEntryCount(), 0u);
+  EXPECT_EQ(path_cache.GetByteSize(), 0u);
+}
+
+// A path that is drawn again with a new generation ID after it changed does
+// not use the mask of its old contents.
+TEST(DisplayListPathCache, ChangedPathsMissTheCache) {
+  DisplayListPathCache path_cache;
+  SkPaint paint;
+  auto surface = SkSurface::MakeRasterN32Premul(kRenderSize, kRenderSize);
+  SkPath path = MakeStar(40, 40, 30);
+  EXPECT_FALSE(path_cache.DrawPath(surface->getCanvas(), path, paint));
+  EXPECT_TRUE(path_cache.DrawPath(surface->getCanvas(), path, paint));
+
+  path.lineTo(0, 0);
+  EXPECT_FALSE(path_cache.DrawPath(surface->getCanvas(), path, paint));
+
+  // Moving by whole pixels keeps the entry, moving by a fraction does not.
+  surface->getCanvas()->translate(3, 0);
+  EXPECT_TRUE(path_cache.DrawPath(surface->getCanvas(), path, paint));
+  surface->getCanvas()->translate(0.5, 0);
+  EXPECT_FALSE(path_cache.DrawPath(surface->getCanvas(), path, paint));
+}
+
+// Copies of a path share its points, and so its generation ID, even when they
+// are filled with another rule. The center of the star is inside it with the
+// winding rule, but outside of it with the even-odd rule.
+TEST(DisplayListPathCache, KeepsMasksOfFillTypesApart) {
+  SkPath winding = MakeStar(40, 40, 30);
+  SkPath even_odd = winding;
+  even_odd.setFillType(SkPathFillType::kEvenOdd);
+  ASSERT_EQ(winding.getGenerationID(), even_odd.getGenerationID());
+
+  DisplayListPathCache path_cache;
+  SkPaint paint;
+  paint.setColor(SK_ColorBLUE);
+  auto surface = SkSurface::MakeRasterN32Premul(kRenderSize, kRenderSize);
+  SkCanvas* canvas = surface->getCanvas();
+  for (int i = 0; i < 2; i++) {
+    path_cache.DrawPath(canvas, winding, paint);
+  }
+  EXPECT_EQ(path_cache.GetEntryCount(), 1u);
+
+  for (int i = 0; i < 2; i++) {
+    canvas->clear(SK_ColorTRANSPARENT);
+    if (!path_cache.DrawPath(canvas, even_odd, paint)) {
+      canvas->drawPath(even_odd, paint);
+    }
+  }
+  EXPECT_EQ(path_cache.GetEntryCount(), 2u);
+  EXPECT_EQ(path_cache.hit_count(), 2u);
+
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(kRenderSize, kRenderSize);
+  ASSERT_TRUE(surface->readPixels(bitmap, 0, 0));
+  EXPECT_EQ(bitmap.getColor(40, 40), SK_ColorTRANSPARENT);
+  // The tip of the top point is inside with either rule.
+  EXPECT_EQ(bitmap.getColor(40, 15), SK_ColorBLUE);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -772,6 +772,7 @@ TEST(DisplayList, SingleOpDisplayListsRecapturedAreEqual) {
       ASSERT_EQ(copy->op_count(true), dl->op_count(true)) << desc;
       ASSERT_EQ(copy->bytes(true), dl->bytes(true)) << desc;
       ASSERT_EQ(copy->bounds(), dl->bounds()) << desc;
+      ASSERT_EQ(copy->content_hash(), dl->content_hash()) << desc;
       ASSERT_TRUE(copy->Equals(*dl)) << desc;
       ASSERT_TRUE(dl->Equals(*copy)) << desc;
     }
@@ -838,11 +839,13 @@ TEST(DisplayList, SingleOpDisplayListsCompareToEachOther) {
           ASSERT_EQ(listA->op_count(true), listB->op_count(true)) << desc;
           ASSERT_EQ(listA->bytes(true), listB->bytes(true)) << desc;
           ASSERT_EQ(listA->bounds(), listB->bounds()) << desc;
+          ASSERT_EQ(listA->content_hash(), listB->content_hash()) << desc;
           ASSERT_TRUE(listA->Equals(*listB)) << desc;
           ASSERT_TRUE(listB->Equals(*listA)) << desc;
         } else {
           // No assertion on op/byte counts or bounds
           // they may or may not be equal between variants
+          ASSERT_NE(listA->content_hash(), listB->content_hash()) << desc;
           ASSERT_FALSE(listA->Equals(*listB)) << desc;
           ASSERT_FALSE(listB->Equals(*listA)) << desc;
         }
@@ -851,6 +854,29 @@ TEST(DisplayList, SingleOpDisplayListsCompareToEachOther) {
   }
 }
 
+TEST(DisplayList, ContentHashMatchesSeparatelyConstructedPaths) {
+  auto build = [](const SkPath& path) {
+    DisplayListBuilder builder;
+    builder.setColor(SK_ColorRED);
+    builder.drawPath(path);
+    builder.clipPath(path, SkClipOp::kIntersect, true);
+    builder.drawShadow(path, SK_ColorBLACK, 4, false, 1);
+    builder.drawRect(TestBounds);
+    return builder.Build();
+  };
+  auto make_path = [](SkScalar x) {
+    return SkPath::Polygon({{0, 0}, {x, 10}, {10, 0}, {0, 10}}, true);
+  };
+  sk_sp<DisplayList> dl1 = build(make_path(10));
+  sk_sp<DisplayList> dl2 = build(make_path(10));
+  sk_sp<DisplayList> dl3 = build(make_path(20));
+  ASSERT_NE(dl1->unique_id(), dl2->unique_id());
+  ASSERT_EQ(dl1->content_hash(), dl2->content_hash());
+  ASSERT_TRUE(dl1->Equals(*dl2));
+  ASSERT_NE(dl1->content_hash(), dl3->content_hash());
+  ASSERT_FALSE(dl1->Equals(*dl3));
+}
+
 TEST(DisplayList, FullRotationsAreNop) {
   DisplayListBuilder builder;
   builder.rotate(0);
@@ -1580,5 +1606,58 @@ TEST(DisplayList, SaveLayerBoundsSnapshotsImageFilter) {
   EXPECT_EQ(bounds, SkRect::MakeLTRB(50, 50, 100, 100));
 }
 
+TEST(DisplayList, DrawPointsBoundsMatchBoundsOfExtremePoints) {
+  std::vector<SkPoint> points;
+  SkPoint extremes[] = {{SK_ScalarMax, SK_ScalarMax},
+                        {SK_ScalarMin, SK_ScalarMin}};
+  for (int i = 0; i < 100; i++) {
+    SkPoint point = SkPoint::Make((i * 37) % 101, (i * 53) % 89 + 0.5f);
+    extremes[0].set(std::min(extremes[0].fX, point.fX),
+                    std::min(extremes[0].fY, point.fY));
+    extremes[1].set(std::max(extremes[1].fX, point.fX),
+                    std::max(extremes[1].fY, point.fY));
+    points.push_back(point);
+  }
+  DisplayListBuilder builder;
+  builder.drawPoints(SkCanvas::kPoints_PointMode, points.size(),
+                     points.data());
+  DisplayListBuilder extremes_builder;
+  extremes_builder.drawPoints(SkCanvas::kPoints_PointMode, 2, extremes);
+  EXPECT_EQ(builder.Build()->bounds(), extremes_builder.Build()->bounds());
+}
+
+TEST(DisplayList, DrawPointsBoundsIgnoreNonFinitePoints) {
+  SkPoint points[] = {{10, 20}, {30, 40}, {SK_ScalarNaN, 5}, {50, 15}};
+  DisplayListBuilder builder;
+  builder.drawPoints(SkCanvas::kPolygon_PointMode, 4, points);
+  SkPoint finite_points[] = {{10, 20}, {30, 40}, {50, 15}};
+  DisplayListBuilder finite_builder;
+  finite_builder.drawPoints(SkCanvas::kPolygon_PointMode, 3, finite_points);
+  EXPECT_EQ(builder.Build()->bounds(), finite_builder.Build()->bounds());
+}
+
+TEST(DisplayList, DrawAtlasBoundsMatchBoundsOfEachSprite) {
+  // More sprites than are gathered in one batch.
+  std::vector<SkRSXform> xforms;
+  std::vector<SkRect> texs;
+  for (int i = 0; i < 70; i++) {
+    xforms.push_back(SkRSXform::MakeFromRadians(1.0f + i % 3, i * 0.1f,
+                                                (i * 13) % 50, (i * 7) % 60,
+                                                5, 5));
+    texs.push_back(SkRect::MakeLTRB(0, 0, 10 + i % 5, 10 + i % 7));
+  }
+  DisplayListBuilder all_builder;
+  all_builder.drawAtlas(TestImage1, xforms.data(), texs.data(), nullptr,
+                        xforms.size(), SkBlendMode::kSrcOver,
+                        DisplayList::NearestSampling, nullptr, false);
+  DisplayListBuilder each_builder;
+  for (size_t i = 0; i < xforms.size(); i++) {
+    each_builder.drawAtlas(TestImage1, &xforms[i], &texs[i], nullptr, 1,
+                           SkBlendMode::kSrcOver, DisplayList::NearestSampling,
+                           nullptr, false);
+  }
+  EXPECT_EQ(all_builder.Build()->bounds(), each_builder.Build()->bounds());
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -4,6 +4,7 @@
 
 #include "flutter/display_list/display_list_utils.h"
 
+#include <algorithm>
 #include <math.h>
 #include <type_traits>
 
@@ -400,9 +401,7 @@ void DisplayListBoundsCalculator::drawPoints(SkCanvas::PointMode mode,
                                              const SkPoint pts[]) {
   if (count > 0) {
     BoundsAccumulator ptBounds;
-    for (size_t i = 0; i < count; i++) {
-      ptBounds.accumulate(pts[i]);
-    }
+    ptBounds.accumulate(pts, count);
     SkRect point_bounds = ptBounds.bounds();
     switch (mode) {
       case SkCanvas::kPoints_PointMode:
@@ -474,14 +473,18 @@ void DisplayListBoundsCalculator::drawAtlas(const sk_sp<SkImage> atlas,
                                             const SkSamplingOptions& sampling,
                                             const SkRect* cullRect,
                                             bool render_with_attributes) {
-  SkPoint quad[4];
+  // The corners of the sprites are gathered in batches so that their bounds
+  // can be reduced together.
+  constexpr int kSpritesPerBatch = 32;
+  SkPoint quads[kSpritesPerBatch * 4];
   BoundsAccumulator atlasBounds;
-  for (int i = 0; i < count; i++) {
-    const SkRect& src = tex[i];
-    xform[i].toQuad(src.width(), src.height(), quad);
-    for (int j = 0; j < 4; j++) {
-      atlasBounds.accumulate(quad[j]);
+  for (int i = 0; i < count; i += kSpritesPerBatch) {
+    const int batch_count = std::min(count - i, kSpritesPerBatch);
+    for (int j = 0; j < batch_count; j++) {
+      const SkRect& src = tex[i + j];
+      xform[i + j].toQuad(src.width(), src.height(), &quads[j * 4]);
     }
+    atlasBounds.accumulate(quads, batch_count * 4);
   }
   if (atlasBounds.is_not_empty()) {
     DisplayListAttributeFlags flags = render_with_attributes  //
@@ -273,6 +273,19 @@ class BoundsAccumulator {
       accumulate(r.fRight, r.fBottom);
     }
   }
+  void accumulate(const SkPoint points[], int count) {
+    SkRect r;
+    // SkRect::setBoundsCheck reduces the points with SIMD min/max, but it
+    // gives up on non-finite points, which the per point loop tolerates.
+    if (count > 0 && r.setBoundsCheck(points, count)) {
+      accumulate(r.fLeft, r.fTop);
+      accumulate(r.fRight, r.fBottom);
+    } else {
+      for (int i = 0; i < count; i++) {
+        accumulate(points[i]);
+      }
+    }
+  }
 
   bool is_empty() const { return min_x_ >= max_x_ || min_y_ >= max_y_; }
   bool is_not_empty() const { return min_x_ < max_x_ && min_y_ < max_y_; }
@@ -53,6 +53,7 @@ void CompositorContext::BeginFrame(ScopedFrame& frame,
   if (enable_instrumentation) {
     frame_count_.Increment();
     raster_time_.Start();
+    layer_cost_tracker_.BeginFrame();
   }
 }
 
@@ -60,6 +61,7 @@ void CompositorContext::EndFrame(ScopedFrame& frame,
                                  bool enable_instrumentation) {
   if (enable_instrumentation) {
     raster_time_.Stop();
+    layer_cost_tracker_.EndFrame();
   }
 }
 
@@ -153,11 +155,13 @@ RasterStatus CompositorContext::ScopedFrame::Raster(
 void CompositorContext::OnGrContextCreated() {
   texture_registry_.OnGrContextCreated();
   raster_cache_.Clear();
+  path_cache_.Clear();
 }
 
 void CompositorContext::OnGrContextDestroyed() {
   texture_registry_.OnGrContextDestroyed();
   raster_cache_.Clear();
+  path_cache_.Clear();
 }
 
 }  // namespace flutter
@@ -12,6 +12,8 @@
 #include "flutter/flow/diff_context.h"
 #include "flutter/flow/embedded_views.h"
 #include "flutter/flow/instrumentation.h"
+#include "flutter/display_list/display_list_path_cache.h"
+#include "flutter/flow/layer_cost_tracker.h"
 #include "flutter/flow/raster_cache.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/raster_thread_merger.h"
@@ -166,12 +168,18 @@ class CompositorContext {
 
   Stopwatch& ui_time() { return ui_time_; }
 
+  LayerCostTracker& layer_cost_tracker() { return layer_cost_tracker_; }
+
+  DisplayListPathCache& path_cache() { return path_cache_; }
+
  private:
   RasterCache raster_cache_;
   TextureRegistry texture_registry_;
   Counter frame_count_;
   Stopwatch raster_time_;
   Stopwatch ui_time_;
+  LayerCostTracker layer_cost_tracker_;
+  DisplayListPathCache path_cache_;
 
   void BeginFrame(ScopedFrame& frame, bool enable_instrumentation);
 
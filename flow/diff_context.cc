@@ -170,6 +170,10 @@ void DiffContext::AddReadbackRegion(const SkIRect& rect) {
   readbacks_.push_back(std::move(readback));
 }
 
+bool DiffContext::IntersectsDamage(const SkIRect& rect) const {
+  return damage_.intersects(SkRect::Make(rect));
+}
+
 PaintRegion DiffContext::CurrentSubtreeRegion() const {
   bool has_readback = std::any_of(
       readbacks_.begin(), readbacks_.end(),
@@ -123,6 +123,12 @@ class DiffContext {
   // Readback rect is in screen coordinates.
   void AddReadbackRegion(const SkIRect& rect);
 
+  // Returns true if the rect (in screen coordinates) intersects the damage
+  // accumulated so far. Layers are diffed in paint order, so for a layer that
+  // reads back from the surface this tells whether anything painted beneath
+  // it within the rect has changed since the previous frame.
+  bool IntersectsDamage(const SkIRect& rect) const;
+
   // Returns the paint region for current subtree; Each rect in paint region is
   // in screen coordinates; Once a layer accumulates the paint regions of its
   // children, this PaintRegion value can be associated with the current layer
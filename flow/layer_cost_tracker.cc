@@ -0,0 +1,156 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layer_cost_tracker.h"
+
+#include <algorithm>
+
+#include "flutter/flow/layers/layer.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+LayerCostTracker::LayerCostTracker() = default;
+
+LayerCostTracker::~LayerCostTracker() = default;
+
+bool LayerCostTracker::BeginFrame() {
+  FML_DCHECK(!tracking_);
+  tracking_ = enabled_ || next_frame_requested_;
+  next_frame_requested_ = false;
+  frame_costs_.clear();
+  frame_cost_index_.clear();
+  return tracking_;
+}
+
+void LayerCostTracker::EndFrame() {
+  if (!tracking_) {
+    return;
+  }
+  FML_DCHECK(active_layers_.empty());
+  tracking_ = false;
+  tracked_frame_count_++;
+  for (const auto& frame_cost : frame_costs_) {
+    Aggregate& aggregate = aggregates_[frame_cost.layer_id];
+    aggregate.total.preroll_time =
+        aggregate.total.preroll_time + frame_cost.cost.preroll_time;
+    aggregate.total.paint_time =
+        aggregate.total.paint_time + frame_cost.cost.paint_time;
+    aggregate.total.save_layer_count += frame_cost.cost.save_layer_count;
+    aggregate.max_total_time =
+        std::max(aggregate.max_total_time, frame_cost.cost.total_time());
+    aggregate.frame_count++;
+    aggregate.last_frame = tracked_frame_count_;
+  }
+  for (auto it = aggregates_.begin(); it != aggregates_.end();) {
+    if (tracked_frame_count_ - it->second.last_frame >= kMaxUnseenFrames) {
+      it = aggregates_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  last_frame_costs_.swap(frame_costs_);
+  TraceTopLayersToTimeline();
+}
+
+LayerCostTracker::ScopedPreroll::ScopedPreroll(LayerCostTracker* tracker,
+                                               const Layer* layer)
+    : tracker_(tracker && tracker->tracking_ ? tracker : nullptr) {
+  if (tracker_) {
+    tracker_->Begin(layer);
+  }
+}
+
+LayerCostTracker::ScopedPreroll::~ScopedPreroll() {
+  if (tracker_) {
+    tracker_->End(Phase::kPreroll);
+  }
+}
+
+LayerCostTracker::ScopedPaint::ScopedPaint(LayerCostTracker* tracker,
+                                           const Layer* layer,
+                                           const SkCanvas* canvas)
+    : tracker_(tracker && tracker->tracking_ ? tracker : nullptr) {
+  if (tracker_) {
+    tracker_->Begin(layer);
+    SkRect bounds = canvas->getTotalMatrix().mapRect(layer->paint_bounds());
+    size_t index = tracker_->active_layers_.back().index;
+    tracker_->frame_costs_[index].device_bounds.join(bounds);
+  }
+}
+
+LayerCostTracker::ScopedPaint::~ScopedPaint() {
+  if (tracker_) {
+    tracker_->End(Phase::kPaint);
+  }
+}
+
+void LayerCostTracker::Begin(const Layer* layer) {
+  const uint64_t layer_id = layer->original_layer_id();
+  auto inserted = frame_cost_index_.emplace(layer_id, frame_costs_.size());
+  if (inserted.second) {
+    frame_costs_.push_back({layer_id, {}});
+  }
+  active_layers_.push_back(
+      {inserted.first->second, fml::TimePoint::Now(), fml::TimeDelta::Zero()});
+}
+
+void LayerCostTracker::End(Phase phase) {
+  FML_DCHECK(!active_layers_.empty());
+  const ActiveLayer& active = active_layers_.back();
+  const fml::TimeDelta elapsed = fml::TimePoint::Now() - active.start;
+  const fml::TimeDelta self_time = elapsed - active.children_time;
+  Cost& cost = frame_costs_[active.index].cost;
+  if (phase == Phase::kPreroll) {
+    cost.preroll_time = cost.preroll_time + self_time;
+  } else {
+    cost.paint_time = cost.paint_time + self_time;
+  }
+  active_layers_.pop_back();
+  if (!active_layers_.empty()) {
+    ActiveLayer& parent = active_layers_.back();
+    parent.children_time = parent.children_time + elapsed;
+  }
+}
+
+void LayerCostTracker::AddSaveLayer() {
+  if (tracking_ && !active_layers_.empty()) {
+    frame_costs_[active_layers_.back().index].cost.save_layer_count++;
+  }
+}
+
+std::vector<LayerCostTracker::FrameCost> LayerCostTracker::GetTopLayers(
+    size_t count) const {
+  std::vector<FrameCost> top_layers = last_frame_costs_;
+  count = std::min(count, top_layers.size());
+  std::partial_sort(top_layers.begin(), top_layers.begin() + count,
+                    top_layers.end(),
+                    [](const FrameCost& a, const FrameCost& b) {
+                      return a.cost.total_time() > b.cost.total_time();
+                    });
+  top_layers.resize(count);
+  return top_layers;
+}
+
+void LayerCostTracker::Reset() {
+  last_frame_costs_.clear();
+  aggregates_.clear();
+  tracked_frame_count_ = 0;
+}
+
+void LayerCostTracker::TraceTopLayersToTimeline() const {
+#if !FLUTTER_RELEASE
+  for (const auto& frame_cost : GetTopLayers(kTopLayerCount)) {
+    FML_TRACE_COUNTER(
+        "flutter",                                                       //
+        "LayerRasterCost", static_cast<int64_t>(frame_cost.layer_id),    //
+        "PrerollMicros", frame_cost.cost.preroll_time.ToMicroseconds(),  //
+        "PaintMicros", frame_cost.cost.paint_time.ToMicroseconds(),      //
+        "SaveLayers", frame_cost.cost.save_layer_count);
+  }
+#endif  // !FLUTTER_RELEASE
+}
+
+}  // namespace flutter
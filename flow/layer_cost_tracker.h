@@ -0,0 +1,204 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_LAYER_COST_TRACKER_H_
+#define FLUTTER_FLOW_LAYER_COST_TRACKER_H_
+
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkRect.h"
+
+namespace flutter {
+
+class Layer;
+
+//------------------------------------------------------------------------------
+/// Attributes the raster time of a frame to the layers of its layer tree.
+///
+/// While a frame is tracked, every layer records the time that it spends in
+/// |Preroll| and |Paint|, excluding the time spent in its children, and the
+/// number of save layers that it creates. Layers are identified by their
+/// |Layer::original_layer_id|, which stays the same when the framework
+/// replaces a layer with an updated one, so costs can be aggregated across
+/// frames.
+///
+/// Only layers that the framework builds with their previous layer, such as
+/// the container layers of retained render objects, keep their ID. Picture
+/// and display list layers are built anew whenever they are repainted, so
+/// their costs do not aggregate across the frames that repaint them. To keep
+/// such layers from growing the aggregates without bound, the aggregate of a
+/// layer is dropped once it has not been in |kMaxUnseenFrames| tracked
+/// frames.
+///
+/// Tracking is off by default. It is on for every frame while enabled, and
+/// for a single frame when it was requested during the frame before, which is
+/// how the performance overlay keeps it on for as long as it displays layer
+/// costs. The layer tree only hands the tracker to its layers for the frames
+/// that |BeginFrame| reports as tracked, so the layers of other frames only
+/// check a null pointer.
+///
+/// This class is not thread safe and must be used on the raster thread.
+///
+class LayerCostTracker {
+ public:
+  struct Cost {
+    fml::TimeDelta preroll_time;
+    fml::TimeDelta paint_time;
+    size_t save_layer_count = 0;
+
+    fml::TimeDelta total_time() const { return preroll_time + paint_time; }
+  };
+
+  /// The cost of one layer in one frame.
+  struct FrameCost {
+    uint64_t layer_id;
+    Cost cost;
+    // The paint bounds of the layer on the surface, if it was painted.
+    SkRect device_bounds = SkRect::MakeEmpty();
+  };
+
+  /// The costs of one layer over all of the tracked frames that it was in.
+  struct Aggregate {
+    Cost total;
+    fml::TimeDelta max_total_time;
+    size_t frame_count = 0;
+    // The number of the last tracked frame that the layer was in.
+    size_t last_frame = 0;
+  };
+
+  /// The number of layers that are traced to the timeline every frame, and
+  /// that the performance overlay highlights.
+  static constexpr size_t kTopLayerCount = 5;
+
+  /// The number of tracked frames after which the aggregate of a layer that
+  /// was not in any of them is dropped.
+  static constexpr size_t kMaxUnseenFrames = 60;
+
+  LayerCostTracker();
+
+  ~LayerCostTracker();
+
+  void set_enabled(bool enabled) { enabled_ = enabled; }
+
+  bool enabled() const { return enabled_; }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Tracks the next frame even if tracking is not enabled.
+  ///
+  void RequestNextFrame() { next_frame_requested_ = true; }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Starts a frame.
+  ///
+  /// @return     Whether the frame is tracked.
+  ///
+  bool BeginFrame();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Ends the frame, adds its costs to the aggregates, drops the
+  ///             aggregates of layers that have not been seen for
+  ///             |kMaxUnseenFrames| tracked frames, and traces the most
+  ///             expensive layers of the frame to the timeline.
+  ///
+  void EndFrame();
+
+  bool is_tracking() const { return tracking_; }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Records the preroll of a layer for the duration of its scope
+  ///             if |tracker| is not null and tracking.
+  ///
+  class ScopedPreroll {
+   public:
+    ScopedPreroll(LayerCostTracker* tracker, const Layer* layer);
+
+    ~ScopedPreroll();
+
+   private:
+    LayerCostTracker* tracker_;
+
+    FML_DISALLOW_COPY_AND_ASSIGN(ScopedPreroll);
+  };
+
+  //----------------------------------------------------------------------------
+  /// @brief      Records the paint of a layer onto |canvas| for the duration
+  ///             of its scope if |tracker| is not null and tracking.
+  ///
+  class ScopedPaint {
+   public:
+    ScopedPaint(LayerCostTracker* tracker,
+                const Layer* layer,
+                const SkCanvas* canvas);
+
+    ~ScopedPaint();
+
+   private:
+    LayerCostTracker* tracker_;
+
+    FML_DISALLOW_COPY_AND_ASSIGN(ScopedPaint);
+  };
+
+  //----------------------------------------------------------------------------
+  /// @brief      Attributes a save layer to the layer that is being painted.
+  ///
+  void AddSaveLayer();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns the |count| layers with the highest total time in
+  ///             the last tracked frame, most expensive first.
+  ///
+  std::vector<FrameCost> GetTopLayers(size_t count) const;
+
+  const std::vector<FrameCost>& last_frame_costs() const {
+    return last_frame_costs_;
+  }
+
+  const std::unordered_map<uint64_t, Aggregate>& aggregates() const {
+    return aggregates_;
+  }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Drops the costs of all of the frames tracked so far.
+  ///
+  void Reset();
+
+ private:
+  enum class Phase { kPreroll, kPaint };
+
+  struct ActiveLayer {
+    size_t index;
+    fml::TimePoint start;
+    fml::TimeDelta children_time;
+  };
+
+  bool enabled_ = false;
+  bool next_frame_requested_ = false;
+  bool tracking_ = false;
+  // The costs of the frame in progress, in the order that the layers were
+  // first visited, with an index to find the entry of a layer.
+  std::vector<FrameCost> frame_costs_;
+  std::unordered_map<uint64_t, size_t> frame_cost_index_;
+  std::vector<ActiveLayer> active_layers_;
+  std::vector<FrameCost> last_frame_costs_;
+  std::unordered_map<uint64_t, Aggregate> aggregates_;
+  // The number of tracked frames since the last reset.
+  size_t tracked_frame_count_ = 0;
+
+  void Begin(const Layer* layer);
+
+  void End(Phase phase);
+
+  void TraceTopLayersToTimeline() const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(LayerCostTracker);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_LAYER_COST_TRACKER_H_
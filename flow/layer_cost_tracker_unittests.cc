@@ -0,0 +1,159 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layer_cost_tracker.h"
+
+#include "flutter/flow/compositor_context.h"
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/layer_tree.h"
+#include "flutter/flow/layers/performance_overlay_layer.h"
+#include "flutter/flow/testing/mock_layer.h"
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+namespace testing {
+
+TEST(LayerCostTracker, TracksNothingWhenDisabled) {
+  LayerCostTracker tracker;
+  ContainerLayer layer;
+  EXPECT_FALSE(tracker.BeginFrame());
+  {
+    LayerCostTracker::ScopedPreroll preroll(&tracker, &layer);
+    tracker.AddSaveLayer();
+  }
+  tracker.EndFrame();
+  EXPECT_TRUE(tracker.last_frame_costs().empty());
+  EXPECT_TRUE(tracker.aggregates().empty());
+}
+
+TEST(LayerCostTracker, AttributesCostsToEachLayer) {
+  LayerCostTracker tracker;
+  tracker.set_enabled(true);
+  ContainerLayer parent;
+  ContainerLayer child;
+  child.set_paint_bounds(SkRect::MakeWH(10, 10));
+  SkCanvas canvas(100, 100);
+  canvas.translate(20, 30);
+
+  ASSERT_TRUE(tracker.BeginFrame());
+  {
+    LayerCostTracker::ScopedPreroll parent_preroll(&tracker, &parent);
+    LayerCostTracker::ScopedPreroll child_preroll(&tracker, &child);
+  }
+  {
+    LayerCostTracker::ScopedPaint parent_paint(&tracker, &parent, &canvas);
+    tracker.AddSaveLayer();
+    LayerCostTracker::ScopedPaint child_paint(&tracker, &child, &canvas);
+  }
+  tracker.EndFrame();
+
+  const auto& costs = tracker.last_frame_costs();
+  ASSERT_EQ(costs.size(), 2u);
+  EXPECT_EQ(costs[0].layer_id, parent.original_layer_id());
+  EXPECT_EQ(costs[0].cost.save_layer_count, 1u);
+  EXPECT_EQ(costs[1].layer_id, child.original_layer_id());
+  EXPECT_EQ(costs[1].cost.save_layer_count, 0u);
+  EXPECT_EQ(costs[1].device_bounds, SkRect::MakeXYWH(20, 30, 10, 10));
+
+  EXPECT_EQ(tracker.aggregates().size(), 2u);
+  EXPECT_EQ(tracker.aggregates().at(parent.original_layer_id()).frame_count,
+            1u);
+  EXPECT_EQ(tracker.GetTopLayers(1).size(), 1u);
+
+  tracker.Reset();
+  EXPECT_TRUE(tracker.aggregates().empty());
+}
+
+TEST(LayerCostTracker, DropsAggregatesOfLayersThatAreGone) {
+  LayerCostTracker tracker;
+  tracker.set_enabled(true);
+  ContainerLayer retained;
+
+  // A new leaf layer every frame, as when a picture layer is repainted.
+  for (size_t i = 0; i < LayerCostTracker::kMaxUnseenFrames * 3; i++) {
+    ContainerLayer leaf;
+    ASSERT_TRUE(tracker.BeginFrame());
+    {
+      LayerCostTracker::ScopedPreroll retained_preroll(&tracker, &retained);
+      LayerCostTracker::ScopedPreroll leaf_preroll(&tracker, &leaf);
+    }
+    tracker.EndFrame();
+    EXPECT_LE(tracker.aggregates().size(),
+              LayerCostTracker::kMaxUnseenFrames + 1);
+  }
+
+  // The retained layer, and the leaves of the last frames.
+  EXPECT_EQ(tracker.aggregates().size(),
+            LayerCostTracker::kMaxUnseenFrames + 1);
+  EXPECT_EQ(tracker.aggregates().at(retained.original_layer_id()).frame_count,
+            LayerCostTracker::kMaxUnseenFrames * 3);
+}
+
+TEST(LayerCostTracker, RequestTracksOnlyTheNextFrame) {
+  LayerCostTracker tracker;
+  tracker.RequestNextFrame();
+  EXPECT_TRUE(tracker.BeginFrame());
+  tracker.EndFrame();
+  EXPECT_FALSE(tracker.BeginFrame());
+  tracker.EndFrame();
+}
+
+TEST(LayerCostTracker, CompositorContextTracksLayerTree) {
+  auto mock_layer = std::make_shared<MockLayer>(
+      SkPath().addRect(SkRect::MakeWH(10, 10)), SkPaint(SkColors::kRed));
+  auto root = std::make_shared<ContainerLayer>();
+  root->Add(mock_layer);
+  LayerTree layer_tree(SkISize::Make(64, 64), 1.0f);
+  layer_tree.set_root_layer(root);
+
+  CompositorContext compositor_context;
+  compositor_context.layer_cost_tracker().set_enabled(true);
+  auto surface = SkSurface::MakeRasterN32Premul(64, 64);
+  const SkMatrix root_surface_transformation = SkMatrix::I();
+  {
+    auto frame = compositor_context.AcquireFrame(
+        nullptr, surface->getCanvas(), nullptr, root_surface_transformation,
+        true, true, nullptr);
+    frame->Raster(layer_tree, false, nullptr);
+  }
+
+  const auto& costs = compositor_context.layer_cost_tracker().aggregates();
+  EXPECT_EQ(costs.size(), 2u);
+  EXPECT_EQ(costs.count(root->original_layer_id()), 1u);
+  EXPECT_EQ(costs.count(mock_layer->original_layer_id()), 1u);
+}
+
+TEST(LayerCostTracker, PerformanceOverlayTracksTheFramesAfterIt) {
+  auto overlay = std::make_shared<PerformanceOverlayLayer>(
+      kVisualizeLayerCosts);
+  overlay->set_paint_bounds(SkRect::MakeWH(64, 64));
+  auto root = std::make_shared<ContainerLayer>();
+  root->Add(overlay);
+  LayerTree layer_tree(SkISize::Make(64, 64), 1.0f);
+  layer_tree.set_root_layer(root);
+
+  CompositorContext compositor_context;
+  auto surface = SkSurface::MakeRasterN32Premul(64, 64);
+  const SkMatrix root_surface_transformation = SkMatrix::I();
+  auto raster_frame = [&]() {
+    auto frame = compositor_context.AcquireFrame(
+        nullptr, surface->getCanvas(), nullptr, root_surface_transformation,
+        true, true, nullptr);
+    frame->Raster(layer_tree, false, nullptr);
+  };
+
+  // Tracking is not enabled, so the first frame with the overlay is not
+  // tracked, but the overlay requests the next one.
+  raster_frame();
+  EXPECT_TRUE(compositor_context.layer_cost_tracker().aggregates().empty());
+
+  raster_frame();
+  EXPECT_EQ(compositor_context.layer_cost_tracker().aggregates().count(
+                overlay->original_layer_id()),
+            1u);
+}
+
+}  // namespace testing
+}  // namespace flutter
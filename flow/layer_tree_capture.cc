@@ -0,0 +1,570 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layer_tree_capture.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "flutter/display_list/display_list_canvas_recorder.h"
+#include "flutter/flow/layers/backdrop_filter_layer.h"
+#include "flutter/flow/layers/clip_path_layer.h"
+#include "flutter/flow/layers/clip_rect_layer.h"
+#include "flutter/flow/layers/clip_rrect_layer.h"
+#include "flutter/flow/layers/color_filter_layer.h"
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/display_list_layer.h"
+#include "flutter/flow/layers/image_filter_layer.h"
+#include "flutter/flow/layers/opacity_layer.h"
+#include "flutter/flow/layers/physical_shape_layer.h"
+#include "flutter/flow/layers/picture_layer.h"
+#include "flutter/flow/layers/shader_mask_layer.h"
+#include "flutter/flow/layers/transform_layer.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/time/time_point.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/core/SkShader.h"
+
+namespace flutter {
+
+// "FLTC", followed by the version of the format.
+static constexpr uint32_t kCaptureMagic = 0x43544c46;
+static constexpr uint32_t kCaptureVersion = 1;
+
+LayerCaptureWriter::LayerCaptureWriter(const SkSerialProcs* procs)
+    : procs_(procs) {}
+
+LayerCaptureWriter::~LayerCaptureWriter() = default;
+
+void LayerCaptureWriter::WriteLayer(const Layer* layer) {
+  auto it = layer_ids_.find(layer);
+  if (it != layer_ids_.end()) {
+    WriteType(LayerType::kReference);
+    WriteInt(it->second);
+    return;
+  }
+  // Ids are assigned in the order in which layers are first written, which is
+  // also the order in which they are read.
+  const int32_t id = static_cast<int32_t>(layer_ids_.size());
+  layer_ids_[layer] = id;
+  layer->WriteToCapture(*this);
+}
+
+void LayerCaptureWriter::WriteChildren(const ContainerLayer& layer) {
+  WriteInt(static_cast<int32_t>(layer.layers().size()));
+  for (const auto& child : layer.layers()) {
+    WriteLayer(child.get());
+  }
+}
+
+void LayerCaptureWriter::WriteType(LayerType type) {
+  WriteInt(static_cast<int32_t>(type));
+}
+
+void LayerCaptureWriter::WriteInt(int32_t value) {
+  stream_.write32(value);
+}
+
+void LayerCaptureWriter::WriteBool(bool value) {
+  stream_.writeBool(value);
+}
+
+void LayerCaptureWriter::WriteScalar(SkScalar value) {
+  stream_.writeScalar(value);
+}
+
+void LayerCaptureWriter::WritePoint(const SkPoint& point) {
+  WriteScalar(point.x());
+  WriteScalar(point.y());
+}
+
+void LayerCaptureWriter::WriteSize(const SkSize& size) {
+  WriteScalar(size.width());
+  WriteScalar(size.height());
+}
+
+void LayerCaptureWriter::WriteRect(const SkRect& rect) {
+  stream_.write(&rect, sizeof(rect));
+}
+
+void LayerCaptureWriter::WriteRRect(const SkRRect& rrect) {
+  char buffer[SkRRect::kSizeInMemory];
+  rrect.writeToMemory(buffer);
+  stream_.write(buffer, sizeof(buffer));
+}
+
+void LayerCaptureWriter::WriteMatrix(const SkMatrix& matrix) {
+  SkScalar values[9];
+  matrix.get9(values);
+  stream_.write(values, sizeof(values));
+}
+
+void LayerCaptureWriter::WritePath(const SkPath& path) {
+  WriteData(path.serialize());
+}
+
+void LayerCaptureWriter::WriteFlattenable(const SkFlattenable* flattenable) {
+  WriteData(flattenable ? flattenable->serialize(procs_) : nullptr);
+}
+
+void LayerCaptureWriter::WritePicture(const SkPicture* picture) {
+  WriteData(picture ? picture->serialize(procs_) : nullptr);
+}
+
+void LayerCaptureWriter::WriteDisplayList(DisplayList* display_list) {
+  if (!display_list) {
+    WriteData(nullptr);
+    return;
+  }
+  SkPictureRecorder recorder;
+  display_list->RenderTo(recorder.beginRecording(display_list->bounds()));
+  WritePicture(recorder.finishRecordingAsPicture().get());
+}
+
+void LayerCaptureWriter::WriteData(const sk_sp<SkData>& data) {
+  if (!data) {
+    WriteInt(0);
+    return;
+  }
+  WriteInt(static_cast<int32_t>(data->size()));
+  stream_.write(data->data(), data->size());
+}
+
+sk_sp<SkData> LayerCaptureWriter::Finish() {
+  return stream_.detachAsData();
+}
+
+namespace {
+
+// Reads the layers written by |LayerCaptureWriter|. Every read fails once the
+// data is found to be invalid.
+class LayerCaptureReader {
+ public:
+  LayerCaptureReader(const sk_sp<SkData>& data,
+                     fml::RefPtr<SkiaUnrefQueue> unref_queue)
+      : stream_(data), unref_queue_(std::move(unref_queue)) {}
+
+  bool ReadInt(int32_t* value) {
+    valid_ = valid_ && stream_.readS32(value);
+    return valid_;
+  }
+
+  bool ReadUInt(uint32_t* value) {
+    valid_ = valid_ && stream_.readU32(value);
+    return valid_;
+  }
+
+  bool ReadBool(bool* value) {
+    valid_ = valid_ && stream_.readBool(value);
+    return valid_;
+  }
+
+  bool ReadScalar(SkScalar* value) {
+    valid_ = valid_ && stream_.readScalar(value);
+    return valid_;
+  }
+
+  bool ReadPoint(SkPoint* point) {
+    return ReadScalar(&point->fX) && ReadScalar(&point->fY);
+  }
+
+  bool ReadRect(SkRect* rect) { return ReadBytes(rect, sizeof(*rect)); }
+
+  bool ReadRRect(SkRRect* rrect) {
+    char buffer[SkRRect::kSizeInMemory];
+    valid_ = ReadBytes(buffer, sizeof(buffer)) &&
+             rrect->readFromMemory(buffer, sizeof(buffer)) == sizeof(buffer);
+    return valid_;
+  }
+
+  bool ReadMatrix(SkMatrix* matrix) {
+    SkScalar values[9];
+    if (!ReadBytes(values, sizeof(values))) {
+      return false;
+    }
+    matrix->set9(values);
+    return true;
+  }
+
+  bool ReadPath(SkPath* path) {
+    sk_sp<SkData> data = ReadData();
+    valid_ = valid_ && data &&
+             path->readFromMemory(data->data(), data->size()) == data->size();
+    return valid_;
+  }
+
+  bool ReadClip(Clip* clip) {
+    int32_t value;
+    if (!ReadInt(&value)) {
+      return false;
+    }
+    valid_ = value >= Clip::none && value <= Clip::antiAliasWithSaveLayer;
+    *clip = static_cast<Clip>(value);
+    return valid_;
+  }
+
+  bool ReadBlendMode(SkBlendMode* blend_mode) {
+    int32_t value;
+    if (!ReadInt(&value)) {
+      return false;
+    }
+    valid_ =
+        value >= 0 && value <= static_cast<int32_t>(SkBlendMode::kLastMode);
+    *blend_mode = static_cast<SkBlendMode>(value);
+    return valid_;
+  }
+
+  // Reads the serialized form of a flattenable of |type|, or nullptr if none
+  // was written.
+  sk_sp<SkFlattenable> ReadFlattenable(SkFlattenable::Type type) {
+    sk_sp<SkData> data = ReadData();
+    if (!valid_ || !data) {
+      return nullptr;
+    }
+    sk_sp<SkFlattenable> flattenable =
+        SkFlattenable::Deserialize(type, data->data(), data->size());
+    valid_ = !!flattenable;
+    return flattenable;
+  }
+
+  sk_sp<SkPicture> ReadPicture() {
+    sk_sp<SkData> data = ReadData();
+    if (!valid_ || !data) {
+      return nullptr;
+    }
+    sk_sp<SkPicture> picture = SkPicture::MakeFromData(data.get());
+    valid_ = !!picture;
+    return picture;
+  }
+
+  std::shared_ptr<Layer> ReadLayer() {
+    int32_t type;
+    if (!ReadInt(&type)) {
+      return nullptr;
+    }
+    if (type ==
+        static_cast<int32_t>(LayerCaptureWriter::LayerType::kReference)) {
+      // Layers can only refer to layers that were read completely, so that
+      // layers cannot contain themselves.
+      int32_t id;
+      if (!ReadInt(&id) || id < 0 ||
+          static_cast<size_t>(id) >= layers_.size() || !layers_[id]) {
+        valid_ = false;
+        return nullptr;
+      }
+      return layers_[id];
+    }
+    // Reserve the id of the layer before its children are read, as the
+    // writer assigns it before writing them.
+    const size_t id = layers_.size();
+    layers_.push_back(nullptr);
+    std::shared_ptr<Layer> layer =
+        ReadLayerOfType(static_cast<LayerCaptureWriter::LayerType>(type));
+    if (!layer) {
+      valid_ = false;
+      return nullptr;
+    }
+    layers_[id] = layer;
+    return layer;
+  }
+
+  bool valid() const { return valid_; }
+
+ private:
+  bool ReadBytes(void* buffer, size_t size) {
+    valid_ = valid_ && stream_.read(buffer, size) == size;
+    return valid_;
+  }
+
+  sk_sp<SkData> ReadData() {
+    int32_t size;
+    if (!ReadInt(&size) || size < 0 ||
+        static_cast<size_t>(size) >
+            stream_.getLength() - stream_.getPosition()) {
+      valid_ = false;
+      return nullptr;
+    }
+    if (size == 0) {
+      return nullptr;
+    }
+    sk_sp<SkData> data = SkData::MakeUninitialized(size);
+    ReadBytes(data->writable_data(), size);
+    return data;
+  }
+
+  std::shared_ptr<Layer> ReadLayerOfType(LayerCaptureWriter::LayerType type) {
+    using LayerType = LayerCaptureWriter::LayerType;
+    switch (type) {
+      case LayerType::kPlaceholder:
+        return std::make_shared<ContainerLayer>();
+      case LayerType::kContainer:
+        return ReadChildren(std::make_shared<ContainerLayer>());
+      case LayerType::kTransform: {
+        SkMatrix transform;
+        if (!ReadMatrix(&transform)) {
+          return nullptr;
+        }
+        return ReadChildren(std::make_shared<TransformLayer>(transform));
+      }
+      case LayerType::kClipRect: {
+        SkRect clip_rect;
+        Clip clip;
+        if (!ReadRect(&clip_rect) || !ReadClip(&clip)) {
+          return nullptr;
+        }
+        return ReadChildren(std::make_shared<ClipRectLayer>(clip_rect, clip));
+      }
+      case LayerType::kClipRRect: {
+        SkRRect clip_rrect;
+        Clip clip;
+        if (!ReadRRect(&clip_rrect) || !ReadClip(&clip)) {
+          return nullptr;
+        }
+        return ReadChildren(std::make_shared<ClipRRectLayer>(clip_rrect, clip));
+      }
+      case LayerType::kClipPath: {
+        SkPath clip_path;
+        Clip clip;
+        if (!ReadPath(&clip_path) || !ReadClip(&clip)) {
+          return nullptr;
+        }
+        return ReadChildren(std::make_shared<ClipPathLayer>(clip_path, clip));
+      }
+      case LayerType::kOpacity: {
+        int32_t alpha;
+        SkPoint offset;
+        if (!ReadInt(&alpha) || alpha < 0 || alpha > SK_AlphaOPAQUE ||
+            !ReadPoint(&offset)) {
+          return nullptr;
+        }
+        return ReadChildren(std::make_shared<OpacityLayer>(alpha, offset));
+      }
+      case LayerType::kColorFilter: {
+        auto filter = sk_sp<SkColorFilter>(static_cast<SkColorFilter*>(
+            ReadFlattenable(SkFlattenable::kSkColorFilter_Type).release()));
+        if (!valid_) {
+          return nullptr;
+        }
+        return ReadChildren(std::make_shared<ColorFilterLayer>(filter));
+      }
+      case LayerType::kImageFilter: {
+        auto filter = sk_sp<SkImageFilter>(static_cast<SkImageFilter*>(
+            ReadFlattenable(SkFlattenable::kSkImageFilter_Type).release()));
+        if (!valid_) {
+          return nullptr;
+        }
+        return ReadChildren(std::make_shared<ImageFilterLayer>(filter));
+      }
+      case LayerType::kBackdropFilter: {
+        auto filter = sk_sp<SkImageFilter>(static_cast<SkImageFilter*>(
+            ReadFlattenable(SkFlattenable::kSkImageFilter_Type).release()));
+        SkBlendMode blend_mode;
+        if (!ReadBlendMode(&blend_mode)) {
+          return nullptr;
+        }
+        return ReadChildren(
+            std::make_shared<BackdropFilterLayer>(filter, blend_mode));
+      }
+      case LayerType::kShaderMask: {
+        auto shader = sk_sp<SkShader>(static_cast<SkShader*>(
+            ReadFlattenable(SkFlattenable::kSkShader_Type).release()));
+        SkRect mask_rect;
+        SkBlendMode blend_mode;
+        if (!ReadRect(&mask_rect) || !ReadBlendMode(&blend_mode)) {
+          return nullptr;
+        }
+        return ReadChildren(
+            std::make_shared<ShaderMaskLayer>(shader, mask_rect, blend_mode));
+      }
+      case LayerType::kPhysicalShape: {
+        uint32_t color;
+        uint32_t shadow_color;
+        SkScalar elevation;
+        SkPath path;
+        Clip clip;
+        if (!ReadUInt(&color) || !ReadUInt(&shadow_color) ||
+            !ReadScalar(&elevation) || !ReadPath(&path) || !ReadClip(&clip)) {
+          return nullptr;
+        }
+        return ReadChildren(std::make_shared<PhysicalShapeLayer>(
+            color, shadow_color, elevation, path, clip));
+      }
+      case LayerType::kPicture:
+      case LayerType::kDisplayList: {
+        SkPoint offset;
+        bool is_complex;
+        bool will_change;
+        if (!ReadPoint(&offset) || !ReadBool(&is_complex) ||
+            !ReadBool(&will_change)) {
+          return nullptr;
+        }
+        sk_sp<SkPicture> picture = ReadPicture();
+        if (!picture) {
+          return nullptr;
+        }
+        if (type == LayerType::kPicture) {
+          return std::make_shared<PictureLayer>(
+              offset, SkiaGPUObject<SkPicture>(picture, unref_queue_),
+              is_complex, will_change);
+        }
+        DisplayListCanvasRecorder recorder(picture->cullRect());
+        picture->playback(&recorder);
+        return std::make_shared<DisplayListLayer>(
+            offset, SkiaGPUObject<DisplayList>(recorder.Build(), unref_queue_),
+            is_complex, will_change);
+      }
+      case LayerType::kReference:
+        break;
+    }
+    return nullptr;
+  }
+
+  std::shared_ptr<Layer> ReadChildren(std::shared_ptr<ContainerLayer> layer) {
+    int32_t count;
+    if (!ReadInt(&count) || count < 0) {
+      valid_ = false;
+      return nullptr;
+    }
+    for (int32_t i = 0; i < count; i++) {
+      std::shared_ptr<Layer> child = ReadLayer();
+      if (!child) {
+        return nullptr;
+      }
+      layer->Add(std::move(child));
+    }
+    return layer;
+  }
+
+  SkMemoryStream stream_;
+  fml::RefPtr<SkiaUnrefQueue> unref_queue_;
+  // The layers read so far, by id.
+  std::vector<std::shared_ptr<Layer>> layers_;
+  bool valid_ = true;
+};
+
+}  // namespace
+
+LayerTreeCapture::LayerTreeCapture(size_t max_frames)
+    : max_frames_(max_frames) {
+  frames_.reserve(max_frames_);
+}
+
+LayerTreeCapture::~LayerTreeCapture() = default;
+
+bool LayerTreeCapture::Capture(const LayerTree& layer_tree) {
+  if (IsComplete() || !layer_tree.shared_root_layer()) {
+    return false;
+  }
+  frames_.push_back({layer_tree.shared_root_layer(), layer_tree.frame_size(),
+                     layer_tree.device_pixel_ratio()});
+  return true;
+}
+
+std::unique_ptr<LayerTree> LayerTreeCapture::MakeLayerTree(
+    size_t index) const {
+  FML_DCHECK(index < frames_.size());
+  const Frame& frame = frames_[index];
+  auto layer_tree =
+      std::make_unique<LayerTree>(frame.frame_size, frame.device_pixel_ratio);
+  layer_tree->set_root_layer(frame.root_layer);
+  return layer_tree;
+}
+
+std::vector<fml::TimeDelta> LayerTreeCapture::Replay(
+    CompositorContext& compositor_context,
+    SkSurface* surface,
+    GrDirectContext* gr_context) const {
+  TRACE_EVENT0("flutter", "LayerTreeCapture::Replay");
+  std::vector<fml::TimeDelta> frame_times;
+  frame_times.reserve(frames_.size());
+  const SkMatrix root_surface_transformation = SkMatrix::I();
+  for (size_t i = 0; i < frames_.size(); i++) {
+    auto layer_tree = MakeLayerTree(i);
+    const auto start = fml::TimePoint::Now();
+    {
+      auto scoped_frame = compositor_context.AcquireFrame(
+          gr_context, surface->getCanvas(), nullptr,
+          root_surface_transformation, true, true, nullptr);
+      compositor_context.raster_cache().PrepareNewFrame();
+      scoped_frame->Raster(*layer_tree, false, nullptr);
+      compositor_context.raster_cache().CleanupAfterFrame();
+    }
+    surface->flushAndSubmit(true);
+    frame_times.push_back(fml::TimePoint::Now() - start);
+  }
+  return frame_times;
+}
+
+fml::TimeDelta LayerTreeCapture::GetPercentile(
+    std::vector<fml::TimeDelta> frame_times,
+    double percentile) {
+  FML_DCHECK(!frame_times.empty());
+  size_t rank = static_cast<size_t>(
+      std::ceil(percentile / 100.0 * frame_times.size()));
+  size_t index = std::clamp<size_t>(rank, 1, frame_times.size()) - 1;
+  std::nth_element(frame_times.begin(), frame_times.begin() + index,
+                   frame_times.end());
+  return frame_times[index];
+}
+
+sk_sp<SkData> LayerTreeCapture::Serialize(const SkSerialProcs* procs) const {
+  TRACE_EVENT0("flutter", "LayerTreeCapture::Serialize");
+  LayerCaptureWriter writer(procs);
+  writer.WriteInt(kCaptureMagic);
+  writer.WriteInt(kCaptureVersion);
+  writer.WriteInt(static_cast<int32_t>(max_frames_));
+  writer.WriteInt(static_cast<int32_t>(frames_.size()));
+  for (const Frame& frame : frames_) {
+    writer.WriteInt(frame.frame_size.width());
+    writer.WriteInt(frame.frame_size.height());
+    writer.WriteScalar(frame.device_pixel_ratio);
+    writer.WriteLayer(frame.root_layer.get());
+  }
+  return writer.Finish();
+}
+
+std::unique_ptr<LayerTreeCapture> LayerTreeCapture::Deserialize(
+    const sk_sp<SkData>& data,
+    fml::RefPtr<SkiaUnrefQueue> unref_queue) {
+  TRACE_EVENT0("flutter", "LayerTreeCapture::Deserialize");
+  if (!data) {
+    return nullptr;
+  }
+  LayerCaptureReader reader(data, std::move(unref_queue));
+  uint32_t magic;
+  uint32_t version;
+  int32_t max_frames;
+  int32_t frame_count;
+  if (!reader.ReadUInt(&magic) || magic != kCaptureMagic ||
+      !reader.ReadUInt(&version) || version != kCaptureVersion ||
+      !reader.ReadInt(&max_frames) || !reader.ReadInt(&frame_count) ||
+      frame_count < 0 || max_frames < frame_count) {
+    return nullptr;
+  }
+
+  auto capture = std::make_unique<LayerTreeCapture>(max_frames);
+  for (int32_t i = 0; i < frame_count; i++) {
+    int32_t width;
+    int32_t height;
+    SkScalar device_pixel_ratio;
+    if (!reader.ReadInt(&width) || !reader.ReadInt(&height) ||
+        !reader.ReadScalar(&device_pixel_ratio)) {
+      return nullptr;
+    }
+    std::shared_ptr<Layer> root_layer = reader.ReadLayer();
+    if (!root_layer) {
+      return nullptr;
+    }
+    capture->frames_.push_back(
+        {std::move(root_layer), SkISize::Make(width, height),
+         device_pixel_ratio});
+  }
+  if (!reader.valid()) {
+    return nullptr;
+  }
+  return capture;
+}
+
+}  // namespace flutter
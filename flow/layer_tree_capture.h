@@ -0,0 +1,206 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_LAYER_TREE_CAPTURE_H_
+#define FLUTTER_FLOW_LAYER_TREE_CAPTURE_H_
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/display_list/display_list.h"
+#include "flutter/flow/compositor_context.h"
+#include "flutter/flow/layers/layer.h"
+#include "flutter/flow/layers/layer_tree.h"
+#include "flutter/flow/skia_gpu_object.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkFlattenable.h"
+#include "third_party/skia/include/core/SkSerialProcs.h"
+#include "third_party/skia/include/core/SkSize.h"
+#include "third_party/skia/include/core/SkStream.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+
+class ContainerLayer;
+
+//------------------------------------------------------------------------------
+/// Writes the layers of captured frames to the serialized form of a
+/// |LayerTreeCapture|. Layers describe themselves through
+/// |Layer::WriteToCapture|, and layers that appear more than once, e.g.
+/// because they are retained across frames, are written once and referred to
+/// afterwards, so that replaying the frames shares them the same way.
+///
+class LayerCaptureWriter {
+ public:
+  enum class LayerType : int32_t {
+    // Refers to a layer that was written before.
+    kReference,
+    kPlaceholder,
+    kContainer,
+    kTransform,
+    kClipRect,
+    kClipRRect,
+    kClipPath,
+    kOpacity,
+    kColorFilter,
+    kImageFilter,
+    kBackdropFilter,
+    kShaderMask,
+    kPhysicalShape,
+    kPicture,
+    kDisplayList,
+  };
+
+  // |procs| are used to serialize pictures and filters, and may be nullptr.
+  explicit LayerCaptureWriter(const SkSerialProcs* procs);
+
+  ~LayerCaptureWriter();
+
+  void WriteLayer(const Layer* layer);
+  void WriteChildren(const ContainerLayer& layer);
+
+  void WriteType(LayerType type);
+  void WriteInt(int32_t value);
+  void WriteBool(bool value);
+  void WriteScalar(SkScalar value);
+  void WritePoint(const SkPoint& point);
+  void WriteSize(const SkSize& size);
+  void WriteRect(const SkRect& rect);
+  void WriteRRect(const SkRRect& rrect);
+  void WriteMatrix(const SkMatrix& matrix);
+  void WritePath(const SkPath& path);
+  // Writes the serialized form of |flattenable|, which may be nullptr.
+  void WriteFlattenable(const SkFlattenable* flattenable);
+  void WritePicture(const SkPicture* picture);
+  // Display lists are written as the pictures that they render to.
+  void WriteDisplayList(DisplayList* display_list);
+
+  sk_sp<SkData> Finish();
+
+ private:
+  void WriteData(const sk_sp<SkData>& data);
+
+  const SkSerialProcs* procs_;
+  SkDynamicMemoryWStream stream_;
+  std::unordered_map<const Layer*, int32_t> layer_ids_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(LayerCaptureWriter);
+};
+
+//------------------------------------------------------------------------------
+/// Captures a number of consecutive layer trees so that they can be replayed
+/// through the raster pipeline later, for example to reproduce and measure
+/// jank outside of the running application.
+///
+/// A capture holds on to the root layer of every frame. The parameters and
+/// children of a layer do not change once its frame has been built, but some
+/// layers keep state for painting, such as the shadow display list of a
+/// PhysicalShapeLayer or the filtered backdrop of a BackdropFilterLayer, and
+/// that state is kept alive and reused when the frames are replayed in the
+/// same process. Layers that are retained across frames, along with their
+/// display lists and images, are shared between the captured frames rather
+/// than copied.
+///
+/// |Serialize| writes the captured frames to a form that can be loaded with
+/// |Deserialize| in another process, such as the flow_benchmarks replay
+/// benchmark. It keeps the structure and parameters of the layers, and the
+/// contents of picture and display list layers are written as SkPictures.
+/// Textures, platform views and the performance overlay are written as
+/// placeholders that paint nothing, and painting state is not written.
+///
+class LayerTreeCapture {
+ public:
+  struct Frame {
+    std::shared_ptr<Layer> root_layer;
+    SkISize frame_size;
+    float device_pixel_ratio;
+  };
+
+  explicit LayerTreeCapture(size_t max_frames);
+
+  ~LayerTreeCapture();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Adds |layer_tree| to the capture.
+  ///
+  /// @return     Whether the layer tree was captured. Layer trees without a
+  ///             root layer are skipped, as are all layer trees once the
+  ///             capture is complete.
+  ///
+  bool Capture(const LayerTree& layer_tree);
+
+  bool IsComplete() const { return frames_.size() >= max_frames_; }
+
+  size_t GetMaxFrames() const { return max_frames_; }
+
+  const std::vector<Frame>& frames() const { return frames_; }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a new layer tree for the captured frame at |index|,
+  ///             which shares its layers with the captured layer tree.
+  ///
+  std::unique_ptr<LayerTree> MakeLayerTree(size_t index) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Prerolls and paints every captured frame, in order, into
+  ///             |surface| through |compositor_context|, as the rasterizer
+  ///             would. The raster cache of |compositor_context| is used and
+  ///             updated from frame to frame, so replaying the same capture
+  ///             into the same context twice is deterministic only if the
+  ///             raster cache is cleared in between.
+  ///
+  /// @param[in]  compositor_context  The context to raster the frames with.
+  /// @param[in]  surface             The surface to draw the frames into.
+  /// @param[in]  gr_context          The context of |surface| if it is backed
+  ///                                 by the GPU, or nullptr.
+  ///
+  /// @return     The time that each frame took to raster, including flushing
+  ///             the surface.
+  ///
+  std::vector<fml::TimeDelta> Replay(CompositorContext& compositor_context,
+                                     SkSurface* surface,
+                                     GrDirectContext* gr_context) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns the frame time below which |percentile| percent of
+  ///             |frame_times| fall, using the nearest rank. |frame_times|
+  ///             must not be empty.
+  ///
+  static fml::TimeDelta GetPercentile(std::vector<fml::TimeDelta> frame_times,
+                                      double percentile);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Writes the captured frames to a buffer.
+  ///
+  /// @param[in]  procs  The procs used to serialize pictures and filters, e.g.
+  ///                    to embed the data of typefaces. May be nullptr.
+  ///
+  sk_sp<SkData> Serialize(const SkSerialProcs* procs = nullptr) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Loads frames written by |Serialize|.
+  ///
+  /// @param[in]  data         The serialized capture.
+  /// @param[in]  unref_queue  The queue that releases the display lists and
+  ///                          pictures of the loaded layers.
+  ///
+  /// @return     The capture, or nullptr if |data| is not a valid capture.
+  ///
+  static std::unique_ptr<LayerTreeCapture> Deserialize(
+      const sk_sp<SkData>& data,
+      fml::RefPtr<SkiaUnrefQueue> unref_queue);
+
+ private:
+  const size_t max_frames_;
+  std::vector<Frame> frames_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(LayerTreeCapture);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_LAYER_TREE_CAPTURE_H_
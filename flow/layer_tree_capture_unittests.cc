@@ -0,0 +1,193 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layer_tree_capture.h"
+
+#include "flutter/display_list/display_list_builder.h"
+#include "flutter/flow/layers/clip_rect_layer.h"
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/display_list_layer.h"
+#include "flutter/flow/layers/opacity_layer.h"
+#include "flutter/flow/layers/transform_layer.h"
+#include "flutter/flow/testing/mock_layer.h"
+#include "flutter/flow/testing/skia_gpu_object_layer_test.h"
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+std::unique_ptr<LayerTree> MakeLayerTree(const SkRect& rect) {
+  auto root = std::make_shared<ContainerLayer>();
+  root->Add(std::make_shared<MockLayer>(SkPath().addRect(rect),
+                                        SkPaint(SkColors::kGreen)));
+  auto layer_tree = std::make_unique<LayerTree>(SkISize::Make(64, 64), 2.0f);
+  layer_tree->set_root_layer(root);
+  return layer_tree;
+}
+
+}  // namespace
+
+TEST(LayerTreeCapture, CapturesUpToMaxFrames) {
+  LayerTreeCapture capture(2);
+  LayerTree empty_tree(SkISize::Make(64, 64), 1.0f);
+  EXPECT_FALSE(capture.Capture(empty_tree));
+
+  auto first = MakeLayerTree(SkRect::MakeWH(10, 10));
+  auto second = MakeLayerTree(SkRect::MakeWH(20, 20));
+  auto third = MakeLayerTree(SkRect::MakeWH(30, 30));
+  EXPECT_TRUE(capture.Capture(*first));
+  EXPECT_FALSE(capture.IsComplete());
+  EXPECT_TRUE(capture.Capture(*second));
+  EXPECT_TRUE(capture.IsComplete());
+  EXPECT_FALSE(capture.Capture(*third));
+
+  ASSERT_EQ(capture.frames().size(), 2u);
+  EXPECT_EQ(capture.frames()[0].root_layer.get(), first->root_layer());
+  EXPECT_EQ(capture.frames()[1].root_layer.get(), second->root_layer());
+}
+
+TEST(LayerTreeCapture, MakeLayerTreeSharesLayers) {
+  LayerTreeCapture capture(1);
+  auto layer_tree = MakeLayerTree(SkRect::MakeWH(10, 10));
+  capture.Capture(*layer_tree);
+
+  auto replayed = capture.MakeLayerTree(0);
+  EXPECT_EQ(replayed->root_layer(), layer_tree->root_layer());
+  EXPECT_EQ(replayed->frame_size(), layer_tree->frame_size());
+  EXPECT_EQ(replayed->device_pixel_ratio(), 2.0f);
+}
+
+TEST(LayerTreeCapture, ReplayRastersEveryFrame) {
+  LayerTreeCapture capture(3);
+  for (int i = 1; i <= 3; i++) {
+    capture.Capture(*MakeLayerTree(SkRect::MakeWH(i * 10, i * 10)));
+  }
+
+  CompositorContext compositor_context;
+  auto surface = SkSurface::MakeRasterN32Premul(64, 64);
+  auto frame_times = capture.Replay(compositor_context, surface.get(), nullptr);
+  EXPECT_EQ(frame_times.size(), 3u);
+  EXPECT_EQ(compositor_context.frame_count().count(), 3u);
+
+  // Only the last frame is left in the surface.
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(64, 64);
+  ASSERT_TRUE(surface->readPixels(bitmap, 0, 0));
+  EXPECT_EQ(bitmap.getColor(25, 25), SK_ColorGREEN);
+  EXPECT_EQ(bitmap.getColor(35, 35), SK_ColorTRANSPARENT);
+}
+
+TEST(LayerTreeCapture, GetPercentileUsesNearestRank) {
+  std::vector<fml::TimeDelta> frame_times;
+  for (int i = 10; i >= 1; i--) {
+    frame_times.push_back(fml::TimeDelta::FromMilliseconds(i));
+  }
+  EXPECT_EQ(LayerTreeCapture::GetPercentile(frame_times, 0),
+            fml::TimeDelta::FromMilliseconds(1));
+  EXPECT_EQ(LayerTreeCapture::GetPercentile(frame_times, 50),
+            fml::TimeDelta::FromMilliseconds(5));
+  EXPECT_EQ(LayerTreeCapture::GetPercentile(frame_times, 90),
+            fml::TimeDelta::FromMilliseconds(9));
+  EXPECT_EQ(LayerTreeCapture::GetPercentile(frame_times, 100),
+            fml::TimeDelta::FromMilliseconds(10));
+}
+
+using LayerTreeCaptureSerializationTest = SkiaGPUObjectLayerTest;
+
+namespace {
+
+std::shared_ptr<DisplayListLayer> MakeDisplayListLayer(
+    const SkRect& rect,
+    SkColor color,
+    fml::RefPtr<SkiaUnrefQueue> unref_queue) {
+  DisplayListBuilder builder;
+  builder.setColor(color);
+  builder.drawRect(rect);
+  return std::make_shared<DisplayListLayer>(
+      SkPoint::Make(0, 0),
+      SkiaGPUObject<DisplayList>(builder.Build(), unref_queue), false, false);
+}
+
+SkBitmap ReplayLastFrame(const LayerTreeCapture& capture) {
+  CompositorContext compositor_context;
+  auto surface = SkSurface::MakeRasterN32Premul(64, 64);
+  capture.Replay(compositor_context, surface.get(), nullptr);
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(64, 64);
+  surface->readPixels(bitmap, 0, 0);
+  return bitmap;
+}
+
+}  // namespace
+
+TEST_F(LayerTreeCaptureSerializationTest, RoundTripsFrames) {
+  // A retained subtree shared by both frames.
+  auto retained = std::make_shared<ClipRectLayer>(SkRect::MakeWH(32, 32),
+                                                  Clip::hardEdge);
+  retained->Add(MakeDisplayListLayer(SkRect::MakeWH(64, 64), SK_ColorBLUE,
+                                     unref_queue()));
+
+  LayerTreeCapture capture(2);
+  for (int frame = 0; frame < 2; frame++) {
+    auto root = std::make_shared<ContainerLayer>();
+    auto transform = std::make_shared<TransformLayer>(
+        SkMatrix::Translate(frame * 16.0f, 0));
+    transform->Add(retained);
+    root->Add(transform);
+    auto opacity = std::make_shared<OpacityLayer>(255, SkPoint::Make(0, 48));
+    opacity->Add(MakeDisplayListLayer(SkRect::MakeWH(16, 16), SK_ColorGREEN,
+                                      unref_queue()));
+    root->Add(opacity);
+    // Mock layers have no serialized form and paint nothing once replayed.
+    root->Add(std::make_shared<MockLayer>(
+        SkPath().addRect(SkRect::MakeXYWH(48, 48, 16, 16)),
+        SkPaint(SkColors::kRed)));
+    LayerTree layer_tree(SkISize::Make(64, 64), 2.0f);
+    layer_tree.set_root_layer(root);
+    ASSERT_TRUE(capture.Capture(layer_tree));
+  }
+
+  sk_sp<SkData> data = capture.Serialize();
+  ASSERT_NE(data, nullptr);
+  auto loaded = LayerTreeCapture::Deserialize(data, unref_queue());
+  ASSERT_NE(loaded, nullptr);
+  EXPECT_EQ(loaded->GetMaxFrames(), 2u);
+  ASSERT_EQ(loaded->frames().size(), 2u);
+  EXPECT_EQ(loaded->frames()[1].frame_size, SkISize::Make(64, 64));
+  EXPECT_EQ(loaded->frames()[1].device_pixel_ratio, 2.0f);
+
+  // The retained subtree is still shared between the frames.
+  auto retained_in = [&](size_t index) {
+    auto* root =
+        static_cast<ContainerLayer*>(loaded->frames()[index].root_layer.get());
+    auto* transform = static_cast<ContainerLayer*>(root->layers()[0].get());
+    return transform->layers()[0].get();
+  };
+  EXPECT_EQ(retained_in(0), retained_in(1));
+
+  SkBitmap bitmap = ReplayLastFrame(*loaded);
+  EXPECT_EQ(bitmap.getColor(8, 8), SK_ColorTRANSPARENT);
+  EXPECT_EQ(bitmap.getColor(24, 8), SK_ColorBLUE);
+  EXPECT_EQ(bitmap.getColor(40, 8), SK_ColorBLUE);
+  EXPECT_EQ(bitmap.getColor(56, 8), SK_ColorTRANSPARENT);
+  EXPECT_EQ(bitmap.getColor(8, 56), SK_ColorGREEN);
+  EXPECT_EQ(bitmap.getColor(56, 56), SK_ColorTRANSPARENT);
+}
+
+TEST_F(LayerTreeCaptureSerializationTest, RejectsInvalidData) {
+  EXPECT_EQ(LayerTreeCapture::Deserialize(SkData::MakeEmpty(), unref_queue()),
+            nullptr);
+
+  LayerTreeCapture capture(1);
+  capture.Capture(*MakeLayerTree(SkRect::MakeWH(10, 10)));
+  sk_sp<SkData> data = capture.Serialize();
+  sk_sp<SkData> truncated = SkData::MakeSubset(data.get(), 0, data->size() - 1);
+  EXPECT_EQ(LayerTreeCapture::Deserialize(truncated, unref_queue()), nullptr);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -0,0 +1,140 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/display_list/display_list_builder.h"
+#include "flutter/flow/layer_tree_capture.h"
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/display_list_layer.h"
+#include "flutter/flow/layers/transform_layer.h"
+#include "flutter/fml/message_loop.h"
+#include "third_party/skia/include/core/SkData.h"
+
+namespace flutter {
+
+namespace {
+
+constexpr int kFrameCount = 120;
+constexpr int kFrameSize = 1024;
+constexpr SkScalar kItemHeight = 64.0f;
+
+sk_sp<DisplayList> MakeListItem(int index) {
+  DisplayListBuilder builder;
+  builder.setColor(index % 2 ? SK_ColorLTGRAY : SK_ColorWHITE);
+  builder.drawRect(SkRect::MakeWH(kFrameSize, kItemHeight));
+  builder.setAntiAlias(true);
+  builder.setColor(SK_ColorBLUE);
+  builder.drawCircle({kItemHeight / 2, kItemHeight / 2}, 24.0f);
+  builder.setColor(SK_ColorBLACK);
+  for (int line = 0; line < 3; line++) {
+    builder.drawRRect(SkRRect::MakeRectXY(
+        SkRect::MakeXYWH(kItemHeight, 12.0f + line * 16.0f,
+                         600.0f - line * 120.0f, 8.0f),
+        4.0f, 4.0f));
+  }
+  return builder.Build();
+}
+
+// Captures |kFrameCount| frames of a list with |item_count| items that
+// scrolls by a few pixels every frame. The items are retained across frames,
+// as the framework retains the layers of a list that only scrolls.
+std::unique_ptr<LayerTreeCapture> CaptureScrollingList(
+    int item_count,
+    fml::RefPtr<SkiaUnrefQueue> unref_queue) {
+  std::vector<std::shared_ptr<Layer>> items;
+  for (int i = 0; i < item_count; i++) {
+    items.push_back(std::make_shared<DisplayListLayer>(
+        SkPoint::Make(0, i * kItemHeight),
+        SkiaGPUObject<DisplayList>(MakeListItem(i), unref_queue), false,
+        false));
+  }
+
+  auto capture = std::make_unique<LayerTreeCapture>(kFrameCount);
+  for (int frame = 0; frame < kFrameCount; frame++) {
+    auto scroll = std::make_shared<TransformLayer>(
+        SkMatrix::Translate(0, -frame * 7.0f));
+    for (auto& item : items) {
+      scroll->Add(item);
+    }
+    auto root = std::make_shared<ContainerLayer>();
+    root->Add(scroll);
+    LayerTree layer_tree(SkISize::Make(kFrameSize, kFrameSize), 2.0f);
+    layer_tree.set_root_layer(root);
+    capture->Capture(layer_tree);
+  }
+  return capture;
+}
+
+// Replays |capture| once per iteration through a new compositor context and
+// raster cache on the software backend. The time of every iteration is that
+// of all of the frames, and the counters report the distribution of the
+// times of the individual frames.
+void ReplayCapture(benchmark::State& state, const LayerTreeCapture& capture) {
+  int width = 0;
+  int height = 0;
+  for (const auto& frame : capture.frames()) {
+    width = std::max(width, frame.frame_size.width());
+    height = std::max(height, frame.frame_size.height());
+  }
+  auto surface = SkSurface::MakeRasterN32Premul(width, height);
+
+  std::vector<fml::TimeDelta> frame_times;
+  for (auto _ : state) {
+    // Every iteration starts with an empty raster cache.
+    CompositorContext compositor_context;
+    auto times = capture.Replay(compositor_context, surface.get(), nullptr);
+    frame_times.insert(frame_times.end(), times.begin(), times.end());
+  }
+
+  for (double percentile : {50.0, 90.0, 99.0, 100.0}) {
+    auto time = LayerTreeCapture::GetPercentile(frame_times, percentile);
+    state.counters["P" + std::to_string(static_cast<int>(percentile)) +
+                   "FrameMillis"] = time.ToMillisecondsF();
+  }
+}
+
+}  // namespace
+
+// Replays a captured scrolling list.
+static void BM_ReplayScrollingList(benchmark::State& state) {
+  fml::MessageLoop::EnsureInitializedForCurrentThread();
+  auto unref_queue = fml::MakeRefCounted<SkiaUnrefQueue>(
+      fml::MessageLoop::GetCurrent().GetTaskRunner(),
+      fml::TimeDelta::FromSeconds(0));
+  auto capture = CaptureScrollingList(state.range(0), unref_queue);
+  ReplayCapture(state, *capture);
+}
+
+// Replays the frames of an application, as captured by the
+// _flutter.captureLayerTrees service protocol extension and stored to the
+// file given with --layer-tree-capture=<file>.
+static void BM_ReplayCapturedLayerTrees(benchmark::State& state) {
+  std::string path;
+  if (!benchmarking::GetCommandLine().GetOptionValue("layer-tree-capture",
+                                                     &path)) {
+    state.SkipWithError("No capture given with --layer-tree-capture.");
+    return;
+  }
+  fml::MessageLoop::EnsureInitializedForCurrentThread();
+  auto unref_queue = fml::MakeRefCounted<SkiaUnrefQueue>(
+      fml::MessageLoop::GetCurrent().GetTaskRunner(),
+      fml::TimeDelta::FromSeconds(0));
+  auto capture = LayerTreeCapture::Deserialize(
+      SkData::MakeFromFileName(path.c_str()), unref_queue);
+  if (!capture || capture->frames().empty()) {
+    state.SkipWithError("Could not load the layer tree capture.");
+    return;
+  }
+  ReplayCapture(state, *capture);
+}
+
+BENCHMARK(BM_ReplayScrollingList)
+    ->RangeMultiplier(4)
+    ->Range(16, 256)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ReplayCapturedLayerTrees)->Unit(benchmark::kMillisecond);
+
+}  // namespace flutter
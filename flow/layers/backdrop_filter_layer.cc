@@ -4,11 +4,16 @@
 
 #include "flutter/flow/layers/backdrop_filter_layer.h"
 
+#include "flutter/flow/layer_tree_capture.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
 namespace flutter {
 
 BackdropFilterLayer::BackdropFilterLayer(sk_sp<SkImageFilter> filter,
                                          SkBlendMode blend_mode)
-    : filter_(std::move(filter)), blend_mode_(blend_mode) {}
+    : filter_(std::move(filter)),
+      blend_mode_(blend_mode),
+      cache_(filter_ ? std::make_shared<BackdropCache>() : nullptr) {}
 
 void BackdropFilterLayer::Diff(DiffContext* context, const Layer* old_layer) {
   DiffContext::AutoSubtreeRestore subtree(context);
@@ -24,6 +29,7 @@ void BackdropFilterLayer::Diff(DiffContext* context, const Layer* old_layer) {
   auto paint_bounds = context->GetCullRect();
   context->AddLayerBounds(paint_bounds);
 
+  backdrop_unchanged_ = false;
   if (filter_) {
     context->GetTransform().mapRect(&paint_bounds);
     auto input_filter_bounds = paint_bounds.roundOut();
@@ -31,6 +37,14 @@ void BackdropFilterLayer::Diff(DiffContext* context, const Layer* old_layer) {
         filter_->filterBounds(input_filter_bounds, context->GetTransform(),
                               SkImageFilter::kReverse_MapDirection);
     context->AddReadbackRegion(filter_bounds);
+
+    // The filtered backdrop of the previous frame is still valid if the
+    // filter is the same and nothing painted beneath this layer within the
+    // area the filter reads from changed.
+    if (prev && prev->filter_ == filter_) {
+      cache_ = prev->cache_;
+      backdrop_unchanged_ = !context->IntersectsDamage(filter_bounds);
+    }
   }
 
   DiffChildren(context, prev);
@@ -40,6 +54,12 @@ void BackdropFilterLayer::Diff(DiffContext* context, const Layer* old_layer) {
 
 void BackdropFilterLayer::Preroll(PrerollContext* context,
                                   const SkMatrix& matrix) {
+  // Whether the backdrop can be captured must be determined before the
+  // saveLayer state for the children is set up.
+  use_cached_backdrop_ =
+      filter_ && context->paints_directly_to_surface && backdrop_unchanged_;
+  backdrop_unchanged_ = false;
+
   Layer::AutoPrerollSaveLayerState save =
       Layer::AutoPrerollSaveLayerState::Create(context, true, bool(filter_));
   SkRect child_paint_bounds = SkRect::MakeEmpty();
@@ -54,6 +74,17 @@ void BackdropFilterLayer::Paint(PaintContext& context) const {
 
   SkPaint paint;
   paint.setBlendMode(blend_mode_);
+
+  // The backdrop is only captured while it stays the same from frame to
+  // frame. Otherwise Skia's backdrop saveLayer is as fast as a snapshot, and
+  // keeping the filtered backdrop would only hold on to its memory.
+  if (use_cached_backdrop_ && PaintWithCachedBackdrop(context, paint)) {
+    return;
+  }
+  if (cache_) {
+    cache_->image = nullptr;
+  }
+
   Layer::AutoSaveLayer save = Layer::AutoSaveLayer::Create(
       context,
       SkCanvas::SaveLayerRec{&paint_bounds(), &paint, filter_.get(), 0},
@@ -63,4 +94,110 @@ void BackdropFilterLayer::Paint(PaintContext& context) const {
   PaintChildren(context);
 }
 
+void BackdropFilterLayer::WriteToCapture(LayerCaptureWriter& writer) const {
+  writer.WriteType(LayerCaptureWriter::LayerType::kBackdropFilter);
+  writer.WriteFlattenable(filter_.get());
+  writer.WriteInt(static_cast<int32_t>(blend_mode_));
+  writer.WriteChildren(*this);
+}
+
+bool BackdropFilterLayer::BackdropCache::Matches(
+    const SkCanvas* canvas,
+    const GrDirectContext* gr_context,
+    const SkMatrix& matrix,
+    const SkIRect& device_bounds) const {
+  return image && this->canvas == canvas && this->gr_context == gr_context &&
+         this->matrix == matrix && this->device_bounds == device_bounds;
+}
+
+bool BackdropFilterLayer::PaintWithCachedBackdrop(PaintContext& context,
+                                                  const SkPaint& paint) const {
+  SkCanvas* canvas = context.leaf_nodes_canvas;
+  SkSurface* surface = canvas->getSurface();
+  const SkMatrix& matrix = canvas->getTotalMatrix();
+  // Snapshotting the surface yields the backdrop only if the canvas draws
+  // into it directly. Filters are applied in device space below, which is
+  // only equivalent to Skia's backdrop handling for scale/translate matrices.
+  if (!surface || !matrix.isScaleTranslate()) {
+    return false;
+  }
+
+  SkIRect device_bounds = matrix.mapRect(paint_bounds()).roundOut();
+  if (!device_bounds.intersect(canvas->getDeviceClipBounds())) {
+    return false;
+  }
+
+  if (cache_->Matches(canvas, context.gr_context, matrix, device_bounds)) {
+    TRACE_EVENT0("flutter", "BackdropFilterLayer::ReuseCachedBackdrop");
+  } else if (!UpdateBackdropCache(context, surface, matrix, device_bounds)) {
+    return false;
+  }
+
+  Layer::AutoSaveLayer save = Layer::AutoSaveLayer::Create(
+      context, paint_bounds(), &paint,
+      AutoSaveLayer::SaveMode::kLeafNodesCanvas);
+  {
+    SkAutoCanvasRestore auto_restore(canvas, true);
+    canvas->resetMatrix();
+    canvas->drawImageRect(cache_->image, cache_->src, cache_->dst,
+                          SkSamplingOptions(SkFilterMode::kLinear), nullptr,
+                          SkCanvas::kStrict_SrcRectConstraint);
+  }
+  PaintChildren(context);
+  return true;
+}
+
+bool BackdropFilterLayer::UpdateBackdropCache(
+    PaintContext& context,
+    SkSurface* surface,
+    const SkMatrix& matrix,
+    const SkIRect& device_bounds) const {
+  TRACE_EVENT0("flutter", "BackdropFilterLayer::UpdateBackdropCache");
+  cache_->image = nullptr;
+
+  SkIRect readback_bounds = filter_->filterBounds(
+      device_bounds, matrix, SkImageFilter::kReverse_MapDirection,
+      &device_bounds);
+  if (!readback_bounds.intersect(
+          SkIRect::MakeWH(surface->width(), surface->height()))) {
+    return false;
+  }
+  sk_sp<SkImage> backdrop = surface->makeImageSnapshot(readback_bounds);
+  if (!backdrop) {
+    return false;
+  }
+
+  // Maps from device space to the space of the backdrop image.
+  const SkMatrix image_from_device =
+      SkMatrix::Translate(-readback_bounds.x(), -readback_bounds.y());
+
+  // Apply the filter in the space of the backdrop image so that its
+  // parameters are scaled exactly like Skia would scale them for a backdrop
+  // saveLayer drawn with |matrix|.
+  SkMatrix filter_matrix = SkMatrix::Concat(image_from_device, matrix);
+  sk_sp<SkImageFilter> filter = filter_->makeWithLocalMatrix(filter_matrix);
+  const SkIRect clip_bounds =
+      image_from_device.mapRect(SkRect::Make(device_bounds)).roundOut();
+  SkIRect out_subset;
+  SkIPoint offset;
+  sk_sp<SkImage> filtered = backdrop->makeWithFilter(
+      context.gr_context, filter.get(),
+      SkIRect::MakeWH(backdrop->width(), backdrop->height()), clip_bounds,
+      &out_subset, &offset);
+  if (!filtered) {
+    return false;
+  }
+
+  cache_->canvas = context.leaf_nodes_canvas;
+  cache_->gr_context = context.gr_context;
+  cache_->matrix = matrix;
+  cache_->device_bounds = device_bounds;
+  cache_->image = std::move(filtered);
+  cache_->src = SkRect::Make(out_subset);
+  cache_->dst = SkRect::MakeXYWH(readback_bounds.x() + offset.x(),
+                                 readback_bounds.y() + offset.y(),
+                                 out_subset.width(), out_subset.height());
+  return true;
+}
+
 }  // namespace flutter
@@ -6,6 +6,7 @@
 #define FLUTTER_FLOW_LAYERS_BACKDROP_FILTER_LAYER_H_
 
 #include "flutter/flow/layers/container_layer.h"
+#include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkImageFilter.h"
 
 namespace flutter {
@@ -20,10 +21,63 @@ class BackdropFilterLayer : public ContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  void WriteToCapture(LayerCaptureWriter& writer) const override;
+
+  // Whether the last |Diff| found that nothing beneath this layer changed, so
+  // that the filtered backdrop of the previous frame can be reused. Exposed
+  // for testing.
+  bool backdrop_unchanged() const { return backdrop_unchanged_; }
+
+  // Whether a filtered backdrop is held for the next frame. Exposed for
+  // testing.
+  bool has_cached_backdrop() const { return cache_ && cache_->image; }
+
  private:
+  // The filtered backdrop painted by the layer in the previous frame. The
+  // cache is handed over from the layer this layer replaces during |Diff|,
+  // and its image is dropped as soon as the backdrop changes.
+  struct BackdropCache {
+    // Describes where the backdrop was captured; it can only be reused if the
+    // layer is painted with the same parameters.
+    const SkCanvas* canvas = nullptr;
+    const GrDirectContext* gr_context = nullptr;
+    SkMatrix matrix;
+    SkIRect device_bounds = SkIRect::MakeEmpty();
+
+    sk_sp<SkImage> image;
+    // The region of |image| holding the filtered backdrop and where it lands
+    // in device space.
+    SkRect src = SkRect::MakeEmpty();
+    SkRect dst = SkRect::MakeEmpty();
+
+    bool Matches(const SkCanvas* canvas,
+                 const GrDirectContext* gr_context,
+                 const SkMatrix& matrix,
+                 const SkIRect& device_bounds) const;
+  };
+
   sk_sp<SkImageFilter> filter_;
   SkBlendMode blend_mode_;
 
+  std::shared_ptr<BackdropCache> cache_;
+  // Set by |Diff| if nothing beneath the layer changed and latched by
+  // |Preroll|, so that frames that are not diffed never use the cache.
+  bool backdrop_unchanged_ = false;
+  bool use_cached_backdrop_ = false;
+
+  // Paints the layer from the filtered backdrop of the previous frame, or, if
+  // there is none yet, by snapshotting the surface backing the leaf nodes
+  // canvas and filtering it once for the frames that follow. Returns false if
+  // the backdrop cannot be captured, in which case the layer must be painted
+  // with a backdrop saveLayer instead.
+  bool PaintWithCachedBackdrop(PaintContext& context,
+                               const SkPaint& paint) const;
+
+  bool UpdateBackdropCache(PaintContext& context,
+                           SkSurface* surface,
+                           const SkMatrix& matrix,
+                           const SkIRect& device_bounds) const;
+
   FML_DISALLOW_COPY_AND_ASSIGN(BackdropFilterLayer);
 };
 
@@ -0,0 +1,140 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/display_list/display_list_builder.h"
+#include "flutter/flow/compositor_context.h"
+#include "flutter/flow/layers/backdrop_filter_layer.h"
+#include "flutter/flow/layers/clip_rect_layer.h"
+#include "flutter/flow/layers/display_list_layer.h"
+#include "flutter/flow/layers/layer_tree.h"
+#include "flutter/flow/layers/transform_layer.h"
+#include "flutter/fml/message_loop.h"
+#include "third_party/skia/include/effects/SkImageFilters.h"
+
+namespace flutter {
+
+namespace {
+
+constexpr int kFrameSize = 1024;
+constexpr int kItemCount = 32;
+constexpr SkScalar kItemHeight = 64.0f;
+constexpr SkScalar kAppBarHeight = 128.0f;
+
+sk_sp<DisplayList> MakeStripe(int index) {
+  DisplayListBuilder builder;
+  builder.setColor(index % 2 ? SK_ColorLTGRAY : SK_ColorWHITE);
+  builder.drawRect(SkRect::MakeWH(kFrameSize, kItemHeight));
+  builder.setAntiAlias(true);
+  builder.setColor(SK_ColorBLUE);
+  builder.drawCircle({kItemHeight / 2, kItemHeight / 2}, 24.0f);
+  return builder.Build();
+}
+
+// A progress bar in the app bar, which changes every frame.
+sk_sp<DisplayList> MakeProgressBar(int frame) {
+  DisplayListBuilder builder;
+  builder.setColor(SK_ColorBLACK);
+  builder.drawRect(SkRect::MakeXYWH(16.0f, kAppBarHeight - 24.0f,
+                                    (frame % 100) * 9.0f, 8.0f));
+  return builder.Build();
+}
+
+}  // namespace
+
+// Rasters a list beneath an app bar that blurs its backdrop, as the
+// rasterizer would on the software backend. The list is either static or
+// scrolls every frame, while a progress bar in the app bar always changes.
+// With |diff_frames|, frames are diffed against the previous frame, so that a
+// static backdrop is filtered once and then reused. Without it, every frame
+// paints the app bar with a backdrop saveLayer. The whole frame is repainted
+// either way.
+static void BM_BackdropFilter(benchmark::State& state,
+                              bool scrolling,
+                              bool diff_frames) {
+  fml::MessageLoop::EnsureInitializedForCurrentThread();
+  auto unref_queue = fml::MakeRefCounted<SkiaUnrefQueue>(
+      fml::MessageLoop::GetCurrent().GetTaskRunner(),
+      fml::TimeDelta::FromSeconds(0));
+  auto surface = SkSurface::MakeRasterN32Premul(kFrameSize, kFrameSize);
+  auto filter = SkImageFilters::Blur(20, 20, SkTileMode::kClamp, nullptr);
+
+  std::vector<std::shared_ptr<Layer>> items;
+  for (int i = 0; i < kItemCount; i++) {
+    items.push_back(std::make_shared<DisplayListLayer>(
+        SkPoint::Make(0, i * kItemHeight),
+        SkiaGPUObject<DisplayList>(MakeStripe(i), unref_queue), false, false));
+  }
+
+  CompositorContext compositor_context;
+  std::unique_ptr<LayerTree> prev_layer_tree;
+  std::shared_ptr<TransformLayer> scroll;
+  std::shared_ptr<ClipRectLayer> app_bar;
+  std::shared_ptr<BackdropFilterLayer> backdrop;
+  int frame = 0;
+  for (auto _ : state) {
+    std::unique_ptr<LayerTree> layer_tree;
+    {
+      benchmarking::ScopedPauseTiming pause(state);
+      if (!scroll || scrolling) {
+        auto new_scroll = std::make_shared<TransformLayer>(
+            SkMatrix::Translate(0, -(frame % 256) * 3.0f));
+        for (auto& item : items) {
+          new_scroll->Add(item);
+        }
+        if (scroll) {
+          new_scroll->AssignOldLayer(scroll.get());
+        }
+        scroll = std::move(new_scroll);
+      }
+      auto new_app_bar = std::make_shared<ClipRectLayer>(
+          SkRect::MakeWH(kFrameSize, kAppBarHeight), Clip::hardEdge);
+      auto new_backdrop =
+          std::make_shared<BackdropFilterLayer>(filter, SkBlendMode::kSrcOver);
+      new_backdrop->Add(std::make_shared<DisplayListLayer>(
+          SkPoint::Make(0, 0),
+          SkiaGPUObject<DisplayList>(MakeProgressBar(frame), unref_queue),
+          false, true));
+      new_app_bar->Add(new_backdrop);
+      if (app_bar) {
+        new_app_bar->AssignOldLayer(app_bar.get());
+        new_backdrop->AssignOldLayer(backdrop.get());
+      }
+      app_bar = std::move(new_app_bar);
+      backdrop = std::move(new_backdrop);
+
+      auto root = std::make_shared<ContainerLayer>();
+      root->Add(scroll);
+      root->Add(app_bar);
+      layer_tree = std::make_unique<LayerTree>(
+          SkISize::Make(kFrameSize, kFrameSize), 1.0f);
+      layer_tree->set_root_layer(root);
+    }
+
+    FrameDamage frame_damage;
+    frame_damage.SetPreviousLayerTree(prev_layer_tree.get());
+    frame_damage.AddAdditonalDamage(SkIRect::MakeWH(kFrameSize, kFrameSize));
+    {
+      auto scoped_frame = compositor_context.AcquireFrame(
+          nullptr, surface->getCanvas(), nullptr, SkMatrix::I(), false, true,
+          nullptr);
+      scoped_frame->Raster(*layer_tree, true,
+                           diff_frames ? &frame_damage : nullptr);
+    }
+    surface->flushAndSubmit(true);
+    prev_layer_tree = std::move(layer_tree);
+    frame++;
+  }
+}
+
+BENCHMARK_CAPTURE(BM_BackdropFilter, StaticDiffed, false, true)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_BackdropFilter, StaticNotDiffed, false, false)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_BackdropFilter, ScrollingDiffed, true, true)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_BackdropFilter, ScrollingNotDiffed, true, false)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace flutter
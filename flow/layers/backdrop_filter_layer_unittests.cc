@@ -5,14 +5,18 @@
 #include "flutter/flow/layers/backdrop_filter_layer.h"
 #include "flutter/flow/layers/clip_rect_layer.h"
 
+#include "flutter/flow/compositor_context.h"
 #include "flutter/flow/layers/clip_rect_layer.h"
+#include "flutter/flow/layers/layer_tree.h"
 #include "flutter/flow/layers/transform_layer.h"
 #include "flutter/flow/testing/diff_context_test.h"
 #include "flutter/flow/testing/layer_test.h"
 #include "flutter/flow/testing/mock_layer.h"
 #include "flutter/fml/macros.h"
 #include "flutter/testing/mock_canvas.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkImageFilter.h"
+#include "third_party/skia/include/core/SkSurface.h"
 #include "third_party/skia/include/effects/SkImageFilters.h"
 
 namespace flutter {
@@ -351,5 +355,167 @@ TEST_F(BackdropLayerDiffTest, BackdropLayerInvalidTransform) {
   EXPECT_EQ(damage.frame_damage, SkIRect::MakeWH(15, 15));
 }
 
+TEST_F(BackdropLayerDiffTest, BackdropUnchangedWhenNothingBeneathChanges) {
+  auto filter = SkImageFilters::Blur(10, 10, SkTileMode::kClamp, nullptr);
+  auto clip = std::make_shared<ClipRectLayer>(SkRect::MakeLTRB(20, 20, 60, 60),
+                                              Clip::hardEdge);
+  auto below = std::make_shared<MockLayer>(
+      SkPath().addRect(SkRect::MakeLTRB(30, 30, 50, 50)));
+
+  MockLayerTree l1(SkISize::Make(200, 200));
+  auto backdrop1 =
+      std::make_shared<BackdropFilterLayer>(filter, SkBlendMode::kSrcOver);
+  clip->Add(backdrop1);
+  l1.root()->Add(below);
+  l1.root()->Add(clip);
+  DiffLayerTree(l1, MockLayerTree(SkISize::Make(200, 200)));
+  EXPECT_FALSE(backdrop1->backdrop_unchanged());
+
+  // Path outside of the readback region (0, 0, 90, 90) changes.
+  MockLayerTree l2(SkISize::Make(200, 200));
+  l2.root()->Add(below);
+  l2.root()->Add(clip);
+  l2.root()->Add(std::make_shared<MockLayer>(
+      SkPath().addRect(SkRect::MakeLTRB(100, 100, 110, 110))));
+  DiffLayerTree(l2, l1);
+  EXPECT_TRUE(backdrop1->backdrop_unchanged());
+
+  // Layer beneath the backdrop changes within the readback region.
+  MockLayerTree l3(SkISize::Make(200, 200));
+  auto clip3 = std::make_shared<ClipRectLayer>(SkRect::MakeLTRB(20, 20, 60, 60),
+                                               Clip::hardEdge);
+  clip3->AssignOldLayer(clip.get());
+  auto backdrop3 =
+      std::make_shared<BackdropFilterLayer>(filter, SkBlendMode::kSrcOver);
+  backdrop3->AssignOldLayer(backdrop1.get());
+  clip3->Add(backdrop3);
+  l3.root()->Add(std::make_shared<MockLayer>(
+      SkPath().addRect(SkRect::MakeLTRB(80, 80, 85, 85))));
+  l3.root()->Add(clip3);
+  DiffLayerTree(l3, l2);
+  EXPECT_FALSE(backdrop3->backdrop_unchanged());
+
+  // Nothing beneath changes; the new layer replaces the old one.
+  MockLayerTree l4(SkISize::Make(200, 200));
+  auto clip4 = std::make_shared<ClipRectLayer>(SkRect::MakeLTRB(20, 20, 60, 60),
+                                               Clip::hardEdge);
+  clip4->AssignOldLayer(clip3.get());
+  auto backdrop4 =
+      std::make_shared<BackdropFilterLayer>(filter, SkBlendMode::kSrcOver);
+  backdrop4->AssignOldLayer(backdrop3.get());
+  clip4->Add(backdrop4);
+  l4.root()->Add(l3.root()->layers()[0]);
+  l4.root()->Add(clip4);
+  DiffLayerTree(l4, l3);
+  EXPECT_TRUE(backdrop4->backdrop_unchanged());
+}
+
+namespace {
+
+// Rasters frames that draw a rect beneath a backdrop blur into a surface that
+// supports readback, diffing every frame against the previous one.
+class BackdropFrameRasterizer {
+ public:
+  static constexpr int kSize = 100;
+
+  BackdropFrameRasterizer()
+      : surface_(SkSurface::MakeRasterN32Premul(kSize, kSize)) {}
+
+  SkBitmap Raster(const std::shared_ptr<Layer>& below,
+                  std::shared_ptr<BackdropFilterLayer> backdrop) {
+    if (backdrop_) {
+      backdrop->AssignOldLayer(backdrop_.get());
+    }
+    backdrop_ = std::move(backdrop);
+    auto root = std::make_shared<ContainerLayer>();
+    root->Add(below);
+    root->Add(backdrop_);
+    auto layer_tree =
+        std::make_unique<LayerTree>(SkISize::Make(kSize, kSize), 1.0f);
+    layer_tree->set_root_layer(root);
+
+    FrameDamage frame_damage;
+    frame_damage.SetPreviousLayerTree(prev_layer_tree_.get());
+    // Repaint the whole frame, as if the buffer contents were lost.
+    frame_damage.AddAdditonalDamage(SkIRect::MakeWH(kSize, kSize));
+    {
+      auto frame = compositor_context_.AcquireFrame(
+          nullptr, surface_->getCanvas(), nullptr, SkMatrix::I(), false, true,
+          nullptr);
+      frame->Raster(*layer_tree, true, &frame_damage);
+    }
+    prev_layer_tree_ = std::move(layer_tree);
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(kSize, kSize);
+    EXPECT_TRUE(surface_->readPixels(bitmap, 0, 0));
+    return bitmap;
+  }
+
+ private:
+  CompositorContext compositor_context_;
+  sk_sp<SkSurface> surface_;
+  std::shared_ptr<BackdropFilterLayer> backdrop_;
+  std::unique_ptr<LayerTree> prev_layer_tree_;
+};
+
+void ExpectSamePixels(const SkBitmap& expected, const SkBitmap& actual) {
+  for (int y = 0; y < expected.height(); y++) {
+    for (int x = 0; x < expected.width(); x++) {
+      SkColor a = expected.getColor(x, y);
+      SkColor b = actual.getColor(x, y);
+      for (int shift : {0, 8, 16, 24}) {
+        ASSERT_LE(std::abs(static_cast<int>((a >> shift) & 0xFF) -
+                           static_cast<int>((b >> shift) & 0xFF)),
+                  1)
+            << "at " << x << ", " << y;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST_F(BackdropFilterLayerTest, CachesBackdropOnlyWhileItIsUnchanged) {
+  auto filter = SkImageFilters::Blur(4, 4, SkTileMode::kClamp, nullptr);
+  auto make_backdrop = [&filter]() {
+    auto backdrop =
+        std::make_shared<BackdropFilterLayer>(filter, SkBlendMode::kSrcOver);
+    backdrop->Add(std::make_shared<MockLayer>(
+        SkPath().addRect(SkRect::MakeLTRB(60, 60, 70, 70)),
+        SkPaint(SkColors::kRed)));
+    return backdrop;
+  };
+  auto below = std::make_shared<MockLayer>(
+      SkPath().addRect(SkRect::MakeLTRB(20, 20, 50, 50)),
+      SkPaint(SkColors::kBlue));
+  BackdropFrameRasterizer rasterizer;
+
+  // The first frame is not diffed against anything, so Skia's backdrop
+  // saveLayer paints the layer.
+  auto backdrop1 = make_backdrop();
+  SkBitmap expected = rasterizer.Raster(below, backdrop1);
+  EXPECT_FALSE(backdrop1->has_cached_backdrop());
+
+  // Nothing beneath the layer changed, so the backdrop is captured once...
+  auto backdrop2 = make_backdrop();
+  ExpectSamePixels(expected, rasterizer.Raster(below, backdrop2));
+  EXPECT_TRUE(backdrop2->has_cached_backdrop());
+
+  // ... and reused by the frames that follow.
+  auto backdrop3 = make_backdrop();
+  ExpectSamePixels(expected, rasterizer.Raster(below, backdrop3));
+  EXPECT_TRUE(backdrop3->has_cached_backdrop());
+
+  // The layer beneath changes, so the layer goes back to a backdrop saveLayer
+  // and the cached backdrop is released.
+  auto moved = std::make_shared<MockLayer>(
+      SkPath().addRect(SkRect::MakeLTRB(30, 30, 60, 60)),
+      SkPaint(SkColors::kBlue));
+  auto backdrop4 = make_backdrop();
+  rasterizer.Raster(moved, backdrop4);
+  EXPECT_FALSE(backdrop4->has_cached_backdrop());
+}
+
 }  // namespace testing
 }  // namespace flutter
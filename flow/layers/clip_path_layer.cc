@@ -3,6 +3,8 @@
 // found in the LICENSE file.
 
 #include "flutter/flow/layers/clip_path_layer.h"
+
+#include "flutter/flow/layer_tree_capture.h"
 #include "flutter/flow/paint_utils.h"
 
 namespace flutter {
@@ -76,4 +78,11 @@ void ClipPathLayer::Paint(PaintContext& context) const {
   }
 }
 
+void ClipPathLayer::WriteToCapture(LayerCaptureWriter& writer) const {
+  writer.WriteType(LayerCaptureWriter::LayerType::kClipPath);
+  writer.WritePath(clip_path_);
+  writer.WriteInt(clip_behavior_);
+  writer.WriteChildren(*this);
+}
+
 }  // namespace flutter
@@ -3,6 +3,8 @@
 // found in the LICENSE file.
 
 #include "flutter/flow/layers/clip_rect_layer.h"
+
+#include "flutter/flow/layer_tree_capture.h"
 #include "flutter/flow/paint_utils.h"
 
 namespace flutter {
@@ -75,4 +77,11 @@ void ClipRectLayer::Paint(PaintContext& context) const {
   }
 }
 
+void ClipRectLayer::WriteToCapture(LayerCaptureWriter& writer) const {
+  writer.WriteType(LayerCaptureWriter::LayerType::kClipRect);
+  writer.WriteRect(clip_rect_);
+  writer.WriteInt(clip_behavior_);
+  writer.WriteChildren(*this);
+}
+
 }  // namespace flutter
@@ -3,6 +3,8 @@
 // found in the LICENSE file.
 
 #include "flutter/flow/layers/clip_rrect_layer.h"
+
+#include "flutter/flow/layer_tree_capture.h"
 #include "flutter/flow/paint_utils.h"
 
 namespace flutter {
@@ -76,4 +78,11 @@ void ClipRRectLayer::Paint(PaintContext& context) const {
   }
 }
 
+void ClipRRectLayer::WriteToCapture(LayerCaptureWriter& writer) const {
+  writer.WriteType(LayerCaptureWriter::LayerType::kClipRRect);
+  writer.WriteRRect(clip_rrect_);
+  writer.WriteInt(clip_behavior_);
+  writer.WriteChildren(*this);
+}
+
 }  // namespace flutter
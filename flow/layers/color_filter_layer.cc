@@ -4,6 +4,8 @@
 
 #include "flutter/flow/layers/color_filter_layer.h"
 
+#include "flutter/flow/layer_tree_capture.h"
+
 namespace flutter {
 
 ColorFilterLayer::ColorFilterLayer(sk_sp<SkColorFilter> filter)
@@ -43,4 +45,10 @@ void ColorFilterLayer::Paint(PaintContext& context) const {
   PaintChildren(context);
 }
 
+void ColorFilterLayer::WriteToCapture(LayerCaptureWriter& writer) const {
+  writer.WriteType(LayerCaptureWriter::LayerType::kColorFilter);
+  writer.WriteFlattenable(filter_.get());
+  writer.WriteChildren(*this);
+}
+
 }  // namespace flutter
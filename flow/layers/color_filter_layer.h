@@ -20,6 +20,8 @@ class ColorFilterLayer : public ContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  void WriteToCapture(LayerCaptureWriter& writer) const override;
+
  private:
   sk_sp<SkColorFilter> filter_;
 
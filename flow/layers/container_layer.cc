@@ -6,6 +6,8 @@
 
 #include <optional>
 
+#include "flutter/flow/layer_tree_capture.h"
+
 namespace flutter {
 
 ContainerLayer::ContainerLayer() {}
@@ -121,6 +123,11 @@ void ContainerLayer::Paint(PaintContext& context) const {
   PaintChildren(context);
 }
 
+void ContainerLayer::WriteToCapture(LayerCaptureWriter& writer) const {
+  writer.WriteType(LayerCaptureWriter::LayerType::kContainer);
+  writer.WriteChildren(*this);
+}
+
 static bool safe_intersection_test(const SkRect* rect1, const SkRect& rect2) {
   if (rect1->isEmpty() || rect2.isEmpty()) {
     return false;
@@ -147,7 +154,11 @@ void ContainerLayer::PrerollChildren(PrerollContext* context,
     // and allow it to override the answer during its |Preroll|
     context->subtree_can_inherit_opacity = layer->layer_can_inherit_opacity();
 
-    layer->Preroll(context, child_matrix);
+    {
+      LayerCostTracker::ScopedPreroll cost(context->layer_cost_tracker,
+                                           layer.get());
+      layer->Preroll(context, child_matrix);
+    }
 
     subtree_can_inherit_opacity =
         subtree_can_inherit_opacity && context->subtree_can_inherit_opacity;
@@ -183,6 +194,9 @@ void ContainerLayer::PaintChildren(PaintContext& context) const {
   // and the trace event on this common function has a small overhead.
   for (auto& layer : layers_) {
     if (layer->needs_painting(context)) {
+      LayerCostTracker::ScopedPaint cost(context.layer_cost_tracker,
+                                         layer.get(),
+                                         context.leaf_nodes_canvas);
       layer->Paint(context);
     }
   }
@@ -23,6 +23,8 @@ class ContainerLayer : public Layer {
   void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
   void Paint(PaintContext& context) const override;
 
+  void WriteToCapture(LayerCaptureWriter& writer) const override;
+
   const std::vector<std::shared_ptr<Layer>>& layers() const { return layers_; }
 
   virtual void DiffChildren(DiffContext* context,
@@ -5,6 +5,7 @@
 #include "flutter/flow/layers/display_list_layer.h"
 
 #include "flutter/display_list/display_list_builder.h"
+#include "flutter/flow/layer_tree_capture.h"
 
 namespace flutter {
 
@@ -67,6 +68,7 @@ bool DisplayListLayer::Compare(DiffContext::Statistics& statistics,
   const auto op_bytes_1 = dl1->bytes();
   const auto op_bytes_2 = dl2->bytes();
   if (op_cnt_1 != op_cnt_2 || op_bytes_1 != op_bytes_2 ||
+      dl1->content_hash() != dl2->content_hash() ||
       dl1->bounds() != dl2->bounds()) {
     statistics.AddNewPicture();
     return false;
@@ -133,7 +135,15 @@ void DisplayListLayer::Paint(PaintContext& context) const {
   }
 
   display_list()->RenderTo(context.leaf_nodes_canvas,
-                           context.inherited_opacity);
+                           context.inherited_opacity, context.path_cache);
+}
+
+void DisplayListLayer::WriteToCapture(LayerCaptureWriter& writer) const {
+  writer.WriteType(LayerCaptureWriter::LayerType::kDisplayList);
+  writer.WritePoint(offset_);
+  writer.WriteBool(is_complex_);
+  writer.WriteBool(will_change_);
+  writer.WriteDisplayList(display_list());
 }
 
 }  // namespace flutter
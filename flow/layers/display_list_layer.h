@@ -36,6 +36,8 @@ class DisplayListLayer : public Layer {
 
   void Paint(PaintContext& context) const override;
 
+  void WriteToCapture(LayerCaptureWriter& writer) const override;
+
  private:
   SkPoint offset_;
   flutter::SkiaGPUObject<DisplayList> display_list_;
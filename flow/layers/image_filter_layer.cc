@@ -4,6 +4,8 @@
 
 #include "flutter/flow/layers/image_filter_layer.h"
 
+#include "flutter/flow/layer_tree_capture.h"
+
 namespace flutter {
 
 ImageFilterLayer::ImageFilterLayer(sk_sp<SkImageFilter> filter)
@@ -120,4 +122,10 @@ void ImageFilterLayer::Paint(PaintContext& context) const {
   PaintChildren(context);
 }
 
+void ImageFilterLayer::WriteToCapture(LayerCaptureWriter& writer) const {
+  writer.WriteType(LayerCaptureWriter::LayerType::kImageFilter);
+  writer.WriteFlattenable(filter_.get());
+  writer.WriteChildren(*this);
+}
+
 }  // namespace flutter
@@ -4,6 +4,7 @@
 
 #include "flutter/flow/layers/layer.h"
 
+#include "flutter/flow/layer_tree_capture.h"
 #include "flutter/flow/paint_utils.h"
 #include "third_party/skia/include/core/SkColorFilter.h"
 
@@ -29,6 +30,10 @@ uint64_t Layer::NextUniqueID() {
 
 void Layer::Preroll(PrerollContext* context, const SkMatrix& matrix) {}
 
+void Layer::WriteToCapture(LayerCaptureWriter& writer) const {
+  writer.WriteType(LayerCaptureWriter::LayerType::kPlaceholder);
+}
+
 Layer::AutoPrerollSaveLayerState::AutoPrerollSaveLayerState(
     PrerollContext* preroll_context,
     bool save_layer_is_active,
@@ -38,7 +43,10 @@ Layer::AutoPrerollSaveLayerState::AutoPrerollSaveLayerState(
       layer_itself_performs_readback_(layer_itself_performs_readback) {
   if (save_layer_is_active_) {
     prev_surface_needs_readback_ = preroll_context_->surface_needs_readback;
+    prev_paints_directly_to_surface_ =
+        preroll_context_->paints_directly_to_surface;
     preroll_context_->surface_needs_readback = false;
+    preroll_context_->paints_directly_to_surface = false;
   }
 }
 
@@ -54,6 +62,8 @@ Layer::AutoPrerollSaveLayerState::~AutoPrerollSaveLayerState() {
   if (save_layer_is_active_) {
     preroll_context_->surface_needs_readback =
         (prev_surface_needs_readback_ || layer_itself_performs_readback_);
+    preroll_context_->paints_directly_to_surface =
+        prev_paints_directly_to_surface_;
   }
 }
 
@@ -67,6 +77,9 @@ Layer::AutoSaveLayer::AutoSaveLayer(const PaintContext& paint_context,
                   ? *(paint_context.internal_nodes_canvas)
                   : *(paint_context.leaf_nodes_canvas)) {
   TRACE_EVENT0("flutter", "Canvas::saveLayer");
+  if (paint_context.layer_cost_tracker) {
+    paint_context.layer_cost_tracker->AddSaveLayer();
+  }
   canvas_.saveLayer(bounds_, paint);
 }
 
@@ -79,6 +92,9 @@ Layer::AutoSaveLayer::AutoSaveLayer(const PaintContext& paint_context,
                   ? *(paint_context.internal_nodes_canvas)
                   : *(paint_context.leaf_nodes_canvas)) {
   TRACE_EVENT0("flutter", "Canvas::saveLayer");
+  if (paint_context.layer_cost_tracker) {
+    paint_context.layer_cost_tracker->AddSaveLayer();
+  }
   canvas_.saveLayer(layer_rec);
 }
 
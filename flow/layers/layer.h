@@ -9,9 +9,11 @@
 #include <vector>
 
 #include "flutter/common/graphics/texture.h"
+#include "flutter/display_list/display_list_path_cache.h"
 #include "flutter/flow/diff_context.h"
 #include "flutter/flow/embedded_views.h"
 #include "flutter/flow/instrumentation.h"
+#include "flutter/flow/layer_cost_tracker.h"
 #include "flutter/flow/raster_cache.h"
 #include "flutter/fml/build_config.h"
 #include "flutter/fml/compiler_specific.h"
@@ -80,8 +82,19 @@ struct PrerollContext {
   // than to remember the value so that it can choose the right strategy
   // for its |Paint| method.
   bool subtree_can_inherit_opacity = false;
+
+  // This value indicates that the layer being prerolled will paint directly
+  // into the surface backing the leaf nodes canvas, i.e. the surface supports
+  // readback and no ancestor paints this subtree into a saveLayer. Layers that
+  // read back from the surface can then snapshot it instead of relying on a
+  // backdrop saveLayer. It is maintained by |AutoPrerollSaveLayerState|.
+  bool paints_directly_to_surface = false;
+
+  // Records the cost of each layer. Null unless the frame is tracked.
+  LayerCostTracker* layer_cost_tracker = nullptr;
 };
 
+class LayerCaptureWriter;
 class PictureLayer;
 class DisplayListLayer;
 class PerformanceOverlayLayer;
@@ -143,6 +156,7 @@ class Layer {
     bool layer_itself_performs_readback_;
 
     bool prev_surface_needs_readback_;
+    bool prev_paints_directly_to_surface_;
   };
 
   struct PaintContext {
@@ -174,6 +188,18 @@ class Layer {
     // |saveLayer| with an |SkPaint| initialized to this alphaf value and
     // a |kSrcOver| blend mode.
     SkScalar inherited_opacity = SK_Scalar1;
+
+    // Records the cost of each layer. Null unless the frame is tracked.
+    LayerCostTracker* layer_cost_tracker = nullptr;
+
+    // The cost tracker of the compositor, whether or not the frame is
+    // tracked, for the performance overlay to display the costs and to
+    // request tracking of the next frame. May be null.
+    LayerCostTracker* compositor_cost_tracker = nullptr;
+
+    // Caches the coverage masks of paths drawn onto raster canvases. May be
+    // null.
+    DisplayListPathCache* path_cache = nullptr;
   };
 
   class AutoCachePaint {
@@ -258,6 +284,13 @@ class Layer {
 
   virtual void Paint(PaintContext& context) const = 0;
 
+  // Writes the type and the parameters of this layer to |writer|, so that a
+  // captured frame can be replayed from its serialized form. Container layers
+  // write their children as well. Layers that depend on the running
+  // application, such as textures and platform views, are written as
+  // placeholders that paint nothing.
+  virtual void WriteToCapture(LayerCaptureWriter& writer) const;
+
   bool subtree_has_platform_view() const { return subtree_has_platform_view_; }
   void set_subtree_has_platform_view(bool value) {
     subtree_has_platform_view_ = value;
@@ -50,7 +50,13 @@ bool LayerTree::Preroll(CompositorContext::ScopedFrame& frame,
       frame.context().texture_registry(),
       checkerboard_offscreen_layers_,
       device_pixel_ratio_};
+  context.paints_directly_to_surface = frame.surface_supports_readback();
+  LayerCostTracker& cost_tracker = frame.context().layer_cost_tracker();
+  context.layer_cost_tracker =
+      cost_tracker.is_tracking() ? &cost_tracker : nullptr;
 
+  LayerCostTracker::ScopedPreroll cost(context.layer_cost_tracker,
+                                       root_layer_.get());
   root_layer_->Preroll(&context, frame.root_surface_transformation());
   return context.surface_needs_readback;
 }
@@ -85,8 +91,18 @@ void LayerTree::Paint(CompositorContext::ScopedFrame& frame,
       ignore_raster_cache ? nullptr : &frame.context().raster_cache(),
       checkerboard_offscreen_layers_,
       device_pixel_ratio_};
+  LayerCostTracker& cost_tracker = frame.context().layer_cost_tracker();
+  context.layer_cost_tracker =
+      cost_tracker.is_tracking() ? &cost_tracker : nullptr;
+  context.compositor_cost_tracker = &cost_tracker;
+  // Masks are drawn at quarter pixel offsets, so they are left out along
+  // with the raster cache when exact rendering is needed.
+  context.path_cache =
+      ignore_raster_cache ? nullptr : &frame.context().path_cache();
 
   if (root_layer_->needs_painting(context)) {
+    LayerCostTracker::ScopedPaint cost(context.layer_cost_tracker,
+                                       root_layer_.get(), frame.canvas());
     root_layer_->Paint(context);
   }
 }
@@ -39,6 +39,11 @@ class LayerTree {
 
   Layer* root_layer() const { return root_layer_.get(); }
 
+  // The root layer, for callers that keep the layers alive beyond this tree.
+  const std::shared_ptr<Layer>& shared_root_layer() const {
+    return root_layer_;
+  }
+
   void set_root_layer(std::shared_ptr<Layer> root_layer) {
     root_layer_ = std::move(root_layer);
   }
@@ -4,6 +4,7 @@
 
 #include "flutter/flow/layers/opacity_layer.h"
 
+#include "flutter/flow/layer_tree_capture.h"
 #include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/core/SkPaint.h"
 
@@ -119,4 +120,11 @@ void OpacityLayer::Paint(PaintContext& context) const {
   PaintChildren(context);
 }
 
+void OpacityLayer::WriteToCapture(LayerCaptureWriter& writer) const {
+  writer.WriteType(LayerCaptureWriter::LayerType::kOpacity);
+  writer.WriteInt(alpha_);
+  writer.WritePoint(offset_);
+  writer.WriteChildren(*this);
+}
+
 }  // namespace flutter
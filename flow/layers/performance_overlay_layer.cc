@@ -41,6 +41,51 @@ void VisualizeStopWatch(SkCanvas* canvas,
   }
 }
 
+// Outlines the most expensive layers of the last tracked frame on the surface,
+// labelled with their rank and raster time.
+void VisualizeLayerCosts(SkCanvas* canvas,
+                         const LayerCostTracker& tracker,
+                         const std::string& font_path) {
+  SkFont font;
+  if (font_path != "") {
+    font = SkFont(SkTypeface::MakeFromFile(font_path.c_str()));
+  }
+  font.setSize(15);
+
+  SkAutoCanvasRestore save(canvas, true);
+  // The bounds of the layers are in device coordinates.
+  canvas->resetMatrix();
+  SkPaint outline;
+  outline.setStyle(SkPaint::kStroke_Style);
+  outline.setStrokeWidth(3);
+  SkPaint label;
+  auto top_layers = tracker.GetTopLayers(LayerCostTracker::kTopLayerCount);
+  for (size_t i = 0; i < top_layers.size(); i++) {
+    const auto& frame_cost = top_layers[i];
+    if (frame_cost.device_bounds.isEmpty()) {
+      continue;
+    }
+    // From red for the most expensive layer to yellow for the least.
+    const SkColor color = SkColorSetARGB(
+        0xFF, 0xFF, 0xFF * i / LayerCostTracker::kTopLayerCount, 0x00);
+    outline.setColor(color);
+    canvas->drawRect(frame_cost.device_bounds, outline);
+
+    std::stringstream stream;
+    stream.setf(std::ios::fixed | std::ios::showpoint);
+    stream << std::setprecision(2);
+    stream << "#" << (i + 1) << "  "
+           << frame_cost.cost.total_time().ToMillisecondsF() << " ms";
+    auto text = stream.str();
+    label.setColor(color);
+    canvas->drawTextBlob(
+        SkTextBlob::MakeFromText(text.c_str(), text.size(), font,
+                                 SkTextEncoding::kUTF8),
+        frame_cost.device_bounds.x() + 4, frame_cost.device_bounds.y() + 18,
+        label);
+  }
+}
+
 }  // namespace
 
 sk_sp<SkTextBlob> PerformanceOverlayLayer::MakeStatisticsText(
@@ -109,6 +154,13 @@ void PerformanceOverlayLayer::Paint(PaintContext& context) const {
                      width, height - padding,
                      options_ & kVisualizeEngineStatistics,
                      options_ & kDisplayEngineStatistics, "UI", font_path_);
+
+  if ((options_ & kVisualizeLayerCosts) && context.compositor_cost_tracker) {
+    // Keep tracking the costs of the layers for as long as they are shown.
+    context.compositor_cost_tracker->RequestNextFrame();
+    VisualizeLayerCosts(context.leaf_nodes_canvas,
+                        *context.compositor_cost_tracker, font_path_);
+  }
 }
 
 }  // namespace flutter
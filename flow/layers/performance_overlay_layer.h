@@ -19,6 +19,7 @@ const int kDisplayRasterizerStatistics = 1 << 0;
 const int kVisualizeRasterizerStatistics = 1 << 1;
 const int kDisplayEngineStatistics = 1 << 2;
 const int kVisualizeEngineStatistics = 1 << 3;
+const int kVisualizeLayerCosts = 1 << 4;
 
 class PerformanceOverlayLayer : public Layer {
  public:
@@ -4,7 +4,9 @@
 
 #include "flutter/flow/layers/physical_shape_layer.h"
 
+#include "flutter/display_list/display_list_builder.h"
 #include "flutter/display_list/display_list_canvas_dispatcher.h"
+#include "flutter/flow/layer_tree_capture.h"
 #include "flutter/flow/paint_utils.h"
 
 namespace flutter {
@@ -67,7 +69,30 @@ void PhysicalShapeLayer::Preroll(PrerollContext* context,
     // children to it so we don't need to join the child paint bounds.
     set_paint_bounds(DisplayListCanvasDispatcher::ComputeShadowBounds(
         path_, elevation_, context->frame_device_pixel_ratio, matrix));
+
+    if (auto* cache = context->raster_cache) {
+      TRACE_EVENT0("flutter", "PhysicalShapeLayer::RasterCache (Preroll)");
+      UpdateShadowDisplayList(context->frame_device_pixel_ratio);
+      cache->PrepareShadow(
+          context, shadow_display_list_.get(),
+          paint_bounds().makeOffset(-shadow_offset_.x(), -shadow_offset_.y()),
+          matrix, shadow_offset_);
+    }
+  }
+}
+
+void PhysicalShapeLayer::UpdateShadowDisplayList(SkScalar dpr) {
+  if (shadow_display_list_ && shadow_dpr_ == dpr) {
+    return;
   }
+  const SkRect& bounds = path_.getBounds();
+  shadow_offset_ = SkPoint::Make(bounds.fLeft, bounds.fTop);
+  DisplayListBuilder builder;
+  builder.drawShadow(path_.makeOffset(-bounds.fLeft, -bounds.fTop),
+                     shadow_color_, elevation_, SkColorGetA(color_) != 0xff,
+                     dpr);
+  shadow_display_list_ = builder.Build();
+  shadow_dpr_ = dpr;
 }
 
 void PhysicalShapeLayer::Paint(PaintContext& context) const {
@@ -75,9 +100,16 @@ void PhysicalShapeLayer::Paint(PaintContext& context) const {
   FML_DCHECK(needs_painting(context));
 
   if (elevation_ != 0) {
-    DisplayListCanvasDispatcher::DrawShadow(
-        context.leaf_nodes_canvas, path_, shadow_color_, elevation_,
-        SkColorGetA(color_) != 0xff, context.frame_device_pixel_ratio);
+    if (context.raster_cache && shadow_display_list_ &&
+        context.raster_cache->DrawShadow(*shadow_display_list_,
+                                         *context.leaf_nodes_canvas,
+                                         shadow_offset_)) {
+      TRACE_EVENT_INSTANT0("flutter", "raster cache hit");
+    } else {
+      DisplayListCanvasDispatcher::DrawShadow(
+          context.leaf_nodes_canvas, path_, shadow_color_, elevation_,
+          SkColorGetA(color_) != 0xff, context.frame_device_pixel_ratio);
+    }
   }
 
   // Call drawPath without clip if possible for better performance.
@@ -85,7 +117,10 @@ void PhysicalShapeLayer::Paint(PaintContext& context) const {
   paint.setColor(color_);
   paint.setAntiAlias(true);
   if (clip_behavior_ != Clip::antiAliasWithSaveLayer) {
-    context.leaf_nodes_canvas->drawPath(path_, paint);
+    if (!context.path_cache || !context.path_cache->DrawPath(
+                                   context.leaf_nodes_canvas, path_, paint)) {
+      context.leaf_nodes_canvas->drawPath(path_, paint);
+    }
   }
 
   int saveCount = context.internal_nodes_canvas->save();
@@ -124,4 +159,14 @@ void PhysicalShapeLayer::Paint(PaintContext& context) const {
   }
 }
 
+void PhysicalShapeLayer::WriteToCapture(LayerCaptureWriter& writer) const {
+  writer.WriteType(LayerCaptureWriter::LayerType::kPhysicalShape);
+  writer.WriteInt(color_);
+  writer.WriteInt(shadow_color_);
+  writer.WriteScalar(elevation_);
+  writer.WritePath(path_);
+  writer.WriteInt(clip_behavior_);
+  writer.WriteChildren(*this);
+}
+
 }  // namespace flutter
@@ -5,6 +5,7 @@
 #ifndef FLUTTER_FLOW_LAYERS_PHYSICAL_SHAPE_LAYER_H_
 #define FLUTTER_FLOW_LAYERS_PHYSICAL_SHAPE_LAYER_H_
 
+#include "flutter/display_list/display_list.h"
 #include "flutter/flow/layers/container_layer.h"
 
 namespace flutter {
@@ -23,6 +24,8 @@ class PhysicalShapeLayer : public ContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  void WriteToCapture(LayerCaptureWriter& writer) const override;
+
   bool UsesSaveLayer() const {
     return clip_behavior_ == Clip::antiAliasWithSaveLayer;
   }
@@ -30,11 +33,21 @@ class PhysicalShapeLayer : public ContainerLayer {
   float elevation() const { return elevation_; }
 
  private:
+  // Records the shadow of |path_| moved so that its bounds start at the
+  // origin, so that the raster cache can share it between layers with the
+  // same shape at different positions.
+  void UpdateShadowDisplayList(SkScalar dpr);
+
   SkColor color_;
   SkColor shadow_color_;
   float elevation_ = 0.0f;
   SkPath path_;
   Clip clip_behavior_;
+
+  sk_sp<DisplayList> shadow_display_list_;
+  // Moves the shadow of |shadow_display_list_| back to |path_|.
+  SkPoint shadow_offset_;
+  SkScalar shadow_dpr_ = 0.0f;
 };
 
 }  // namespace flutter
@@ -4,6 +4,7 @@
 
 #include "flutter/flow/layers/picture_layer.h"
 
+#include "flutter/flow/layer_tree_capture.h"
 #include "flutter/fml/logging.h"
 #include "third_party/skia/include/core/SkSerialProcs.h"
 
@@ -155,4 +156,12 @@ void PictureLayer::Paint(PaintContext& context) const {
   picture()->playback(context.leaf_nodes_canvas);
 }
 
+void PictureLayer::WriteToCapture(LayerCaptureWriter& writer) const {
+  writer.WriteType(LayerCaptureWriter::LayerType::kPicture);
+  writer.WritePoint(offset_);
+  writer.WriteBool(is_complex_);
+  writer.WriteBool(will_change_);
+  writer.WritePicture(picture());
+}
+
 }  // namespace flutter
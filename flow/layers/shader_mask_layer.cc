@@ -4,6 +4,8 @@
 
 #include "flutter/flow/layers/shader_mask_layer.h"
 
+#include "flutter/flow/layer_tree_capture.h"
+
 namespace flutter {
 
 ShaderMaskLayer::ShaderMaskLayer(sk_sp<SkShader> shader,
@@ -52,4 +54,12 @@ void ShaderMaskLayer::Paint(PaintContext& context) const {
       SkRect::MakeWH(mask_rect_.width(), mask_rect_.height()), paint);
 }
 
+void ShaderMaskLayer::WriteToCapture(LayerCaptureWriter& writer) const {
+  writer.WriteType(LayerCaptureWriter::LayerType::kShaderMask);
+  writer.WriteFlattenable(shader_.get());
+  writer.WriteRect(mask_rect_);
+  writer.WriteInt(static_cast<int32_t>(blend_mode_));
+  writer.WriteChildren(*this);
+}
+
 }  // namespace flutter
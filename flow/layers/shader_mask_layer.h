@@ -22,6 +22,8 @@ class ShaderMaskLayer : public ContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  void WriteToCapture(LayerCaptureWriter& writer) const override;
+
  private:
   sk_sp<SkShader> shader_;
   SkRect mask_rect_;
@@ -6,6 +6,8 @@
 
 #include <optional>
 
+#include "flutter/flow/layer_tree_capture.h"
+
 namespace flutter {
 
 TransformLayer::TransformLayer(const SkMatrix& transform)
@@ -77,4 +79,10 @@ void TransformLayer::Paint(PaintContext& context) const {
   PaintChildren(context);
 }
 
+void TransformLayer::WriteToCapture(LayerCaptureWriter& writer) const {
+  writer.WriteType(LayerCaptureWriter::LayerType::kTransform);
+  writer.WriteMatrix(transform_);
+  writer.WriteChildren(*this);
+}
+
 }  // namespace flutter
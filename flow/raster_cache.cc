@@ -4,9 +4,11 @@
 
 #include "flutter/flow/raster_cache.h"
 
+#include <cmath>
 #include <vector>
 
 #include "flutter/common/constants.h"
+#include "flutter/display_list/display_list_complexity.h"
 #include "flutter/flow/layers/layer.h"
 #include "flutter/flow/paint_utils.h"
 #include "flutter/fml/logging.h"
@@ -38,6 +40,20 @@ void RasterCacheResult::draw(SkCanvas& canvas, const SkPaint* paint) const {
                    paint);
 }
 
+void RasterCacheResult::drawScaled(SkCanvas& canvas,
+                                   const SkMatrix& raster_matrix,
+                                   const SkSamplingOptions& sampling,
+                                   const SkPaint* paint) const {
+  TRACE_EVENT0("flutter", "RasterCacheResult::drawScaled");
+  SkAutoCanvasRestore auto_restore(&canvas, true);
+  SkIRect bounds = RasterCache::GetDeviceBounds(logical_rect_, raster_matrix);
+  // Undo the scale that the image was rasterized with, so that the total
+  // matrix maps it to where the logical rect is drawn.
+  canvas.scale(1 / raster_matrix.getScaleX(), 1 / raster_matrix.getScaleY());
+  flow_.Step();
+  canvas.drawImage(image_, bounds.fLeft, bounds.fTop, sampling, paint);
+}
+
 RasterCache::RasterCache(size_t access_threshold,
                          size_t picture_and_display_list_cache_limit_per_frame)
     : access_threshold_(access_threshold),
@@ -45,6 +61,10 @@ RasterCache::RasterCache(size_t access_threshold,
           picture_and_display_list_cache_limit_per_frame),
       checkerboard_images_(false) {}
 
+RasterCache::~RasterCache() {
+  SetBudget(nullptr);
+}
+
 static bool CanRasterizeRect(const SkRect& cull_rect) {
   if (cull_rect.isEmpty()) {
     // No point in ever rasterizing an empty display list.
@@ -88,7 +108,8 @@ static bool IsPictureWorthRasterizing(SkPicture* picture,
 
 static bool IsDisplayListWorthRasterizing(DisplayList* display_list,
                                           bool will_change,
-                                          bool is_complex) {
+                                          bool is_complex,
+                                          bool admit_by_cost) {
   if (will_change) {
     // If the display list is going to change in the future, there is no point
     // in doing to extra work to rasterize.
@@ -107,6 +128,13 @@ static bool IsDisplayListWorthRasterizing(DisplayList* display_list,
     return true;
   }
 
+  if (admit_by_cost) {
+    // Whether the display list is expensive enough to be worth the memory is
+    // decided by its estimated cost once it has been accessed often enough.
+    // See |IsDisplayListWorthCaching|.
+    return true;
+  }
+
   // TODO(abarth): We should find a better heuristic here that lets us avoid
   // wasting memory on trivial layers that are easy to re-rasterize every frame.
   return display_list->op_count(true) > 5;
@@ -172,6 +200,31 @@ std::unique_ptr<RasterCacheResult> RasterCache::RasterizeDisplayList(
                    [=](SkCanvas* canvas) { display_list->RenderTo(canvas); });
 }
 
+std::unique_ptr<RasterCacheResult> RasterCache::RasterizeScaledDisplayList(
+    DisplayList* display_list,
+    GrDirectContext* context,
+    const SkMatrix& bucket_matrix,
+    SkColorSpace* dst_color_space,
+    bool checkerboard) const {
+  const SkRect padded_bounds = display_list->bounds().makeOutset(
+      1 / bucket_matrix.getScaleX(), 1 / bucket_matrix.getScaleY());
+  return Rasterize(context, bucket_matrix, dst_color_space, checkerboard,
+                   padded_bounds, "RasterCacheFlow::DisplayList",
+                   [=](SkCanvas* canvas) { display_list->RenderTo(canvas); });
+}
+
+std::unique_ptr<RasterCacheResult> RasterCache::RasterizeShadow(
+    DisplayList* shadow,
+    const SkRect& shadow_bounds,
+    GrDirectContext* context,
+    const SkMatrix& ctm,
+    SkColorSpace* dst_color_space,
+    bool checkerboard) const {
+  return Rasterize(context, ctm, dst_color_space, checkerboard, shadow_bounds,
+                   "RasterCacheFlow::Shadow",
+                   [=](SkCanvas* canvas) { shadow->RenderTo(canvas); });
+}
+
 void RasterCache::Prepare(PrerollContext* context,
                           Layer* layer,
                           const SkMatrix& ctm) {
@@ -179,8 +232,9 @@ void RasterCache::Prepare(PrerollContext* context,
   Entry& entry = layer_cache_[cache_key];
   entry.access_count++;
   entry.used_this_frame = true;
-  if (!entry.image) {
+  if (!entry.image && IsWithinBudget()) {
     entry.image = RasterizeLayer(context, layer, ctm, checkerboard_images_);
+    AccountForImage(entry.image);
   }
 }
 
@@ -258,6 +312,7 @@ bool RasterCache::Prepare(PrerollContext* context,
     entry.image =
         RasterizePicture(picture, context->gr_context, transformation_matrix,
                          context->dst_color_space, checkerboard_images_);
+    AccountForImage(entry.image);
     picture_cached_this_frame_++;
   }
   return true;
@@ -273,7 +328,8 @@ bool RasterCache::Prepare(PrerollContext* context,
     return false;
   }
 
-  if (!IsDisplayListWorthRasterizing(display_list, will_change, is_complex)) {
+  if (!IsDisplayListWorthRasterizing(display_list, will_change, is_complex,
+                                     admit_display_lists_by_cost_)) {
     // We only deal with display lists that are worthy of rasterization.
     return false;
   }
@@ -286,31 +342,143 @@ bool RasterCache::Prepare(PrerollContext* context,
     return false;
   }
 
-  DisplayListRasterCacheKey cache_key(display_list->unique_id(),
-                                      transformation_matrix);
+  SkMatrix bucket_matrix;
+  const bool bucketed =
+      GetScaleBucketMatrix(transformation_matrix, &bucket_matrix);
+  DisplayListRasterCacheKey cache_key(
+      display_list->content_hash(),
+      bucketed ? bucket_matrix : transformation_matrix);
 
   // Creates an entry, if not present prior.
   Entry& entry = display_list_cache_[cache_key];
+  if (!MatchDisplayListEntry(entry, *display_list)) {
+    // A different display list with the same hash. Replace it.
+    entry = Entry();
+    entry.display_list = sk_ref_sp(display_list);
+  }
   if (entry.access_count < access_threshold_) {
     // Frame threshold has not yet been reached.
     return false;
   }
 
   if (!entry.image) {
-    // GetIntegralTransCTM effect for matrix which only contains scale,
-    // translate, so it won't affect result of matrix decomposition and cache
-    // key.
+    if (!is_complex && admit_display_lists_by_cost_ &&
+        !IsDisplayListWorthCaching(
+            context, entry, bucketed ? bucket_matrix : transformation_matrix)) {
+      // The display list is cheap enough to render every frame.
+      return false;
+    }
+    if (bucketed) {
+      entry.image = RasterizeScaledDisplayList(
+          display_list, context->gr_context, bucket_matrix,
+          context->dst_color_space, checkerboard_images_);
+    } else {
+      // GetIntegralTransCTM effect for matrix which only contains scale,
+      // translate, so it won't affect result of matrix decomposition and
+      // cache key.
+#ifndef SUPPORT_FRACTIONAL_TRANSLATION
+      transformation_matrix = GetIntegralTransCTM(transformation_matrix);
+#endif
+      entry.image = RasterizeDisplayList(
+          display_list, context->gr_context, transformation_matrix,
+          context->dst_color_space, checkerboard_images_);
+    }
+    AccountForImage(entry.image);
+    display_list_cached_this_frame_++;
+  }
+  return true;
+}
+
+bool RasterCache::PrepareShadow(PrerollContext* context,
+                                DisplayList* shadow,
+                                const SkRect& shadow_bounds,
+                                const SkMatrix& untranslated_matrix,
+                                const SkPoint& offset) {
+  if (!GenerateNewCacheInThisFrame()) {
+    return false;
+  }
+
+  // Shadows are blurred, so they are always worth rasterizing unless their
+  // estimated cost says otherwise.
+  if (!IsDisplayListWorthRasterizing(shadow, false, true, false) ||
+      !CanRasterizeRect(shadow_bounds)) {
+    return false;
+  }
+
+  SkMatrix transformation_matrix = untranslated_matrix;
+  transformation_matrix.preTranslate(offset.x(), offset.y());
+
+  if (!transformation_matrix.invert(nullptr)) {
+    // The matrix was singular. No point in going further.
+    return false;
+  }
+
+  DisplayListRasterCacheKey cache_key(shadow->content_hash(),
+                                      transformation_matrix);
+
+  // Creates an entry, if not present prior.
+  Entry& entry = shadow_cache_[cache_key];
+  if (!MatchDisplayListEntry(entry, *shadow)) {
+    // A different shadow with the same hash. Replace it.
+    entry = Entry();
+    entry.display_list = sk_ref_sp(shadow);
+  }
+  if (entry.access_count < access_threshold_) {
+    // Frame threshold has not yet been reached.
+    return false;
+  }
+
+  if (!entry.image) {
+    if (admit_display_lists_by_cost_ &&
+        !IsDisplayListWorthCaching(context, entry, transformation_matrix)) {
+      // The shadow is cheap enough to draw every frame, e.g. because the
+      // backend draws the shadows of rounded rects analytically.
+      return false;
+    }
 #ifndef SUPPORT_FRACTIONAL_TRANSLATION
     transformation_matrix = GetIntegralTransCTM(transformation_matrix);
 #endif
-    entry.image = RasterizeDisplayList(
-        display_list, context->gr_context, transformation_matrix,
+    entry.image = RasterizeShadow(
+        shadow, shadow_bounds, context->gr_context, transformation_matrix,
         context->dst_color_space, checkerboard_images_);
-    display_list_cached_this_frame_++;
+    AccountForImage(entry.image);
+    shadow_cached_this_frame_++;
   }
   return true;
 }
 
+bool RasterCache::IsDisplayListWorthCaching(const PrerollContext* context,
+                                            Entry& entry,
+                                            const SkMatrix& matrix) {
+  const DisplayListComplexityCalculator& calculator =
+      context->gr_context
+          ? DisplayListComplexityCalculator::GetForBackend(
+                context->gr_context->backend())
+          : DisplayListComplexityCalculator::GetForSoftware();
+  if (!entry.display_list_cost) {
+    entry.display_list_cost =
+        calculator.Compute(entry.display_list.get(), matrix);
+  }
+  const SkIRect cache_rect =
+      GetDeviceBounds(entry.display_list->bounds(), matrix);
+  const uint64_t pixel_count =
+      static_cast<uint64_t>(cache_rect.width()) * cache_rect.height();
+  return calculator.ShouldBeCached(*entry.display_list_cost, pixel_count,
+                                   entry.access_count);
+}
+
+bool RasterCache::MatchDisplayListEntry(Entry& entry,
+                                        const DisplayList& display_list) {
+  if (entry.display_list.get() == &display_list) {
+    return true;
+  }
+  if (entry.display_list && !entry.display_list->Equals(display_list)) {
+    return false;
+  }
+  entry.display_list = sk_ref_sp(&display_list);
+  return true;
+}
+
 void RasterCache::Touch(Layer* layer, const SkMatrix& ctm) {
   LayerRasterCacheKey cache_key(layer->unique_id(), ctm);
   auto it = layer_cache_.find(cache_key);
@@ -332,8 +500,12 @@ void RasterCache::Touch(SkPicture* picture,
 
 void RasterCache::Touch(DisplayList* display_list,
                         const SkMatrix& transformation_matrix) {
-  DisplayListRasterCacheKey cache_key(display_list->unique_id(),
-                                      transformation_matrix);
+  SkMatrix bucket_matrix;
+  const bool bucketed =
+      GetScaleBucketMatrix(transformation_matrix, &bucket_matrix);
+  DisplayListRasterCacheKey cache_key(
+      display_list->content_hash(),
+      bucketed ? bucket_matrix : transformation_matrix);
   auto it = display_list_cache_.find(cache_key);
   if (it != display_list_cache_.end()) {
     it->second.used_this_frame = true;
@@ -365,10 +537,15 @@ bool RasterCache::Draw(const SkPicture& picture,
 bool RasterCache::Draw(const DisplayList& display_list,
                        SkCanvas& canvas,
                        const SkPaint* paint) const {
-  DisplayListRasterCacheKey cache_key(display_list.unique_id(),
-                                      canvas.getTotalMatrix());
+  SkMatrix bucket_matrix;
+  const bool bucketed =
+      GetScaleBucketMatrix(canvas.getTotalMatrix(), &bucket_matrix);
+  DisplayListRasterCacheKey cache_key(
+      display_list.content_hash(),
+      bucketed ? bucket_matrix : canvas.getTotalMatrix());
   auto it = display_list_cache_.find(cache_key);
-  if (it == display_list_cache_.end()) {
+  if (it == display_list_cache_.end() ||
+      !MatchDisplayListEntry(it->second, display_list)) {
     return false;
   }
 
@@ -377,7 +554,40 @@ bool RasterCache::Draw(const DisplayList& display_list,
   entry.used_this_frame = true;
 
   if (entry.image) {
-    entry.image->draw(canvas, paint);
+    if (bucketed) {
+      entry.image->drawScaled(canvas, bucket_matrix, scale_buckets_.sampling,
+                              paint);
+    } else {
+      entry.image->draw(canvas, paint);
+    }
+    return true;
+  }
+
+  return false;
+}
+
+bool RasterCache::DrawShadow(const DisplayList& shadow,
+                             SkCanvas& canvas,
+                             const SkPoint& offset) const {
+  SkAutoCanvasRestore auto_restore(&canvas, true);
+  canvas.translate(offset.x(), offset.y());
+#ifndef SUPPORT_FRACTIONAL_TRANSLATION
+  canvas.setMatrix(GetIntegralTransCTM(canvas.getTotalMatrix()));
+#endif
+
+  DisplayListRasterCacheKey cache_key(shadow.content_hash(),
+                                      canvas.getTotalMatrix());
+  auto it = shadow_cache_.find(cache_key);
+  if (it == shadow_cache_.end() || !MatchDisplayListEntry(it->second, shadow)) {
+    return false;
+  }
+
+  Entry& entry = it->second;
+  entry.access_count++;
+  entry.used_this_frame = true;
+
+  if (entry.image) {
+    entry.image->draw(canvas, nullptr);
     return true;
   }
 
@@ -408,6 +618,7 @@ bool RasterCache::Draw(const Layer* layer,
 void RasterCache::PrepareNewFrame() {
   picture_cached_this_frame_ = 0;
   display_list_cached_this_frame_ = 0;
+  shadow_cached_this_frame_ = 0;
 }
 
 void RasterCache::CleanupAfterFrame() {
@@ -417,22 +628,88 @@ void RasterCache::CleanupAfterFrame() {
     TRACE_EVENT0("flutter", "RasterCache::SweepCaches");
     SweepOneCacheAfterFrame(picture_cache_, picture_metrics_);
     SweepOneCacheAfterFrame(display_list_cache_, picture_metrics_);
+    SweepOneCacheAfterFrame(shadow_cache_, picture_metrics_);
     SweepOneCacheAfterFrame(layer_cache_, layer_metrics_);
   }
+  if (budget_) {
+    budget_->SetCacheBytes(
+        this, picture_metrics_.in_use_bytes + layer_metrics_.in_use_bytes);
+  }
   TraceStatsToTimeline();
 }
 
 void RasterCache::Clear() {
   picture_cache_.clear();
   display_list_cache_.clear();
+  shadow_cache_.clear();
   layer_cache_.clear();
   picture_metrics_ = {};
   layer_metrics_ = {};
+  if (budget_) {
+    budget_->SetCacheBytes(this, 0);
+  }
+}
+
+void RasterCache::SetBudget(std::shared_ptr<RasterCacheBudget> budget) {
+  if (budget_ == budget) {
+    return;
+  }
+  if (budget_) {
+    budget_->RemoveCache(this);
+  }
+  budget_ = std::move(budget);
+  if (budget_) {
+    budget_->AddCache(this);
+    budget_->SetCacheBytes(
+        this, EstimatePictureCacheByteSize() + EstimateLayerCacheByteSize());
+  }
+}
+
+void RasterCache::SetAdmitDisplayListsByCost(bool admit_by_cost) {
+  admit_display_lists_by_cost_ = admit_by_cost;
+}
+
+void RasterCache::SetScaleBuckets(const RasterCacheScaleBuckets& buckets) {
+  scale_buckets_ = buckets;
+  // Entries are keyed by the matrices of the old buckets.
+  Clear();
+}
+
+static SkScalar GetBucketScale(SkScalar scale, SkScalar step) {
+  // The smallest power of |step| that is at least |scale|. The tolerance
+  // keeps scales that are powers of |step| in their own bucket despite
+  // rounding errors.
+  const SkScalar exponent =
+      std::ceil(std::log(scale) / std::log(step) - 1e-4f);
+  return std::pow(step, exponent);
+}
+
+bool RasterCache::GetScaleBucketMatrix(const SkMatrix& matrix,
+                                       SkMatrix* bucket_matrix) const {
+  if (scale_buckets_.step <= 1 || !matrix.isScaleTranslate()) {
+    return false;
+  }
+  const SkScalar scale_x = matrix.getScaleX();
+  const SkScalar scale_y = matrix.getScaleY();
+  if (scale_x <= 0 || scale_y <= 0 || scale_x > scale_buckets_.max_scale ||
+      scale_y > scale_buckets_.max_scale) {
+    return false;
+  }
+  bucket_matrix->setScale(GetBucketScale(scale_x, scale_buckets_.step),
+                          GetBucketScale(scale_y, scale_buckets_.step));
+  return true;
+}
+
+void RasterCache::AccountForImage(
+    const std::unique_ptr<RasterCacheResult>& image) const {
+  if (budget_ && image) {
+    budget_->AddCacheBytes(this, image->image_bytes());
+  }
 }
 
 size_t RasterCache::GetCachedEntriesCount() const {
   return layer_cache_.size() + picture_cache_.size() +
-         display_list_cache_.size();
+         display_list_cache_.size() + shadow_cache_.size();
 }
 
 size_t RasterCache::GetLayerCachedEntriesCount() const {
@@ -443,6 +720,10 @@ size_t RasterCache::GetPictureCachedEntriesCount() const {
   return picture_cache_.size() + display_list_cache_.size();
 }
 
+size_t RasterCache::GetShadowCachedEntriesCount() const {
+  return shadow_cache_.size();
+}
+
 void RasterCache::SetCheckboardCacheImages(bool checkerboard) {
   if (checkerboard_images_ == checkerboard) {
     return;
@@ -490,6 +771,11 @@ size_t RasterCache::EstimatePictureCacheByteSize() const {
       picture_cache_bytes += item.second.image->image_bytes();
     }
   }
+  for (const auto& item : shadow_cache_) {
+    if (item.second.image) {
+      picture_cache_bytes += item.second.image->image_bytes();
+    }
+  }
   return picture_cache_bytes;
 }
 
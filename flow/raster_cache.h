@@ -6,9 +6,11 @@
 #define FLUTTER_FLOW_RASTER_CACHE_H_
 
 #include <memory>
+#include <optional>
 #include <unordered_map>
 
 #include "flutter/display_list/display_list.h"
+#include "flutter/flow/raster_cache_budget.h"
 #include "flutter/flow/raster_cache_key.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/weak_ptr.h"
@@ -28,6 +30,14 @@ class RasterCacheResult {
 
   virtual void draw(SkCanvas& canvas, const SkPaint* paint) const;
 
+  // Draws an image that was rasterized with |raster_matrix|, a scale without
+  // translation, with the total matrix of |canvas|, which may scale it down
+  // and move it by fractional pixels. The image is filtered with |sampling|.
+  void drawScaled(SkCanvas& canvas,
+                  const SkMatrix& raster_matrix,
+                  const SkSamplingOptions& sampling,
+                  const SkPaint* paint) const;
+
   virtual SkISize image_dimensions() const {
     return image_ ? image_->dimensions() : SkISize::Make(0, 0);
   };
@@ -44,6 +54,32 @@ class RasterCacheResult {
 
 struct PrerollContext;
 
+/**
+ * Configures how display list entries are shared between the nearby scales
+ * that they are drawn at, as during zoom animations. See
+ * |RasterCache::SetScaleBuckets|.
+ */
+struct RasterCacheScaleBuckets {
+  /**
+   * The ratio between consecutive bucket scales, e.g. 2 for power of two
+   * steps or 1.1 for 10% steps. An entry is scaled down by at most this
+   * factor when it is drawn, so smaller steps give sharper images at the cost
+   * of more entries. Scales are not bucketed for a step of 1 or less.
+   */
+  SkScalar step = 0;
+
+  /**
+   * Scales above this are not bucketed, as rounding their entries up to the
+   * next bucket costs the most memory.
+   */
+  SkScalar max_scale = 4;
+
+  /**
+   * The sampling that entries are drawn with at scales below their bucket.
+   */
+  SkSamplingOptions sampling = SkSamplingOptions(SkFilterMode::kLinear);
+};
+
 struct RasterCacheMetrics {
   /**
    * The number of cache entries with images evicted in this frame.
@@ -92,7 +128,7 @@ class RasterCache {
                        size_t picture_and_display_list_cache_limit_per_frame =
                            kDefaultPictureAndDispLayListCacheLimitPerFrame);
 
-  virtual ~RasterCache() = default;
+  virtual ~RasterCache();
 
   /**
    * @brief Rasterize a picture object and produce a RasterCacheResult
@@ -122,6 +158,41 @@ class RasterCache {
       SkColorSpace* dst_color_space,
       bool checkerboard) const;
 
+  /**
+   * @brief Rasterize a display list that only draws a shadow and produce a
+   * RasterCacheResult to be stored in the cache.
+   *
+   * @param shadow the display list that draws the shadow.
+   * @param shadow_bounds the bounds of the shadow, which may exceed the
+   *        bounds of the display list as they depend on the ctm.
+   * @see RasterizeDisplayList for the other parameters.
+   */
+  virtual std::unique_ptr<RasterCacheResult> RasterizeShadow(
+      DisplayList* shadow,
+      const SkRect& shadow_bounds,
+      GrDirectContext* context,
+      const SkMatrix& ctm,
+      SkColorSpace* dst_color_space,
+      bool checkerboard) const;
+
+  /**
+   * @brief Rasterize a display list at the scale of a bucket, see
+   * |SetScaleBuckets|, and produce a RasterCacheResult to be stored in the
+   * cache.
+   *
+   * The image is padded with a transparent pixel on each side so that
+   * filtering fades its edges out as rendering the display list would.
+   *
+   * @param bucket_matrix the scale of the bucket.
+   * @see RasterizeDisplayList for the other parameters.
+   */
+  virtual std::unique_ptr<RasterCacheResult> RasterizeScaledDisplayList(
+      DisplayList* display_list,
+      GrDirectContext* context,
+      const SkMatrix& bucket_matrix,
+      SkColorSpace* dst_color_space,
+      bool checkerboard) const;
+
   /**
    * @brief Rasterize an engine Layer and produce a RasterCacheResult
    * to be stored in the cache.
@@ -192,6 +263,23 @@ class RasterCache {
                const SkMatrix& untranslated_matrix,
                const SkPoint& offset = SkPoint());
 
+  // Return true if the cache is generated for a display list that only draws
+  // the shadow of a shape, such as the one of a PhysicalShapeLayer.
+  //
+  // The shape should be moved so that its bounds start at the origin, with
+  // |offset| moving it back, so that shadows of identical shapes share one
+  // entry wherever they are drawn. This works because shadows are lit by a
+  // directional light. |shadow_bounds| are the bounds of the shadow of the
+  // moved shape as drawn with |untranslated_matrix|.
+  //
+  // The conditions for not generating the cache are the same as for display
+  // lists.
+  bool PrepareShadow(PrerollContext* context,
+                     DisplayList* shadow,
+                     const SkRect& shadow_bounds,
+                     const SkMatrix& untranslated_matrix,
+                     const SkPoint& offset);
+
   // If there is cache entry for this picture, display list or layer, mark it as
   // used for this frame in order to not get evicted. This is needed during
   // partial repaint for layers that are outside of current clip and are culled
@@ -216,6 +304,14 @@ class RasterCache {
             SkCanvas& canvas,
             const SkPaint* paint = nullptr) const;
 
+  // Find the raster cache for the shadow prepared with |PrepareShadow| and
+  // draw it to the canvas, moved by |offset|.
+  //
+  // Return true if it's found and drawn.
+  bool DrawShadow(const DisplayList& shadow,
+                  SkCanvas& canvas,
+                  const SkPoint& offset) const;
+
   // Find the raster cache for the layer and draw it to the canvas.
   //
   // Additional paint can be given to change how the raster cache is drawn
@@ -233,6 +329,58 @@ class RasterCache {
 
   void SetCheckboardCacheImages(bool checkerboard);
 
+  /**
+   * @brief Make this cache account for its images in a byte budget that it
+   * may share with the caches of other engines. While the budget is exhausted,
+   * no new images are rasterized. Passing nullptr removes the budget.
+   */
+  void SetBudget(std::shared_ptr<RasterCacheBudget> budget);
+
+  const std::shared_ptr<RasterCacheBudget>& budget() const { return budget_; }
+
+  /**
+   * @brief Decide which display lists to cache by their estimated rendering
+   * cost on the backend, as computed by a DisplayListComplexityCalculator,
+   * instead of by their op count. Entries are then cached once the raster
+   * time saved over their accesses pays for rendering their image. Display
+   * lists that are marked as complex are cached either way.
+   *
+   * This is off by default, as the cost tables have not been calibrated on
+   * each backend yet.
+   */
+  void SetAdmitDisplayListsByCost(bool admit_by_cost);
+
+  bool admits_display_lists_by_cost() const {
+    return admit_display_lists_by_cost_;
+  }
+
+  /**
+   * @brief Share display list entries between the scales that fall into the
+   * same bucket. Their images are rasterized at the scale of the bucket,
+   * which is the smallest power of |buckets.step| that is at least the scale
+   * they are drawn at, without any translation, and scaled down and moved
+   * with filtering when they are drawn. This keeps zoom animations and
+   * fractional translations from missing the cache every frame.
+   *
+   * Setting the buckets clears the cache.
+   */
+  void SetScaleBuckets(const RasterCacheScaleBuckets& buckets);
+
+  const RasterCacheScaleBuckets& scale_buckets() const {
+    return scale_buckets_;
+  }
+
+  /**
+   * @brief Return whether display list entries drawn with |matrix| are
+   * shared between scales, and if so, set |bucket_matrix| to the scale of
+   * their bucket.
+   *
+   * Only matrices that scale by positive factors and translate, up to the
+   * maximum scale, are bucketed.
+   */
+  bool GetScaleBucketMatrix(const SkMatrix& matrix,
+                            SkMatrix* bucket_matrix) const;
+
   const RasterCacheMetrics& picture_metrics() const { return picture_metrics_; }
   const RasterCacheMetrics& layer_metrics() const { return layer_metrics_; }
 
@@ -251,10 +399,16 @@ class RasterCache {
    */
   size_t GetPictureCachedEntriesCount() const;
 
+  /**
+   * Return the number of map entries in the shadow cache regardless of
+   * whether the entries have been populated with an image.
+   */
+  size_t GetShadowCachedEntriesCount() const;
+
   /**
    * @brief Estimate how much memory is used by picture raster cache entries in
-   * bytes, including cache entries in the SkPicture cache and the DisplayList
-   * cache.
+   * bytes, including cache entries in the SkPicture cache, the DisplayList
+   * cache and the shadow cache.
    *
    * Only SkImage's memory usage is counted as other objects are often much
    * smaller compared to SkImage. SkImageInfo::computeMinByteSize is used to
@@ -287,8 +441,26 @@ class RasterCache {
     bool used_this_frame = false;
     size_t access_count = 0;
     std::unique_ptr<RasterCacheResult> image;
+    // The most recent display list that matched a display list entry.
+    sk_sp<DisplayList> display_list;
+    // The estimated time it takes to render |display_list|, in nanoseconds.
+    std::optional<uint64_t> display_list_cost;
   };
 
+  // Whether drawing a cached image of the display list entry instead of
+  // rendering the display list is expected to save enough raster time, as
+  // estimated by a DisplayListComplexityCalculator, to pay for rendering the
+  // image given how often the entry has been accessed.
+  static bool IsDisplayListWorthCaching(const PrerollContext* context,
+                                        Entry& entry,
+                                        const SkMatrix& matrix);
+
+  // Display list entries are keyed by content hash. Returns whether the
+  // entry really holds the contents of |display_list|, and if so, makes it
+  // refer to |display_list| so that the next frames can skip the compare.
+  static bool MatchDisplayListEntry(Entry& entry,
+                                    const DisplayList& display_list);
+
   template <class Cache>
   static void SweepOneCacheAfterFrame(Cache& cache,
                                       RasterCacheMetrics& metrics) {
@@ -317,20 +489,33 @@ class RasterCache {
   bool GenerateNewCacheInThisFrame() const {
     // Disabling caching when access_threshold is zero is historic behavior.
     return access_threshold_ != 0 &&
-           picture_cached_this_frame_ + display_list_cached_this_frame_ <
-               picture_and_display_list_cache_limit_per_frame_;
+           picture_cached_this_frame_ + display_list_cached_this_frame_ +
+                   shadow_cached_this_frame_ <
+               picture_and_display_list_cache_limit_per_frame_ &&
+           IsWithinBudget();
   }
 
+  bool IsWithinBudget() const { return !budget_ || budget_->CanGrow(this); }
+
+  void AccountForImage(const std::unique_ptr<RasterCacheResult>& image) const;
+
   const size_t access_threshold_;
   const size_t picture_and_display_list_cache_limit_per_frame_;
   size_t picture_cached_this_frame_ = 0;
   size_t display_list_cached_this_frame_ = 0;
+  size_t shadow_cached_this_frame_ = 0;
   RasterCacheMetrics layer_metrics_;
   RasterCacheMetrics picture_metrics_;
   mutable PictureRasterCacheKey::Map<Entry> picture_cache_;
   mutable DisplayListRasterCacheKey::Map<Entry> display_list_cache_;
+  // Shadows are kept apart from other display lists as they are rasterized
+  // with their own bounds. Their metrics are part of the picture metrics.
+  mutable DisplayListRasterCacheKey::Map<Entry> shadow_cache_;
   mutable LayerRasterCacheKey::Map<Entry> layer_cache_;
   bool checkerboard_images_;
+  std::shared_ptr<RasterCacheBudget> budget_;
+  bool admit_display_lists_by_cost_ = false;
+  RasterCacheScaleBuckets scale_buckets_;
 
   void TraceStatsToTimeline() const;
 
@@ -0,0 +1,186 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/common/graphics/texture.h"
+#include "flutter/display_list/display_list_builder.h"
+#include "flutter/flow/embedded_views.h"
+#include "flutter/flow/instrumentation.h"
+#include "flutter/flow/layers/layer.h"
+#include "flutter/flow/raster_cache.h"
+#include "flutter/flow/raster_cache_budget.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+
+namespace {
+
+constexpr int kSurfaceSize = 1024;
+constexpr int kTileSize = 128;
+constexpr int kTilesPerRow = kSurfaceSize / kTileSize;
+constexpr size_t kSharedBudgetBytes = 8 << 20;
+
+// A tile of the screen of an application. Tiles differ by |index|, and by
+// |variant|, such as the engine that draws them or their version.
+sk_sp<DisplayList> MakeTile(int variant, int index) {
+  DisplayListBuilder builder;
+  builder.setColor(SkColorSetRGB(variant * 64 % 256, index * 4 % 256, 128));
+  builder.drawRect(SkRect::MakeWH(kTileSize, kTileSize));
+  builder.setAntiAlias(true);
+  builder.setColor(SK_ColorWHITE);
+  builder.drawCircle(SkPoint::Make(kTileSize / 2, kTileSize / 2),
+                     kTileSize / 3);
+  return builder.Build();
+}
+
+// Draws |display_lists| on |canvas| in a grid through |cache|, as display
+// list layers do, and returns how many of them were drawn from the cache.
+size_t DrawFrame(RasterCache& cache,
+                 const std::vector<sk_sp<DisplayList>>& display_lists,
+                 SkCanvas* canvas) {
+  MutatorsStack mutators_stack;
+  Stopwatch raster_time;
+  Stopwatch ui_time;
+  TextureRegistry texture_registry;
+  PrerollContext context = {
+      &cache,            // raster_cache
+      nullptr,           // gr_context
+      nullptr,           // view_embedder
+      mutators_stack,    // mutators_stack
+      nullptr,           // dst_color_space
+      kGiantRect,        // cull_rect
+      false,             // surface_needs_readback
+      raster_time,       // raster_time
+      ui_time,           // ui_time
+      texture_registry,  // texture_registry
+      false,             // checkerboard_offscreen_layers
+      1.0f,              // frame_device_pixel_ratio
+  };
+
+  cache.PrepareNewFrame();
+  size_t hit_count = 0;
+  for (size_t i = 0; i < display_lists.size(); i++) {
+    DisplayList* display_list = display_lists[i].get();
+    SkMatrix matrix = SkMatrix::Translate(
+        static_cast<SkScalar>(i % kTilesPerRow * kTileSize),
+        static_cast<SkScalar>(i / kTilesPerRow % kTilesPerRow * kTileSize));
+    cache.Prepare(&context, display_list, true, false, matrix);
+    canvas->save();
+    canvas->setMatrix(matrix);
+    if (cache.Draw(*display_list, *canvas)) {
+      hit_count++;
+    } else {
+      display_list->RenderTo(canvas);
+    }
+    canvas->restore();
+  }
+  cache.CleanupAfterFrame();
+  return hit_count;
+}
+
+}  // namespace
+
+// Draws frames of |state.range(0)| engines, such as a shell and the shells
+// spawned from it, each with a screen of tiles of its own. If
+// |state.range(1)| is set, the raster caches of the engines share a budget
+// of |kSharedBudgetBytes|, as with --shared-raster-cache-size. Reports the
+// size of the raster caches of all of the engines together once they have
+// settled, and the fraction of tiles drawn from the caches.
+static void BM_SpawnedEnginesRasterCacheBytes(benchmark::State& state) {
+  const int engine_count = state.range(0);
+  const bool shared_budget = state.range(1);
+  constexpr int kTileCount = 32;
+
+  auto surface = SkSurface::MakeRasterN32Premul(kSurfaceSize, kSurfaceSize);
+  std::shared_ptr<RasterCacheBudget> budget;
+  if (shared_budget) {
+    budget = std::make_shared<RasterCacheBudget>(kSharedBudgetBytes);
+  }
+  std::vector<std::unique_ptr<RasterCache>> caches;
+  std::vector<std::vector<sk_sp<DisplayList>>> screens;
+  for (int engine = 0; engine < engine_count; engine++) {
+    caches.push_back(std::make_unique<RasterCache>());
+    caches.back()->SetBudget(budget);
+    screens.emplace_back();
+    for (int i = 0; i < kTileCount; i++) {
+      screens.back().push_back(MakeTile(engine, i));
+    }
+  }
+
+  size_t draw_count = 0;
+  size_t hit_count = 0;
+  for (auto _ : state) {
+    for (int engine = 0; engine < engine_count; engine++) {
+      hit_count +=
+          DrawFrame(*caches[engine], screens[engine], surface->getCanvas());
+      draw_count += kTileCount;
+    }
+    surface->flushAndSubmit(true);
+  }
+
+  size_t cache_bytes = 0;
+  for (const auto& cache : caches) {
+    cache_bytes += cache->EstimatePictureCacheByteSize() +
+                   cache->EstimateLayerCacheByteSize();
+  }
+  state.counters["CacheMB"] = static_cast<double>(cache_bytes) / (1 << 20);
+  state.counters["HitRate"] =
+      draw_count ? static_cast<double>(hit_count) / draw_count : 0.0;
+}
+
+// Draws frames of |state.range(0)| tiles whose display lists are recorded
+// again every frame, as they are when the framework rebuilds widgets whose
+// output did not change. One in eight tiles changes its content every frame.
+// The tiles go through the raster cache as display list layers do, which
+// finds the entries of unchanged tiles by the content of their lists.
+// Reports the number of cache entries drawn per frame, as counted by
+// |RasterCache::picture_metrics|, and the fraction of tiles drawn from the
+// cache.
+static void BM_RasterCacheRebuiltDisplayLists(benchmark::State& state) {
+  const int tile_count = state.range(0);
+
+  auto surface = SkSurface::MakeRasterN32Premul(kSurfaceSize, kSurfaceSize);
+  RasterCache cache;
+
+  size_t frame = 0;
+  size_t draw_count = 0;
+  size_t hit_count = 0;
+  size_t in_use_count = 0;
+  for (auto _ : state) {
+    std::vector<sk_sp<DisplayList>> tiles;
+    for (int i = 0; i < tile_count; i++) {
+      // A changed tile differs from the one of the frame before and from
+      // the unchanged tiles.
+      int variant = (i + frame) % 8 == 0 ? static_cast<int>(frame % 3) + 1 : 0;
+      tiles.push_back(MakeTile(variant, i));
+    }
+    hit_count += DrawFrame(cache, tiles, surface->getCanvas());
+    draw_count += tile_count;
+    in_use_count += cache.picture_metrics().in_use_count;
+    surface->flushAndSubmit(true);
+    frame++;
+  }
+
+  state.counters["CacheHitsPerFrame"] =
+      frame ? static_cast<double>(in_use_count) / frame : 0.0;
+  state.counters["HitRate"] =
+      draw_count ? static_cast<double>(hit_count) / draw_count : 0.0;
+}
+
+BENCHMARK(BM_RasterCacheRebuiltDisplayLists)
+    ->RangeMultiplier(4)
+    ->Range(16, 64)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_SpawnedEnginesRasterCacheBytes)
+    ->ArgNames({"engines", "shared_budget"})
+    ->RangeMultiplier(2)
+    ->Ranges({{1, 8}, {0, 1}})
+    ->MinTime(1.0)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace flutter
@@ -0,0 +1,96 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/raster_cache_budget.h"
+
+#include "flutter/common/constants.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+RasterCacheBudget::RasterCacheBudget(size_t max_bytes)
+    : max_bytes_(max_bytes) {}
+
+RasterCacheBudget::~RasterCacheBudget() = default;
+
+void RasterCacheBudget::AddCache(const RasterCache* cache) {
+  std::scoped_lock lock(mutex_);
+  cache_bytes_.emplace(cache, 0);
+}
+
+void RasterCacheBudget::RemoveCache(const RasterCache* cache) {
+  std::scoped_lock lock(mutex_);
+  auto found = cache_bytes_.find(cache);
+  if (found == cache_bytes_.end()) {
+    return;
+  }
+  total_bytes_ -= found->second;
+  cache_bytes_.erase(found);
+  TraceStatsToTimeline();
+}
+
+void RasterCacheBudget::SetCacheBytes(const RasterCache* cache, size_t bytes) {
+  std::scoped_lock lock(mutex_);
+  auto found = cache_bytes_.find(cache);
+  FML_DCHECK(found != cache_bytes_.end());
+  if (found == cache_bytes_.end()) {
+    return;
+  }
+  total_bytes_ = total_bytes_ - found->second + bytes;
+  found->second = bytes;
+  TraceStatsToTimeline();
+}
+
+void RasterCacheBudget::AddCacheBytes(const RasterCache* cache, size_t bytes) {
+  std::scoped_lock lock(mutex_);
+  auto found = cache_bytes_.find(cache);
+  FML_DCHECK(found != cache_bytes_.end());
+  if (found == cache_bytes_.end()) {
+    return;
+  }
+  found->second += bytes;
+  total_bytes_ += bytes;
+}
+
+size_t RasterCacheBudget::GetCacheBytes(const RasterCache* cache) const {
+  std::scoped_lock lock(mutex_);
+  auto found = cache_bytes_.find(cache);
+  return found == cache_bytes_.end() ? 0 : found->second;
+}
+
+size_t RasterCacheBudget::GetTotalBytes() const {
+  std::scoped_lock lock(mutex_);
+  return total_bytes_;
+}
+
+size_t RasterCacheBudget::GetCacheCount() const {
+  std::scoped_lock lock(mutex_);
+  return cache_bytes_.size();
+}
+
+bool RasterCacheBudget::CanGrow(const RasterCache* cache) const {
+  std::scoped_lock lock(mutex_);
+  if (total_bytes_ < max_bytes_) {
+    return true;
+  }
+  auto found = cache_bytes_.find(cache);
+  if (found == cache_bytes_.end()) {
+    return false;
+  }
+  return found->second < max_bytes_ / cache_bytes_.size();
+}
+
+void RasterCacheBudget::TraceStatsToTimeline() const {
+#if !FLUTTER_RELEASE
+  FML_TRACE_COUNTER(
+      "flutter",                                                 //
+      "RasterCacheBudget", reinterpret_cast<int64_t>(this),      //
+      "CacheCount", cache_bytes_.size(),                         //
+      "TotalMBytes", total_bytes_ / kMegaByteSizeInBytes,        //
+      "MaxMBytes", max_bytes_ / kMegaByteSizeInBytes);
+#endif  // !FLUTTER_RELEASE
+}
+
+}  // namespace flutter
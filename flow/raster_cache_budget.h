@@ -0,0 +1,75 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_RASTER_CACHE_BUDGET_H_
+#define FLUTTER_FLOW_RASTER_CACHE_BUDGET_H_
+
+#include <mutex>
+#include <unordered_map>
+
+#include "flutter/fml/macros.h"
+
+namespace flutter {
+
+class RasterCache;
+
+//------------------------------------------------------------------------------
+/// A byte budget shared by the raster caches of several engines, such as a
+/// shell and the shells spawned from it, with per-cache accounting.
+///
+/// A cache may rasterize new entries while the caches together are under
+/// budget. Once they are over, a cache may still grow up to an equal share of
+/// the budget, so that one engine cannot starve the others. Entries that are
+/// already cached are never evicted for the budget; the caches shrink as they
+/// sweep the entries that their frames no longer use.
+///
+/// This class is thread safe.
+///
+class RasterCacheBudget {
+ public:
+  explicit RasterCacheBudget(size_t max_bytes);
+
+  ~RasterCacheBudget();
+
+  size_t GetMaxBytes() const { return max_bytes_; }
+
+  void AddCache(const RasterCache* cache);
+
+  void RemoveCache(const RasterCache* cache);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Sets the number of bytes that |cache| holds.
+  ///
+  void SetCacheBytes(const RasterCache* cache, size_t bytes);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Accounts for an image that |cache| has just added.
+  ///
+  void AddCacheBytes(const RasterCache* cache, size_t bytes);
+
+  size_t GetCacheBytes(const RasterCache* cache) const;
+
+  size_t GetTotalBytes() const;
+
+  size_t GetCacheCount() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether |cache| may rasterize new entries.
+  ///
+  bool CanGrow(const RasterCache* cache) const;
+
+ private:
+  const size_t max_bytes_;
+  mutable std::mutex mutex_;
+  std::unordered_map<const RasterCache*, size_t> cache_bytes_;
+  size_t total_bytes_ = 0;
+
+  void TraceStatsToTimeline() const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(RasterCacheBudget);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_RASTER_CACHE_BUDGET_H_
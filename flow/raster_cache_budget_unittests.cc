@@ -0,0 +1,79 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/raster_cache_budget.h"
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+// The budget only uses the caches as keys.
+const RasterCache* MakeCache(uintptr_t id) {
+  return reinterpret_cast<const RasterCache*>(id);
+}
+
+}  // namespace
+
+TEST(RasterCacheBudget, AccountsBytesPerCache) {
+  RasterCacheBudget budget(100);
+  auto first = MakeCache(1);
+  auto second = MakeCache(2);
+  budget.AddCache(first);
+  budget.AddCache(second);
+  EXPECT_EQ(budget.GetCacheCount(), 2u);
+
+  budget.AddCacheBytes(first, 10);
+  budget.AddCacheBytes(first, 20);
+  budget.SetCacheBytes(second, 40);
+  EXPECT_EQ(budget.GetCacheBytes(first), 30u);
+  EXPECT_EQ(budget.GetCacheBytes(second), 40u);
+  EXPECT_EQ(budget.GetTotalBytes(), 70u);
+
+  budget.SetCacheBytes(first, 5);
+  EXPECT_EQ(budget.GetTotalBytes(), 45u);
+
+  budget.RemoveCache(second);
+  EXPECT_EQ(budget.GetCacheCount(), 1u);
+  EXPECT_EQ(budget.GetCacheBytes(second), 0u);
+  EXPECT_EQ(budget.GetTotalBytes(), 5u);
+}
+
+TEST(RasterCacheBudget, CachesMayGrowToTheirShareWhenOverBudget) {
+  RasterCacheBudget budget(100);
+  auto first = MakeCache(1);
+  auto second = MakeCache(2);
+  budget.AddCache(first);
+  budget.AddCache(second);
+
+  budget.SetCacheBytes(first, 90);
+  EXPECT_TRUE(budget.CanGrow(first));
+  EXPECT_TRUE(budget.CanGrow(second));
+
+  budget.SetCacheBytes(second, 20);
+  EXPECT_FALSE(budget.CanGrow(first));
+  EXPECT_TRUE(budget.CanGrow(second));
+
+  budget.SetCacheBytes(second, 50);
+  EXPECT_FALSE(budget.CanGrow(first));
+  EXPECT_FALSE(budget.CanGrow(second));
+
+  budget.SetCacheBytes(first, 40);
+  EXPECT_TRUE(budget.CanGrow(first));
+  EXPECT_TRUE(budget.CanGrow(second));
+}
+
+TEST(RasterCacheBudget, UnknownCachesMayNotGrowWhenOverBudget) {
+  RasterCacheBudget budget(10);
+  auto cache = MakeCache(1);
+  EXPECT_TRUE(budget.CanGrow(cache));
+  budget.AddCache(cache);
+  budget.SetCacheBytes(cache, 10);
+  EXPECT_FALSE(budget.CanGrow(MakeCache(2)));
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -52,8 +52,9 @@ class RasterCacheKey {
 // The ID is the uint32_t picture uniqueID
 using PictureRasterCacheKey = RasterCacheKey<uint32_t>;
 
-// The ID is the uint32_t DisplayList uniqueID
-using DisplayListRasterCacheKey = RasterCacheKey<uint32_t>;
+// The ID is the uint64_t DisplayList content_hash, so that a display list
+// that is recorded again with the same ops reuses the cached image.
+using DisplayListRasterCacheKey = RasterCacheKey<uint64_t>;
 
 class Layer;
 
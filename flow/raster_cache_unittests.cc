@@ -2,15 +2,20 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+
 #include "flutter/display_list/display_list.h"
 #include "flutter/display_list/display_list_builder.h"
+#include "flutter/display_list/display_list_canvas_dispatcher.h"
 #include "flutter/flow/raster_cache.h"
 #include "flutter/flow/testing/mock_raster_cache.h"
 #include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkPaint.h"
 #include "third_party/skia/include/core/SkPicture.h"
 #include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/core/SkSurface.h"
 
 namespace flutter {
 namespace testing {
@@ -191,6 +196,143 @@ TEST(RasterCache, ThresholdIsRespectedForDisplayList) {
   ASSERT_TRUE(cache.Draw(*display_list, dummy_canvas));
 }
 
+TEST(RasterCache, DisplayListsAreAdmittedByOpCountByDefault) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  ASSERT_FALSE(cache.admits_display_lists_by_cost());
+
+  SkMatrix matrix = SkMatrix::I();
+
+  DisplayListBuilder builder;
+  builder.setMaskBlurFilter(kNormal_SkBlurStyle, 10);
+  builder.drawPath(SkPath::Circle(80, 80, 50));
+  auto few_ops = builder.Build();
+  ASSERT_LE(few_ops->op_count(true), 5);
+  auto many_ops = GetSampleNestedDisplayList();
+  ASSERT_GT(many_ops->op_count(true), 5);
+
+  SkCanvas dummy_canvas;
+
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder();
+
+  for (int i = 0; i < 3; i++) {
+    cache.PrepareNewFrame();
+    ASSERT_FALSE(cache.Prepare(&preroll_context_holder.preroll_context,
+                               few_ops.get(), false, false, matrix));
+    ASSERT_EQ(cache.Prepare(&preroll_context_holder.preroll_context,
+                            many_ops.get(), false, false, matrix),
+              i > 0);
+    cache.CleanupAfterFrame();
+  }
+}
+
+TEST(RasterCache, CheapDisplayListIsNotCachedUnlessComplex) {
+  size_t threshold = 2;
+  flutter::RasterCache cache(threshold);
+  cache.SetAdmitDisplayListsByCost(true);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto display_list = GetSampleDisplayList();
+
+  SkCanvas dummy_canvas;
+
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder();
+
+  for (int i = 0; i < 4; i++) {
+    cache.PrepareNewFrame();
+    ASSERT_FALSE(cache.Prepare(&preroll_context_holder.preroll_context,
+                               display_list.get(), false, false, matrix));
+    ASSERT_FALSE(cache.Draw(*display_list, dummy_canvas));
+    cache.CleanupAfterFrame();
+  }
+
+  // The caller knows better.
+  cache.PrepareNewFrame();
+  ASSERT_TRUE(cache.Prepare(&preroll_context_holder.preroll_context,
+                            display_list.get(), true, false, matrix));
+  ASSERT_TRUE(cache.Draw(*display_list, dummy_canvas));
+}
+
+TEST(RasterCache, ExpensiveDisplayListIsCachedWithFewOps) {
+  size_t threshold = 2;
+  flutter::RasterCache cache(threshold);
+  cache.SetAdmitDisplayListsByCost(true);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  DisplayListBuilder builder;
+  builder.setMaskBlurFilter(kNormal_SkBlurStyle, 10);
+  builder.drawPath(SkPath::Circle(80, 80, 50));
+  auto display_list = builder.Build();
+  ASSERT_LE(display_list->op_count(true), 5);
+
+  SkCanvas dummy_canvas;
+
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder();
+
+  for (size_t i = 0; i < threshold; i++) {
+    cache.PrepareNewFrame();
+    ASSERT_FALSE(cache.Prepare(&preroll_context_holder.preroll_context,
+                               display_list.get(), false, false, matrix));
+    ASSERT_FALSE(cache.Draw(*display_list, dummy_canvas));
+    cache.CleanupAfterFrame();
+  }
+
+  cache.PrepareNewFrame();
+  ASSERT_TRUE(cache.Prepare(&preroll_context_holder.preroll_context,
+                            display_list.get(), false, false, matrix));
+  ASSERT_TRUE(cache.Draw(*display_list, dummy_canvas));
+}
+
+TEST(RasterCache, ShadowsOfIdenticalShapesShareAnEntry) {
+  size_t threshold = 2;
+  flutter::RasterCache cache(threshold);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  // Shapes are moved to the origin, with the offsets moving them back. Each
+  // shadow gets its own path, as two layers with the same shape would.
+  auto make_path = []() {
+    return SkPath::RRect(SkRRect::MakeRectXY({0, 0, 100, 100}, 10, 10));
+  };
+  auto make_shadow = [](const SkPath& path) {
+    DisplayListBuilder builder;
+    builder.drawShadow(path, SK_ColorBLACK, 20, false, 1);
+    return builder.Build();
+  };
+  SkPath path = make_path();
+  SkPath same_path = make_path();
+  auto shadow = make_shadow(path);
+  auto same_shadow = make_shadow(same_path);
+  SkRect bounds =
+      DisplayListCanvasDispatcher::ComputeShadowBounds(path, 20, 1, matrix);
+  SkPoint offset = SkPoint::Make(10, 10);
+  SkPoint other_offset = SkPoint::Make(200, 50);
+
+  SkCanvas dummy_canvas;
+
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder();
+
+  for (size_t i = 0; i < threshold; i++) {
+    cache.PrepareNewFrame();
+    ASSERT_FALSE(cache.PrepareShadow(&preroll_context_holder.preroll_context,
+                                     shadow.get(), bounds, matrix, offset));
+    ASSERT_FALSE(cache.DrawShadow(*shadow, dummy_canvas, offset));
+    cache.CleanupAfterFrame();
+  }
+
+  cache.PrepareNewFrame();
+  ASSERT_TRUE(cache.PrepareShadow(&preroll_context_holder.preroll_context,
+                                  shadow.get(), bounds, matrix, offset));
+  ASSERT_TRUE(cache.DrawShadow(*shadow, dummy_canvas, offset));
+  ASSERT_TRUE(cache.PrepareShadow(&preroll_context_holder.preroll_context,
+                                  same_shadow.get(), bounds, matrix,
+                                  other_offset));
+  ASSERT_TRUE(cache.DrawShadow(*same_shadow, dummy_canvas, other_offset));
+  ASSERT_EQ(cache.GetShadowCachedEntriesCount(), 1u);
+}
+
 TEST(RasterCache, AccessThresholdOfZeroDisablesCachingForSkPicture) {
   size_t threshold = 0;
   flutter::RasterCache cache(threshold);
@@ -541,6 +683,210 @@ TEST(RasterCache, DisplayListWithSingularMatrixIsNotCached) {
   }
 }
 
+TEST(RasterCache, DisplayListsWithSameContentShareEntries) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+
+  SkMatrix matrix = SkMatrix::I();
+  SkCanvas dummy_canvas;
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder();
+
+  // Each frame records the same content into a new display list, like a
+  // framework rebuild would.
+  for (int i = 0; i < 3; i++) {
+    auto display_list = GetSampleDisplayList();
+    cache.PrepareNewFrame();
+    ASSERT_EQ(cache.Prepare(&preroll_context_holder.preroll_context,
+                            display_list.get(), true, false, matrix),
+              i > 0);
+    ASSERT_EQ(cache.Draw(*display_list, dummy_canvas), i > 0);
+    cache.CleanupAfterFrame();
+    ASSERT_EQ(cache.GetPictureCachedEntriesCount(), 1u);
+  }
+
+  // Different content does not match the entry.
+  DisplayListBuilder builder(SkRect::MakeWH(150, 100));
+  builder.setColor(SK_ColorBLUE);
+  builder.drawRect(SkRect::MakeXYWH(10, 10, 80, 80));
+  auto other_display_list = builder.Build();
+  ASSERT_FALSE(cache.Draw(*other_display_list, dummy_canvas));
+}
+
+TEST(RasterCache, SharedBudgetLimitsNewEntries) {
+  size_t threshold = 1;
+  auto picture = GetSamplePicture();
+  SkMatrix matrix = SkMatrix::I();
+  SkCanvas dummy_canvas;
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder();
+
+  // Large enough for one image but not for two.
+  auto budget = std::make_shared<RasterCacheBudget>(1);
+  flutter::RasterCache first_cache(threshold);
+  flutter::RasterCache second_cache(threshold);
+  first_cache.SetBudget(budget);
+  second_cache.SetBudget(budget);
+
+  auto prepare_and_draw = [&](flutter::RasterCache& cache) {
+    cache.PrepareNewFrame();
+    bool cached = cache.Prepare(&preroll_context_holder.preroll_context,
+                                picture.get(), true, false, matrix);
+    cache.Draw(*picture, dummy_canvas);
+    cache.CleanupAfterFrame();
+    return cached;
+  };
+
+  ASSERT_FALSE(prepare_and_draw(first_cache));
+  ASSERT_TRUE(prepare_and_draw(first_cache));
+  ASSERT_GT(budget->GetCacheBytes(&first_cache), 0u);
+  ASSERT_EQ(budget->GetTotalBytes(), budget->GetCacheBytes(&first_cache));
+
+  ASSERT_FALSE(prepare_and_draw(second_cache));
+  ASSERT_FALSE(prepare_and_draw(second_cache));
+  ASSERT_EQ(budget->GetCacheBytes(&second_cache), 0u);
+
+  // Once the first cache lets go of its image, the second one may grow.
+  first_cache.Clear();
+  ASSERT_EQ(budget->GetTotalBytes(), 0u);
+  ASSERT_FALSE(prepare_and_draw(second_cache));
+  ASSERT_TRUE(prepare_and_draw(second_cache));
+}
+
+TEST(RasterCache, ScaleBucketsRoundScalesUpToPowersOfTheStep) {
+  flutter::RasterCache cache;
+  SkMatrix bucket_matrix;
+  ASSERT_FALSE(
+      cache.GetScaleBucketMatrix(SkMatrix::Scale(1.5, 1.5), &bucket_matrix));
+
+  RasterCacheScaleBuckets buckets;
+  buckets.step = 2;
+  cache.SetScaleBuckets(buckets);
+
+  ASSERT_TRUE(
+      cache.GetScaleBucketMatrix(SkMatrix::Scale(1.5, 0.3), &bucket_matrix));
+  ASSERT_EQ(bucket_matrix, SkMatrix::Scale(2, 0.5));
+  // Translations are dropped and exact powers of the step keep their scale.
+  SkMatrix matrix = SkMatrix::Translate(10.5, 3.25);
+  matrix.preScale(2, 1);
+  ASSERT_TRUE(cache.GetScaleBucketMatrix(matrix, &bucket_matrix));
+  ASSERT_EQ(bucket_matrix, SkMatrix::Scale(2, 1));
+
+  // Rotations, flips and large scales are not bucketed.
+  ASSERT_FALSE(
+      cache.GetScaleBucketMatrix(SkMatrix::RotateDeg(45), &bucket_matrix));
+  ASSERT_FALSE(
+      cache.GetScaleBucketMatrix(SkMatrix::Scale(-1, 1), &bucket_matrix));
+  ASSERT_FALSE(
+      cache.GetScaleBucketMatrix(SkMatrix::Scale(5, 5), &bucket_matrix));
+
+  buckets.step = 1.1;
+  cache.SetScaleBuckets(buckets);
+  ASSERT_TRUE(
+      cache.GetScaleBucketMatrix(SkMatrix::Scale(1.05, 1.05), &bucket_matrix));
+  ASSERT_NEAR(bucket_matrix.getScaleX(), 1.1, 1e-5);
+}
+
+TEST(RasterCache, ZoomAnimationHitsScaleBuckets) {
+  size_t threshold = 2;
+  auto display_list = GetSampleDisplayList();
+  SkCanvas dummy_canvas;
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder();
+
+  // Zooms from a scale of 1.05 to 1.95 over 30 frames while the display list
+  // also moves by fractional pixels. Returns how many frames were drawn from
+  // the cache.
+  auto animate_zoom = [&](flutter::RasterCache& cache) {
+    int hit_count = 0;
+    for (int frame = 0; frame < 30; frame++) {
+      SkScalar scale = 1.05 + frame * 0.03;
+      SkMatrix matrix = SkMatrix::Translate(frame * 0.3, frame * 0.7);
+      matrix.preScale(scale, scale);
+      cache.PrepareNewFrame();
+      cache.Prepare(&preroll_context_holder.preroll_context,
+                    display_list.get(), true, false, matrix);
+      dummy_canvas.setMatrix(matrix);
+      if (cache.Draw(*display_list, dummy_canvas)) {
+        hit_count++;
+      }
+      cache.CleanupAfterFrame();
+    }
+    return hit_count;
+  };
+
+  flutter::RasterCache exact_cache(threshold);
+  ASSERT_EQ(animate_zoom(exact_cache), 0);
+
+  flutter::RasterCache bucketed_cache(threshold);
+  RasterCacheScaleBuckets buckets;
+  buckets.step = 2;
+  bucketed_cache.SetScaleBuckets(buckets);
+  ASSERT_EQ(animate_zoom(bucketed_cache), 30 - static_cast<int>(threshold));
+  ASSERT_EQ(bucketed_cache.GetPictureCachedEntriesCount(), 1u);
+}
+
+TEST(RasterCache, ScaleBucketEntriesLookLikeTheDisplayList) {
+  DisplayListBuilder builder(SkRect::MakeWH(150, 100));
+  builder.setColor(SK_ColorRED);
+  builder.drawRect(SkRect::MakeXYWH(10, 10, 80, 80));
+  builder.setAntiAlias(true);
+  builder.setColor(SK_ColorBLUE);
+  builder.drawCircle({100, 50}, 40);
+  auto display_list = builder.Build();
+
+  SkMatrix matrix = SkMatrix::Translate(10.4, 7.7);
+  matrix.preScale(1.3, 1.3);
+  const SkImageInfo info = SkImageInfo::MakeN32Premul(220, 150);
+
+  auto expected_surface = SkSurface::MakeRaster(info);
+  expected_surface->getCanvas()->setMatrix(matrix);
+  display_list->RenderTo(expected_surface->getCanvas());
+
+  flutter::RasterCache cache(1);
+  RasterCacheScaleBuckets buckets;
+  buckets.step = 2;
+  cache.SetScaleBuckets(buckets);
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder();
+  auto surface = SkSurface::MakeRaster(info);
+  surface->getCanvas()->setMatrix(matrix);
+  cache.PrepareNewFrame();
+  cache.Prepare(&preroll_context_holder.preroll_context, display_list.get(),
+                true, false, matrix);
+  cache.Draw(*display_list, *surface->getCanvas());
+  cache.CleanupAfterFrame();
+  cache.PrepareNewFrame();
+  ASSERT_TRUE(cache.Prepare(&preroll_context_holder.preroll_context,
+                            display_list.get(), true, false, matrix));
+  surface->getCanvas()->clear(SK_ColorTRANSPARENT);
+  ASSERT_TRUE(cache.Draw(*display_list, *surface->getCanvas()));
+
+  SkBitmap expected;
+  SkBitmap actual;
+  expected.allocPixels(info);
+  actual.allocPixels(info);
+  ASSERT_TRUE(expected_surface->readPixels(expected, 0, 0));
+  ASSERT_TRUE(surface->readPixels(actual, 0, 0));
+
+  // Filtering only changes the anti-aliased edges, and only by a little.
+  int differing_pixels = 0;
+  for (int y = 0; y < info.height(); y++) {
+    for (int x = 0; x < info.width(); x++) {
+      SkColor a = expected.getColor(x, y);
+      SkColor b = actual.getColor(x, y);
+      int difference = std::max(
+          {std::abs(static_cast<int>(SkColorGetA(a) - SkColorGetA(b))),
+           std::abs(static_cast<int>(SkColorGetR(a) - SkColorGetR(b))),
+           std::abs(static_cast<int>(SkColorGetG(a) - SkColorGetG(b))),
+           std::abs(static_cast<int>(SkColorGetB(a) - SkColorGetB(b)))});
+      if (difference > 32) {
+        differing_pixels++;
+      }
+    }
+  }
+  ASSERT_LT(differing_pixels, info.width() * info.height() / 50);
+  ASSERT_EQ(actual.getColor(40, 40), SK_ColorRED);
+  ASSERT_EQ(actual.getColor(140, 72), SK_ColorBLUE);
+  ASSERT_EQ(actual.getColor(215, 145), SK_ColorTRANSPARENT);
+}
+
 }  // namespace testing
 
 }  // namespace flutter
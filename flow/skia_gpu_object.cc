@@ -11,9 +11,11 @@ namespace flutter {
 
 SkiaUnrefQueue::SkiaUnrefQueue(fml::RefPtr<fml::TaskRunner> task_runner,
                                fml::TimeDelta delay,
-                               fml::WeakPtr<GrDirectContext> context)
+                               fml::WeakPtr<GrDirectContext> context,
+                               fml::TimeDelta drain_budget)
     : task_runner_(std::move(task_runner)),
       drain_delay_(delay),
+      drain_budget_(drain_budget),
       drain_pending_(false),
       context_(context) {}
 
@@ -21,27 +23,38 @@ SkiaUnrefQueue::~SkiaUnrefQueue() {
   FML_DCHECK(objects_.empty());
 }
 
-void SkiaUnrefQueue::Unref(SkRefCnt* object) {
+void SkiaUnrefQueue::Unref(SkRefCnt* object, size_t bytes) {
   std::scoped_lock lock(mutex_);
-  objects_.push_back(object);
+  objects_.push_back({object, bytes});
+  queued_bytes_ += bytes;
   if (!drain_pending_) {
     drain_pending_ = true;
     task_runner_->PostDelayedTask(
-        [strong = fml::Ref(this)]() { strong->Drain(); }, drain_delay_);
+        [strong = fml::Ref(this)]() { strong->DrainWithinBudget(); },
+        drain_delay_);
+  }
+  // Do not hold on to large amounts of GPU memory for the whole drain delay.
+  if (queued_bytes_ >= kMaxQueuedBytes && !immediate_drain_pending_) {
+    immediate_drain_pending_ = true;
+    task_runner_->PostTask(
+        [strong = fml::Ref(this)]() { strong->DrainWithinBudget(); });
   }
 }
 
 void SkiaUnrefQueue::Drain() {
   TRACE_EVENT0("flutter", "SkiaUnrefQueue::Drain");
-  std::deque<SkRefCnt*> skia_objects;
+  std::deque<QueuedObject> skia_objects;
   {
     std::scoped_lock lock(mutex_);
     objects_.swap(skia_objects);
+    queued_bytes_ = 0;
     drain_pending_ = false;
+    immediate_drain_pending_ = false;
+    TraceQueuedObjects();
   }
 
-  for (SkRefCnt* skia_object : skia_objects) {
-    skia_object->unref();
+  for (const QueuedObject& skia_object : skia_objects) {
+    skia_object.object->unref();
   }
 
   if (context_ && skia_objects.size() > 0) {
@@ -49,4 +62,71 @@ void SkiaUnrefQueue::Drain() {
   }
 }
 
+size_t SkiaUnrefQueue::GetQueuedBytes() {
+  std::scoped_lock lock(mutex_);
+  return queued_bytes_;
+}
+
+bool SkiaUnrefQueue::DrainUntil(fml::TimePoint deadline) {
+  TRACE_EVENT0("flutter", "SkiaUnrefQueue::DrainUntil");
+  std::deque<QueuedObject> skia_objects;
+  {
+    std::scoped_lock lock(mutex_);
+    if (objects_.empty()) {
+      return false;
+    }
+    objects_.swap(skia_objects);
+  }
+
+  size_t released_bytes = ReleaseObjects(&skia_objects, deadline);
+
+  // Release the GPU memory of the whole batch at once.
+  if (context_) {
+    context_->performDeferredCleanup(std::chrono::milliseconds(0));
+  }
+
+  std::scoped_lock lock(mutex_);
+  queued_bytes_ -= released_bytes;
+  // Objects queued during this drain go after the ones that did not fit
+  // before the deadline.
+  objects_.insert(objects_.begin(), skia_objects.begin(), skia_objects.end());
+  TraceQueuedObjects();
+  return !objects_.empty();
+}
+
+void SkiaUnrefQueue::DrainWithinBudget() {
+  TRACE_EVENT0("flutter", "SkiaUnrefQueue::DrainWithinBudget");
+  DrainUntil(fml::TimePoint::Now() + drain_budget_);
+
+  std::scoped_lock lock(mutex_);
+  if (objects_.empty()) {
+    drain_pending_ = false;
+    immediate_drain_pending_ = false;
+  } else {
+    task_runner_->PostTask(
+        [strong = fml::Ref(this)]() { strong->DrainWithinBudget(); });
+  }
+}
+
+size_t SkiaUnrefQueue::ReleaseObjects(std::deque<QueuedObject>* objects,
+                                      fml::TimePoint deadline) {
+  size_t released_bytes = 0;
+  do {
+    const QueuedObject& skia_object = objects->front();
+    skia_object.object->unref();
+    released_bytes += skia_object.bytes;
+    objects->pop_front();
+  } while (!objects->empty() && fml::TimePoint::Now() < deadline);
+  return released_bytes;
+}
+
+void SkiaUnrefQueue::TraceQueuedObjects() const {
+#if !FLUTTER_RELEASE
+  FML_TRACE_COUNTER("flutter", "SkiaUnrefQueue",
+                    reinterpret_cast<int64_t>(this),  //
+                    "QueuedObjects", objects_.size(),  //
+                    "QueuedBytes", queued_bytes_);
+#endif  // !FLUTTER_RELEASE
+}
+
 }  // namespace flutter
@@ -7,10 +7,13 @@
 
 #include <mutex>
 #include <queue>
+#include <type_traits>
 
 #include "flutter/fml/memory/ref_counted.h"
 #include "flutter/fml/memory/weak_ptr.h"
 #include "flutter/fml/task_runner.h"
+#include "flutter/fml/time/time_point.h"
+#include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkRefCnt.h"
 #include "third_party/skia/include/gpu/GrDirectContext.h"
 
@@ -18,23 +21,69 @@ namespace flutter {
 
 // A queue that holds Skia objects that must be destructed on the given task
 // runner.
+//
+// Objects are released in batches, some time after they were queued. Each
+// batch runs for at most the drain budget, so that releasing a large number of
+// textures does not block the task runner for long, and ends with a single
+// cleanup of the GrDirectContext. Objects that do not fit into the budget are
+// released by a follow-up task, which lets other tasks run in between.
 class SkiaUnrefQueue : public fml::RefCountedThreadSafe<SkiaUnrefQueue> {
  public:
-  void Unref(SkRefCnt* object);
+  // The default time that a single batch of releases may take.
+  static constexpr fml::TimeDelta kDefaultDrainBudget =
+      fml::TimeDelta::FromMilliseconds(2);
+
+  // The number of queued bytes above which the queue is drained without
+  // waiting for the drain delay.
+  static constexpr size_t kMaxQueuedBytes = 64 * 1024 * 1024;
+
+  // Queues |object| for release. |bytes| is the GPU memory that is freed
+  // along with the object, if known.
+  void Unref(SkRefCnt* object, size_t bytes = 0);
 
   // Usually, the drain is called automatically. However, during IO manager
   // shutdown (when the platform side reference to the OpenGL context is about
-  // to go away), we may need to pre-emptively drain the unref queue. It is the
+  // to go away), or when the system is low on memory, we may need to
+  // pre-emptively drain the unref queue. This drain releases all queued
+  // objects regardless of the drain budget. During shutdown, it is the
   // responsibility of the caller to ensure that no further unrefs are queued
   // after this call.
   void Drain();
 
+  // Releases queued objects until |deadline|, for use when the engine is idle.
+  // Always releases at least one object if any are queued. Must be called on
+  // the task runner of the queue. Returns whether objects are still queued.
+  bool DrainUntil(fml::TimePoint deadline);
+
+  // The number of bytes held by queued objects.
+  size_t GetQueuedBytes();
+
  private:
+  struct QueuedObject {
+    SkRefCnt* object;
+    size_t bytes;
+  };
+
+  // Releases queued objects until the drain budget is used up, then schedules
+  // another drain if any are left.
+  void DrainWithinBudget();
+
+  // Releases the objects in |objects| in order, until |deadline| has passed.
+  // Always releases at least one object. Returns the number of bytes freed.
+  size_t ReleaseObjects(std::deque<QueuedObject>* objects,
+                        fml::TimePoint deadline);
+
+  // Traces the queue size. Must be called with |mutex_| held.
+  void TraceQueuedObjects() const;
+
   const fml::RefPtr<fml::TaskRunner> task_runner_;
   const fml::TimeDelta drain_delay_;
+  const fml::TimeDelta drain_budget_;
   std::mutex mutex_;
-  std::deque<SkRefCnt*> objects_;
+  std::deque<QueuedObject> objects_;
+  size_t queued_bytes_ = 0;
   bool drain_pending_;
+  bool immediate_drain_pending_ = false;
   fml::WeakPtr<GrDirectContext> context_;
 
   // The `GrDirectContext* context` is only used for signaling Skia to
@@ -42,7 +91,8 @@ class SkiaUnrefQueue : public fml::RefCountedThreadSafe<SkiaUnrefQueue> {
   // (e.g., in unit tests).
   SkiaUnrefQueue(fml::RefPtr<fml::TaskRunner> task_runner,
                  fml::TimeDelta delay,
-                 fml::WeakPtr<GrDirectContext> context = {});
+                 fml::WeakPtr<GrDirectContext> context = {},
+                 fml::TimeDelta drain_budget = kDefaultDrainBudget);
 
   ~SkiaUnrefQueue();
 
@@ -73,7 +123,11 @@ class SkiaGPUObject {
 
   void reset() {
     if (object_ && queue_) {
-      queue_->Unref(object_.release());
+      size_t bytes = 0;
+      if constexpr (std::is_base_of_v<SkImage, SkiaObjectType>) {
+        bytes = object_->textureSize();
+      }
+      queue_->Unref(object_.release(), bytes);
     }
     queue_ = nullptr;
     FML_DCHECK(object_ == nullptr);
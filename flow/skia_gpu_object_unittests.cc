@@ -4,9 +4,12 @@
 
 #include "flutter/flow/skia_gpu_object.h"
 
+#include <atomic>
 #include <future>
+#include <thread>
 
 #include "flutter/fml/message_loop.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
 #include "flutter/fml/synchronization/waitable_event.h"
 #include "flutter/fml/task_runner.h"
 #include "flutter/testing/thread_test.h"
@@ -34,6 +37,38 @@ class TestSkObject : public SkRefCnt {
   fml::TaskQueueId* dtor_task_queue_id_;
 };
 
+// An object that takes a while to release, like a large texture.
+class SlowTestSkObject : public SkRefCnt {
+ public:
+  SlowTestSkObject(std::atomic<size_t>* released_count,
+                   fml::CountDownLatch* latch)
+      : released_count_(released_count), latch_(latch) {}
+
+  ~SlowTestSkObject() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    (*released_count_)++;
+    latch_->CountDown();
+  }
+
+ private:
+  std::atomic<size_t>* released_count_;
+  fml::CountDownLatch* latch_;
+};
+
+// An object that queues another object when it is released, like an image
+// that holds on to a texture.
+class QueueingTestSkObject : public SkRefCnt {
+ public:
+  QueueingTestSkObject(fml::RefPtr<SkiaUnrefQueue> queue, SkRefCnt* object)
+      : queue_(std::move(queue)), object_(object) {}
+
+  ~QueueingTestSkObject() { queue_->Unref(object_); }
+
+ private:
+  fml::RefPtr<SkiaUnrefQueue> queue_;
+  SkRefCnt* object_;
+};
+
 class SkiaGpuObjectTest : public ThreadTest {
  public:
   SkiaGpuObjectTest()
@@ -127,5 +162,104 @@ TEST_F(SkiaGpuObjectTest, ObjectResetTwice) {
   ASSERT_EQ(dtor_task_queue_id, unref_task_runner()->GetTaskQueueId());
 }
 
+TEST_F(SkiaGpuObjectTest, DrainIsSplitIntoBudgetedBatches) {
+  constexpr size_t kObjectCount = 100;
+  // As in the fixture, the queue must be created on the unref task runner.
+  fml::RefPtr<SkiaUnrefQueue> queue;
+  std::promise<bool> queue_created;
+  unref_task_runner()->PostTask([this, &queue, &queue_created]() {
+    queue = fml::MakeRefCounted<SkiaUnrefQueue>(
+        unref_task_runner(), fml::TimeDelta::FromSeconds(0),
+        fml::WeakPtr<GrDirectContext>(), fml::TimeDelta::FromMilliseconds(4));
+    queue_created.set_value(true);
+  });
+  queue_created.get_future().wait();
+  std::atomic<size_t> released_count = 0;
+  fml::CountDownLatch latch(kObjectCount);
+
+  // Block the task runner while queueing, so that all objects are released by
+  // the drains that follow.
+  fml::AutoResetWaitableEvent queued;
+  unref_task_runner()->PostTask([&queued]() { queued.Wait(); });
+  for (size_t i = 0; i < kObjectCount; i++) {
+    queue->Unref(new SlowTestSkObject(&released_count, &latch));
+  }
+  // A task posted now runs after the first drain, which must not release all
+  // objects at once.
+  std::promise<size_t> released_before_task;
+  unref_task_runner()->PostTask([&released_count, &released_before_task]() {
+    released_before_task.set_value(released_count);
+  });
+  queued.Signal();
+
+  size_t released = released_before_task.get_future().get();
+  EXPECT_GE(released, 1u);
+  EXPECT_LT(released, kObjectCount / 2);
+
+  latch.Wait();
+  EXPECT_EQ(released_count, kObjectCount);
+  EXPECT_EQ(queue->GetQueuedBytes(), 0u);
+}
+
+TEST_F(SkiaGpuObjectTest, DrainReleasesEverythingAtOnce) {
+  constexpr size_t kObjectCount = 10;
+  std::atomic<size_t> released_count = 0;
+  fml::CountDownLatch latch(kObjectCount);
+  for (size_t i = 0; i < kObjectCount; i++) {
+    delayed_unref_queue()->Unref(
+        new SlowTestSkObject(&released_count, &latch), 100);
+  }
+  EXPECT_EQ(delayed_unref_queue()->GetQueuedBytes(), kObjectCount * 100);
+
+  unref_task_runner()->PostTask(
+      [queue = delayed_unref_queue()]() { queue->Drain(); });
+  latch.Wait();
+  EXPECT_EQ(delayed_unref_queue()->GetQueuedBytes(), 0u);
+}
+
+TEST_F(SkiaGpuObjectTest, DrainUntilStopsAtDeadline) {
+  constexpr size_t kObjectCount = 50;
+  std::atomic<size_t> released_count = 0;
+  fml::CountDownLatch latch(kObjectCount);
+  for (size_t i = 0; i < kObjectCount; i++) {
+    delayed_unref_queue()->Unref(
+        new SlowTestSkObject(&released_count, &latch), 100);
+  }
+
+  std::promise<bool> has_more;
+  unref_task_runner()->PostTask([queue = delayed_unref_queue(), &has_more]() {
+    has_more.set_value(queue->DrainUntil(fml::TimePoint::Now() +
+                                         fml::TimeDelta::FromMilliseconds(5)));
+  });
+  EXPECT_TRUE(has_more.get_future().get());
+  EXPECT_GE(released_count, 1u);
+  EXPECT_LT(released_count, kObjectCount);
+  EXPECT_EQ(delayed_unref_queue()->GetQueuedBytes(),
+            (kObjectCount - released_count) * 100);
+
+  unref_task_runner()->PostTask(
+      [queue = delayed_unref_queue()]() { queue->Drain(); });
+  latch.Wait();
+}
+
+TEST_F(SkiaGpuObjectTest, ObjectsQueuedDuringDrainAreReleased) {
+  std::shared_ptr<fml::AutoResetWaitableEvent> latch =
+      std::make_shared<fml::AutoResetWaitableEvent>();
+  // The inner object is queued while the drain that releases the outer one
+  // is running, so no new drain is scheduled for it.
+  unref_queue()->Unref(new QueueingTestSkObject(
+      unref_queue(), new TestSkObject(latch, nullptr)));
+  EXPECT_FALSE(latch->WaitWithTimeout(fml::TimeDelta::FromSeconds(5)));
+}
+
+TEST_F(SkiaGpuObjectTest, LargeQueuesAreDrainedEarly) {
+  std::shared_ptr<fml::AutoResetWaitableEvent> latch =
+      std::make_shared<fml::AutoResetWaitableEvent>();
+  // The delayed queue waits three seconds before draining small queues.
+  delayed_unref_queue()->Unref(new TestSkObject(latch, nullptr),
+                               SkiaUnrefQueue::kMaxQueuedBytes);
+  EXPECT_FALSE(latch->WaitWithTimeout(fml::TimeDelta::FromSeconds(1)));
+}
+
 }  // namespace testing
 }  // namespace flutter
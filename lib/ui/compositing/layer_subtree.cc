@@ -0,0 +1,77 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/compositing/layer_subtree.h"
+
+#include "flutter/fml/logging.h"
+
+namespace flutter {
+
+LayerSubtreeKey::LayerSubtreeKey(Type type) : type_(type) {}
+
+LayerSubtreeKey::~LayerSubtreeKey() = default;
+
+void LayerSubtreeKey::AddValue(double value) {
+  values_.push_back(value);
+}
+
+void LayerSubtreeKey::AddMatrix(const SkMatrix& matrix) {
+  for (int i = 0; i < 9; i++) {
+    values_.push_back(matrix[i]);
+  }
+}
+
+void LayerSubtreeKey::AddRect(const SkRect& rect) {
+  values_.insert(values_.end(),
+                 {rect.fLeft, rect.fTop, rect.fRight, rect.fBottom});
+}
+
+void LayerSubtreeKey::AddRRect(const SkRRect& rrect) {
+  AddRect(rrect.rect());
+  for (int corner = 0; corner < 4; corner++) {
+    SkVector radii = rrect.radii(static_cast<SkRRect::Corner>(corner));
+    values_.insert(values_.end(), {radii.fX, radii.fY});
+  }
+}
+
+void LayerSubtreeKey::AddObject(const void* object) {
+  objects_.push_back(object);
+}
+
+void LayerSubtreeKey::SetPath(const SkPath& path) {
+  FML_DCHECK(!path_.has_value());
+  path_ = path;
+}
+
+bool LayerSubtreeKey::operator==(const LayerSubtreeKey& other) const {
+  return type_ == other.type_ && values_ == other.values_ &&
+         objects_ == other.objects_ && path_ == other.path_;
+}
+
+bool LayerSubtree::Matches(const LayerSubtree& other) const {
+  if (key != other.key || children.size() != other.children.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < children.size(); i++) {
+    if (children[i].layer != other.children[i].layer) {
+      return false;
+    }
+  }
+  return true;
+}
+
+const LayerSubtree::Child* LayerSubtree::FindPicture(
+    size_t index,
+    const LayerSubtreeKey& key) const {
+  if (index >= children.size()) {
+    return nullptr;
+  }
+  const Child& child = children[index];
+  if (!child.key || *child.key != key) {
+    return nullptr;
+  }
+  return &child;
+}
+
+}  // namespace flutter
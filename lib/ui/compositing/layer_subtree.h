@@ -0,0 +1,101 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_COMPOSITING_LAYER_SUBTREE_H_
+#define FLUTTER_LIB_UI_COMPOSITING_LAYER_SUBTREE_H_
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "flutter/flow/layers/layer.h"
+#include "third_party/skia/include/core/SkMatrix.h"
+#include "third_party/skia/include/core/SkPath.h"
+#include "third_party/skia/include/core/SkRRect.h"
+#include "third_party/skia/include/core/SkRect.h"
+
+namespace flutter {
+
+// The parameters a layer was created with by |SceneBuilder|. Two layers with
+// equal keys and identical children paint identically.
+//
+// Objects such as pictures and filters are compared by identity. The layer
+// the key was built for holds a reference to them, so their addresses cannot
+// be reused while the key is compared against.
+class LayerSubtreeKey {
+ public:
+  enum class Type {
+    kContainer,
+    kTransform,
+    kClipRect,
+    kClipRRect,
+    kClipPath,
+    kOpacity,
+    kColorFilter,
+    kImageFilter,
+    kBackdropFilter,
+    kShaderMask,
+    kPhysicalShape,
+    kPicture,
+    kDisplayList,
+  };
+
+  explicit LayerSubtreeKey(Type type);
+
+  ~LayerSubtreeKey();
+
+  void AddValue(double value);
+
+  void AddMatrix(const SkMatrix& matrix);
+
+  void AddRect(const SkRect& rect);
+
+  void AddRRect(const SkRRect& rrect);
+
+  void AddObject(const void* object);
+
+  void SetPath(const SkPath& path);
+
+  bool operator==(const LayerSubtreeKey& other) const;
+
+  bool operator!=(const LayerSubtreeKey& other) const {
+    return !(*this == other);
+  }
+
+ private:
+  Type type_;
+  std::vector<double> values_;
+  std::vector<const void*> objects_;
+  std::optional<SkPath> path_;
+};
+
+// Describes how a container layer and its direct children were built by
+// |SceneBuilder|. It is kept with the |EngineLayer| of the container so that
+// the next frame can share the layers of subtrees that did not change.
+struct LayerSubtree {
+  struct Child {
+    std::shared_ptr<Layer> layer;
+    // Set for pictures, which are shared if an equal picture is added at the
+    // same position. Containers are shared by |SceneBuilder| when they are
+    // popped, so any other child is matched by identity.
+    std::shared_ptr<const LayerSubtreeKey> key;
+  };
+
+  explicit LayerSubtree(LayerSubtreeKey key) : key(std::move(key)) {}
+
+  // Whether a layer built as |other| would paint identically to the layer
+  // built as this subtree.
+  bool Matches(const LayerSubtree& other) const;
+
+  // Returns the |index|th child of this subtree if it is a picture that was
+  // built with |key|, or nullptr.
+  const Child* FindPicture(size_t index, const LayerSubtreeKey& key) const;
+
+  const LayerSubtreeKey key;
+  std::vector<Child> children;
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_COMPOSITING_LAYER_SUBTREE_H_
@@ -23,6 +23,7 @@
 #include "flutter/flow/layers/texture_layer.h"
 #include "flutter/flow/layers/transform_layer.h"
 #include "flutter/fml/build_config.h"
+#include "flutter/fml/trace_event.h"
 #include "flutter/lib/ui/painting/matrix.h"
 #include "flutter/lib/ui/painting/shader.h"
 #include "third_party/skia/include/core/SkColorFilter.h"
@@ -74,7 +75,11 @@ void SceneBuilder::RegisterNatives(tonic::DartLibraryNatives* natives) {
 SceneBuilder::SceneBuilder() {
   // Add a ContainerLayer as the root layer, so that AddLayer operations are
   // always valid.
-  PushLayer(std::make_shared<flutter::ContainerLayer>());
+  layer_stack_.push_back(std::make_shared<flutter::ContainerLayer>());
+  PendingSubtree root;
+  root.subtree = std::make_shared<LayerSubtree>(
+      LayerSubtreeKey(LayerSubtreeKey::Type::kContainer));
+  pending_subtrees_.push_back(std::move(root));
 }
 
 SceneBuilder::~SceneBuilder() = default;
@@ -83,15 +88,14 @@ void SceneBuilder::pushTransform(Dart_Handle layer_handle,
                                  tonic::Float64List& matrix4,
                                  fml::RefPtr<EngineLayer> oldLayer) {
   SkMatrix sk_matrix = ToSkMatrix(matrix4);
-  auto layer = std::make_shared<flutter::TransformLayer>(sk_matrix);
-  PushLayer(layer);
   // matrix4 has to be released before we can return another Dart object
   matrix4.Release();
-  EngineLayer::MakeRetained(layer_handle, layer);
-
-  if (oldLayer && oldLayer->Layer()) {
-    layer->AssignOldLayer(oldLayer->Layer().get());
-  }
+  LayerSubtreeKey key(LayerSubtreeKey::Type::kTransform);
+  key.AddMatrix(sk_matrix);
+  ContainerLayerParams params;
+  params.type = LayerSubtreeKey::Type::kTransform;
+  params.matrix = sk_matrix;
+  PushLayer(layer_handle, std::move(params), std::move(key), oldLayer);
 }
 
 void SceneBuilder::pushOffset(Dart_Handle layer_handle,
@@ -99,13 +103,12 @@ void SceneBuilder::pushOffset(Dart_Handle layer_handle,
                               double dy,
                               fml::RefPtr<EngineLayer> oldLayer) {
   SkMatrix sk_matrix = SkMatrix::Translate(dx, dy);
-  auto layer = std::make_shared<flutter::TransformLayer>(sk_matrix);
-  PushLayer(layer);
-  EngineLayer::MakeRetained(layer_handle, layer);
-
-  if (oldLayer && oldLayer->Layer()) {
-    layer->AssignOldLayer(oldLayer->Layer().get());
-  }
+  LayerSubtreeKey key(LayerSubtreeKey::Type::kTransform);
+  key.AddMatrix(sk_matrix);
+  ContainerLayerParams params;
+  params.type = LayerSubtreeKey::Type::kTransform;
+  params.matrix = sk_matrix;
+  PushLayer(layer_handle, std::move(params), std::move(key), oldLayer);
 }
 
 void SceneBuilder::pushClipRect(Dart_Handle layer_handle,
@@ -117,14 +120,14 @@ void SceneBuilder::pushClipRect(Dart_Handle layer_handle,
                                 fml::RefPtr<EngineLayer> oldLayer) {
   SkRect clipRect = SkRect::MakeLTRB(left, top, right, bottom);
   flutter::Clip clip_behavior = static_cast<flutter::Clip>(clipBehavior);
-  auto layer =
-      std::make_shared<flutter::ClipRectLayer>(clipRect, clip_behavior);
-  PushLayer(layer);
-  EngineLayer::MakeRetained(layer_handle, layer);
-
-  if (oldLayer && oldLayer->Layer()) {
-    layer->AssignOldLayer(oldLayer->Layer().get());
-  }
+  LayerSubtreeKey key(LayerSubtreeKey::Type::kClipRect);
+  key.AddRect(clipRect);
+  key.AddValue(clip_behavior);
+  ContainerLayerParams params;
+  params.type = LayerSubtreeKey::Type::kClipRect;
+  params.rect = clipRect;
+  params.clip = clip_behavior;
+  PushLayer(layer_handle, std::move(params), std::move(key), oldLayer);
 }
 
 void SceneBuilder::pushClipRRect(Dart_Handle layer_handle,
@@ -132,14 +135,14 @@ void SceneBuilder::pushClipRRect(Dart_Handle layer_handle,
                                  int clipBehavior,
                                  fml::RefPtr<EngineLayer> oldLayer) {
   flutter::Clip clip_behavior = static_cast<flutter::Clip>(clipBehavior);
-  auto layer =
-      std::make_shared<flutter::ClipRRectLayer>(rrect.sk_rrect, clip_behavior);
-  PushLayer(layer);
-  EngineLayer::MakeRetained(layer_handle, layer);
-
-  if (oldLayer && oldLayer->Layer()) {
-    layer->AssignOldLayer(oldLayer->Layer().get());
-  }
+  LayerSubtreeKey key(LayerSubtreeKey::Type::kClipRRect);
+  key.AddRRect(rrect.sk_rrect);
+  key.AddValue(clip_behavior);
+  ContainerLayerParams params;
+  params.type = LayerSubtreeKey::Type::kClipRRect;
+  params.rrect = rrect.sk_rrect;
+  params.clip = clip_behavior;
+  PushLayer(layer_handle, std::move(params), std::move(key), oldLayer);
 }
 
 void SceneBuilder::pushClipPath(Dart_Handle layer_handle,
@@ -148,14 +151,14 @@ void SceneBuilder::pushClipPath(Dart_Handle layer_handle,
                                 fml::RefPtr<EngineLayer> oldLayer) {
   flutter::Clip clip_behavior = static_cast<flutter::Clip>(clipBehavior);
   FML_DCHECK(clip_behavior != flutter::Clip::none);
-  auto layer =
-      std::make_shared<flutter::ClipPathLayer>(path->path(), clip_behavior);
-  PushLayer(layer);
-  EngineLayer::MakeRetained(layer_handle, layer);
-
-  if (oldLayer && oldLayer->Layer()) {
-    layer->AssignOldLayer(oldLayer->Layer().get());
-  }
+  LayerSubtreeKey key(LayerSubtreeKey::Type::kClipPath);
+  key.SetPath(path->path());
+  key.AddValue(clip_behavior);
+  ContainerLayerParams params;
+  params.type = LayerSubtreeKey::Type::kClipPath;
+  params.path = path->path();
+  params.clip = clip_behavior;
+  PushLayer(layer_handle, std::move(params), std::move(key), oldLayer);
 }
 
 void SceneBuilder::pushOpacity(Dart_Handle layer_handle,
@@ -163,54 +166,51 @@ void SceneBuilder::pushOpacity(Dart_Handle layer_handle,
                                double dx,
                                double dy,
                                fml::RefPtr<EngineLayer> oldLayer) {
-  auto layer =
-      std::make_shared<flutter::OpacityLayer>(alpha, SkPoint::Make(dx, dy));
-  PushLayer(layer);
-  EngineLayer::MakeRetained(layer_handle, layer);
-
-  if (oldLayer && oldLayer->Layer()) {
-    layer->AssignOldLayer(oldLayer->Layer().get());
-  }
+  LayerSubtreeKey key(LayerSubtreeKey::Type::kOpacity);
+  key.AddValue(alpha);
+  key.AddValue(dx);
+  key.AddValue(dy);
+  ContainerLayerParams params;
+  params.type = LayerSubtreeKey::Type::kOpacity;
+  params.alpha = alpha;
+  params.offset = SkPoint::Make(dx, dy);
+  PushLayer(layer_handle, std::move(params), std::move(key), oldLayer);
 }
 
 void SceneBuilder::pushColorFilter(Dart_Handle layer_handle,
                                    const ColorFilter* color_filter,
                                    fml::RefPtr<EngineLayer> oldLayer) {
-  auto layer =
-      std::make_shared<flutter::ColorFilterLayer>(color_filter->filter());
-  PushLayer(layer);
-  EngineLayer::MakeRetained(layer_handle, layer);
-
-  if (oldLayer && oldLayer->Layer()) {
-    layer->AssignOldLayer(oldLayer->Layer().get());
-  }
+  LayerSubtreeKey key(LayerSubtreeKey::Type::kColorFilter);
+  key.AddObject(color_filter->filter().get());
+  ContainerLayerParams params;
+  params.type = LayerSubtreeKey::Type::kColorFilter;
+  params.color_filter = color_filter->filter();
+  PushLayer(layer_handle, std::move(params), std::move(key), oldLayer);
 }
 
 void SceneBuilder::pushImageFilter(Dart_Handle layer_handle,
                                    const ImageFilter* image_filter,
                                    fml::RefPtr<EngineLayer> oldLayer) {
-  auto layer =
-      std::make_shared<flutter::ImageFilterLayer>(image_filter->filter());
-  PushLayer(layer);
-  EngineLayer::MakeRetained(layer_handle, layer);
-
-  if (oldLayer && oldLayer->Layer()) {
-    layer->AssignOldLayer(oldLayer->Layer().get());
-  }
+  LayerSubtreeKey key(LayerSubtreeKey::Type::kImageFilter);
+  key.AddObject(image_filter->filter().get());
+  ContainerLayerParams params;
+  params.type = LayerSubtreeKey::Type::kImageFilter;
+  params.image_filter = image_filter->filter();
+  PushLayer(layer_handle, std::move(params), std::move(key), oldLayer);
 }
 
 void SceneBuilder::pushBackdropFilter(Dart_Handle layer_handle,
                                       ImageFilter* filter,
                                       int blendMode,
                                       fml::RefPtr<EngineLayer> oldLayer) {
-  auto layer = std::make_shared<flutter::BackdropFilterLayer>(
-      filter->filter(), static_cast<SkBlendMode>(blendMode));
-  PushLayer(layer);
-  EngineLayer::MakeRetained(layer_handle, layer);
-
-  if (oldLayer && oldLayer->Layer()) {
-    layer->AssignOldLayer(oldLayer->Layer().get());
-  }
+  LayerSubtreeKey key(LayerSubtreeKey::Type::kBackdropFilter);
+  key.AddObject(filter->filter().get());
+  key.AddValue(blendMode);
+  ContainerLayerParams params;
+  params.type = LayerSubtreeKey::Type::kBackdropFilter;
+  params.image_filter = filter->filter();
+  params.blend_mode = static_cast<SkBlendMode>(blendMode);
+  PushLayer(layer_handle, std::move(params), std::move(key), oldLayer);
 }
 
 void SceneBuilder::pushShaderMask(Dart_Handle layer_handle,
@@ -225,14 +225,17 @@ void SceneBuilder::pushShaderMask(Dart_Handle layer_handle,
   SkRect rect = SkRect::MakeLTRB(maskRectLeft, maskRectTop, maskRectRight,
                                  maskRectBottom);
   auto sampling = ImageFilter::SamplingFromIndex(filterQualityIndex);
-  auto layer = std::make_shared<flutter::ShaderMaskLayer>(
-      shader->shader(sampling), rect, static_cast<SkBlendMode>(blendMode));
-  PushLayer(layer);
-  EngineLayer::MakeRetained(layer_handle, layer);
-
-  if (oldLayer && oldLayer->Layer()) {
-    layer->AssignOldLayer(oldLayer->Layer().get());
-  }
+  sk_sp<SkShader> sk_shader = shader->shader(sampling);
+  LayerSubtreeKey key(LayerSubtreeKey::Type::kShaderMask);
+  key.AddObject(sk_shader.get());
+  key.AddRect(rect);
+  key.AddValue(blendMode);
+  ContainerLayerParams params;
+  params.type = LayerSubtreeKey::Type::kShaderMask;
+  params.shader = std::move(sk_shader);
+  params.rect = rect;
+  params.blend_mode = static_cast<SkBlendMode>(blendMode);
+  PushLayer(layer_handle, std::move(params), std::move(key), oldLayer);
 }
 
 void SceneBuilder::pushPhysicalShape(Dart_Handle layer_handle,
@@ -242,16 +245,20 @@ void SceneBuilder::pushPhysicalShape(Dart_Handle layer_handle,
                                      int shadow_color,
                                      int clipBehavior,
                                      fml::RefPtr<EngineLayer> oldLayer) {
-  auto layer = std::make_shared<flutter::PhysicalShapeLayer>(
-      static_cast<SkColor>(color), static_cast<SkColor>(shadow_color),
-      static_cast<float>(elevation), path->path(),
-      static_cast<flutter::Clip>(clipBehavior));
-  PushLayer(layer);
-  EngineLayer::MakeRetained(layer_handle, layer);
-
-  if (oldLayer && oldLayer->Layer()) {
-    layer->AssignOldLayer(oldLayer->Layer().get());
-  }
+  LayerSubtreeKey key(LayerSubtreeKey::Type::kPhysicalShape);
+  key.SetPath(path->path());
+  key.AddValue(elevation);
+  key.AddValue(color);
+  key.AddValue(shadow_color);
+  key.AddValue(clipBehavior);
+  ContainerLayerParams params;
+  params.type = LayerSubtreeKey::Type::kPhysicalShape;
+  params.path = path->path();
+  params.elevation = static_cast<float>(elevation);
+  params.color = static_cast<SkColor>(color);
+  params.shadow_color = static_cast<SkColor>(shadow_color);
+  params.clip = static_cast<flutter::Clip>(clipBehavior);
+  PushLayer(layer_handle, std::move(params), std::move(key), oldLayer);
 }
 
 void SceneBuilder::addRetained(fml::RefPtr<EngineLayer> retainedLayer) {
@@ -266,17 +273,32 @@ void SceneBuilder::addPicture(double dx,
                               double dy,
                               Picture* picture,
                               int hints) {
+  LayerSubtreeKey key(picture->picture() ? LayerSubtreeKey::Type::kPicture
+                                         : LayerSubtreeKey::Type::kDisplayList);
+  if (picture->picture()) {
+    key.AddObject(picture->picture().get());
+  } else {
+    key.AddObject(picture->display_list().get());
+  }
+  key.AddValue(dx);
+  key.AddValue(dy);
+  key.AddValue(hints);
+  if (AddPreviousPicture(key)) {
+    return;
+  }
+
+  auto shared_key = std::make_shared<const LayerSubtreeKey>(std::move(key));
   if (picture->picture()) {
     auto layer = std::make_unique<flutter::PictureLayer>(
         SkPoint::Make(dx, dy), UIDartState::CreateGPUObject(picture->picture()),
         !!(hints & 1), !!(hints & 2));
-    AddLayer(std::move(layer));
+    AddLayer(std::move(layer), std::move(shared_key));
   } else {
     auto layer = std::make_unique<flutter::DisplayListLayer>(
         SkPoint::Make(dx, dy),
         UIDartState::CreateGPUObject(picture->display_list()), !!(hints & 1),
         !!(hints & 2));
-    AddLayer(std::move(layer));
+    AddLayer(std::move(layer), std::move(shared_key));
   }
 }
 
@@ -331,31 +353,148 @@ void SceneBuilder::setCheckerboardOffscreenLayers(bool checkerboard) {
 void SceneBuilder::build(Dart_Handle scene_handle) {
   FML_DCHECK(layer_stack_.size() >= 1);
 
+  // Layers are only added to their parent when they are popped.
+  while (layer_stack_.size() > 1) {
+    PopLayer();
+  }
+  TraceLayerReuseToTimeline();
+
   Scene::create(
       scene_handle, std::move(layer_stack_[0]), rasterizer_tracing_threshold_,
       checkerboard_raster_cache_images_, checkerboard_offscreen_layers_);
   layer_stack_.clear();
+  pending_subtrees_.clear();
   ClearDartWrapper();  // may delete this object.
 }
 
-void SceneBuilder::AddLayer(std::shared_ptr<Layer> layer) {
+void SceneBuilder::AddLayer(std::shared_ptr<Layer> layer,
+                            std::shared_ptr<const LayerSubtreeKey> key) {
   FML_DCHECK(layer);
 
   if (!layer_stack_.empty()) {
-    layer_stack_.back()->Add(std::move(layer));
+    layer_count_++;
+    // Pushed containers only receive their children once they are popped.
+    if (layer_stack_.size() == 1) {
+      layer_stack_.back()->Add(layer);
+    }
+    pending_subtrees_.back().subtree->children.push_back(
+        {std::move(layer), std::move(key)});
+  }
+}
+
+bool SceneBuilder::AddPreviousPicture(const LayerSubtreeKey& key) {
+  if (pending_subtrees_.empty()) {
+    return false;
+  }
+  const PendingSubtree& parent = pending_subtrees_.back();
+  if (!parent.old_subtree) {
+    return false;
+  }
+  const LayerSubtree::Child* child = parent.old_subtree->FindPicture(
+      parent.subtree->children.size(), key);
+  if (!child) {
+    return false;
   }
+  reused_layer_count_++;
+  AddLayer(child->layer, child->key);
+  return true;
 }
 
-void SceneBuilder::PushLayer(std::shared_ptr<ContainerLayer> layer) {
-  AddLayer(layer);
-  layer_stack_.push_back(std::move(layer));
+void SceneBuilder::PushLayer(Dart_Handle layer_handle,
+                             ContainerLayerParams params,
+                             LayerSubtreeKey key,
+                             const fml::RefPtr<EngineLayer>& old_layer) {
+  PendingSubtree pending;
+  pending.params = std::move(params);
+  pending.subtree = std::make_shared<LayerSubtree>(std::move(key));
+  // The layer is set when it is popped.
+  pending.engine_layer = EngineLayer::MakeRetained(layer_handle, nullptr);
+  if (old_layer && old_layer->Layer()) {
+    pending.old_layer = old_layer->Layer();
+    pending.old_subtree = old_layer->Subtree();
+  }
+  layer_stack_.push_back(nullptr);
+  pending_subtrees_.push_back(std::move(pending));
 }
 
 void SceneBuilder::PopLayer() {
   // We never pop the root layer, so that AddLayer operations are always valid.
-  if (layer_stack_.size() > 1) {
-    layer_stack_.pop_back();
+  if (layer_stack_.size() <= 1) {
+    return;
+  }
+  PendingSubtree pending = std::move(pending_subtrees_.back());
+  layer_stack_.pop_back();
+  pending_subtrees_.pop_back();
+
+  // If the layer and its children are identical to the layer it replaces, the
+  // layer from the previous frame is shared instead. The rasterizer then skips
+  // diffing the subtree and keeps the raster cache entries of its layers.
+  std::shared_ptr<ContainerLayer> layer;
+  std::shared_ptr<const LayerSubtree> subtree = std::move(pending.subtree);
+  if (pending.old_subtree && pending.old_subtree->Matches(*subtree)) {
+    layer = std::move(pending.old_layer);
+    subtree = std::move(pending.old_subtree);
+    reused_layer_count_++;
+  } else {
+    layer = CreateContainerLayer(pending.params);
+    for (const LayerSubtree::Child& child : subtree->children) {
+      layer->Add(child.layer);
+    }
+    if (pending.old_layer) {
+      layer->AssignOldLayer(pending.old_layer.get());
+    }
   }
+  pending.engine_layer->SetSubtree(layer, std::move(subtree));
+  AddLayer(std::move(layer));
+}
+
+std::shared_ptr<ContainerLayer> SceneBuilder::CreateContainerLayer(
+    const ContainerLayerParams& params) {
+  created_container_count_++;
+  switch (params.type) {
+    case LayerSubtreeKey::Type::kTransform:
+      return std::make_shared<flutter::TransformLayer>(params.matrix);
+    case LayerSubtreeKey::Type::kClipRect:
+      return std::make_shared<flutter::ClipRectLayer>(params.rect,
+                                                      params.clip);
+    case LayerSubtreeKey::Type::kClipRRect:
+      return std::make_shared<flutter::ClipRRectLayer>(params.rrect,
+                                                       params.clip);
+    case LayerSubtreeKey::Type::kClipPath:
+      return std::make_shared<flutter::ClipPathLayer>(params.path,
+                                                      params.clip);
+    case LayerSubtreeKey::Type::kOpacity:
+      return std::make_shared<flutter::OpacityLayer>(params.alpha,
+                                                     params.offset);
+    case LayerSubtreeKey::Type::kColorFilter:
+      return std::make_shared<flutter::ColorFilterLayer>(params.color_filter);
+    case LayerSubtreeKey::Type::kImageFilter:
+      return std::make_shared<flutter::ImageFilterLayer>(params.image_filter);
+    case LayerSubtreeKey::Type::kBackdropFilter:
+      return std::make_shared<flutter::BackdropFilterLayer>(
+          params.image_filter, params.blend_mode);
+    case LayerSubtreeKey::Type::kShaderMask:
+      return std::make_shared<flutter::ShaderMaskLayer>(
+          params.shader, params.rect, params.blend_mode);
+    case LayerSubtreeKey::Type::kPhysicalShape:
+      return std::make_shared<flutter::PhysicalShapeLayer>(
+          params.color, params.shadow_color, params.elevation, params.path,
+          params.clip);
+    case LayerSubtreeKey::Type::kContainer:
+    case LayerSubtreeKey::Type::kPicture:
+    case LayerSubtreeKey::Type::kDisplayList:
+      break;
+  }
+  FML_UNREACHABLE();
+}
+
+void SceneBuilder::TraceLayerReuseToTimeline() const {
+#if !FLUTTER_RELEASE
+  FML_TRACE_COUNTER("flutter", "SceneBuilder", reinterpret_cast<int64_t>(this),
+                    "Layers", layer_count_, "ReusedLayers",
+                    reused_layer_count_, "CreatedContainers",
+                    created_container_count_);
+#endif  // !FLUTTER_RELEASE
 }
 
 }  // namespace flutter
@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "flutter/flow/layers/container_layer.h"
+#include "flutter/lib/ui/compositing/layer_subtree.h"
 #include "flutter/lib/ui/compositing/scene.h"
 #include "flutter/lib/ui/dart_wrapper.h"
 #include "flutter/lib/ui/painting/color_filter.h"
@@ -119,20 +120,77 @@ class SceneBuilder : public RefCountedDartWrappable<SceneBuilder> {
 
   void build(Dart_Handle scene_handle);
 
+  // The root layer followed by a null entry for each container layer that has
+  // been pushed but not popped yet.
   const std::vector<std::shared_ptr<ContainerLayer>>& layer_stack() {
     return layer_stack_;
   }
 
+  // The number of layers added to the scene so far, and how many of those are
+  // shared with the previous frame because nothing in their subtree changed.
+  size_t layer_count() const { return layer_count_; }
+  size_t reused_layer_count() const { return reused_layer_count_; }
+  // The number of container layers created so far. Containers that are shared
+  // with the previous frame are never created.
+  size_t created_container_count() const { return created_container_count_; }
+
   static void RegisterNatives(tonic::DartLibraryNatives* natives);
 
  private:
   SceneBuilder();
 
-  void AddLayer(std::shared_ptr<Layer> layer);
-  void PushLayer(std::shared_ptr<ContainerLayer> layer);
+  // The arguments a container layer was pushed with. Only the fields used by
+  // |type| are set.
+  struct ContainerLayerParams {
+    LayerSubtreeKey::Type type = LayerSubtreeKey::Type::kContainer;
+    SkMatrix matrix;
+    SkRect rect;
+    SkRRect rrect;
+    SkPath path;
+    Clip clip = Clip::none;
+    int alpha = 0;
+    SkPoint offset;
+    sk_sp<SkColorFilter> color_filter;
+    sk_sp<SkImageFilter> image_filter;
+    sk_sp<SkShader> shader;
+    SkBlendMode blend_mode = SkBlendMode::kSrcOver;
+    float elevation = 0;
+    SkColor color = SK_ColorTRANSPARENT;
+    SkColor shadow_color = SK_ColorTRANSPARENT;
+  };
+
+  // A container layer that has been pushed but not popped yet. It is only
+  // created and added to its parent when popped, once it is known whether the
+  // layer it replaces can be shared instead.
+  struct PendingSubtree {
+    ContainerLayerParams params;
+    std::shared_ptr<LayerSubtree> subtree;
+    fml::RefPtr<EngineLayer> engine_layer;
+    // The layer passed as |oldLayer| when the layer was pushed.
+    std::shared_ptr<ContainerLayer> old_layer;
+    std::shared_ptr<const LayerSubtree> old_subtree;
+  };
+
+  void AddLayer(std::shared_ptr<Layer> layer,
+                std::shared_ptr<const LayerSubtreeKey> key = nullptr);
+  // Adds the picture at the same position in the layer being replaced by the
+  // current container if it was built with |key|.
+  bool AddPreviousPicture(const LayerSubtreeKey& key);
+  void PushLayer(Dart_Handle layer_handle,
+                 ContainerLayerParams params,
+                 LayerSubtreeKey key,
+                 const fml::RefPtr<EngineLayer>& old_layer);
   void PopLayer();
+  std::shared_ptr<ContainerLayer> CreateContainerLayer(
+      const ContainerLayerParams& params);
+  void TraceLayerReuseToTimeline() const;
 
   std::vector<std::shared_ptr<ContainerLayer>> layer_stack_;
+  // Parallel to |layer_stack_|.
+  std::vector<PendingSubtree> pending_subtrees_;
+  size_t layer_count_ = 0;
+  size_t reused_layer_count_ = 0;
+  size_t created_container_count_ = 0;
   int rasterizer_tracing_threshold_ = 0;
   bool checkerboard_raster_cache_images_ = false;
   bool checkerboard_offscreen_layers_ = false;
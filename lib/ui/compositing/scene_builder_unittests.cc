@@ -12,6 +12,7 @@
 #include "flutter/shell/common/shell_test.h"
 #include "flutter/shell/common/thread_host.h"
 #include "flutter/testing/testing.h"
+#include "third_party/tonic/converter/dart_converter.h"
 
 namespace flutter {
 namespace testing {
@@ -154,5 +155,70 @@ TEST_F(ShellTest, EngineLayerDisposeReleasesReference) {
   DestroyShell(std::move(shell), std::move(task_runners));
 }
 
+TEST_F(ShellTest, SceneBuilderSharesUnchangedSubtreesWithPreviousFrame) {
+  auto message_latch = std::make_shared<fml::AutoResetWaitableEvent>();
+
+  auto validate_reused_layers = [](Dart_NativeArguments args) {
+    auto handle = Dart_GetNativeArgument(args, 0);
+    intptr_t peer = 0;
+    Dart_Handle result = Dart_GetNativeInstanceField(
+        handle, tonic::DartWrappable::kPeerIndex, &peer);
+    ASSERT_FALSE(Dart_IsError(result));
+    SceneBuilder* scene_builder = reinterpret_cast<SceneBuilder*>(peer);
+    ASSERT_TRUE(scene_builder);
+    int64_t frame = tonic::DartConverter<int64_t>::FromDart(
+        Dart_GetNativeArgument(args, 1));
+
+    EXPECT_EQ(scene_builder->layer_count(), 3ul);
+    switch (frame) {
+      case 0:
+        EXPECT_EQ(scene_builder->reused_layer_count(), 0ul);
+        EXPECT_EQ(scene_builder->created_container_count(), 2ul);
+        break;
+      case 1:
+        // The offset, the clip and the picture are all unchanged, so no
+        // container layer is created at all.
+        EXPECT_EQ(scene_builder->reused_layer_count(), 3ul);
+        EXPECT_EQ(scene_builder->created_container_count(), 0ul);
+        break;
+      case 2:
+        // Only the picture is shared once the clip changes.
+        EXPECT_EQ(scene_builder->reused_layer_count(), 1ul);
+        EXPECT_EQ(scene_builder->created_container_count(), 2ul);
+        break;
+    }
+  };
+
+  auto finish = [message_latch](Dart_NativeArguments args) {
+    message_latch->Signal();
+  };
+
+  Settings settings = CreateSettingsForFixture();
+  TaskRunners task_runners("test",                  // label
+                           GetCurrentTaskRunner(),  // platform
+                           CreateNewThread(),       // raster
+                           CreateNewThread(),       // ui
+                           CreateNewThread()        // io
+  );
+
+  AddNativeCallback("ValidateReusedLayers",
+                    CREATE_NATIVE_ENTRY(validate_reused_layers));
+  AddNativeCallback("Finish", CREATE_NATIVE_ENTRY(finish));
+
+  std::unique_ptr<Shell> shell =
+      CreateShell(std::move(settings), std::move(task_runners));
+
+  ASSERT_TRUE(shell->IsSetup());
+  auto configuration = RunConfiguration::InferFromSettings(settings);
+  configuration.SetEntrypoint("validateUnchangedSubtreesAreReused");
+
+  shell->RunEngine(std::move(configuration), [](auto result) {
+    ASSERT_EQ(result, Engine::RunStatus::Success);
+  });
+
+  message_latch->Wait();
+  DestroyShell(std::move(shell), std::move(task_runners));
+}
+
 }  // namespace testing
 }  // namespace flutter
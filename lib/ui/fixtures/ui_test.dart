@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 import 'dart:async';
+import 'dart:isolate';
 import 'dart:typed_data';
 import 'dart:ui';
 
@@ -43,6 +44,32 @@ _captureRootLayer(SceneBuilder sceneBuilder) native 'CaptureRootLayer';
 _validateLayerTreeCounts() native 'ValidateLayerTreeCounts';
 _validateEngineLayerDispose() native 'ValidateEngineLayerDispose';
 
+@pragma('vm:entry-point')
+void validateUnchangedSubtreesAreReused() {
+  final PictureRecorder recorder = PictureRecorder();
+  Canvas(recorder).drawRect(const Rect.fromLTRB(0, 0, 10, 10), Paint());
+  final Picture picture = recorder.endRecording();
+
+  OffsetEngineLayer? offsetLayer;
+  ClipRectEngineLayer? clipLayer;
+  for (int frame = 0; frame < 3; frame++) {
+    final SceneBuilder builder = SceneBuilder();
+    offsetLayer = builder.pushOffset(10, 10, oldLayer: offsetLayer);
+    // The clip changes in the last frame.
+    clipLayer = builder.pushClipRect(
+      Rect.fromLTRB(0, 0, frame < 2 ? 100 : 50, 100),
+      oldLayer: clipLayer,
+    );
+    builder.addPicture(Offset.zero, picture);
+    builder.pop();
+    builder.pop();
+    _validateReusedLayers(builder, frame);
+    builder.build().dispose();
+  }
+  _finish();
+}
+_validateReusedLayers(SceneBuilder builder, int frame) native 'ValidateReusedLayers';
+
 @pragma('vm:entry-point')
 Future<void> createSingleFrameCodec() async {
   final ImmutableBuffer buffer = await ImmutableBuffer.fromUint8List(Uint8List.fromList(List<int>.filled(4, 100)));
@@ -196,6 +223,54 @@ void createPath() {
 }
 void _validatePath(Path path) native 'ValidatePath';
 
+ParagraphBuilder _buildDocument(String name) {
+  final ParagraphBuilder builder = ParagraphBuilder(ParagraphStyle(fontSize: 14));
+  for (int i = 0; i < 500; i++) {
+    builder.addText('Paragraph $i of $name, which is laid out ahead of time. ');
+  }
+  return builder;
+}
+
+const ParagraphConstraints _documentConstraints = ParagraphConstraints(width: 400);
+
+void _layoutDocumentInBackground(SendPort sendPort) {
+  sendPort.send(TransferableParagraph(_buildDocument('document one'), _documentConstraints));
+}
+
+@pragma('vm:entry-point')
+Future<void> layoutParagraphInBackground() async {
+  final ReceivePort receivePort = ReceivePort();
+  await Isolate.spawn(_layoutDocumentInBackground, receivePort.sendPort);
+  final TransferableParagraph transferable = await receivePort.first as TransferableParagraph;
+
+  // Materializing the paragraph laid out in the background is all that the
+  // root isolate has to do before painting it.
+  final Paragraph paragraph = transferable.materialize();
+  final double height = paragraph.height;
+
+  final Paragraph rootParagraph = _buildDocument('document one').build()
+    ..layout(_documentConstraints);
+  final double rootHeight = rootParagraph.height;
+
+  final PictureRecorder recorder = PictureRecorder();
+  Canvas(recorder).drawParagraph(paragraph, Offset.zero);
+  recorder.endRecording();
+
+  bool materializedTwice = true;
+  try {
+    transferable.materialize();
+  } catch (_) {
+    materializedTwice = false;
+  }
+
+  _validateParagraphLayout(height, rootHeight, materializedTwice);
+}
+void _validateParagraphLayout(
+  double height,
+  double rootHeight,
+  bool materializedTwice,
+) native 'ValidateParagraphLayout';
+
 @pragma('vm:entry-point')
 void frameCallback(_Image, int) {
   print('called back');
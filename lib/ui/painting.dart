@@ -3767,24 +3767,48 @@ class FragmentProgram extends NativeFieldWrapperClass1 {
   ///
   /// [A current specification of valid SPIR-V is here.](https://github.com/flutter/engine/blob/master/lib/spirv/README.md)
   /// SPIR-V not meeting this specification will throw an exception.
+  ///
+  /// The shader is compiled on a background thread, and compiled shaders are
+  /// shared by all programs created from the same SPIR-V, so compiling the
+  /// same SPIR-V again is cheap.
   static Future<FragmentProgram> compile({
     required ByteBuffer spirv,
     bool debugPrint = false,
   }) {
-    return Future<FragmentProgram>(() => FragmentProgram._(spirv: spirv, debugPrint: debugPrint));
+    return Future<FragmentProgram>(() {
+      // Not a sync completer: programs that are compiled synchronously call
+      // back from within the constructor, before there is a listener for an
+      // error.
+      final Completer<void> compiled = Completer<void>();
+      final FragmentProgram program = FragmentProgram._(
+        spirv: spirv,
+        debugPrint: debugPrint,
+        onCompiled: (String? error) {
+          if (error == null) {
+            compiled.complete();
+          } else {
+            compiled.completeError(Exception(error));
+          }
+        },
+      );
+      return compiled.future.then((_) => program);
+    });
   }
 
   @pragma('vm:entry-point')
   FragmentProgram._({
     required ByteBuffer spirv,
     bool debugPrint = false,
+    required _Callback<String?> onCompiled,
   }) {
     _constructor();
     final spv.TranspileResult result = spv.transpile(
       spirv,
       spv.TargetLanguage.sksl,
     );
-    _init(result.src, debugPrint);
+    final String? error = _init(result.src, debugPrint, onCompiled);
+    if (error != null)
+      throw Exception(error);
     _uniformFloatCount = result.uniformFloatCount;
     _samplerCount = result.samplerCount;
   }
@@ -3793,7 +3817,7 @@ class FragmentProgram extends NativeFieldWrapperClass1 {
   late final int _samplerCount;
 
   void _constructor() native 'FragmentProgram_constructor';
-  void _init(String sksl, bool debugPrint) native 'FragmentProgram_init';
+  String? _init(String sksl, bool debugPrint, _Callback<String?> callback) native 'FragmentProgram_init';
 
   /// Constructs a [Shader] object suitable for use by [Paint.shader] with
   /// the given uniforms.
@@ -25,8 +25,15 @@ EngineLayer::EngineLayer(std::shared_ptr<flutter::ContainerLayer> layer)
 
 EngineLayer::~EngineLayer() = default;
 
+void EngineLayer::SetSubtree(std::shared_ptr<flutter::ContainerLayer> layer,
+                             std::shared_ptr<const LayerSubtree> subtree) {
+  layer_ = std::move(layer);
+  subtree_ = std::move(subtree);
+}
+
 void EngineLayer::dispose() {
   layer_.reset();
+  subtree_.reset();
   ClearDartWrapper();
 }
 
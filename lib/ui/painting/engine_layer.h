@@ -6,6 +6,7 @@
 #define FLUTTER_LIB_UI_PAINTING_ENGINE_LAYER_H_
 
 #include "flutter/flow/layers/container_layer.h"
+#include "flutter/lib/ui/compositing/layer_subtree.h"
 #include "flutter/lib/ui/dart_wrapper.h"
 
 namespace tonic {
@@ -22,10 +23,12 @@ class EngineLayer : public RefCountedDartWrappable<EngineLayer> {
  public:
   ~EngineLayer() override;
 
-  static void MakeRetained(Dart_Handle dart_handle,
-                           std::shared_ptr<flutter::ContainerLayer> layer) {
+  static fml::RefPtr<EngineLayer> MakeRetained(
+      Dart_Handle dart_handle,
+      std::shared_ptr<flutter::ContainerLayer> layer) {
     auto engine_layer = fml::MakeRefCounted<EngineLayer>(layer);
     engine_layer->AssociateWithDartWrapper(dart_handle);
+    return engine_layer;
   }
 
   static void RegisterNatives(tonic::DartLibraryNatives* natives);
@@ -34,9 +37,20 @@ class EngineLayer : public RefCountedDartWrappable<EngineLayer> {
 
   std::shared_ptr<flutter::ContainerLayer> Layer() const { return layer_; }
 
+  // How |Layer| was built, once the layer has been popped.
+  const std::shared_ptr<const LayerSubtree>& Subtree() const {
+    return subtree_;
+  }
+
+  // Called by |SceneBuilder| once the layer has been popped. The layer may be
+  // replaced with an identical layer from the previous frame.
+  void SetSubtree(std::shared_ptr<flutter::ContainerLayer> layer,
+                  std::shared_ptr<const LayerSubtree> subtree);
+
  private:
   explicit EngineLayer(std::shared_ptr<flutter::ContainerLayer> layer);
   std::shared_ptr<flutter::ContainerLayer> layer_;
+  std::shared_ptr<const LayerSubtree> subtree_;
 
   FML_FRIEND_MAKE_REF_COUNTED(EngineLayer);
 };
@@ -6,6 +6,7 @@
 
 #include "flutter/lib/ui/painting/fragment_program.h"
 
+#include "flutter/fml/make_copyable.h"
 #include "flutter/lib/ui/dart_wrapper.h"
 #include "flutter/lib/ui/ui_dart_state.h"
 #include "third_party/skia/include/core/SkString.h"
@@ -13,6 +14,8 @@
 #include "third_party/tonic/dart_args.h"
 #include "third_party/tonic/dart_binding_macros.h"
 #include "third_party/tonic/dart_library_natives.h"
+#include "third_party/tonic/dart_persistent_value.h"
+#include "third_party/tonic/logging/dart_invoke.h"
 #include "third_party/tonic/typed_data/typed_list.h"
 
 using tonic::ToDart;
@@ -37,20 +40,72 @@ void FragmentProgram::RegisterNatives(tonic::DartLibraryNatives* natives) {
        FOR_EACH_BINDING(DART_REGISTER_NATIVE)});
 }
 
-void FragmentProgram::init(std::string sksl, bool debugPrintSksl) {
-  SkRuntimeEffect::Result result =
-      SkRuntimeEffect::MakeForShader(SkString(sksl));
-  runtime_effect_ = result.effect;
-
-  if (runtime_effect_ == nullptr) {
-    Dart_ThrowException(tonic::ToDart(
-        std::string("Invalid SkSL:\n") + sksl.c_str() +
-        std::string("\nSkSL Error:\n") + result.errorText.c_str()));
-    return;
+Dart_Handle FragmentProgram::init(std::string sksl,
+                                  bool debugPrintSksl,
+                                  Dart_Handle callback) {
+  if (!Dart_IsClosure(callback)) {
+    return tonic::ToDart("Callback must be a function");
   }
   if (debugPrintSksl) {
     FML_DLOG(INFO) << std::string("debugPrintSksl:\n") + sksl.c_str();
   }
+
+  auto& cache = RuntimeEffectCache::GetInstance();
+  auto* dart_state = UIDartState::Current();
+  auto concurrent_task_runner = dart_state->GetConcurrentTaskRunner();
+
+  // Programs that were compiled before, by this or any other isolate, and
+  // isolates that have no worker threads, don't need to wait for a worker.
+  sk_sp<SkRuntimeEffect> cached = cache.Find(sksl);
+  if (cached || !concurrent_task_runner) {
+    RuntimeEffectCache::Result result =
+        cached ? RuntimeEffectCache::Result{std::move(cached), {}}
+               : cache.Compile(sksl);
+    tonic::DartInvoke(callback, {SetRuntimeEffect(sksl, result)});
+    return Dart_Null();
+  }
+
+  auto persistent_callback =
+      std::make_unique<tonic::DartPersistentValue>(dart_state, callback);
+  auto ui_task_runner = dart_state->GetTaskRunners().GetUITaskRunner();
+
+  auto ui_task = fml::MakeCopyable(
+      [program = fml::RefPtr<FragmentProgram>(this), sksl,
+       callback = std::move(persistent_callback)](
+          const RuntimeEffectCache::Result& result) mutable {
+        auto dart_state = callback->dart_state().lock();
+        if (!dart_state) {
+          // The isolate could have died in the meantime.
+          return;
+        }
+        tonic::DartState::Scope scope(dart_state);
+        tonic::DartInvoke(callback->Get(),
+                          {program->SetRuntimeEffect(sksl, result)});
+
+        // Both are associated with the Dart isolate and must be released on
+        // the UI thread.
+        callback.reset();
+        program = nullptr;
+      });
+
+  concurrent_task_runner->PostTask([sksl, ui_task_runner, ui_task] {
+    auto result = RuntimeEffectCache::GetInstance().Compile(sksl);
+    ui_task_runner->PostTask([ui_task, result] { ui_task(result); });
+  });
+
+  return Dart_Null();
+}
+
+Dart_Handle FragmentProgram::SetRuntimeEffect(
+    const std::string& sksl,
+    const RuntimeEffectCache::Result& result) {
+  runtime_effect_ = result.effect;
+  if (runtime_effect_ == nullptr) {
+    return tonic::ToDart(std::string("Invalid SkSL:\n") + sksl.c_str() +
+                         std::string("\nSkSL Error:\n") +
+                         result.error.c_str());
+  }
+  return Dart_Null();
 }
 
 fml::RefPtr<FragmentShader> FragmentProgram::shader(
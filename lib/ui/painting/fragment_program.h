@@ -7,6 +7,7 @@
 
 #include "flutter/lib/ui/dart_wrapper.h"
 #include "flutter/lib/ui/painting/fragment_shader.h"
+#include "flutter/lib/ui/painting/runtime_effect_cache.h"
 #include "third_party/skia/include/effects/SkRuntimeEffect.h"
 #include "third_party/tonic/dart_library_natives.h"
 #include "third_party/tonic/typed_data/typed_list.h"
@@ -28,7 +29,10 @@ class FragmentProgram : public RefCountedDartWrappable<FragmentProgram> {
   ~FragmentProgram() override;
   static fml::RefPtr<FragmentProgram> Create();
 
-  void init(std::string sksl, bool debugPrintSksl);
+  /// Compiles |sksl|, on a worker thread unless it was compiled before, and
+  /// then invokes |callback| on the UI thread with null or an error message.
+  /// Returns an error message if compilation could not be started.
+  Dart_Handle init(std::string sksl, bool debugPrintSksl, Dart_Handle callback);
 
   fml::RefPtr<FragmentShader> shader(Dart_Handle shader,
                                      const tonic::Float32List& uniforms,
@@ -38,6 +42,10 @@ class FragmentProgram : public RefCountedDartWrappable<FragmentProgram> {
 
  private:
   FragmentProgram();
+
+  Dart_Handle SetRuntimeEffect(const std::string& sksl,
+                               const RuntimeEffectCache::Result& result);
+
   sk_sp<SkRuntimeEffect> runtime_effect_;
 };
 
@@ -0,0 +1,101 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/runtime_effect_cache.h"
+
+#include <algorithm>
+
+#include "flutter/fml/time/time_point.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/core/SkString.h"
+
+namespace flutter {
+
+RuntimeEffectCache& RuntimeEffectCache::GetInstance() {
+  // Never destroyed, as worker threads may still be compiling at exit.
+  static RuntimeEffectCache* instance = new RuntimeEffectCache();
+  return *instance;
+}
+
+RuntimeEffectCache::RuntimeEffectCache() = default;
+
+RuntimeEffectCache::~RuntimeEffectCache() = default;
+
+sk_sp<SkRuntimeEffect> RuntimeEffectCache::Find(const std::string& sksl) {
+  std::scoped_lock lock(mutex_);
+  auto found = effects_.find(sksl);
+  if (found == effects_.end()) {
+    return nullptr;
+  }
+  hit_count_++;
+  TraceStatsToTimeline();
+  return found->second;
+}
+
+RuntimeEffectCache::Result RuntimeEffectCache::Compile(
+    const std::string& sksl) {
+  if (auto effect = Find(sksl)) {
+    return {std::move(effect), {}};
+  }
+
+  // Compile without holding the lock so that different programs can be
+  // compiled concurrently. Should two threads race to compile the same SkSL,
+  // the first one to finish wins and the other effect is dropped.
+  TRACE_EVENT0("flutter", "RuntimeEffectCache::Compile");
+  const auto start = fml::TimePoint::Now();
+  SkRuntimeEffect::Result result =
+      SkRuntimeEffect::MakeForShader(SkString(sksl));
+  const auto compile_time = fml::TimePoint::Now() - start;
+
+  if (!result.effect) {
+    return {nullptr, result.errorText.c_str()};
+  }
+
+  std::scoped_lock lock(mutex_);
+  compile_count_++;
+  total_compile_time_ = total_compile_time_ + compile_time;
+  max_compile_time_ = std::max(max_compile_time_, compile_time);
+  auto inserted = effects_.emplace(sksl, std::move(result.effect));
+  TraceStatsToTimeline();
+  return {inserted.first->second, {}};
+}
+
+size_t RuntimeEffectCache::GetEntryCount() const {
+  std::scoped_lock lock(mutex_);
+  return effects_.size();
+}
+
+size_t RuntimeEffectCache::GetHitCount() const {
+  std::scoped_lock lock(mutex_);
+  return hit_count_;
+}
+
+size_t RuntimeEffectCache::GetCompileCount() const {
+  std::scoped_lock lock(mutex_);
+  return compile_count_;
+}
+
+fml::TimeDelta RuntimeEffectCache::GetTotalCompileTime() const {
+  std::scoped_lock lock(mutex_);
+  return total_compile_time_;
+}
+
+fml::TimeDelta RuntimeEffectCache::GetMaxCompileTime() const {
+  std::scoped_lock lock(mutex_);
+  return max_compile_time_;
+}
+
+void RuntimeEffectCache::TraceStatsToTimeline() const {
+#if !FLUTTER_RELEASE
+  FML_TRACE_COUNTER(
+      "flutter",                                                   //
+      "RuntimeEffectCache", reinterpret_cast<int64_t>(this),       //
+      "Hits", hit_count_,                                          //
+      "Compiles", compile_count_,                                  //
+      "TotalCompileMicros", total_compile_time_.ToMicroseconds(),  //
+      "MaxCompileMicros", max_compile_time_.ToMicroseconds());
+#endif  // !FLUTTER_RELEASE
+}
+
+}  // namespace flutter
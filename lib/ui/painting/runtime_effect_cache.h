@@ -0,0 +1,87 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_RUNTIME_EFFECT_CACHE_H_
+#define FLUTTER_LIB_UI_PAINTING_RUNTIME_EFFECT_CACHE_H_
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+#include "third_party/skia/include/effects/SkRuntimeEffect.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      A process-wide cache of runtime effects compiled from SkSL.
+///
+///             Every fragment program compiled from the same SkSL, by any
+///             isolate or engine in the process, shares one compiled
+///             SkRuntimeEffect. Compiling SkSL is expensive enough that it is
+///             done on a worker thread when possible, so this class is thread
+///             safe.
+///
+///             Entries are never evicted: an application only ever has a
+///             small, fixed set of shaders.
+///
+class RuntimeEffectCache {
+ public:
+  /// The outcome of compiling SkSL. Either |effect| is set, or |error|
+  /// describes why the SkSL could not be compiled.
+  struct Result {
+    sk_sp<SkRuntimeEffect> effect;
+    std::string error;
+  };
+
+  static RuntimeEffectCache& GetInstance();
+
+  RuntimeEffectCache();
+
+  ~RuntimeEffectCache();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns the effect compiled from |sksl| if it is in the
+  ///             cache, or nullptr. This never compiles.
+  ///
+  sk_sp<SkRuntimeEffect> Find(const std::string& sksl);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns the effect compiled from |sksl|, compiling it on the
+  ///             calling thread if it is not in the cache yet. Compilation
+  ///             errors are returned but not cached.
+  ///
+  Result Compile(const std::string& sksl);
+
+  size_t GetEntryCount() const;
+
+  size_t GetHitCount() const;
+
+  size_t GetCompileCount() const;
+
+  /// The time spent compiling all of the SkSL that was not in the cache.
+  fml::TimeDelta GetTotalCompileTime() const;
+
+  /// The time spent compiling the slowest SkSL, which is what the first
+  /// frames that use it wait for if it is compiled when first used.
+  fml::TimeDelta GetMaxCompileTime() const;
+
+ private:
+  void TraceStatsToTimeline() const;
+
+  mutable std::mutex mutex_;
+  // Keyed by SkSL; the map hashes it.
+  std::unordered_map<std::string, sk_sp<SkRuntimeEffect>> effects_;
+  size_t hit_count_ = 0;
+  size_t compile_count_ = 0;
+  fml::TimeDelta total_compile_time_;
+  fml::TimeDelta max_compile_time_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(RuntimeEffectCache);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_RUNTIME_EFFECT_CACHE_H_
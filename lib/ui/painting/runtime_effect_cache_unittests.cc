@@ -0,0 +1,80 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/runtime_effect_cache.h"
+
+#include <thread>
+#include <vector>
+
+#include "flutter/testing/testing.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+constexpr char kGreenSkSL[] =
+    "half4 main(float2 p) { return half4(0.0, 1.0, 0.0, 1.0); }";
+constexpr char kRedSkSL[] =
+    "half4 main(float2 p) { return half4(1.0, 0.0, 0.0, 1.0); }";
+
+}  // namespace
+
+TEST(RuntimeEffectCacheTest, CompilesOnlyOnce) {
+  RuntimeEffectCache cache;
+  EXPECT_EQ(cache.Find(kGreenSkSL), nullptr);
+
+  auto first = cache.Compile(kGreenSkSL);
+  ASSERT_NE(first.effect, nullptr);
+  EXPECT_TRUE(first.error.empty());
+  EXPECT_EQ(cache.GetCompileCount(), 1u);
+
+  auto second = cache.Compile(kGreenSkSL);
+  EXPECT_EQ(second.effect, first.effect);
+  EXPECT_EQ(cache.Find(kGreenSkSL), first.effect);
+  EXPECT_EQ(cache.GetCompileCount(), 1u);
+  EXPECT_EQ(cache.GetHitCount(), 2u);
+  EXPECT_EQ(cache.GetEntryCount(), 1u);
+  EXPECT_LE(cache.GetMaxCompileTime(), cache.GetTotalCompileTime());
+}
+
+TEST(RuntimeEffectCacheTest, DifferentSkSLIsCompiledSeparately) {
+  RuntimeEffectCache cache;
+  auto green = cache.Compile(kGreenSkSL);
+  auto red = cache.Compile(kRedSkSL);
+  ASSERT_NE(green.effect, nullptr);
+  ASSERT_NE(red.effect, nullptr);
+  EXPECT_NE(green.effect, red.effect);
+  EXPECT_EQ(cache.GetCompileCount(), 2u);
+  EXPECT_EQ(cache.GetEntryCount(), 2u);
+}
+
+TEST(RuntimeEffectCacheTest, ErrorsAreReportedButNotCached) {
+  RuntimeEffectCache cache;
+  auto result = cache.Compile("not sksl");
+  EXPECT_EQ(result.effect, nullptr);
+  EXPECT_FALSE(result.error.empty());
+  EXPECT_EQ(cache.Find("not sksl"), nullptr);
+  EXPECT_EQ(cache.GetEntryCount(), 0u);
+}
+
+TEST(RuntimeEffectCacheTest, ConcurrentCompilesShareOneEffect) {
+  RuntimeEffectCache cache;
+  std::vector<sk_sp<SkRuntimeEffect>> effects(4);
+  std::vector<std::thread> threads;
+  for (auto& effect : effects) {
+    threads.emplace_back(
+        [&cache, &effect] { effect = cache.Compile(kGreenSkSL).effect; });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const auto& effect : effects) {
+    EXPECT_EQ(effect, cache.Find(kGreenSkSL));
+  }
+  EXPECT_EQ(cache.GetEntryCount(), 1u);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -3025,6 +3025,56 @@ class ParagraphBuilder extends NativeFieldWrapperClass1 {
     return paragraph;
   }
   void _build(Paragraph outParagraph) native 'ParagraphBuilder_build';
+
+  int _buildTransferable(double width) native 'ParagraphBuilder_buildTransferable';
+}
+
+/// A [Paragraph] that has been laid out on one isolate, to be painted by the
+/// root isolate.
+///
+/// Laying out long text can take longer than a frame. Isolates spawned by the
+/// root isolate lay out text with the same fonts as the root isolate, so they
+/// can lay out a paragraph ahead of time and send it to the root isolate,
+/// which then paints it without shaping the text again:
+///
+/// ```dart
+/// void layOutDocument(SendPort sendPort) {
+///   final ParagraphBuilder builder = ParagraphBuilder(ParagraphStyle());
+///   builder.addText(document);
+///   sendPort.send(TransferableParagraph(builder, const ParagraphConstraints(width: 400)));
+/// }
+/// ```
+///
+/// The layout cannot be changed until it is turned back into a [Paragraph]
+/// with [materialize]. Transferable paragraphs can only be sent to isolates
+/// spawned with `Isolate.spawn`. A transferable paragraph that is never
+/// materialized keeps its layout alive until [dispose] is called, or until
+/// the root isolate and the isolates it spawned have all shut down.
+class TransferableParagraph {
+  /// Builds the paragraph of [builder] and lays it out with [constraints].
+  ///
+  /// After calling this constructor, the paragraph builder object is invalid
+  /// and cannot be used further.
+  TransferableParagraph(ParagraphBuilder builder, ParagraphConstraints constraints)
+    : _handle = builder._buildTransferable(constraints.width);
+
+  final int _handle;
+
+  /// Returns the laid out paragraph, which belongs to the calling isolate
+  /// from then on.
+  ///
+  /// Must be called on the root isolate, and at most once for every
+  /// paragraph, even if the paragraph was sent to several isolates.
+  Paragraph materialize() {
+    final Paragraph paragraph = Paragraph._();
+    _materialize(paragraph, _handle);
+    return paragraph;
+  }
+  static void _materialize(Paragraph outParagraph, int handle) native 'TransferableParagraph_materialize';
+
+  /// Releases the layout without materializing it.
+  void dispose() => _dispose(_handle);
+  static void _dispose(int handle) native 'TransferableParagraph_dispose';
 }
 
 /// Loads a font from a buffer and makes it available for rendering text.
@@ -11,6 +11,7 @@
 #include "flutter/fml/logging.h"
 #include "flutter/fml/task_runner.h"
 #include "flutter/lib/ui/text/font_collection.h"
+#include "flutter/lib/ui/text/transferable_paragraph.h"
 #include "flutter/lib/ui/ui_dart_state.h"
 #include "flutter/lib/ui/window/platform_configuration.h"
 #include "flutter/third_party/txt/src/txt/font_style.h"
@@ -136,18 +137,25 @@ const int sForceStrutHeightMask = 1 << sForceStrutHeightIndex;
 }  // namespace
 
 static void ParagraphBuilder_constructor(Dart_NativeArguments args) {
-  UIDartState::ThrowIfUIOperationsProhibited();
+  // Paragraphs can be built and laid out on any isolate spawned by the root
+  // isolate, as long as the fonts of its engine are known.
+  if (!UIDartState::Current()->GetFontCollection()) {
+    Dart_ThrowException(
+        tonic::ToDart("Text layout is not available on this isolate."));
+    return;
+  }
   DartCallConstructor(&ParagraphBuilder::create, args);
 }
 
 IMPLEMENT_WRAPPERTYPEINFO(ui, ParagraphBuilder);
 
-#define FOR_EACH_BINDING(V)           \
-  V(ParagraphBuilder, pushStyle)      \
-  V(ParagraphBuilder, pop)            \
-  V(ParagraphBuilder, addText)        \
-  V(ParagraphBuilder, addPlaceholder) \
-  V(ParagraphBuilder, build)
+#define FOR_EACH_BINDING(V)              \
+  V(ParagraphBuilder, pushStyle)         \
+  V(ParagraphBuilder, pop)               \
+  V(ParagraphBuilder, addText)           \
+  V(ParagraphBuilder, addPlaceholder)    \
+  V(ParagraphBuilder, build)             \
+  V(ParagraphBuilder, buildTransferable)
 
 FOR_EACH_BINDING(DART_NATIVE_CALLBACK)
 
@@ -296,11 +304,6 @@ ParagraphBuilder::ParagraphBuilder(
     style.locale = locale;
   }
 
-  FontCollection& font_collection = UIDartState::Current()
-                                        ->platform_configuration()
-                                        ->client()
-                                        ->GetFontCollection();
-
   typedef std::unique_ptr<txt::ParagraphBuilder> (*ParagraphBuilderFactory)(
       const txt::ParagraphStyle& style,
       std::shared_ptr<txt::FontCollection> font_collection);
@@ -312,12 +315,16 @@ ParagraphBuilder::ParagraphBuilder(
 #else
   bool enable_skparagraph = UIDartState::Current()->enable_skparagraph();
 #endif
-  if (enable_skparagraph) {
+  // The Skia text layout font collection is not thread safe, so only the root
+  // isolate shapes text with it. Other isolates use the txt shaper, whose font
+  // caches are guarded by minikin's lock.
+  if (enable_skparagraph && UIDartState::Current()->IsRootIsolate()) {
     factory = txt::ParagraphBuilder::CreateSkiaBuilder;
   }
 #endif  // FLUTTER_ENABLE_SKSHAPER
 
-  m_paragraphBuilder = factory(style, font_collection.GetFontCollection());
+  m_paragraphBuilder =
+      factory(style, UIDartState::Current()->GetFontCollection());
 }
 
 ParagraphBuilder::~ParagraphBuilder() = default;
@@ -528,4 +535,17 @@ void ParagraphBuilder::build(Dart_Handle paragraph_handle) {
   Paragraph::Create(paragraph_handle, m_paragraphBuilder->Build());
 }
 
+int64_t ParagraphBuilder::buildTransferable(double width) {
+  std::shared_ptr<TransferableParagraphStore> store =
+      UIDartState::Current()->GetTransferableParagraphs();
+  if (!store) {
+    Dart_ThrowException(
+        tonic::ToDart("Paragraphs cannot be transferred from this isolate."));
+    return 0;
+  }
+  std::unique_ptr<txt::Paragraph> paragraph = m_paragraphBuilder->Build();
+  paragraph->Layout(width);
+  return store->Add(std::move(paragraph));
+}
+
 }  // namespace flutter
@@ -71,6 +71,11 @@ class ParagraphBuilder : public RefCountedDartWrappable<ParagraphBuilder> {
 
   void build(Dart_Handle paragraph_handle);
 
+  // Builds the paragraph and lays it out with |width|, so that it can be
+  // materialized by another isolate. Returns the handle of the paragraph in
+  // the |TransferableParagraphStore| of the isolate group.
+  int64_t buildTransferable(double width);
+
   static void RegisterNatives(tonic::DartLibraryNatives* natives);
 
  private:
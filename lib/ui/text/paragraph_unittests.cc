@@ -0,0 +1,76 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/text/paragraph.h"
+
+#include <memory>
+
+#include "flutter/common/task_runners.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/lib/ui/text/transferable_paragraph.h"
+#include "flutter/lib/ui/ui_dart_state.h"
+#include "flutter/shell/common/shell_test.h"
+#include "flutter/shell/common/thread_host.h"
+#include "flutter/testing/testing.h"
+#include "third_party/tonic/converter/dart_converter.h"
+
+namespace flutter {
+namespace testing {
+
+TEST_F(ShellTest, BackgroundIsolateLayoutIsPaintedByRootIsolate) {
+  auto message_latch = std::make_shared<fml::AutoResetWaitableEvent>();
+
+  auto native_validate_paragraph_layout =
+      [message_latch](Dart_NativeArguments args) {
+        double height = tonic::DartConverter<double>::FromDart(
+            Dart_GetNativeArgument(args, 0));
+        double root_height = tonic::DartConverter<double>::FromDart(
+            Dart_GetNativeArgument(args, 1));
+        bool materialized_twice = tonic::DartConverter<bool>::FromDart(
+            Dart_GetNativeArgument(args, 2));
+
+        // The background isolate lays out the same document as the root
+        // isolate.
+        EXPECT_GT(height, 0);
+        EXPECT_EQ(height, root_height);
+        EXPECT_FALSE(materialized_twice);
+        // Nothing is left behind in the isolate group once the paragraph is
+        // materialized.
+        auto store = UIDartState::Current()->GetTransferableParagraphs();
+        EXPECT_TRUE(store);
+        if (store) {
+          EXPECT_EQ(store->GetParagraphCount(), 0u);
+        }
+        message_latch->Signal();
+      };
+
+  Settings settings = CreateSettingsForFixture();
+  TaskRunners task_runners("test",                  // label
+                           GetCurrentTaskRunner(),  // platform
+                           CreateNewThread(),       // raster
+                           CreateNewThread(),       // ui
+                           CreateNewThread()        // io
+  );
+
+  AddNativeCallback("ValidateParagraphLayout",
+                    CREATE_NATIVE_ENTRY(native_validate_paragraph_layout));
+
+  std::unique_ptr<Shell> shell =
+      CreateShell(std::move(settings), std::move(task_runners));
+
+  ASSERT_TRUE(shell->IsSetup());
+  auto configuration = RunConfiguration::InferFromSettings(settings);
+  configuration.SetEntrypoint("layoutParagraphInBackground");
+
+  shell->RunEngine(std::move(configuration), [](auto result) {
+    ASSERT_EQ(result, Engine::RunStatus::Success);
+  });
+
+  message_latch->Wait();
+
+  DestroyShell(std::move(shell), std::move(task_runners));
+}
+
+}  // namespace testing
+}  // namespace flutter
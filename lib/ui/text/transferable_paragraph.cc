@@ -0,0 +1,94 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/text/transferable_paragraph.h"
+
+#include "flutter/lib/ui/text/paragraph.h"
+#include "flutter/lib/ui/ui_dart_state.h"
+#include "third_party/tonic/converter/dart_converter.h"
+#include "third_party/tonic/dart_args.h"
+#include "third_party/tonic/dart_library_natives.h"
+
+namespace flutter {
+
+namespace {
+
+std::unique_ptr<txt::Paragraph> TakeFromCurrentIsolateGroup(int64_t handle) {
+  std::shared_ptr<TransferableParagraphStore> store =
+      UIDartState::Current()->GetTransferableParagraphs();
+  if (!store) {
+    return nullptr;
+  }
+  return store->Take(handle);
+}
+
+void Materialize(Dart_Handle paragraph_handle, int64_t handle) {
+  std::unique_ptr<txt::Paragraph> paragraph =
+      TakeFromCurrentIsolateGroup(handle);
+  if (!paragraph) {
+    Dart_ThrowException(tonic::ToDart(
+        "The paragraph was already materialized or disposed."));
+    return;
+  }
+  Paragraph::Create(paragraph_handle, std::move(paragraph));
+}
+
+void _Materialize(Dart_NativeArguments args) {
+  // Paragraphs are only painted by the root isolate. Keeping them there also
+  // keeps paragraphs built with the Skia shaper off the background isolates.
+  UIDartState::ThrowIfUIOperationsProhibited();
+  tonic::DartCallStatic(Materialize, args);
+}
+
+void Dispose(int64_t handle) {
+  TakeFromCurrentIsolateGroup(handle);
+}
+
+void _Dispose(Dart_NativeArguments args) {
+  tonic::DartCallStatic(Dispose, args);
+}
+
+}  // namespace
+
+TransferableParagraphStore::TransferableParagraphStore() = default;
+
+TransferableParagraphStore::~TransferableParagraphStore() = default;
+
+int64_t TransferableParagraphStore::Add(
+    std::unique_ptr<txt::Paragraph> paragraph) {
+  std::scoped_lock lock(mutex_);
+  int64_t handle = next_handle_++;
+  paragraphs_[handle] = std::move(paragraph);
+  return handle;
+}
+
+std::unique_ptr<txt::Paragraph> TransferableParagraphStore::Take(
+    int64_t handle) {
+  std::unique_ptr<txt::Paragraph> paragraph;
+  {
+    std::scoped_lock lock(mutex_);
+    auto found = paragraphs_.find(handle);
+    if (found == paragraphs_.end()) {
+      return nullptr;
+    }
+    paragraph = std::move(found->second);
+    paragraphs_.erase(found);
+  }
+  return paragraph;
+}
+
+size_t TransferableParagraphStore::GetParagraphCount() const {
+  std::scoped_lock lock(mutex_);
+  return paragraphs_.size();
+}
+
+void TransferableParagraphStore::RegisterNatives(
+    tonic::DartLibraryNatives* natives) {
+  natives->Register({
+      {"TransferableParagraph_materialize", _Materialize, 2, true},
+      {"TransferableParagraph_dispose", _Dispose, 1, true},
+  });
+}
+
+}  // namespace flutter
@@ -0,0 +1,61 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_TEXT_TRANSFERABLE_PARAGRAPH_H_
+#define FLUTTER_LIB_UI_TEXT_TRANSFERABLE_PARAGRAPH_H_
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "flutter/fml/macros.h"
+#include "flutter/third_party/txt/src/txt/paragraph.h"
+
+namespace tonic {
+class DartLibraryNatives;
+}  // namespace tonic
+
+namespace flutter {
+
+// Holds paragraphs that were laid out on one isolate of an isolate group until
+// another isolate of the group materializes them, so that long text can be
+// laid out off the UI thread and painted on it without being shaped again.
+//
+// There is one store for every isolate group, so handles are meaningless to
+// the isolates of other engines, and paragraphs that are never materialized
+// nor disposed are released when the isolate group shuts down.
+//
+// A paragraph is only ever used by one isolate at a time: the isolate that
+// laid it out gives it up when it is added here, and it is not touched again
+// until the isolate that takes it out owns it.
+class TransferableParagraphStore {
+ public:
+  TransferableParagraphStore();
+
+  ~TransferableParagraphStore();
+
+  // Takes |paragraph|, which must have been laid out, and returns the handle
+  // to take it out with.
+  int64_t Add(std::unique_ptr<txt::Paragraph> paragraph);
+
+  // Removes the paragraph of |handle| and returns it, or nullptr if it was
+  // already taken or disposed.
+  std::unique_ptr<txt::Paragraph> Take(int64_t handle);
+
+  size_t GetParagraphCount() const;
+
+  static void RegisterNatives(tonic::DartLibraryNatives* natives);
+
+ private:
+  mutable std::mutex mutex_;
+  int64_t next_handle_ = 1;
+  std::unordered_map<int64_t, std::unique_ptr<txt::Paragraph>> paragraphs_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(TransferableParagraphStore);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_TEXT_TRANSFERABLE_PARAGRAPH_H_
@@ -4,6 +4,7 @@
 
 #include "flutter/benchmarking/benchmarking.h"
 #include "flutter/common/settings.h"
+#include "flutter/lib/ui/painting/runtime_effect_cache.h"
 #include "flutter/lib/ui/volatile_path_tracker.h"
 #include "flutter/lib/ui/window/platform_message_response_dart.h"
 #include "flutter/runtime/dart_vm_lifecycle.h"
@@ -12,6 +13,7 @@
 #include "flutter/testing/fixture_test.h"
 
 #include <future>
+#include <string>
 
 namespace flutter {
 
@@ -112,9 +114,59 @@ static void BM_PathVolatilityTracker(benchmark::State& state) {
   }
 }
 
+// A fragment shader of the size that applications typically use.
+static constexpr char kShaderSkSL[] =
+    "uniform float2 size;\n"
+    "uniform float time;\n"
+    "half4 main(float2 p) {\n"
+    "  float2 uv = p / size;\n"
+    "  float d = length(uv - 0.5);\n"
+    "  float ring = smoothstep(0.2, 0.21, d) - smoothstep(0.3, 0.31, d);\n"
+    "  half3 color = half3(0.5 + 0.5 * cos(time + uv.xyx + float3(0, 2, 4)));\n"
+    "  return half4(color * half(ring), 1.0);\n"
+    "}\n";
+
+// |kShaderSkSL| with a comment that makes it differ for every |variant|.
+static std::string MakeShaderSkSL(size_t variant) {
+  return "// " + std::to_string(variant) + "\n" + kShaderSkSL;
+}
+
+// The time until a fragment program can be used when its SkSL is compiled
+// on first use, as it is the first time an application runs it.
+static void BM_RuntimeEffectCacheFirstUse(benchmark::State& state) {
+  RuntimeEffectCache cache;
+  size_t variant = 0;
+  while (state.KeepRunning()) {
+    state.PauseTiming();
+    // Different SkSL every time, so that none of it is in the cache.
+    std::string sksl = MakeShaderSkSL(variant++);
+    state.ResumeTiming();
+    auto result = cache.Compile(sksl);
+    FML_CHECK(result.effect);
+  }
+  state.counters["MaxCompileMs"] = cache.GetMaxCompileTime().ToMillisecondsF();
+}
+
+// The time until a fragment program can be used when its SkSL was already
+// compiled, as it is for the programs of spawned engines and for the ones
+// compiled again after startup.
+static void BM_RuntimeEffectCacheStartup(benchmark::State& state) {
+  RuntimeEffectCache cache;
+  const std::string sksl = MakeShaderSkSL(0);
+  FML_CHECK(cache.Compile(sksl).effect);
+  while (state.KeepRunning()) {
+    auto result = cache.Compile(sksl);
+    FML_CHECK(result.effect);
+  }
+}
+
 BENCHMARK(BM_PlatformMessageResponseDartComplete)
     ->Unit(benchmark::kMicrosecond);
 
 BENCHMARK(BM_PathVolatilityTracker)->Unit(benchmark::kMillisecond);
 
+BENCHMARK(BM_RuntimeEffectCacheFirstUse)->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_RuntimeEffectCacheStartup)->Unit(benchmark::kMicrosecond);
+
 }  // namespace flutter
@@ -7,6 +7,7 @@
 #include <iostream>
 
 #include "flutter/fml/message_loop.h"
+#include "flutter/lib/ui/text/font_collection.h"
 #include "flutter/lib/ui/window/platform_configuration.h"
 #include "third_party/tonic/converter/dart_converter.h"
 #include "third_party/tonic/dart_message_handler.h"
@@ -137,6 +138,25 @@ std::shared_ptr<VolatilePathTracker> UIDartState::GetVolatilePathTracker()
   return context_.volatile_path_tracker;
 }
 
+std::shared_ptr<txt::FontCollection> UIDartState::GetFontCollection() const {
+  if (platform_configuration_) {
+    return platform_configuration_->client()
+        ->GetFontCollection()
+        .GetFontCollection();
+  }
+  return context_.font_collection;
+}
+
+std::shared_ptr<TransferableParagraphStore>
+UIDartState::GetTransferableParagraphs() const {
+  return context_.transferable_paragraphs;
+}
+
+std::shared_ptr<fml::ConcurrentTaskRunner>
+UIDartState::GetConcurrentTaskRunner() const {
+  return context_.concurrent_task_runner;
+}
+
 void UIDartState::ScheduleMicrotask(Dart_Handle closure) {
   if (tonic::LogIfError(closure) || !Dart_IsClosure(closure)) {
     return;
@@ -13,6 +13,7 @@
 #include "flutter/common/task_runners.h"
 #include "flutter/flow/skia_gpu_object.h"
 #include "flutter/fml/build_config.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/memory/weak_ptr.h"
 #include "flutter/fml/synchronization/waitable_event.h"
 #include "flutter/lib/ui/io_manager.h"
@@ -26,10 +27,15 @@
 #include "third_party/tonic/dart_persistent_value.h"
 #include "third_party/tonic/dart_state.h"
 
+namespace txt {
+class FontCollection;
+}  // namespace txt
+
 namespace flutter {
 class FontSelector;
 class ImageGeneratorRegistry;
 class PlatformConfiguration;
+class TransferableParagraphStore;
 
 class UIDartState : public tonic::DartState {
  public:
@@ -89,6 +95,21 @@ class UIDartState : public tonic::DartState {
 
     /// Cache for tracking path volatility.
     std::shared_ptr<VolatilePathTracker> volatile_path_tracker;
+
+    /// The fonts used to lay out text in isolates that do not have a platform
+    /// configuration, such as background isolates spawned by the root
+    /// isolate. Paragraph layouts are shared between all isolates using the
+    /// same fonts.
+    std::shared_ptr<txt::FontCollection> font_collection;
+
+    /// The paragraphs laid out by the isolates of this isolate group that are
+    /// waiting to be materialized by another isolate of the group.
+    std::shared_ptr<TransferableParagraphStore> transferable_paragraphs;
+
+    /// The VM's worker pool, on which expensive work that does not need the
+    /// UI thread, such as compiling fragment programs, can be done. Null if
+    /// the work must be done synchronously instead.
+    std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner;
   };
 
   Dart_Port main_port() const { return main_port_; }
@@ -118,6 +139,17 @@ class UIDartState : public tonic::DartState {
 
   std::shared_ptr<VolatilePathTracker> GetVolatilePathTracker() const;
 
+  /// The fonts available to paragraphs built by this isolate, or nullptr if
+  /// the isolate cannot lay out text.
+  std::shared_ptr<txt::FontCollection> GetFontCollection() const;
+
+  /// The paragraphs that can be materialized by this isolate, or nullptr if
+  /// the isolate cannot transfer paragraphs.
+  std::shared_ptr<TransferableParagraphStore> GetTransferableParagraphs()
+      const;
+
+  std::shared_ptr<fml::ConcurrentTaskRunner> GetConcurrentTaskRunner() const;
+
   fml::WeakPtr<SnapshotDelegate> GetSnapshotDelegate() const;
 
   fml::WeakPtr<GrDirectContext> GetResourceContext() const;
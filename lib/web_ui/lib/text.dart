@@ -725,6 +725,26 @@ abstract class ParagraphBuilder {
   });
 }
 
+class TransferableParagraph {
+  TransferableParagraph(ParagraphBuilder builder, ParagraphConstraints constraints)
+      : _paragraph = builder.build()..layout(constraints);
+
+  Paragraph? _paragraph;
+
+  Paragraph materialize() {
+    final Paragraph? paragraph = _paragraph;
+    if (paragraph == null) {
+      throw StateError('The paragraph was already materialized or disposed.');
+    }
+    _paragraph = null;
+    return paragraph;
+  }
+
+  void dispose() {
+    _paragraph = null;
+  }
+}
+
 Future<void> loadFontFromList(Uint8List list, {String? fontFamily}) {
   if (engine.useCanvasKit) {
     return engine.skiaFontCollection
@@ -204,14 +204,21 @@ std::weak_ptr<DartIsolate> DartIsolate::CreateRootIsolate(
               context.advisory_script_entrypoint,  // advisory entrypoint
               nullptr,                             // child isolate preparer
               isolate_create_callback,             // isolate create callback
-              isolate_shutdown_callback            // isolate shutdown callback
+              isolate_shutdown_callback,           // isolate shutdown callback
+              context.font_collection              // font collection
               )));
 
+  // Engines spawned from another engine join the isolate group of its root
+  // isolate, so they share its transferable paragraphs.
+  UIDartState::Context root_context = context;
+  root_context.transferable_paragraphs =
+      spawning_isolate ? spawning_isolate->GetTransferableParagraphs()
+                       : (*isolate_group_data)->GetTransferableParagraphs();
   auto isolate_data = std::make_unique<std::shared_ptr<DartIsolate>>(
       std::shared_ptr<DartIsolate>(new DartIsolate(
-          settings,           // settings
-          true,               // is_root_isolate
-          std::move(context)  // context
+          settings,                // settings
+          true,                    // is_root_isolate
+          std::move(root_context)  // context
           )));
 
   DartErrorString error;
@@ -918,7 +925,8 @@ Dart_Isolate DartIsolate::DartIsolateGroupCreateCallback(
               advisory_script_entrypoint,
               parent_group_data.GetChildIsolatePreparer(),
               parent_group_data.GetIsolateCreateCallback(),
-              parent_group_data.GetIsolateShutdownCallback())));
+              parent_group_data.GetIsolateShutdownCallback(),
+              parent_group_data.GetFontCollection())));
 
   TaskRunners null_task_runners(advisory_script_uri,
                                 /* platform= */ nullptr,
@@ -929,6 +937,9 @@ Dart_Isolate DartIsolate::DartIsolateGroupCreateCallback(
   UIDartState::Context context(null_task_runners);
   context.advisory_script_uri = advisory_script_uri;
   context.advisory_script_entrypoint = advisory_script_entrypoint;
+  context.font_collection = parent_group_data.GetFontCollection();
+  context.transferable_paragraphs =
+      (*isolate_group_data)->GetTransferableParagraphs();
   auto isolate_data = std::make_unique<std::shared_ptr<DartIsolate>>(
       std::shared_ptr<DartIsolate>(
           new DartIsolate((*isolate_group_data)->GetSettings(),  // settings
@@ -982,6 +993,9 @@ bool DartIsolate::DartIsolateInitializeCallback(void** child_callback_data,
   context.advisory_script_uri = (*isolate_group_data)->GetAdvisoryScriptURI();
   context.advisory_script_entrypoint =
       (*isolate_group_data)->GetAdvisoryScriptEntrypoint();
+  context.font_collection = (*isolate_group_data)->GetFontCollection();
+  context.transferable_paragraphs =
+      (*isolate_group_data)->GetTransferableParagraphs();
   auto embedder_isolate = std::make_unique<std::shared_ptr<DartIsolate>>(
       std::shared_ptr<DartIsolate>(
           new DartIsolate((*isolate_group_data)->GetSettings(),  // settings
@@ -4,6 +4,7 @@
 
 #include "flutter/runtime/dart_isolate_group_data.h"
 
+#include "flutter/lib/ui/text/transferable_paragraph.h"
 #include "flutter/runtime/dart_snapshot.h"
 
 namespace flutter {
@@ -15,14 +16,17 @@ DartIsolateGroupData::DartIsolateGroupData(
     std::string advisory_script_entrypoint,
     const ChildIsolatePreparer& child_isolate_preparer,
     const fml::closure& isolate_create_callback,
-    const fml::closure& isolate_shutdown_callback)
+    const fml::closure& isolate_shutdown_callback,
+    std::shared_ptr<txt::FontCollection> font_collection)
     : settings_(settings),
       isolate_snapshot_(isolate_snapshot),
       advisory_script_uri_(advisory_script_uri),
       advisory_script_entrypoint_(advisory_script_entrypoint),
       child_isolate_preparer_(child_isolate_preparer),
       isolate_create_callback_(isolate_create_callback),
-      isolate_shutdown_callback_(isolate_shutdown_callback) {
+      isolate_shutdown_callback_(isolate_shutdown_callback),
+      font_collection_(std::move(font_collection)),
+      transferable_paragraphs_(std::make_shared<TransferableParagraphStore>()) {
   FML_DCHECK(isolate_snapshot_) << "Must contain a valid isolate snapshot.";
 }
 
@@ -58,6 +62,16 @@ const fml::closure& DartIsolateGroupData::GetIsolateShutdownCallback() const {
   return isolate_shutdown_callback_;
 }
 
+const std::shared_ptr<txt::FontCollection>&
+DartIsolateGroupData::GetFontCollection() const {
+  return font_collection_;
+}
+
+const std::shared_ptr<TransferableParagraphStore>&
+DartIsolateGroupData::GetTransferableParagraphs() const {
+  return transferable_paragraphs_;
+}
+
 void DartIsolateGroupData::SetChildIsolatePreparer(
     const ChildIsolatePreparer& value) {
   std::scoped_lock lock(child_isolate_preparer_mutex_);
@@ -5,6 +5,7 @@
 #ifndef FLUTTER_RUNTIME_DART_ISOLATE_GROUP_DATA_H_
 #define FLUTTER_RUNTIME_DART_ISOLATE_GROUP_DATA_H_
 
+#include <memory>
 #include <mutex>
 #include <string>
 
@@ -12,10 +13,15 @@
 #include "flutter/fml/closure.h"
 #include "flutter/fml/memory/ref_ptr.h"
 
+namespace txt {
+class FontCollection;
+}  // namespace txt
+
 namespace flutter {
 
 class DartIsolate;
 class DartSnapshot;
+class TransferableParagraphStore;
 
 using ChildIsolatePreparer = std::function<bool(DartIsolate*)>;
 
@@ -33,7 +39,8 @@ class DartIsolateGroupData {
                        std::string advisory_script_entrypoint,
                        const ChildIsolatePreparer& child_isolate_preparer,
                        const fml::closure& isolate_create_callback,
-                       const fml::closure& isolate_shutdown_callback);
+                       const fml::closure& isolate_shutdown_callback,
+                       std::shared_ptr<txt::FontCollection> font_collection);
 
   ~DartIsolateGroupData();
 
@@ -51,6 +58,15 @@ class DartIsolateGroupData {
 
   const fml::closure& GetIsolateShutdownCallback() const;
 
+  // The fonts of the engine that launched the root isolate of this group. Used
+  // to lay out text in isolates that have no platform configuration.
+  const std::shared_ptr<txt::FontCollection>& GetFontCollection() const;
+
+  // The paragraphs laid out by the isolates of this group that are waiting to
+  // be materialized. Leftover paragraphs are released with the group.
+  const std::shared_ptr<TransferableParagraphStore>& GetTransferableParagraphs()
+      const;
+
   void SetChildIsolatePreparer(const ChildIsolatePreparer& value);
 
  private:
@@ -62,6 +78,8 @@ class DartIsolateGroupData {
   ChildIsolatePreparer child_isolate_preparer_;
   const fml::closure isolate_create_callback_;
   const fml::closure isolate_shutdown_callback_;
+  const std::shared_ptr<txt::FontCollection> font_collection_;
+  const std::shared_ptr<TransferableParagraphStore> transferable_paragraphs_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(DartIsolateGroupData);
 };
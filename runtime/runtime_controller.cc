@@ -360,6 +360,15 @@ bool RuntimeController::LaunchRootIsolate(
     return false;
   }
 
+  // Isolates spawned by the root isolate lay out text with the fonts of this
+  // engine.
+  context_.font_collection = client_.GetFontCollection().GetFontCollection();
+
+  // Fragment programs are compiled on the VM's workers.
+  if (vm_) {
+    context_.concurrent_task_runner = vm_->GetConcurrentWorkerTaskRunner();
+  }
+
   auto strong_root_isolate =
       DartIsolate::CreateRunningRootIsolate(
           settings,                                       //
@@ -37,6 +37,10 @@ const std::string_view ServiceProtocol::kGetSkSLsExtensionName =
 const std::string_view
     ServiceProtocol::kEstimateRasterCacheMemoryExtensionName =
         "_flutter.estimateRasterCacheMemory";
+const std::string_view ServiceProtocol::kGetLayerRasterCostsExtensionName =
+    "_flutter.getLayerRasterCosts";
+const std::string_view ServiceProtocol::kCaptureLayerTreesExtensionName =
+    "_flutter.captureLayerTrees";
 
 static constexpr std::string_view kViewIdPrefx = "_flutterView/";
 static constexpr std::string_view kListViewsExtensionName =
@@ -56,6 +60,8 @@ ServiceProtocol::ServiceProtocol()
           kGetDisplayRefreshRateExtensionName,
           kGetSkSLsExtensionName,
           kEstimateRasterCacheMemoryExtensionName,
+          kGetLayerRasterCostsExtensionName,
+          kCaptureLayerTreesExtensionName,
       }),
       handlers_mutex_(fml::SharedMutex::Create()) {}
 
@@ -29,6 +29,8 @@ class ServiceProtocol {
   static const std::string_view kGetDisplayRefreshRateExtensionName;
   static const std::string_view kGetSkSLsExtensionName;
   static const std::string_view kEstimateRasterCacheMemoryExtensionName;
+  static const std::string_view kGetLayerRasterCostsExtensionName;
+  static const std::string_view kCaptureLayerTreesExtensionName;
 
   class Handler {
    public:
@@ -0,0 +1,261 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/runtime/snapshot_page_prefetcher.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <sstream>
+
+#include "flutter/fml/build_config.h"
+#include "flutter/fml/eintr_wrapper.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/trace_event.h"
+
+#if OS_LINUX || OS_ANDROID
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <fstream>
+#endif  // OS_LINUX || OS_ANDROID
+
+namespace flutter {
+
+namespace {
+
+#if OS_LINUX || OS_ANDROID
+
+size_t GetPageSize() {
+  static const size_t page_size = ::sysconf(_SC_PAGESIZE);
+  return page_size;
+}
+
+bool Advise(const uint8_t* start, size_t size, int advice) {
+  return ::madvise(const_cast<uint8_t*>(start), size, advice) == 0;
+}
+
+#endif  // OS_LINUX || OS_ANDROID
+
+}  // namespace
+
+SnapshotPagePrefetcher::SnapshotPagePrefetcher(
+    fml::RefPtr<const DartSnapshot> vm_snapshot,
+    fml::RefPtr<const DartSnapshot> isolate_snapshot,
+    std::string profile_path)
+    : vm_snapshot_(std::move(vm_snapshot)),
+      isolate_snapshot_(std::move(isolate_snapshot)),
+      profile_path_(std::move(profile_path)) {
+  if (vm_snapshot_) {
+    AddRegion("VMData", vm_snapshot_->GetDataMapping(), false);
+    AddRegion("VMInstructions", vm_snapshot_->GetInstructionsMapping(), true);
+  }
+  if (isolate_snapshot_) {
+    AddRegion("IsolateData", isolate_snapshot_->GetDataMapping(), false);
+    AddRegion("IsolateInstructions",
+              isolate_snapshot_->GetInstructionsMapping(), true);
+  }
+}
+
+SnapshotPagePrefetcher::~SnapshotPagePrefetcher() = default;
+
+bool SnapshotPagePrefetcher::HasProfile() const {
+  return !profile_path_.empty() && fml::IsFile(profile_path_);
+}
+
+void SnapshotPagePrefetcher::AddRegion(std::string name,
+                                       const uint8_t* address,
+                                       bool executable) {
+  if (address == nullptr) {
+    return;
+  }
+  auto mapping = FindMappedRegion(address);
+  if (!mapping) {
+    return;
+  }
+  // The data and instructions of a snapshot may share a mapping.
+  for (const auto& region : regions_) {
+    if (region.mapping.start == mapping->start) {
+      return;
+    }
+  }
+  regions_.push_back({std::move(name), *mapping, executable});
+}
+
+size_t SnapshotPagePrefetcher::Prefetch() const {
+#if OS_LINUX || OS_ANDROID
+  TRACE_EVENT0("flutter", "SnapshotPagePrefetcher::Prefetch");
+  PageProfile profile;
+  if (!profile_path_.empty()) {
+    if (auto mapping = fml::FileMapping::CreateReadOnly(profile_path_)) {
+      profile = ParseProfile(std::string(
+          reinterpret_cast<const char*>(mapping->GetMapping()),
+          mapping->GetSize()));
+    }
+  }
+
+  const size_t page_size = GetPageSize();
+  size_t requested = 0;
+  for (const auto& region : regions_) {
+#ifdef MADV_HUGEPAGE
+    // Lets khugepaged collapse the instructions into huge pages, which
+    // reduces TLB misses. This is only honored for file backed mappings by
+    // kernels built with CONFIG_READ_ONLY_THP_FOR_FS, and failing is fine.
+    if (region.executable) {
+      Advise(region.mapping.start, region.mapping.size, MADV_HUGEPAGE);
+    }
+#endif  // MADV_HUGEPAGE
+
+    const size_t page_count =
+        (region.mapping.size + page_size - 1) / page_size;
+    auto ranges = profile.find(region.name);
+    if (ranges == profile.end()) {
+      if (Advise(region.mapping.start, region.mapping.size, MADV_WILLNEED)) {
+        requested += region.mapping.size;
+      }
+      continue;
+    }
+    for (const auto& range : ranges->second) {
+      // The profile may have been recorded with a different build.
+      if (range.first_page >= page_count) {
+        continue;
+      }
+      const size_t offset = range.first_page * page_size;
+      const size_t size =
+          std::min(range.page_count * page_size, region.mapping.size - offset);
+      if (Advise(region.mapping.start + offset, size, MADV_WILLNEED)) {
+        requested += size;
+      }
+    }
+  }
+  return requested;
+#else   // OS_LINUX || OS_ANDROID
+  return 0;
+#endif  // OS_LINUX || OS_ANDROID
+}
+
+bool SnapshotPagePrefetcher::RecordProfile() const {
+  if (profile_path_.empty() || regions_.empty()) {
+    return false;
+  }
+  TRACE_EVENT0("flutter", "SnapshotPagePrefetcher::RecordProfile");
+  PageProfile profile;
+  for (const auto& region : regions_) {
+    profile[region.name] = GetTouchedPages(region.mapping);
+  }
+
+  const size_t separator = profile_path_.rfind('/');
+  const std::string directory_path =
+      separator == std::string::npos
+          ? "."
+          : profile_path_.substr(0, std::max<size_t>(separator, 1));
+  const std::string file_name = profile_path_.substr(
+      separator == std::string::npos ? 0 : separator + 1);
+  auto directory = fml::OpenDirectory(directory_path.c_str(), false,
+                                      fml::FilePermission::kReadWrite);
+  if (!directory.is_valid()) {
+    FML_LOG(ERROR) << "Could not open the directory of the snapshot page "
+                      "profile at "
+                   << profile_path_;
+    return false;
+  }
+  return fml::WriteAtomically(directory, file_name.c_str(),
+                              fml::DataMapping(SerializeProfile(profile)));
+}
+
+std::optional<SnapshotPagePrefetcher::MappedRegion>
+SnapshotPagePrefetcher::FindMappedRegion(const void* address) {
+#if OS_LINUX || OS_ANDROID
+  const auto target = reinterpret_cast<uintptr_t>(address);
+  std::ifstream maps("/proc/self/maps");
+  std::string line;
+  while (std::getline(maps, line)) {
+    uintptr_t start = 0;
+    uintptr_t end = 0;
+    if (std::sscanf(line.c_str(), "%" SCNxPTR "-%" SCNxPTR, &start, &end) !=
+        2) {
+      continue;
+    }
+    if (target >= start && target < end) {
+      const uintptr_t page_start = target & ~(GetPageSize() - 1);
+      return MappedRegion{reinterpret_cast<const uint8_t*>(page_start),
+                          end - page_start};
+    }
+  }
+#endif  // OS_LINUX || OS_ANDROID
+  return std::nullopt;
+}
+
+std::vector<SnapshotPagePrefetcher::PageRange>
+SnapshotPagePrefetcher::GetTouchedPages(const MappedRegion& region) {
+  std::vector<PageRange> ranges;
+#if OS_LINUX || OS_ANDROID
+  // mincore would report the pages that are in the page cache, which after a
+  // few runs is all of them. The page map instead tells which pages are
+  // mapped into this process, i.e. which ones it has touched.
+  fml::UniqueFD page_map{
+      FML_HANDLE_EINTR(::open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC))};
+  if (!page_map.is_valid()) {
+    return ranges;
+  }
+  const size_t page_size = GetPageSize();
+  const size_t page_count = (region.size + page_size - 1) / page_size;
+  const off_t first_entry =
+      reinterpret_cast<uintptr_t>(region.start) / page_size * sizeof(uint64_t);
+  std::vector<uint64_t> entries(page_count);
+  const ssize_t size = entries.size() * sizeof(uint64_t);
+  if (FML_HANDLE_EINTR(::pread(page_map.get(), entries.data(), size,
+                               first_entry)) != size) {
+    return ranges;
+  }
+  constexpr uint64_t kPagePresent = 1ull << 63;
+  for (size_t page = 0; page < page_count; page++) {
+    if ((entries[page] & kPagePresent) == 0) {
+      continue;
+    }
+    if (!ranges.empty() &&
+        ranges.back().first_page + ranges.back().page_count == page) {
+      ranges.back().page_count++;
+    } else {
+      ranges.push_back({page, 1});
+    }
+  }
+#endif  // OS_LINUX || OS_ANDROID
+  return ranges;
+}
+
+std::string SnapshotPagePrefetcher::SerializeProfile(
+    const PageProfile& profile) {
+  // One line per range: "<mapping name> <first page> <page count>".
+  std::stringstream stream;
+  for (const auto& [name, ranges] : profile) {
+    for (const auto& range : ranges) {
+      stream << name << " " << range.first_page << " " << range.page_count
+             << "\n";
+    }
+  }
+  return stream.str();
+}
+
+SnapshotPagePrefetcher::PageProfile SnapshotPagePrefetcher::ParseProfile(
+    const std::string& profile) {
+  PageProfile result;
+  std::stringstream stream(profile);
+  std::string line;
+  while (std::getline(stream, line)) {
+    std::stringstream line_stream(line);
+    std::string name;
+    PageRange range;
+    if (line_stream >> name >> range.first_page >> range.page_count &&
+        range.page_count > 0) {
+      result[name].push_back(range);
+    }
+  }
+  return result;
+}
+
+}  // namespace flutter
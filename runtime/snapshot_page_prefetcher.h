@@ -0,0 +1,137 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_RUNTIME_SNAPSHOT_PAGE_PREFETCHER_H_
+#define FLUTTER_RUNTIME_SNAPSHOT_PAGE_PREFETCHER_H_
+
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/memory/ref_ptr.h"
+#include "flutter/runtime/dart_snapshot.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Reads the pages of the Dart snapshots into memory ahead of
+///             time, so that the first frames do not stall on page faults.
+///
+///             AOT snapshots are memory mapped and their pages are only read
+///             from storage when they are first touched. Without a profile,
+///             the prefetcher asks the kernel to read every page of the
+///             mappings that contain the snapshots. With a profile recorded
+///             by an earlier run (see |RecordProfile|), only the pages that
+///             run used are requested. The mappings that contain instructions
+///             are also marked as candidates for transparent huge pages.
+///
+///             Only supported on Linux and Android. On other platforms the
+///             snapshots' mappings cannot be found and all calls are no-ops.
+///
+class SnapshotPagePrefetcher {
+ public:
+  /// A run of consecutive pages within a mapping.
+  struct PageRange {
+    size_t first_page = 0;
+    size_t page_count = 0;
+
+    bool operator==(const PageRange& other) const {
+      return first_page == other.first_page && page_count == other.page_count;
+    }
+  };
+
+  /// The pages that were touched in each mapping, by mapping name.
+  using PageProfile = std::map<std::string, std::vector<PageRange>>;
+
+  /// The extent of the memory mapping that contains an address.
+  struct MappedRegion {
+    const uint8_t* start = nullptr;
+    size_t size = 0;
+  };
+
+  //----------------------------------------------------------------------------
+  /// @param[in]  vm_snapshot       The core snapshot. May be null.
+  /// @param[in]  isolate_snapshot  The isolate snapshot. May be null.
+  /// @param[in]  profile_path      The file the page profile is read from and
+  ///                               written to. May be empty, in which case
+  ///                               all pages are prefetched.
+  ///
+  SnapshotPagePrefetcher(fml::RefPtr<const DartSnapshot> vm_snapshot,
+                         fml::RefPtr<const DartSnapshot> isolate_snapshot,
+                         std::string profile_path);
+
+  ~SnapshotPagePrefetcher();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Asks the kernel to start reading the pages of the snapshots.
+  ///             Does not wait for the reads to finish, but may block while
+  ///             they are being queued, so this should be called off the
+  ///             threads that are busy during startup.
+  ///
+  /// @return     The number of bytes requested.
+  ///
+  size_t Prefetch() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether a profile was recorded by an earlier run.
+  ///
+  bool HasProfile() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Writes the pages of the snapshots that this process has
+  ///             touched so far to the profile, for |Prefetch| to use in later
+  ///             runs. Should be called once the application has shown its
+  ///             first frame.
+  ///
+  /// @return     Whether the profile was written.
+  ///
+  bool RecordProfile() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Finds the memory mapping of this process that contains
+  ///             |address|. The returned region starts at the beginning of
+  ///             the page that contains |address| and ends at the end of the
+  ///             mapping.
+  ///
+  static std::optional<MappedRegion> FindMappedRegion(const void* address);
+
+  //----------------------------------------------------------------------------
+  /// @brief      The pages of |region| that are mapped into this process,
+  ///             which are the ones it has touched (and, with fault-around,
+  ///             some of their neighbors). Prefetching does not map pages, it
+  ///             only reads them into the page cache.
+  ///
+  static std::vector<PageRange> GetTouchedPages(const MappedRegion& region);
+
+  static std::string SerializeProfile(const PageProfile& profile);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Parses a profile written by |SerializeProfile|. Malformed
+  ///             lines are skipped.
+  ///
+  static PageProfile ParseProfile(const std::string& profile);
+
+ private:
+  struct Region {
+    std::string name;
+    MappedRegion mapping;
+    bool executable = false;
+  };
+
+  // The snapshots are kept alive so that their mappings are.
+  const fml::RefPtr<const DartSnapshot> vm_snapshot_;
+  const fml::RefPtr<const DartSnapshot> isolate_snapshot_;
+  const std::string profile_path_;
+  std::vector<Region> regions_;
+
+  void AddRegion(std::string name, const uint8_t* address, bool executable);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(SnapshotPagePrefetcher);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_RUNTIME_SNAPSHOT_PAGE_PREFETCHER_H_
@@ -0,0 +1,135 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/runtime/snapshot_page_prefetcher.h"
+
+#include <string>
+#include <vector>
+
+#include "flutter/fml/build_config.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/paths.h"
+#include "gtest/gtest.h"
+
+#if OS_LINUX || OS_ANDROID
+#include <unistd.h>
+#endif  // OS_LINUX || OS_ANDROID
+
+namespace flutter {
+namespace testing {
+
+using PageRange = SnapshotPagePrefetcher::PageRange;
+
+TEST(SnapshotPagePrefetcherTest, ProfileRoundTrips) {
+  SnapshotPagePrefetcher::PageProfile profile;
+  profile["IsolateData"] = {{0, 3}, {10, 1}};
+  profile["IsolateInstructions"] = {{4, 12}};
+
+  auto parsed = SnapshotPagePrefetcher::ParseProfile(
+      SnapshotPagePrefetcher::SerializeProfile(profile));
+  EXPECT_EQ(parsed, profile);
+}
+
+TEST(SnapshotPagePrefetcherTest, ParseSkipsMalformedLines) {
+  auto profile = SnapshotPagePrefetcher::ParseProfile(
+      "IsolateData 0 2\n"
+      "garbage\n"
+      "IsolateData 5\n"
+      "IsolateData 7 0\n"
+      "VMData 1 1\n");
+  ASSERT_EQ(profile.size(), 2u);
+  EXPECT_EQ(profile["IsolateData"], std::vector<PageRange>({{0, 2}}));
+  EXPECT_EQ(profile["VMData"], std::vector<PageRange>({{1, 1}}));
+}
+
+#if OS_LINUX || OS_ANDROID
+
+namespace {
+
+constexpr size_t kPageCount = 4;
+
+// Maps a file of |kPageCount| pages that was just written, and whose pages
+// are therefore all in the page cache.
+std::unique_ptr<fml::FileMapping> MapTestFile(const fml::UniqueFD& directory,
+                                              size_t page_size) {
+  const std::vector<uint8_t> contents(kPageCount * page_size, 0xAB);
+  if (!fml::WriteAtomically(directory, "snapshot",
+                            fml::DataMapping(contents))) {
+    return nullptr;
+  }
+  return fml::FileMapping::CreateReadOnly(directory, "snapshot");
+}
+
+}  // namespace
+
+TEST(SnapshotPagePrefetcherTest, FindsMappingContainingAddress) {
+  fml::ScopedTemporaryDirectory temp_dir;
+  const size_t page_size = ::sysconf(_SC_PAGESIZE);
+  auto mapping = MapTestFile(temp_dir.fd(), page_size);
+  ASSERT_TRUE(mapping);
+
+  auto region = SnapshotPagePrefetcher::FindMappedRegion(
+      mapping->GetMapping() + page_size + 10);
+  ASSERT_TRUE(region.has_value());
+  EXPECT_EQ(region->start, mapping->GetMapping() + page_size);
+  EXPECT_EQ(region->size, (kPageCount - 1) * page_size);
+}
+
+TEST(SnapshotPagePrefetcherTest, ReportsTouchedPages) {
+  fml::ScopedTemporaryDirectory temp_dir;
+  const size_t page_size = ::sysconf(_SC_PAGESIZE);
+  auto mapping = MapTestFile(temp_dir.fd(), page_size);
+  ASSERT_TRUE(mapping);
+  const SnapshotPagePrefetcher::MappedRegion region = {mapping->GetMapping(),
+                                                       mapping->GetSize()};
+  EXPECT_TRUE(SnapshotPagePrefetcher::GetTouchedPages(region).empty());
+
+  volatile uint8_t value = mapping->GetMapping()[2 * page_size];
+  (void)value;
+  auto pages = SnapshotPagePrefetcher::GetTouchedPages(region);
+  // Fault-around may have mapped the neighboring pages as well.
+  ASSERT_FALSE(pages.empty());
+  bool found = false;
+  for (const auto& range : pages) {
+    found |= range.first_page <= 2 && range.first_page + range.page_count > 2;
+  }
+  EXPECT_TRUE(found);
+}
+
+TEST(SnapshotPagePrefetcherTest, PrefetchesProfiledPagesOnly) {
+  fml::ScopedTemporaryDirectory temp_dir;
+  const size_t page_size = ::sysconf(_SC_PAGESIZE);
+  std::shared_ptr<const fml::Mapping> mapping =
+      MapTestFile(temp_dir.fd(), page_size);
+  ASSERT_TRUE(mapping);
+  auto snapshot = DartSnapshot::IsolateSnapshotFromMappings(mapping, nullptr);
+  ASSERT_TRUE(snapshot);
+  SnapshotPagePrefetcher prefetcher(
+      nullptr, snapshot, fml::paths::JoinPaths({temp_dir.path(), "profile"}));
+
+  // Without a profile, the whole mapping is requested.
+  EXPECT_FALSE(prefetcher.HasProfile());
+  EXPECT_EQ(prefetcher.Prefetch(), kPageCount * page_size);
+
+  volatile uint8_t value = mapping->GetMapping()[0];
+  (void)value;
+  ASSERT_TRUE(prefetcher.RecordProfile());
+  EXPECT_TRUE(prefetcher.HasProfile());
+  const size_t requested = prefetcher.Prefetch();
+  EXPECT_GE(requested, page_size);
+  EXPECT_LE(requested, kPageCount * page_size);
+
+  SnapshotPagePrefetcher::PageProfile profile;
+  profile["IsolateData"] = {{1, 2}, {kPageCount - 1, 5}};
+  ASSERT_TRUE(fml::WriteAtomically(
+      temp_dir.fd(), "profile",
+      fml::DataMapping(SnapshotPagePrefetcher::SerializeProfile(profile))));
+  EXPECT_EQ(prefetcher.Prefetch(), 3 * page_size);
+}
+
+#endif  // OS_LINUX || OS_ANDROID
+
+}  // namespace testing
+}  // namespace flutter
@@ -9,7 +9,10 @@
 #include <functional>
 #include <future>
 #include <memory>
+#include <vector>
 
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/shell/common/pointer_data_dispatcher.h"
 #include "flutter/shell/common/shell_test.h"
 #include "flutter/shell/common/shell_test_platform_view.h"
 #include "flutter/testing/testing.h"
@@ -37,6 +40,147 @@ class FakeAnimatorDelegate : public Animator::Delegate {
   bool notify_idle_called_ = false;
 };
 
+class BeginFrameAnimatorDelegate : public FakeAnimatorDelegate {
+ public:
+  explicit BeginFrameAnimatorDelegate(std::function<void()> on_begin_frame)
+      : on_begin_frame_(std::move(on_begin_frame)) {}
+
+  void OnAnimatorBeginFrame(fml::TimePoint frame_target_time,
+                            uint64_t frame_number) override {
+    on_begin_frame_();
+  }
+
+ private:
+  std::function<void()> on_begin_frame_;
+};
+
+// Fires vsync when the test asks for it, once it has been requested.
+class ManualVsyncWaiter : public VsyncWaiter {
+ public:
+  ManualVsyncWaiter(TaskRunners task_runners, fml::TimeDelta frame_interval)
+      : VsyncWaiter(std::move(task_runners)), frame_interval_(frame_interval) {}
+
+  // Waits for vsync to be requested, fires it, and returns its time.
+  fml::TimePoint FireWhenRequested() {
+    requested_.Wait();
+    const fml::TimePoint vsync_time = fml::TimePoint::Now();
+    task_runners_.GetPlatformTaskRunner()->PostTask([this, vsync_time]() {
+      FireCallback(vsync_time, vsync_time + frame_interval_);
+    });
+    return vsync_time;
+  }
+
+ protected:
+  void AwaitVSync() override { requested_.Signal(); }
+
+ private:
+  const fml::TimeDelta frame_interval_;
+  fml::AutoResetWaitableEvent requested_;
+};
+
+// Schedules the secondary vsync callbacks of a pointer data dispatcher with
+// an animator, as the engine does, and records the frame that consumes each
+// dispatched packet, which is the first frame to begin after it.
+class PointerDataFrameRecorder : public PointerDataDispatcher::Delegate {
+ public:
+  explicit PointerDataFrameRecorder(std::function<void()> on_dispatch)
+      : on_dispatch_(std::move(on_dispatch)) {}
+
+  void DoDispatchPacket(std::unique_ptr<PointerDataPacket> packet,
+                        uint64_t trace_flow_id) override {
+    consuming_frames_.push_back(begun_frame_count_ + 1);
+    on_dispatch_();
+  }
+
+  void ScheduleSecondaryVsyncCallback(uintptr_t id,
+                                      const fml::closure& callback) override {
+    animator_->ScheduleSecondaryVsyncCallback(id, callback);
+  }
+
+  void OnBeginFrame() { begun_frame_count_++; }
+
+  void set_animator(Animator* animator) { animator_ = animator; }
+
+  uint64_t begun_frame_count() const { return begun_frame_count_; }
+
+  const std::vector<uint64_t>& consuming_frames() const {
+    return consuming_frames_;
+  }
+
+ private:
+  std::function<void()> on_dispatch_;
+  Animator* animator_ = nullptr;
+  uint64_t begun_frame_count_ = 0;
+  std::vector<uint64_t> consuming_frames_;
+};
+
+// Dispatches a pointer data packet during the first frame, and another one
+// |input_delay| after the vsync of the second frame, through a
+// |SmoothPointerDataDispatcher|. The second packet arrives while the first
+// one is still in progress, so the dispatcher holds it back until its
+// secondary vsync callback runs. Returns the frames that consume the packets.
+static std::vector<uint64_t> GetFramesConsumingPointerData(
+    const TaskRunners& task_runners,
+    fml::TimeDelta frame_interval,
+    fml::TimeDelta input_delay,
+    std::shared_ptr<FrameTimePredictor> predictor) {
+  fml::AutoResetWaitableEvent latch;
+  fml::CountDownLatch dispatch_latch(2);
+  std::unique_ptr<Animator> animator;
+  std::unique_ptr<SmoothPointerDataDispatcher> dispatcher;
+  ManualVsyncWaiter* vsync_waiter = nullptr;
+
+  PointerDataFrameRecorder recorder([&]() { dispatch_latch.CountDown(); });
+  BeginFrameAnimatorDelegate delegate([&]() {
+    recorder.OnBeginFrame();
+    if (recorder.begun_frame_count() == 1) {
+      dispatcher->DispatchPacket(std::make_unique<PointerDataPacket>(1), 0);
+      animator->RequestFrame();
+      latch.Signal();
+    }
+  });
+
+  task_runners.GetUITaskRunner()->PostTask([&] {
+    auto waiter =
+        std::make_unique<ManualVsyncWaiter>(task_runners, frame_interval);
+    vsync_waiter = waiter.get();
+    if (predictor) {
+      waiter->SetFrameTimePredictor(predictor);
+    }
+    animator = std::make_unique<Animator>(delegate, task_runners,
+                                          std::move(waiter));
+    recorder.set_animator(animator.get());
+    dispatcher = std::make_unique<SmoothPointerDataDispatcher>(recorder);
+    animator->Start();
+    latch.Signal();
+  });
+  latch.Wait();
+
+  // The first frame requests the second one.
+  vsync_waiter->FireWhenRequested();
+  latch.Wait();
+  // Let the animator wait for the vsync of the second frame.
+  task_runners.GetUITaskRunner()->PostTask([&] { latch.Signal(); });
+  latch.Wait();
+
+  const fml::TimePoint vsync_time = vsync_waiter->FireWhenRequested();
+  task_runners.GetUITaskRunner()->PostTaskForTime(
+      [&] {
+        dispatcher->DispatchPacket(std::make_unique<PointerDataPacket>(1), 0);
+      },
+      vsync_time + input_delay);
+  dispatch_latch.Wait();
+
+  task_runners.GetUITaskRunner()->PostTask([&] {
+    dispatcher.reset();
+    animator.reset();
+    latch.Signal();
+  });
+  latch.Wait();
+
+  return recorder.consuming_frames();
+}
+
 TEST_F(ShellTest, VSyncTargetTime) {
   // Add native callbacks to listen for window.onBeginFrame
   int64_t target_time;
@@ -223,5 +367,42 @@ TEST_F(ShellTest, AnimatorDoesNotNotifyIdleBeforeRender) {
   latch.Wait();
 }
 
+TEST_F(ShellTest, PredictiveFrameSchedulingLatchesPointerDataIntoFrame) {
+  TaskRunners task_runners = {
+      "test",
+      CreateNewThread(),  // platform
+      CreateNewThread(),  // raster
+      CreateNewThread(),  // ui
+      CreateNewThread()   // io
+  };
+  const fml::TimeDelta frame_interval = fml::TimeDelta::FromMilliseconds(32);
+  const fml::TimeDelta input_delay = fml::TimeDelta::FromMilliseconds(4);
+
+  // Frames start at vsync, and the secondary vsync callback runs right after
+  // the second frame has begun, so the pointer data that arrives after vsync
+  // is consumed by the third frame.
+  EXPECT_EQ(GetFramesConsumingPointerData(task_runners, frame_interval,
+                                          input_delay, nullptr),
+            std::vector<uint64_t>({2, 3}));
+
+  // Recent frames took 4ms, so the second frame and its secondary vsync
+  // callback start about 26ms after vsync, and the frame consumes the
+  // pointer data.
+  auto predictor = std::make_shared<FrameTimePredictor>();
+  for (size_t i = 0; i < FrameTimePredictor::kMinSampleCount; i++) {
+    FrameTiming timing;
+    const fml::TimePoint vsync_start =
+        fml::TimePoint::FromEpochDelta(frame_interval * i);
+    timing.Set(FrameTiming::kVsyncStart, vsync_start);
+    timing.Set(FrameTiming::kBuildStart, vsync_start);
+    timing.Set(FrameTiming::kRasterFinish,
+               vsync_start + fml::TimeDelta::FromMilliseconds(4));
+    predictor->AddFrameTiming(timing);
+  }
+  EXPECT_EQ(GetFramesConsumingPointerData(task_runners, frame_interval,
+                                          input_delay, predictor),
+            std::vector<uint64_t>({2, 2}));
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -32,6 +32,7 @@
 #include "flutter/shell/common/rasterizer.h"
 #include "flutter/shell/common/run_configuration.h"
 #include "flutter/shell/common/shell_io_manager.h"
+#include "third_party/skia/include/core/SkFontMgr.h"
 #include "third_party/skia/include/core/SkPicture.h"
 
 namespace flutter {
@@ -438,6 +439,15 @@ class Engine final : public RuntimeDelegate, PointerDataDispatcher::Delegate {
   ///
   void SetupDefaultFontManager();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Uses a default font manager that was created ahead of time,
+  ///             instead of creating one as |SetupDefaultFontManager| does.
+  ///
+  /// @param[in]  font_manager  The result of `txt::GetDefaultFontManager` for
+  ///                           the font initialization data in the settings.
+  ///
+  void SetDefaultFontManager(sk_sp<SkFontMgr> font_manager);
+
   //----------------------------------------------------------------------------
   /// @brief      Updates the asset manager referenced by the root isolate of a
   ///             Flutter application. This happens implicitly in the call to
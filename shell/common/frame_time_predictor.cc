@@ -0,0 +1,84 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_time_predictor.h"
+
+#include <algorithm>
+
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+FrameTimePredictor::FrameTimePredictor() = default;
+
+FrameTimePredictor::~FrameTimePredictor() = default;
+
+void FrameTimePredictor::AddFrameTiming(const FrameTiming& timing) {
+  const fml::TimePoint vsync_start = timing.Get(FrameTiming::kVsyncStart);
+  const fml::TimePoint build_start = timing.Get(FrameTiming::kBuildStart);
+  const fml::TimePoint raster_finish = timing.Get(FrameTiming::kRasterFinish);
+
+  std::scoped_lock lock(mutex_);
+  frame_durations_.push_back(raster_finish - build_start);
+  if (frame_durations_.size() > kSampleCount) {
+    frame_durations_.pop_front();
+  }
+
+  // Frames are rasterized in order, so delayed frames that are older than
+  // this one were dropped and will never report a timing.
+  while (!delayed_frames_.empty() &&
+         delayed_frames_.front().vsync_start < vsync_start) {
+    delayed_frames_.pop_front();
+  }
+  if (!delayed_frames_.empty() &&
+      delayed_frames_.front().vsync_start == vsync_start) {
+    if (raster_finish > delayed_frames_.front().vsync_target) {
+      TRACE_EVENT_INSTANT0("flutter", "MissedPredictedFrameDeadline");
+      fallback_frames_ = kFallbackFrameCount;
+      delayed_frames_.clear();
+    } else {
+      delayed_frames_.pop_front();
+    }
+  }
+}
+
+fml::TimeDelta FrameTimePredictor::GetFrameStartDelay(
+    fml::TimePoint frame_start_time,
+    fml::TimePoint frame_target_time) {
+  std::scoped_lock lock(mutex_);
+  if (fallback_frames_ > 0) {
+    fallback_frames_--;
+    return fml::TimeDelta::Zero();
+  }
+  const fml::TimeDelta predicted = PredictFrameDurationLocked();
+  if (predicted == fml::TimeDelta::Zero()) {
+    return fml::TimeDelta::Zero();
+  }
+  const fml::TimeDelta delay =
+      (frame_target_time - frame_start_time) - predicted - kSafetyMargin;
+  if (delay <= fml::TimeDelta::Zero()) {
+    return fml::TimeDelta::Zero();
+  }
+  delayed_frames_.push_back({frame_start_time, frame_target_time});
+  if (delayed_frames_.size() > kSampleCount) {
+    delayed_frames_.pop_front();
+  }
+  return delay;
+}
+
+fml::TimeDelta FrameTimePredictor::GetPredictedFrameDuration() const {
+  std::scoped_lock lock(mutex_);
+  return PredictFrameDurationLocked();
+}
+
+fml::TimeDelta FrameTimePredictor::PredictFrameDurationLocked() const {
+  if (frame_durations_.size() < kMinSampleCount) {
+    return fml::TimeDelta::Zero();
+  }
+  // The slowest recent frame. Overestimating costs a little latency, while
+  // underestimating costs a dropped frame.
+  return *std::max_element(frame_durations_.begin(), frame_durations_.end());
+}
+
+}  // namespace flutter
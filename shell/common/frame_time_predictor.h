@@ -0,0 +1,91 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_FRAME_TIME_PREDICTOR_H_
+#define FLUTTER_SHELL_COMMON_FRAME_TIME_PREDICTOR_H_
+
+#include <deque>
+#include <mutex>
+
+#include "flutter/common/settings.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// Predicts how long it takes to build and rasterize a frame from the timings
+/// of recent frames, so that the |VsyncWaiter| can start a frame as late as
+/// possible while still meeting its deadline. Starting late lets the frame
+/// pick up input that arrived after vsync, which would otherwise only be
+/// presented one frame later.
+///
+/// A frame that was started late and still missed its deadline disables the
+/// prediction for |kFallbackFrameCount| frames, during which frames start at
+/// vsync as usual.
+///
+/// This class is thread safe. Timings are added on the raster thread and
+/// predictions are made on whichever thread fires vsync callbacks.
+///
+class FrameTimePredictor {
+ public:
+  /// The number of recent frames the prediction is based on.
+  static constexpr size_t kSampleCount = 30;
+
+  /// The number of frames that must be timed before any prediction is made.
+  static constexpr size_t kMinSampleCount = 5;
+
+  /// Slack added to the predicted duration to absorb scheduling jitter.
+  static constexpr fml::TimeDelta kSafetyMargin =
+      fml::TimeDelta::FromMilliseconds(2);
+
+  /// The number of frames that start at vsync after a missed prediction.
+  static constexpr int kFallbackFrameCount = 60;
+
+  FrameTimePredictor();
+
+  ~FrameTimePredictor();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Records the timing of a rasterized frame.
+  ///
+  void AddFrameTiming(const FrameTiming& timing);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns how long after |frame_start_time| the frame should
+  ///             start building so that it is rasterized by
+  ///             |frame_target_time|. A zero delay means the frame starts at
+  ///             vsync.
+  ///
+  fml::TimeDelta GetFrameStartDelay(fml::TimePoint frame_start_time,
+                                    fml::TimePoint frame_target_time);
+
+  //----------------------------------------------------------------------------
+  /// @brief      The predicted time from the start of a frame build to the end
+  ///             of its rasterization, or zero if too few frames were timed.
+  ///
+  fml::TimeDelta GetPredictedFrameDuration() const;
+
+ private:
+  // A frame that was started later than vsync. Kept until its timing arrives
+  // so that a missed deadline can be detected.
+  struct DelayedFrame {
+    fml::TimePoint vsync_start;
+    fml::TimePoint vsync_target;
+  };
+
+  mutable std::mutex mutex_;
+  std::deque<fml::TimeDelta> frame_durations_;
+  std::deque<DelayedFrame> delayed_frames_;
+  int fallback_frames_ = 0;
+
+  fml::TimeDelta PredictFrameDurationLocked() const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(FrameTimePredictor);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_FRAME_TIME_PREDICTOR_H_
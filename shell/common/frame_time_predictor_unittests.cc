@@ -0,0 +1,112 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_time_predictor.h"
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+constexpr fml::TimeDelta kFrameInterval = fml::TimeDelta::FromMilliseconds(16);
+
+FrameTiming MakeFrameTiming(fml::TimePoint vsync_start,
+                            fml::TimeDelta start_delay,
+                            fml::TimeDelta duration) {
+  FrameTiming timing;
+  timing.Set(FrameTiming::kVsyncStart, vsync_start);
+  timing.Set(FrameTiming::kBuildStart, vsync_start + start_delay);
+  timing.Set(FrameTiming::kRasterFinish, vsync_start + start_delay + duration);
+  return timing;
+}
+
+fml::TimePoint VsyncTime(int frame) {
+  return fml::TimePoint::FromEpochDelta(kFrameInterval * frame);
+}
+
+}  // namespace
+
+TEST(FrameTimePredictorTest, NoDelayWithoutEnoughFrames) {
+  FrameTimePredictor predictor;
+  const fml::TimeDelta duration = fml::TimeDelta::FromMilliseconds(4);
+  for (size_t i = 0; i < FrameTimePredictor::kMinSampleCount - 1; i++) {
+    predictor.AddFrameTiming(
+        MakeFrameTiming(VsyncTime(i), fml::TimeDelta::Zero(), duration));
+  }
+  EXPECT_EQ(predictor.GetPredictedFrameDuration(), fml::TimeDelta::Zero());
+  EXPECT_EQ(predictor.GetFrameStartDelay(VsyncTime(10), VsyncTime(11)),
+            fml::TimeDelta::Zero());
+}
+
+TEST(FrameTimePredictorTest, DelaysFrameByPredictedDuration) {
+  FrameTimePredictor predictor;
+  for (size_t i = 0; i < FrameTimePredictor::kMinSampleCount; i++) {
+    predictor.AddFrameTiming(MakeFrameTiming(
+        VsyncTime(i), fml::TimeDelta::Zero(),
+        fml::TimeDelta::FromMilliseconds(i == 2 ? 5 : 3)));
+  }
+  // The slowest recent frame is used.
+  EXPECT_EQ(predictor.GetPredictedFrameDuration(),
+            fml::TimeDelta::FromMilliseconds(5));
+  EXPECT_EQ(predictor.GetFrameStartDelay(VsyncTime(10), VsyncTime(11)),
+            kFrameInterval - fml::TimeDelta::FromMilliseconds(5) -
+                FrameTimePredictor::kSafetyMargin);
+}
+
+TEST(FrameTimePredictorTest, NoDelayForSlowFrames) {
+  FrameTimePredictor predictor;
+  for (size_t i = 0; i < FrameTimePredictor::kMinSampleCount; i++) {
+    predictor.AddFrameTiming(MakeFrameTiming(
+        VsyncTime(i), fml::TimeDelta::Zero(),
+        fml::TimeDelta::FromMilliseconds(15)));
+  }
+  EXPECT_EQ(predictor.GetFrameStartDelay(VsyncTime(10), VsyncTime(11)),
+            fml::TimeDelta::Zero());
+}
+
+TEST(FrameTimePredictorTest, FallsBackToVsyncAfterMissedDeadline) {
+  FrameTimePredictor predictor;
+  const fml::TimeDelta duration = fml::TimeDelta::FromMilliseconds(4);
+  for (size_t i = 0; i < FrameTimePredictor::kMinSampleCount; i++) {
+    predictor.AddFrameTiming(
+        MakeFrameTiming(VsyncTime(i), fml::TimeDelta::Zero(), duration));
+  }
+
+  // A delayed frame that meets its deadline keeps the prediction enabled.
+  fml::TimeDelta delay =
+      predictor.GetFrameStartDelay(VsyncTime(10), VsyncTime(11));
+  ASSERT_GT(delay, fml::TimeDelta::Zero());
+  predictor.AddFrameTiming(MakeFrameTiming(VsyncTime(10), delay, duration));
+  delay = predictor.GetFrameStartDelay(VsyncTime(11), VsyncTime(12));
+  ASSERT_GT(delay, fml::TimeDelta::Zero());
+
+  // This one takes longer than predicted and misses its deadline.
+  predictor.AddFrameTiming(MakeFrameTiming(
+      VsyncTime(11), delay, duration + FrameTimePredictor::kSafetyMargin * 2));
+  for (int i = 0; i < FrameTimePredictor::kFallbackFrameCount; i++) {
+    EXPECT_EQ(
+        predictor.GetFrameStartDelay(VsyncTime(12 + i), VsyncTime(13 + i)),
+        fml::TimeDelta::Zero());
+  }
+  EXPECT_GT(predictor.GetFrameStartDelay(VsyncTime(100), VsyncTime(101)),
+            fml::TimeDelta::Zero());
+}
+
+TEST(FrameTimePredictorTest, OnlyRecentFramesArePredicted) {
+  FrameTimePredictor predictor;
+  const fml::TimeDelta slow_duration = fml::TimeDelta::FromMilliseconds(12);
+  const fml::TimeDelta duration = fml::TimeDelta::FromMilliseconds(3);
+  predictor.AddFrameTiming(
+      MakeFrameTiming(VsyncTime(0), fml::TimeDelta::Zero(), slow_duration));
+  for (size_t i = 1; i <= FrameTimePredictor::kSampleCount; i++) {
+    predictor.AddFrameTiming(
+        MakeFrameTiming(VsyncTime(i), fml::TimeDelta::Zero(), duration));
+  }
+  EXPECT_EQ(predictor.GetPredictedFrameDuration(), duration);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -0,0 +1,128 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/idle_task_scheduler.h"
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+IdleTaskScheduler::IdleTaskScheduler(
+    fml::RefPtr<fml::TaskRunner> ui_task_runner)
+    : ui_task_runner_(std::move(ui_task_runner)) {}
+
+IdleTaskScheduler::~IdleTaskScheduler() = default;
+
+void IdleTaskScheduler::PostIdleTask(Priority priority,
+                                     fml::RefPtr<fml::TaskRunner> task_runner,
+                                     IdleTask task) {
+  FML_DCHECK(task_runner);
+  if (!task) {
+    return;
+  }
+  Enqueue({priority, std::move(task_runner), std::move(task)}, false);
+}
+
+void IdleTaskScheduler::RunIdleTasks(fml::TimePoint deadline) {
+  FML_DCHECK(ui_task_runner_->RunsTasksOnCurrentThread());
+  const fml::TimePoint start = fml::TimePoint::Now();
+  if (start + kMinimumIdleTime > deadline) {
+    return;
+  }
+
+  std::deque<PendingTask> tasks;
+  {
+    std::scoped_lock lock(mutex_);
+    for (auto& queue : tasks_) {
+      for (auto& task : queue) {
+        tasks.push_back(std::move(task));
+      }
+      queue.clear();
+    }
+  }
+  if (tasks.empty()) {
+    return;
+  }
+
+  TRACE_EVENT0("flutter", "IdleTaskScheduler::RunIdleTasks");
+  fml::TimeDelta used_time;
+  while (!tasks.empty() &&
+         fml::TimePoint::Now() + kMinimumIdleTime <= deadline) {
+    PendingTask task = std::move(tasks.front());
+    tasks.pop_front();
+
+    if (!task.task_runner->RunsTasksOnCurrentThread()) {
+      auto task_runner = task.task_runner;
+      task_runner->PostTask(
+          [weak_self = weak_from_this(), task = std::move(task),
+           deadline]() mutable {
+            if (auto self = weak_self.lock()) {
+              self->RunForwardedTask(std::move(task), deadline);
+            }
+          });
+      continue;
+    }
+
+    const fml::TimePoint task_start = fml::TimePoint::Now();
+    const bool has_more_work = task.task(deadline);
+    const fml::TimePoint task_end = fml::TimePoint::Now();
+    used_time = used_time + (task_end - task_start);
+    if (task_end > deadline) {
+      TRACE_EVENT_INSTANT0("flutter", "IdleTaskOverranDeadline");
+    }
+    if (has_more_work) {
+      Enqueue(std::move(task), false);
+    }
+  }
+
+  // Tasks that there was no time for go ahead of those that already ran.
+  for (auto it = tasks.rbegin(); it != tasks.rend(); ++it) {
+    Enqueue(std::move(*it), true);
+  }
+
+#if !FLUTTER_RELEASE
+  FML_TRACE_COUNTER("flutter", "IdleTaskScheduler",
+                    reinterpret_cast<int64_t>(this),                    //
+                    "IdleMicros", (deadline - start).ToMicroseconds(),  //
+                    "UsedMicros", used_time.ToMicroseconds());
+#endif  // !FLUTTER_RELEASE
+}
+
+size_t IdleTaskScheduler::GetPendingTaskCount() const {
+  std::scoped_lock lock(mutex_);
+  size_t count = 0;
+  for (const auto& queue : tasks_) {
+    count += queue.size();
+  }
+  return count;
+}
+
+void IdleTaskScheduler::Enqueue(PendingTask task, bool first) {
+  std::scoped_lock lock(mutex_);
+  auto& queue = tasks_[static_cast<size_t>(task.priority)];
+  if (first) {
+    queue.push_front(std::move(task));
+  } else {
+    queue.push_back(std::move(task));
+  }
+}
+
+void IdleTaskScheduler::RunForwardedTask(PendingTask task,
+                                         fml::TimePoint deadline) {
+  // The task runner may have been busy until after the deadline.
+  if (fml::TimePoint::Now() + kMinimumIdleTime > deadline) {
+    Enqueue(std::move(task), true);
+    return;
+  }
+  TRACE_EVENT0("flutter", "IdleTaskScheduler::RunForwardedTask");
+  if (task.task(deadline)) {
+    Enqueue(std::move(task), false);
+  }
+  if (fml::TimePoint::Now() > deadline) {
+    TRACE_EVENT_INSTANT0("flutter", "IdleTaskOverranDeadline");
+  }
+}
+
+}  // namespace flutter
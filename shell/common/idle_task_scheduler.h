@@ -0,0 +1,105 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_IDLE_TASK_SCHEDULER_H_
+#define FLUTTER_SHELL_COMMON_IDLE_TASK_SCHEDULER_H_
+
+#include <array>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/memory/ref_ptr.h"
+#include "flutter/fml/task_runner.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// Runs deferrable engine work while the engine is idle, so that it does not
+/// compete with frames.
+///
+/// The animator reports idle periods through |Shell::OnAnimatorNotifyIdle|.
+/// After the Dart VM has had its share, the remaining time up to the idle
+/// deadline is handed to the tasks posted here, highest priority first. Tasks
+/// receive the deadline and are expected to return before it, splitting their
+/// work across several idle periods if necessary. A task is never started
+/// with less than |kMinimumIdleTime| left.
+///
+/// Tasks may be posted from any thread. Each task runs on the task runner it
+/// was posted with; tasks for other task runners than the UI task runner are
+/// forwarded to them along with the deadline.
+///
+class IdleTaskScheduler
+    : public std::enable_shared_from_this<IdleTaskScheduler> {
+ public:
+  enum class Priority {
+    kHigh,
+    kNormal,
+    kLow,
+  };
+
+  /// Does some work that must be done by |deadline|. Returns true if there is
+  /// more work left, in which case the task is run again in a later idle
+  /// period.
+  using IdleTask = std::function<bool(fml::TimePoint deadline)>;
+
+  /// Tasks are not started when less than this is left until the deadline.
+  static constexpr fml::TimeDelta kMinimumIdleTime =
+      fml::TimeDelta::FromMilliseconds(1);
+
+  explicit IdleTaskScheduler(fml::RefPtr<fml::TaskRunner> ui_task_runner);
+
+  ~IdleTaskScheduler();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Schedules |task| to run on |task_runner| in the next idle
+  ///             period.
+  ///
+  void PostIdleTask(Priority priority,
+                    fml::RefPtr<fml::TaskRunner> task_runner,
+                    IdleTask task);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Runs pending tasks until |deadline|. Must be called on the UI
+  ///             task runner.
+  ///
+  void RunIdleTasks(fml::TimePoint deadline);
+
+  //----------------------------------------------------------------------------
+  /// @brief      The number of tasks waiting for an idle period. Tasks that
+  ///             were forwarded to their task runner are not counted.
+  ///
+  size_t GetPendingTaskCount() const;
+
+ private:
+  struct PendingTask {
+    Priority priority;
+    fml::RefPtr<fml::TaskRunner> task_runner;
+    IdleTask task;
+  };
+
+  static constexpr size_t kPriorityCount =
+      static_cast<size_t>(Priority::kLow) + 1;
+
+  const fml::RefPtr<fml::TaskRunner> ui_task_runner_;
+  mutable std::mutex mutex_;
+  std::array<std::deque<PendingTask>, kPriorityCount> tasks_;
+
+  // Adds |task| after the other tasks of the same priority, or before them if
+  // |first| is set.
+  void Enqueue(PendingTask task, bool first);
+
+  // Runs a task that was forwarded to another task runner.
+  void RunForwardedTask(PendingTask task, fml::TimePoint deadline);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(IdleTaskScheduler);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_IDLE_TASK_SCHEDULER_H_
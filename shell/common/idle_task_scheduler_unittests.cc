@@ -0,0 +1,137 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/idle_task_scheduler.h"
+
+#include <vector>
+
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/testing/thread_test.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+using IdleTaskSchedulerTest = ThreadTest;
+
+namespace {
+
+fml::TimePoint DeadlineIn(int64_t milliseconds) {
+  return fml::TimePoint::Now() +
+         fml::TimeDelta::FromMilliseconds(milliseconds);
+}
+
+}  // namespace
+
+TEST_F(IdleTaskSchedulerTest, RunsTasksInPriorityOrder) {
+  auto ui_task_runner = GetCurrentTaskRunner();
+  auto scheduler = std::make_shared<IdleTaskScheduler>(ui_task_runner);
+  std::vector<int> order;
+  auto record = [&order](int id) {
+    return [&order, id](fml::TimePoint deadline) {
+      order.push_back(id);
+      return false;
+    };
+  };
+  scheduler->PostIdleTask(IdleTaskScheduler::Priority::kLow, ui_task_runner,
+                          record(3));
+  scheduler->PostIdleTask(IdleTaskScheduler::Priority::kHigh, ui_task_runner,
+                          record(1));
+  scheduler->PostIdleTask(IdleTaskScheduler::Priority::kNormal,
+                          ui_task_runner, record(2));
+  scheduler->PostIdleTask(IdleTaskScheduler::Priority::kHigh, ui_task_runner,
+                          record(4));
+  EXPECT_EQ(scheduler->GetPendingTaskCount(), 4u);
+
+  scheduler->RunIdleTasks(DeadlineIn(100));
+  EXPECT_EQ(order, std::vector<int>({1, 4, 2, 3}));
+  EXPECT_EQ(scheduler->GetPendingTaskCount(), 0u);
+}
+
+TEST_F(IdleTaskSchedulerTest, DoesNotStartTasksWithoutIdleTime) {
+  auto ui_task_runner = GetCurrentTaskRunner();
+  auto scheduler = std::make_shared<IdleTaskScheduler>(ui_task_runner);
+  bool ran = false;
+  scheduler->PostIdleTask(IdleTaskScheduler::Priority::kHigh, ui_task_runner,
+                          [&ran](fml::TimePoint deadline) {
+                            ran = true;
+                            return false;
+                          });
+  scheduler->RunIdleTasks(fml::TimePoint::Now());
+  EXPECT_FALSE(ran);
+  EXPECT_EQ(scheduler->GetPendingTaskCount(), 1u);
+
+  scheduler->RunIdleTasks(DeadlineIn(100));
+  EXPECT_TRUE(ran);
+}
+
+TEST_F(IdleTaskSchedulerTest, TasksResumeInLaterIdlePeriods) {
+  auto ui_task_runner = GetCurrentTaskRunner();
+  auto scheduler = std::make_shared<IdleTaskScheduler>(ui_task_runner);
+  int remaining_steps = 3;
+  fml::TimePoint last_deadline;
+  scheduler->PostIdleTask(IdleTaskScheduler::Priority::kNormal, ui_task_runner,
+                          [&](fml::TimePoint deadline) {
+                            last_deadline = deadline;
+                            return --remaining_steps > 0;
+                          });
+  for (int i = 0; i < 3; i++) {
+    const fml::TimePoint deadline = DeadlineIn(100);
+    scheduler->RunIdleTasks(deadline);
+    EXPECT_EQ(last_deadline, deadline);
+  }
+  EXPECT_EQ(remaining_steps, 0);
+  EXPECT_EQ(scheduler->GetPendingTaskCount(), 0u);
+}
+
+TEST_F(IdleTaskSchedulerTest, StopsStartingTasksAtDeadline) {
+  auto ui_task_runner = GetCurrentTaskRunner();
+  auto scheduler = std::make_shared<IdleTaskScheduler>(ui_task_runner);
+  bool second_ran = false;
+  scheduler->PostIdleTask(IdleTaskScheduler::Priority::kHigh, ui_task_runner,
+                          [](fml::TimePoint deadline) {
+                            // Uses up the whole idle period.
+                            while (fml::TimePoint::Now() < deadline) {
+                            }
+                            return false;
+                          });
+  scheduler->PostIdleTask(IdleTaskScheduler::Priority::kLow, ui_task_runner,
+                          [&second_ran](fml::TimePoint deadline) {
+                            second_ran = true;
+                            return false;
+                          });
+  scheduler->RunIdleTasks(DeadlineIn(10));
+  EXPECT_FALSE(second_ran);
+  EXPECT_EQ(scheduler->GetPendingTaskCount(), 1u);
+
+  scheduler->RunIdleTasks(DeadlineIn(10));
+  EXPECT_TRUE(second_ran);
+}
+
+TEST_F(IdleTaskSchedulerTest, RunsTasksOnTheirTaskRunner) {
+  auto ui_task_runner = GetCurrentTaskRunner();
+  auto io_task_runner = CreateNewThread();
+  auto scheduler = std::make_shared<IdleTaskScheduler>(ui_task_runner);
+  fml::AutoResetWaitableEvent latch;
+  bool ran_on_io = false;
+  scheduler->PostIdleTask(IdleTaskScheduler::Priority::kNormal, io_task_runner,
+                          [&](fml::TimePoint deadline) {
+                            ran_on_io =
+                                io_task_runner->RunsTasksOnCurrentThread();
+                            latch.Signal();
+                            return false;
+                          });
+  scheduler->RunIdleTasks(DeadlineIn(1000));
+  latch.Wait();
+  EXPECT_TRUE(ran_on_io);
+
+  // Let the forwarded task finish before checking that it is not requeued.
+  fml::AutoResetWaitableEvent done;
+  io_task_runner->PostTask([&done]() { done.Signal(); });
+  done.Wait();
+  EXPECT_EQ(scheduler->GetPendingTaskCount(), 0u);
+}
+
+}  // namespace testing
+}  // namespace flutter
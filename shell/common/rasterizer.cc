@@ -399,6 +399,7 @@ RasterStatus Rasterizer::DoDraw(
       DrawToSurface(*frame_timings_recorder, *layer_tree);
   if (raster_status == RasterStatus::kSuccess) {
     last_layer_tree_ = std::move(layer_tree);
+    CaptureLastLayerTreeIfCapturing();
   } else if (ShouldResubmitFrame(raster_status)) {
     resubmitted_layer_tree_ = std::move(layer_tree);
     return raster_status;
@@ -772,6 +773,13 @@ void Rasterizer::SetNextFrameCallback(const fml::closure& callback) {
   next_frame_callback_ = callback;
 }
 
+void Rasterizer::CaptureNextLayerTrees(
+    size_t frame_count,
+    std::function<void(std::unique_ptr<LayerTreeCapture>)> callback) {
+  layer_tree_capture_ = std::make_unique<LayerTreeCapture>(frame_count);
+  layer_tree_capture_callback_ = std::move(callback);
+}
+
 void Rasterizer::SetExternalViewEmbedder(
     const std::shared_ptr<ExternalViewEmbedder>& view_embedder) {
   external_view_embedder_ = view_embedder;
@@ -796,6 +804,21 @@ void Rasterizer::FireNextFrameCallbackIfPresent() {
   callback();
 }
 
+void Rasterizer::CaptureLastLayerTreeIfCapturing() {
+  if (!layer_tree_capture_) {
+    return;
+  }
+  layer_tree_capture_->Capture(*last_layer_tree_);
+  if (!layer_tree_capture_->IsComplete()) {
+    return;
+  }
+  // It is safe for the callback to start a new capture.
+  auto capture = std::move(layer_tree_capture_);
+  auto callback = std::move(layer_tree_capture_callback_);
+  layer_tree_capture_callback_ = nullptr;
+  callback(std::move(capture));
+}
+
 void Rasterizer::SetResourceCacheMaxBytes(size_t max_bytes, bool from_user) {
   user_override_resource_cache_bytes_ |= from_user;
 
@@ -836,6 +859,19 @@ std::optional<size_t> Rasterizer::GetResourceCacheMaxBytes() const {
   return std::nullopt;
 }
 
+std::optional<size_t> Rasterizer::GetResourceCacheBytes() const {
+  if (!surface_) {
+    return std::nullopt;
+  }
+  GrDirectContext* context = surface_->GetContext();
+  if (context) {
+    size_t bytes;
+    context->getResourceCacheUsage(nullptr, &bytes);
+    return bytes;
+  }
+  return std::nullopt;
+}
+
 Rasterizer::Screenshot::Screenshot() {}
 
 Rasterizer::Screenshot::Screenshot(sk_sp<SkData> p_data, SkISize p_size)
@@ -13,6 +13,7 @@
 #include "flutter/flow/compositor_context.h"
 #include "flutter/flow/embedded_views.h"
 #include "flutter/flow/frame_timings.h"
+#include "flutter/flow/layer_tree_capture.h"
 #include "flutter/flow/layers/layer_tree.h"
 #include "flutter/flow/surface.h"
 #include "flutter/fml/closure.h"
@@ -345,6 +346,24 @@ class Rasterizer final : public SnapshotDelegate {
   ///
   void SetNextFrameCallback(const fml::closure& callback);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Captures the next |frame_count| layer trees that are
+  ///             successfully rendered to the on-screen surface, so that they
+  ///             can be replayed offscreen to reproduce and measure their
+  ///             rasterization. Starting a capture replaces any capture that
+  ///             is still in progress.
+  ///
+  ///             Like the next frame callback, the callback is executed and
+  ///             dropped on the raster thread.
+  ///
+  /// @param[in]  frame_count  The number of consecutive frames to capture.
+  /// @param[in]  callback     The callback to execute with the capture once
+  ///                          all of the frames have been captured.
+  ///
+  void CaptureNextLayerTrees(
+      size_t frame_count,
+      std::function<void(std::unique_ptr<LayerTreeCapture>)> callback);
+
   //----------------------------------------------------------------------------
   /// @brief Set the External View Embedder. This is done on shell
   ///        initialization. This is non-null on platforms that support
@@ -423,6 +442,16 @@ class Rasterizer final : public SnapshotDelegate {
   ///
   std::optional<size_t> GetResourceCacheMaxBytes() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      The number of bytes currently used by Skia's resource cache,
+  ///             if a surface is present.
+  ///
+  /// @see        `GetResourceCacheMaxBytes`
+  ///
+  /// @return     The usage of Skia's resource cache, if available.
+  ///
+  std::optional<size_t> GetResourceCacheBytes() const;
+
   //----------------------------------------------------------------------------
   /// @brief      Enables the thread merger if the external view embedder
   ///             supports dynamic thread merging.
@@ -482,6 +511,8 @@ class Rasterizer final : public SnapshotDelegate {
 
   void FireNextFrameCallbackIfPresent();
 
+  void CaptureLastLayerTreeIfCapturing();
+
   static bool NoDiscard(const flutter::LayerTree& layer_tree) { return false; }
   static bool ShouldResubmitFrame(const RasterStatus& raster_status);
 
@@ -496,6 +527,9 @@ class Rasterizer final : public SnapshotDelegate {
   // thread configuration. This will be inserted to the front of the pipeline.
   std::unique_ptr<flutter::LayerTree> resubmitted_layer_tree_;
   fml::closure next_frame_callback_;
+  std::unique_ptr<LayerTreeCapture> layer_tree_capture_;
+  std::function<void(std::unique_ptr<LayerTreeCapture>)>
+      layer_tree_capture_callback_;
   bool user_override_resource_cache_bytes_;
   std::optional<size_t> max_cache_bytes_;
   fml::RefPtr<fml::RasterThreadMerger> raster_thread_merger_;
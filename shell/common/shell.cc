@@ -5,7 +5,9 @@
 #define RAPIDJSON_HAS_STDSTRING 1
 #include "flutter/shell/common/shell.h"
 
+#include <algorithm>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <vector>
 
@@ -21,7 +23,9 @@
 #include "flutter/fml/paths.h"
 #include "flutter/fml/trace_event.h"
 #include "flutter/runtime/dart_vm.h"
+#include "flutter/runtime/snapshot_page_prefetcher.h"
 #include "flutter/shell/common/engine.h"
+#include "flutter/shell/common/serialization_callbacks.h"
 #include "flutter/shell/common/skia_event_tracer_impl.h"
 #include "flutter/shell/common/switches.h"
 #include "flutter/shell/common/vsync_waiter.h"
@@ -31,6 +35,7 @@
 #include "third_party/skia/include/core/SkGraphics.h"
 #include "third_party/skia/include/utils/SkBase64.h"
 #include "third_party/tonic/common/log.h"
+#include "txt/platform.h"
 
 namespace flutter {
 
@@ -122,6 +127,38 @@ void PerformInitializationTasks(Settings& settings) {
 
 }  // namespace
 
+// Creating the default font manager scans the fonts installed on the system,
+// which is among the slowest steps of startup. It does not depend on any of
+// the other subsystems, so it is started on the raster thread as soon as the
+// rasterizer has been created, and picked up by the UI thread in |Setup|.
+class Shell::DefaultFontManagerPrefetch {
+ public:
+  DefaultFontManagerPrefetch(uint32_t font_initialization_data,
+                             std::shared_ptr<StartupTimeline> timeline)
+      : font_initialization_data_(font_initialization_data),
+        timeline_(std::move(timeline)) {}
+
+  // Returns the font manager, creating it on the calling thread unless another
+  // thread already has (or is in the process of doing so).
+  sk_sp<SkFontMgr> Get() {
+    std::call_once(once_, [this]() {
+      TRACE_EVENT0("flutter", "Shell::PrefetchDefaultFontManager");
+      StartupTimeline::ScopedPhase phase(*timeline_,
+                                         StartupPhase::kFontManager);
+      font_manager_ = txt::GetDefaultFontManager(font_initialization_data_);
+    });
+    return font_manager_;
+  }
+
+ private:
+  const uint32_t font_initialization_data_;
+  const std::shared_ptr<StartupTimeline> timeline_;
+  std::once_flag once_;
+  sk_sp<SkFontMgr> font_manager_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DefaultFontManagerPrefetch);
+};
+
 std::unique_ptr<Shell> Shell::Create(
     const PlatformData& platform_data,
     TaskRunners task_runners,
@@ -139,30 +176,78 @@ std::unique_ptr<Shell> Shell::Create(
   // arguments are ignored.
   auto vm_snapshot = DartSnapshot::VMSnapshotFromSettings(settings);
   auto isolate_snapshot = DartSnapshot::IsolateSnapshotFromSettings(settings);
+
+  // Read the snapshots from storage on the IO thread while the VM boots, so
+  // that neither the boot nor the first frames wait on page faults. If the
+  // VM is already running, the pages have been touched already.
+  const bool prefetch_snapshot_pages =
+      settings.prefetch_snapshot_pages && !DartVMRef::IsInstanceRunning();
+  if (prefetch_snapshot_pages) {
+    fml::TaskRunner::RunNowOrPostTask(
+        task_runners.GetIOTaskRunner(),
+        [vm_snapshot, isolate_snapshot,
+         profile_path = settings.snapshot_page_profile_path]() {
+          SnapshotPagePrefetcher(vm_snapshot, isolate_snapshot, profile_path)
+              .Prefetch();
+        });
+  }
+  const bool record_snapshot_page_profile =
+      prefetch_snapshot_pages && !settings.snapshot_page_profile_path.empty() &&
+      !fml::IsFile(settings.snapshot_page_profile_path);
+  const std::string snapshot_page_profile_path =
+      settings.snapshot_page_profile_path;
+  const auto prefetched_isolate_snapshot = isolate_snapshot;
+
+  const fml::TimePoint vm_boot_start = fml::TimePoint::Now();
   auto vm = DartVMRef::Create(settings, vm_snapshot, isolate_snapshot);
   FML_CHECK(vm) << "Must be able to initialize the VM.";
+  const fml::TimePoint vm_boot_end = fml::TimePoint::Now();
 
   // If the settings did not specify an `isolate_snapshot`, fall back to the
   // one the VM was launched with.
   if (!isolate_snapshot) {
     isolate_snapshot = vm->GetVMData()->GetIsolateSnapshot();
   }
-  return CreateWithSnapshot(std::move(platform_data),            //
-                            std::move(task_runners),             //
-                            /*parent_merger=*/nullptr,           //
-                            /*parent_io_manager=*/nullptr,       //
-                            std::move(settings),                 //
-                            std::move(vm),                       //
-                            std::move(isolate_snapshot),         //
-                            std::move(on_create_platform_view),  //
-                            std::move(on_create_rasterizer),     //
-                            CreateEngine, is_gpu_disabled);
+  auto shell =
+      CreateWithSnapshot(std::move(platform_data),                //
+                         std::move(task_runners),                 //
+                         /*parent_merger=*/nullptr,               //
+                         /*parent_io_manager=*/nullptr,           //
+                         /*parent_raster_cache_budget=*/nullptr,  //
+                         std::move(settings),                     //
+                         std::move(vm),                           //
+                         std::move(isolate_snapshot),             //
+                         std::move(on_create_platform_view),      //
+                         std::move(on_create_rasterizer),         //
+                         CreateEngine, is_gpu_disabled);
+  if (!shell) {
+    return nullptr;
+  }
+  shell->startup_timeline_->RecordPhase(StartupPhase::kVMBoot, vm_boot_start,
+                                        vm_boot_end);
+
+  // The first idle period follows the first frame. Record the snapshot pages
+  // that were needed until then, so that later runs only prefetch those.
+  if (record_snapshot_page_profile) {
+    shell->GetIdleTaskScheduler()->PostIdleTask(
+        IdleTaskScheduler::Priority::kLow,
+        shell->GetTaskRunners().GetIOTaskRunner(),
+        [vm_snapshot = std::move(vm_snapshot),
+         isolate_snapshot = prefetched_isolate_snapshot,
+         profile_path = snapshot_page_profile_path](fml::TimePoint deadline) {
+          SnapshotPagePrefetcher(vm_snapshot, isolate_snapshot, profile_path)
+              .RecordProfile();
+          return false;
+        });
+  }
+  return shell;
 }
 
 std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
     DartVMRef vm,
     fml::RefPtr<fml::RasterThreadMerger> parent_merger,
     std::shared_ptr<ShellIOManager> parent_io_manager,
+    std::shared_ptr<RasterCacheBudget> parent_raster_cache_budget,
     TaskRunners task_runners,
     const PlatformData& platform_data,
     Settings settings,
@@ -183,6 +268,13 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
                     !settings.skia_deterministic_rendering_on_cpu),
                 is_gpu_disabled));
 
+  if (parent_raster_cache_budget) {
+    shell->raster_cache_budget_ = std::move(parent_raster_cache_budget);
+  } else if (settings.shared_raster_cache_max_bytes > 0) {
+    shell->raster_cache_budget_ = std::make_shared<RasterCacheBudget>(
+        settings.shared_raster_cache_max_bytes);
+  }
+
   // Create the rasterizer on the raster thread.
   std::promise<std::unique_ptr<Rasterizer>> rasterizer_promise;
   auto rasterizer_future = rasterizer_promise.get_future();
@@ -195,12 +287,43 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
                                            shell = shell.get()    //
   ]() {
         TRACE_EVENT0("flutter", "ShellSetupGPUSubsystem");
+        const fml::TimePoint start = fml::TimePoint::Now();
         std::unique_ptr<Rasterizer> rasterizer(on_create_rasterizer(*shell));
+        if (shell->raster_cache_budget_) {
+          rasterizer->compositor_context()->raster_cache().SetBudget(
+              shell->raster_cache_budget_);
+        }
+        if (shell->settings_.raster_cache_scale_bucket_step > 1) {
+          RasterCacheScaleBuckets scale_buckets;
+          scale_buckets.step = shell->settings_.raster_cache_scale_bucket_step;
+          rasterizer->compositor_context()->raster_cache().SetScaleBuckets(
+              scale_buckets);
+        }
+        rasterizer->compositor_context()
+            ->raster_cache()
+            .SetAdmitDisplayListsByCost(
+                shell->settings_.raster_cache_admit_display_lists_by_cost);
+        shell->startup_timeline_->RecordPhase(
+            StartupPhase::kRasterizer, start, fml::TimePoint::Now());
         snapshot_delegate_promise.set_value(rasterizer->GetSnapshotDelegate());
         rasterizer_promise.set_value(std::move(rasterizer));
       });
 
+  // The raster thread has nothing else to do until the first frame, so load
+  // the default font manager there in parallel with the other subsystems.
+  if (!settings.prefetched_default_font_manager) {
+    shell->default_font_manager_prefetch_ =
+        std::make_shared<DefaultFontManagerPrefetch>(
+            settings.font_initialization_data, shell->startup_timeline_);
+    fml::TaskRunner::RunNowOrPostTask(
+        task_runners.GetRasterTaskRunner(),
+        [prefetch = shell->default_font_manager_prefetch_]() {
+          prefetch->Get();
+        });
+  }
+
   // Create the platform view on the platform thread (this thread).
+  const fml::TimePoint platform_view_start = fml::TimePoint::Now();
   auto platform_view = on_create_platform_view(*shell.get());
   if (!platform_view || !platform_view->GetWeakPtr()) {
     return nullptr;
@@ -212,6 +335,12 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
   if (!vsync_waiter) {
     return nullptr;
   }
+  if (shell->frame_time_predictor_) {
+    vsync_waiter->SetFrameTimePredictor(shell->frame_time_predictor_);
+  }
+  shell->startup_timeline_->RecordPhase(StartupPhase::kPlatformView,
+                                        platform_view_start,
+                                        fml::TimePoint::Now());
 
   // Create the IO manager on the IO thread. The IO manager must be initialized
   // first because it has state that the other subsystems depend on. It must
@@ -236,9 +365,11 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
        &unref_queue_promise,                                              //
        platform_view_ptr,                                                 //
        io_task_runner,                                                    //
+       timeline = shell->startup_timeline_,                               //
        is_backgrounded_sync_switch = shell->GetIsGpuDisabledSyncSwitch()  //
   ]() {
         TRACE_EVENT0("flutter", "ShellSetupIOSubsystem");
+        const fml::TimePoint start = fml::TimePoint::Now();
         std::shared_ptr<ShellIOManager> io_manager;
         if (parent_io_manager) {
           io_manager = parent_io_manager;
@@ -247,6 +378,8 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
               platform_view_ptr->CreateResourceContext(),
               is_backgrounded_sync_switch, io_task_runner);
         }
+        timeline->RecordPhase(StartupPhase::kIOManager, start,
+                              fml::TimePoint::Now());
         weak_io_manager_promise.set_value(io_manager->GetWeakPtr());
         unref_queue_promise.set_value(io_manager->GetSkiaUnrefQueue());
         io_manager_promise.set_value(io_manager);
@@ -272,6 +405,12 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
                          &unref_queue_future,                             //
                          &on_create_engine]() mutable {
         TRACE_EVENT0("flutter", "ShellSetupUISubsystem");
+        // Wait for the other subsystems before starting the clock, so that
+        // the recorded duration is that of the engine alone.
+        auto weak_io_manager = weak_io_manager_future.get();
+        auto unref_queue = unref_queue_future.get();
+        auto snapshot_delegate = snapshot_delegate_future.get();
+        const fml::TimePoint start = fml::TimePoint::Now();
         const auto& task_runners = shell->GetTaskRunners();
 
         // The animator is owned by the UI thread but it gets its vsync pulses
@@ -279,28 +418,37 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
         auto animator = std::make_unique<Animator>(*shell, task_runners,
                                                    std::move(vsync_waiter));
 
-        engine_promise.set_value(
-            on_create_engine(*shell,                          //
-                             dispatcher_maker,                //
-                             *shell->GetDartVM(),             //
-                             std::move(isolate_snapshot),     //
-                             task_runners,                    //
-                             platform_data,                   //
-                             shell->GetSettings(),            //
-                             std::move(animator),             //
-                             weak_io_manager_future.get(),    //
-                             unref_queue_future.get(),        //
-                             snapshot_delegate_future.get(),  //
-                             shell->volatile_path_tracker_));
+        auto engine = on_create_engine(*shell,                          //
+                                       dispatcher_maker,                //
+                                       *shell->GetDartVM(),             //
+                                       std::move(isolate_snapshot),     //
+                                       task_runners,                    //
+                                       platform_data,                   //
+                                       shell->GetSettings(),            //
+                                       std::move(animator),             //
+                                       std::move(weak_io_manager),      //
+                                       std::move(unref_queue),          //
+                                       std::move(snapshot_delegate),    //
+                                       shell->volatile_path_tracker_);
+        shell->startup_timeline_->RecordPhase(StartupPhase::kEngine, start,
+                                              fml::TimePoint::Now());
+        engine_promise.set_value(std::move(engine));
       }));
 
+  auto engine = engine_future.get();
+  auto rasterizer = rasterizer_future.get();
+  auto io_manager = io_manager_future.get();
+
+  const fml::TimePoint setup_start = fml::TimePoint::Now();
   if (!shell->Setup(std::move(platform_view),  //
-                    engine_future.get(),       //
-                    rasterizer_future.get(),   //
-                    io_manager_future.get())   //
+                    std::move(engine),         //
+                    std::move(rasterizer),     //
+                    std::move(io_manager))     //
   ) {
     return nullptr;
   }
+  shell->startup_timeline_->RecordPhase(StartupPhase::kSetup, setup_start,
+                                        fml::TimePoint::Now());
 
   return shell;
 }
@@ -310,6 +458,7 @@ std::unique_ptr<Shell> Shell::CreateWithSnapshot(
     TaskRunners task_runners,
     fml::RefPtr<fml::RasterThreadMerger> parent_thread_merger,
     std::shared_ptr<ShellIOManager> parent_io_manager,
+    std::shared_ptr<RasterCacheBudget> parent_raster_cache_budget,
     Settings settings,
     DartVMRef vm,
     fml::RefPtr<const DartSnapshot> isolate_snapshot,
@@ -337,6 +486,7 @@ std::unique_ptr<Shell> Shell::CreateWithSnapshot(
            &shell,                                                        //
            parent_thread_merger,                                          //
            parent_io_manager,                                             //
+           parent_raster_cache_budget,                                    //
            task_runners = std::move(task_runners),                        //
            platform_data = std::move(platform_data),                      //
            settings = std::move(settings),                                //
@@ -350,6 +500,7 @@ std::unique_ptr<Shell> Shell::CreateWithSnapshot(
                 std::move(vm),                       //
                 parent_thread_merger,                //
                 parent_io_manager,                   //
+                parent_raster_cache_budget,          //
                 std::move(task_runners),             //
                 std::move(platform_data),            //
                 std::move(settings),                 //
@@ -375,6 +526,12 @@ Shell::Shell(DartVMRef vm,
       vm_(std::move(vm)),
       is_gpu_disabled_sync_switch_(new fml::SyncSwitch(is_gpu_disabled)),
       volatile_path_tracker_(std::move(volatile_path_tracker)),
+      frame_time_predictor_(settings_.enable_predictive_frame_scheduling
+                                ? std::make_shared<FrameTimePredictor>()
+                                : nullptr),
+      idle_task_scheduler_(std::make_shared<IdleTaskScheduler>(
+          task_runners_.GetUITaskRunner())),
+      startup_timeline_(std::make_shared<StartupTimeline>()),
       weak_factory_gpu_(nullptr),
       weak_factory_(this) {
   FML_CHECK(vm_) << "Must have access to VM to create a shell.";
@@ -430,6 +587,16 @@ Shell::Shell(DartVMRef vm,
           task_runners_.GetRasterTaskRunner(),
           std::bind(&Shell::OnServiceProtocolEstimateRasterCacheMemory, this,
                     std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_
+      [ServiceProtocol::kGetLayerRasterCostsExtensionName] = {
+          task_runners_.GetRasterTaskRunner(),
+          std::bind(&Shell::OnServiceProtocolGetLayerRasterCosts, this,
+                    std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_
+      [ServiceProtocol::kCaptureLayerTreesExtensionName] = {
+          task_runners_.GetRasterTaskRunner(),
+          std::bind(&Shell::OnServiceProtocolCaptureLayerTrees, this,
+                    std::placeholders::_1, std::placeholders::_2)};
 }
 
 Shell::~Shell() {
@@ -499,7 +666,8 @@ std::unique_ptr<Shell> Shell::Spawn(
           .SetIfTrue([&is_gpu_disabled] { is_gpu_disabled = true; }));
   std::unique_ptr<Shell> result = CreateWithSnapshot(
       PlatformData{}, task_runners_, rasterizer_->GetRasterThreadMerger(),
-      io_manager_, GetSettings(), vm_, vm_->GetVMData()->GetIsolateSnapshot(),
+      io_manager_, raster_cache_budget_, GetSettings(), vm_,
+      vm_->GetVMData()->GetIsolateSnapshot(),
       on_create_platform_view, on_create_rasterizer,
       [engine = this->engine_.get(), initial_route](
           Engine::Delegate& delegate,
@@ -543,7 +711,15 @@ void Shell::NotifyLowMemoryWarning() const {
                                trace_id);
       });
   // The IO Manager uses resource cache limits of 0, so it is not necessary
-  // to purge them.
+  // to purge them. Objects waiting to be released are freed right away.
+  task_runners_.GetIOTaskRunner()->PostTask(
+      [io_manager = io_manager_->GetWeakPtr()]() {
+        if (io_manager) {
+          io_manager->GetIsGpuDisabledSyncSwitch()->Execute(
+              fml::SyncSwitch::Handlers().SetIfFalse(
+                  [&] { io_manager->GetSkiaUnrefQueue()->Drain(); }));
+        }
+      });
 }
 
 void Shell::RunEngine(RunConfiguration run_configuration) {
@@ -656,13 +832,23 @@ bool Shell::Setup(std::unique_ptr<PlatformView> platform_view,
   weak_platform_view_ = platform_view_->GetWeakPtr();
 
   // Setup the time-consuming default font manager right after engine created.
+  // If it is being prefetched, this waits for the prefetch to finish.
   if (!settings_.prefetched_default_font_manager) {
-    fml::TaskRunner::RunNowOrPostTask(task_runners_.GetUITaskRunner(),
-                                      [engine = weak_engine_] {
-                                        if (engine) {
-                                          engine->SetupDefaultFontManager();
-                                        }
-                                      });
+    fml::TaskRunner::RunNowOrPostTask(
+        task_runners_.GetUITaskRunner(),
+        [engine = weak_engine_, prefetch = default_font_manager_prefetch_,
+         timeline = startup_timeline_] {
+          if (!engine) {
+            return;
+          }
+          StartupTimeline::ScopedPhase phase(*timeline,
+                                             StartupPhase::kFontSetup);
+          if (prefetch) {
+            engine->SetDefaultFontManager(prefetch->Get());
+          } else {
+            engine->SetupDefaultFontManager();
+          }
+        });
   }
 
   is_setup_ = true;
@@ -677,6 +863,23 @@ bool Shell::Setup(std::unique_ptr<PlatformView> platform_view,
     PersistentCache::GetCacheForProcess()->Purge();
   }
 
+  // Release GPU resources the frames no longer use while the engine is idle,
+  // ahead of the delayed drain of the unref queue.
+  idle_task_scheduler_->PostIdleTask(
+      IdleTaskScheduler::Priority::kNormal, task_runners_.GetIOTaskRunner(),
+      [io_manager = std::weak_ptr<ShellIOManager>(io_manager_)](
+          fml::TimePoint deadline) {
+        auto shell_io_manager = io_manager.lock();
+        if (!shell_io_manager) {
+          return false;
+        }
+        if (auto unref_queue = shell_io_manager->GetSkiaUnrefQueue()) {
+          unref_queue->DrainUntil(deadline);
+        }
+        // Keep draining in every idle period.
+        return true;
+      });
+
   return true;
 }
 
@@ -1098,6 +1301,11 @@ void Shell::OnAnimatorNotifyIdle(int64_t deadline) {
   if (engine_) {
     engine_->NotifyIdle(deadline);
     volatile_path_tracker_->OnFrame();
+
+    // Deferred engine work gets the idle time the Dart VM did not use.
+    idle_task_scheduler_->RunIdleTasks(
+        fml::TimePoint::Now() +
+        fml::TimeDelta::FromMicroseconds(deadline - Dart_TimelineGetMicros()));
   }
 }
 
@@ -1383,6 +1591,10 @@ void Shell::OnFrameRasterized(const FrameTiming& timing) {
     settings_.frame_rasterized_callback(timing);
   }
 
+  if (frame_time_predictor_) {
+    frame_time_predictor_->AddFrameTiming(timing);
+  }
+
   if (!needs_report_timings_) {
     return;
   }
@@ -1726,6 +1938,111 @@ bool Shell::OnServiceProtocolEstimateRasterCacheMemory(
   return true;
 }
 
+bool Shell::OnServiceProtocolGetLayerRasterCosts(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document* response) {
+  FML_DCHECK(task_runners_.GetRasterTaskRunner()->RunsTasksOnCurrentThread());
+  auto& tracker = rasterizer_->compositor_context()->layer_cost_tracker();
+  auto enabled = params.find("enabled");
+  if (enabled != params.end()) {
+    tracker.set_enabled(enabled->second == "true");
+  }
+  if (params.count("reset") && params.at("reset") == "true") {
+    tracker.Reset();
+  }
+
+  // Most expensive layers first.
+  std::vector<std::pair<uint64_t, LayerCostTracker::Aggregate>> aggregates(
+      tracker.aggregates().begin(), tracker.aggregates().end());
+  std::sort(aggregates.begin(), aggregates.end(),
+            [](const auto& a, const auto& b) {
+              return a.second.total.total_time() > b.second.total.total_time();
+            });
+
+  auto& allocator = response->GetAllocator();
+  response->SetObject();
+  response->AddMember("type", "LayerRasterCosts", allocator);
+  response->AddMember("enabled", tracker.enabled(), allocator);
+  rapidjson::Value layers(rapidjson::kArrayType);
+  for (const auto& [layer_id, aggregate] : aggregates) {
+    rapidjson::Value layer(rapidjson::kObjectType);
+    layer.AddMember<uint64_t>("layerId", layer_id, allocator);
+    layer.AddMember<uint64_t>("frames", aggregate.frame_count, allocator);
+    layer.AddMember<int64_t>("prerollMicros",
+                             aggregate.total.preroll_time.ToMicroseconds(),
+                             allocator);
+    layer.AddMember<int64_t>("paintMicros",
+                             aggregate.total.paint_time.ToMicroseconds(),
+                             allocator);
+    layer.AddMember<uint64_t>("saveLayers", aggregate.total.save_layer_count,
+                              allocator);
+    layer.AddMember<int64_t>("maxFrameMicros",
+                             aggregate.max_total_time.ToMicroseconds(),
+                             allocator);
+    layers.PushBack(layer, allocator);
+  }
+  response->AddMember("layers", layers, allocator);
+  return true;
+}
+
+bool Shell::OnServiceProtocolCaptureLayerTrees(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document* response) {
+  FML_DCHECK(task_runners_.GetRasterTaskRunner()->RunsTasksOnCurrentThread());
+  auto frame_count_param = params.find("frameCount");
+  if (frame_count_param != params.end()) {
+    char* end = nullptr;
+    long frame_count = strtol(frame_count_param->second.c_str(), &end, 10);
+    if (*end != '\0' || frame_count < 1 ||
+        frame_count > kMaxCapturedLayerTrees) {
+      ServiceProtocolParameterError(
+          response, "'frameCount' must be a number between 1 and " +
+                        std::to_string(kMaxCapturedLayerTrees) + ".");
+      return false;
+    }
+    capturing_layer_trees_ = true;
+    layer_tree_capture_data_ = nullptr;
+    rasterizer_->CaptureNextLayerTrees(
+        frame_count, [shell = weak_factory_gpu_->GetWeakPtr()](
+                         std::unique_ptr<LayerTreeCapture> capture) {
+          if (!shell) {
+            return;
+          }
+#if defined(OS_FUCHSIA)
+          SkSerialProcs procs = {0};
+          procs.fImageProc = SerializeImageWithoutData;
+          procs.fTypefaceProc = SerializeTypefaceWithoutData;
+#else
+          SkSerialProcs procs = {0};
+          procs.fTypefaceProc = SerializeTypefaceWithData;
+#endif
+          shell->layer_tree_capture_data_ = capture->Serialize(&procs);
+          shell->capturing_layer_trees_ = false;
+        });
+  } else if (!capturing_layer_trees_ && !layer_tree_capture_data_) {
+    ServiceProtocolFailureError(
+        response, "No layer trees have been captured. Start a capture with "
+                  "the 'frameCount' parameter.");
+    return false;
+  }
+
+  auto& allocator = response->GetAllocator();
+  response->SetObject();
+  response->AddMember("type", "LayerTreeCapture", allocator);
+  response->AddMember("capturing", capturing_layer_trees_, allocator);
+  if (!capturing_layer_trees_ && layer_tree_capture_data_) {
+    const auto& data = layer_tree_capture_data_;
+    size_t b64_size = SkBase64::Encode(data->data(), data->size(), nullptr);
+    sk_sp<SkData> b64_data = SkData::MakeUninitialized(b64_size + 1);
+    char* b64_char = static_cast<char*>(b64_data->writable_data());
+    SkBase64::Encode(data->data(), data->size(), b64_char);
+    b64_char[b64_size] = 0;
+    response->AddMember("capture", rapidjson::Value(b64_char, allocator),
+                        allocator);
+  }
+  return true;
+}
+
 // Service protocol handler
 bool Shell::OnServiceProtocolSetAssetBundlePath(
     const ServiceProtocol::Handler::ServiceProtocolMap& params,
@@ -1858,6 +2175,14 @@ bool Shell::ReloadSystemFonts() {
   return true;
 }
 
+std::shared_ptr<IdleTaskScheduler> Shell::GetIdleTaskScheduler() const {
+  return idle_task_scheduler_;
+}
+
+const StartupTimeline& Shell::GetStartupTimeline() const {
+  return *startup_timeline_;
+}
+
 std::shared_ptr<const fml::SyncSwitch> Shell::GetIsGpuDisabledSyncSwitch()
     const {
   return is_gpu_disabled_sync_switch_;
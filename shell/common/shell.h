@@ -14,6 +14,7 @@
 #include "flutter/common/graphics/texture.h"
 #include "flutter/common/settings.h"
 #include "flutter/common/task_runners.h"
+#include "flutter/flow/raster_cache_budget.h"
 #include "flutter/flow/surface.h"
 #include "flutter/fml/closure.h"
 #include "flutter/fml/macros.h"
@@ -36,9 +37,12 @@
 #include "flutter/shell/common/animator.h"
 #include "flutter/shell/common/display_manager.h"
 #include "flutter/shell/common/engine.h"
+#include "flutter/shell/common/frame_time_predictor.h"
+#include "flutter/shell/common/idle_task_scheduler.h"
 #include "flutter/shell/common/platform_view.h"
 #include "flutter/shell/common/rasterizer.h"
 #include "flutter/shell/common/shell_io_manager.h"
+#include "flutter/shell/common/startup_timeline.h"
 
 namespace flutter {
 
@@ -361,6 +365,19 @@ class Shell final : public PlatformView::Delegate,
   /// @brief     Marks the GPU as available or unavailable.
   void SetGpuAvailability(GpuAvailability availability);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Accessor for the scheduler of work that is deferred until the
+  ///             engine is idle. Subsystems post tasks to it that should not
+  ///             compete with frames.
+  ///
+  std::shared_ptr<IdleTaskScheduler> GetIdleTaskScheduler() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Accessor for the start and end times of the steps that
+  ///             created this shell. Used to profile startup.
+  ///
+  const StartupTimeline& GetStartupTimeline() const;
+
   //----------------------------------------------------------------------------
   /// @brief      Get a pointer to the Dart VM used by this running shell
   ///             instance.
@@ -404,6 +421,8 @@ class Shell final : public PlatformView::Delegate,
   const VsyncWaiter& GetVsyncWaiter() const;
 
  private:
+  class DefaultFontManagerPrefetch;
+
   using ServiceProtocolHandler =
       std::function<bool(const ServiceProtocol::Handler::ServiceProtocolMap&,
                          rapidjson::Document*)>;
@@ -420,6 +439,19 @@ class Shell final : public PlatformView::Delegate,
   std::shared_ptr<ShellIOManager> io_manager_;   // on IO task runner
   std::shared_ptr<fml::SyncSwitch> is_gpu_disabled_sync_switch_;
   std::shared_ptr<VolatilePathTracker> volatile_path_tracker_;
+  // Fed on the raster thread, used by the vsync waiter. Null unless
+  // |Settings::enable_predictive_frame_scheduling| is set.
+  std::shared_ptr<FrameTimePredictor> frame_time_predictor_;
+  std::shared_ptr<IdleTaskScheduler> idle_task_scheduler_;
+  // Shared with the startup tasks on the other threads.
+  std::shared_ptr<StartupTimeline> startup_timeline_;
+  // Loads the default font manager on the raster thread while the other
+  // subsystems are being created. Null if the font manager was prefetched
+  // by the engine itself.
+  std::shared_ptr<DefaultFontManagerPrefetch> default_font_manager_prefetch_;
+  // Shared with the shells spawned from this one. Null unless
+  // |Settings::shared_raster_cache_max_bytes| is set.
+  std::shared_ptr<RasterCacheBudget> raster_cache_budget_;
   std::shared_ptr<PlatformMessageHandler> platform_message_handler_;
   std::atomic<bool> route_messages_through_platform_thread_ = false;
 
@@ -439,6 +471,13 @@ class Shell final : public PlatformView::Delegate,
   bool is_added_to_service_protocol_ = false;
   uint64_t next_pointer_flow_id_ = 0;
 
+  // The most frames that a single layer tree capture may hold.
+  static constexpr long kMaxCapturedLayerTrees = 600;
+  // Accessed on the raster thread only. The last completed layer tree capture,
+  // serialized so that its layers are not kept alive.
+  bool capturing_layer_trees_ = false;
+  sk_sp<SkData> layer_tree_capture_data_;
+
   bool first_frame_rasterized_ = false;
   std::atomic<bool> waiting_for_first_frame_ = true;
   std::mutex waiting_for_first_frame_mutex_;
@@ -484,6 +523,7 @@ class Shell final : public PlatformView::Delegate,
       DartVMRef vm,
       fml::RefPtr<fml::RasterThreadMerger> parent_merger,
       std::shared_ptr<ShellIOManager> parent_io_manager,
+      std::shared_ptr<RasterCacheBudget> parent_raster_cache_budget,
       TaskRunners task_runners,
       const PlatformData& platform_data,
       Settings settings,
@@ -497,6 +537,7 @@ class Shell final : public PlatformView::Delegate,
       TaskRunners task_runners,
       fml::RefPtr<fml::RasterThreadMerger> parent_thread_merger,
       std::shared_ptr<ShellIOManager> parent_io_manager,
+      std::shared_ptr<RasterCacheBudget> parent_raster_cache_budget,
       Settings settings,
       DartVMRef vm,
       fml::RefPtr<const DartSnapshot> isolate_snapshot,
@@ -684,6 +725,26 @@ class Shell final : public PlatformView::Delegate,
       const ServiceProtocol::Handler::ServiceProtocolMap& params,
       rapidjson::Document* response);
 
+  // Service protocol handler
+  //
+  // Returns the raster costs of the layers aggregated over all of the tracked
+  // frames. The optional "enabled" parameter turns tracking on or off, and
+  // "reset" drops the costs tracked so far.
+  bool OnServiceProtocolGetLayerRasterCosts(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document* response);
+
+  // Service protocol handler
+  //
+  // Starts capturing the next "frameCount" layer trees when that parameter is
+  // given. Otherwise reports whether a capture is still in progress, and
+  // returns the last completed capture, base64 encoded. Decode it before
+  // storing it to a file, which the flow_benchmarks replay benchmark loads
+  // with --layer-tree-capture=<file>.
+  bool OnServiceProtocolCaptureLayerTrees(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document* response);
+
   // Creates an asset bundle from the original settings asset path or
   // directory.
   std::unique_ptr<DirectoryAssetBundle> RestoreOriginalAssetResolver();
@@ -5,17 +5,75 @@
 #include "flutter/shell/common/shell.h"
 
 #include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/build_config.h"
 #include "flutter/fml/logging.h"
 #include "flutter/runtime/dart_vm.h"
 #include "flutter/shell/common/thread_host.h"
 #include "flutter/testing/elf_loader.h"
 #include "flutter/testing/testing.h"
 
+#if OS_POSIX
+#include <sys/resource.h>
+#endif  // OS_POSIX
+
 namespace flutter {
 
-static void StartupAndShutdownShell(benchmark::State& state,
-                                    bool measure_startup,
-                                    bool measure_shutdown) {
+static void AddToAverage(benchmark::State& state,
+                         const std::string& name,
+                         double value) {
+  auto& counter = state.counters[name];
+  counter.flags = benchmark::Counter::kAvgIterations;
+  counter.value += value;
+}
+
+// Counts the page faults of the process, major ones (which had to read from
+// storage) first.
+static std::pair<int64_t, int64_t> GetPageFaults() {
+#if OS_POSIX
+  struct rusage usage = {};
+  if (::getrusage(RUSAGE_SELF, &usage) == 0) {
+    return {usage.ru_majflt, usage.ru_minflt};
+  }
+#endif  // OS_POSIX
+  return {0, 0};
+}
+
+// Reports how long each step of startup took, and the chain of steps that
+// determined when the shell was ready.
+static void ReportStartupTimeline(benchmark::State& state,
+                                  const StartupTimeline& timeline) {
+  for (size_t i = 0; i < StartupTimeline::kPhaseCount; i++) {
+    const auto phase = static_cast<StartupPhase>(i);
+    if (timeline.HasPhase(phase)) {
+      const std::string name = StartupTimeline::GetPhaseName(phase);
+      AddToAverage(state, name + "Ms",
+                   timeline.GetDuration(phase).ToMillisecondsF());
+    }
+  }
+
+  const auto critical_path = timeline.GetCriticalPath();
+  if (critical_path.empty()) {
+    return;
+  }
+  AddToAverage(state, "CriticalPathMs",
+               (timeline.GetEndTime(critical_path.back()) -
+                timeline.GetStartTime(critical_path.front()))
+                   .ToMillisecondsF());
+  std::string label;
+  for (StartupPhase phase : critical_path) {
+    if (!label.empty()) {
+      label += " > ";
+    }
+    label += StartupTimeline::GetPhaseName(phase);
+  }
+  state.SetLabel(label);
+}
+
+static void StartupAndShutdownShell(
+    benchmark::State& state,
+    bool measure_startup,
+    bool measure_shutdown,
+    const std::function<void(Settings&)>& configure_settings = nullptr) {
   auto assets_dir = fml::OpenDirectory(testing::GetFixturesPath(), false,
                                        fml::FilePermission::kRead);
   std::unique_ptr<Shell> shell;
@@ -43,6 +101,10 @@ static void StartupAndShutdownShell(benchmark::State& state,
       };
     }
 
+    if (configure_settings) {
+      configure_settings(settings);
+    }
+
     thread_host = std::make_unique<ThreadHost>(
         "io.flutter.bench.", ThreadHost::Type::Platform |
                                  ThreadHost::Type::RASTER |
@@ -54,12 +116,20 @@ static void StartupAndShutdownShell(benchmark::State& state,
                              thread_host->ui_thread->GetTaskRunner(),
                              thread_host->io_thread->GetTaskRunner());
 
+    const auto page_faults_before = GetPageFaults();
     shell = Shell::Create(
         flutter::PlatformData(), std::move(task_runners), settings,
         [](Shell& shell) {
           return std::make_unique<PlatformView>(shell, shell.GetTaskRunners());
         },
         [](Shell& shell) { return std::make_unique<Rasterizer>(shell); });
+    if (measure_startup) {
+      const auto page_faults_after = GetPageFaults();
+      AddToAverage(state, "MajorPageFaults",
+                   page_faults_after.first - page_faults_before.first);
+      AddToAverage(state, "MinorPageFaults",
+                   page_faults_after.second - page_faults_before.second);
+    }
   }
 
   FML_CHECK(shell);
@@ -79,6 +149,11 @@ static void StartupAndShutdownShell(benchmark::State& state,
     latch.Wait();
   }
 
+  if (measure_startup) {
+    benchmarking::ScopedPauseTiming pause(state, true);
+    ReportStartupTimeline(state, shell->GetStartupTimeline());
+  }
+
   {
     benchmarking::ScopedPauseTiming pause(state, !measure_shutdown);
     // Shutdown must occur synchronously on the platform thread.
@@ -104,6 +179,30 @@ static void BM_ShellInitialization(benchmark::State& state) {
 
 BENCHMARK(BM_ShellInitialization);
 
+// The VM is shut down after every iteration, so that every startup maps and
+// touches the snapshots anew.
+static void BM_ShellInitializationWithVMBoot(benchmark::State& state) {
+  while (state.KeepRunning()) {
+    StartupAndShutdownShell(state, true, false, [](Settings& settings) {
+      settings.leak_vm = false;
+    });
+  }
+}
+
+BENCHMARK(BM_ShellInitializationWithVMBoot);
+
+static void BM_ShellInitializationWithSnapshotPrefetch(
+    benchmark::State& state) {
+  while (state.KeepRunning()) {
+    StartupAndShutdownShell(state, true, false, [](Settings& settings) {
+      settings.leak_vm = false;
+      settings.prefetch_snapshot_pages = true;
+    });
+  }
+}
+
+BENCHMARK(BM_ShellInitializationWithSnapshotPrefetch);
+
 static void BM_ShellShutdown(benchmark::State& state) {
   while (state.KeepRunning()) {
     StartupAndShutdownShell(state, false, true);
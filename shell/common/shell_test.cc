@@ -265,6 +265,12 @@ void ShellTest::OnServiceProtocol(
           case ServiceProtocolEnum::kEstimateRasterCacheMemory:
             shell->OnServiceProtocolEstimateRasterCacheMemory(params, response);
             break;
+          case ServiceProtocolEnum::kGetLayerRasterCosts:
+            shell->OnServiceProtocolGetLayerRasterCosts(params, response);
+            break;
+          case ServiceProtocolEnum::kCaptureLayerTrees:
+            shell->OnServiceProtocolCaptureLayerTrees(params, response);
+            break;
           case ServiceProtocolEnum::kSetAssetBundlePath:
             shell->OnServiceProtocolSetAssetBundlePath(params, response);
             break;
@@ -104,6 +104,8 @@ class ShellTest : public FixtureTest {
   enum ServiceProtocolEnum {
     kGetSkSLs,
     kEstimateRasterCacheMemory,
+    kGetLayerRasterCosts,
+    kCaptureLayerTrees,
     kSetAssetBundlePath,
     kRunInView,
   };
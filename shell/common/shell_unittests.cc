@@ -34,6 +34,7 @@
 #include "gmock/gmock.h"
 #include "third_party/rapidjson/include/rapidjson/writer.h"
 #include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/utils/SkBase64.h"
 #include "third_party/tonic/converter/dart_converter.h"
 
 #ifdef SHELL_ENABLE_VULKAN
@@ -2303,6 +2304,119 @@ TEST_F(ShellTest, OnServiceProtocolEstimateRasterCacheMemoryWorks) {
   DestroyShell(std::move(shell));
 }
 
+TEST_F(ShellTest, OnServiceProtocolGetLayerRasterCostsEnablesTracking) {
+  Settings settings = CreateSettingsForFixture();
+  std::unique_ptr<Shell> shell = CreateShell(settings);
+
+  ServiceProtocol::Handler::ServiceProtocolMap params;
+  params["enabled"] = "true";
+  rapidjson::Document document;
+  OnServiceProtocol(shell.get(), ServiceProtocolEnum::kGetLayerRasterCosts,
+                    shell->GetTaskRunners().GetRasterTaskRunner(), params,
+                    &document);
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+  document.Accept(writer);
+  ASSERT_EQ(std::string(buffer.GetString()),
+            "{\"type\":\"LayerRasterCosts\",\"enabled\":true,\"layers\":[]}");
+
+  std::promise<bool> enabled;
+  shell->GetTaskRunners().GetRasterTaskRunner()->PostTask(
+      [&shell, &enabled] {
+        enabled.set_value(shell->GetRasterizer()
+                              ->compositor_context()
+                              ->layer_cost_tracker()
+                              .enabled());
+      });
+  ASSERT_TRUE(enabled.get_future().get());
+
+  DestroyShell(std::move(shell));
+}
+
+TEST_F(ShellTest, OnServiceProtocolCaptureLayerTreesSerializesFrames) {
+  Settings settings = CreateSettingsForFixture();
+  std::unique_ptr<Shell> shell = CreateShell(settings);
+
+  // Create the surface needed by rasterizer
+  PlatformViewNotifyCreated(shell.get());
+
+  auto configuration = RunConfiguration::InferFromSettings(settings);
+  configuration.SetEntrypoint("emptyMain");
+
+  RunEngine(shell.get(), std::move(configuration));
+
+  // Nothing has been captured yet.
+  ServiceProtocol::Handler::ServiceProtocolMap empty_params;
+  rapidjson::Document document;
+  OnServiceProtocol(shell.get(), ServiceProtocolEnum::kCaptureLayerTrees,
+                    shell->GetTaskRunners().GetRasterTaskRunner(),
+                    empty_params, &document);
+  ASSERT_TRUE(document.HasMember("code"));
+
+  ServiceProtocol::Handler::ServiceProtocolMap params;
+  params["frameCount"] = "2";
+  document = rapidjson::Document();
+  OnServiceProtocol(shell.get(), ServiceProtocolEnum::kCaptureLayerTrees,
+                    shell->GetTaskRunners().GetRasterTaskRunner(), params,
+                    &document);
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+  document.Accept(writer);
+  ASSERT_EQ(std::string(buffer.GetString()),
+            "{\"type\":\"LayerTreeCapture\",\"capturing\":true}");
+
+  fml::RefPtr<SkiaUnrefQueue> queue = fml::MakeRefCounted<SkiaUnrefQueue>(
+      this->GetCurrentTaskRunner(), fml::TimeDelta::Zero());
+  LayerTreeBuilder builder = [&](std::shared_ptr<ContainerLayer> root) {
+    SkPictureRecorder recorder;
+    SkCanvas* recording_canvas =
+        recorder.beginRecording(SkRect::MakeXYWH(0, 0, 80, 80));
+    recording_canvas->drawRect(SkRect::MakeXYWH(0, 0, 80, 80),
+                               SkPaint(SkColor4f::FromColor(SK_ColorRED)));
+    auto sk_picture = recorder.finishRecordingAsPicture();
+    auto picture_layer = std::make_shared<PictureLayer>(
+        SkPoint::Make(10, 10),
+        flutter::SkiaGPUObject<SkPicture>({sk_picture, queue}), false, false);
+    root->Add(picture_layer);
+  };
+  PumpOneFrame(shell.get(), 100, 100, builder);
+  PumpOneFrame(shell.get(), 100, 100, builder);
+
+  // The frames were posted to the raster thread before this request.
+  document = rapidjson::Document();
+  OnServiceProtocol(shell.get(), ServiceProtocolEnum::kCaptureLayerTrees,
+                    shell->GetTaskRunners().GetRasterTaskRunner(),
+                    empty_params, &document);
+  ASSERT_TRUE(document.HasMember("capturing"));
+  ASSERT_FALSE(document["capturing"].GetBool());
+  ASSERT_TRUE(document.HasMember("capture"));
+
+  const char* b64 = document["capture"].GetString();
+  size_t b64_size = document["capture"].GetStringLength();
+  size_t size = 0;
+  ASSERT_EQ(SkBase64::Decode(b64, b64_size, nullptr, &size),
+            SkBase64::kNoError);
+  sk_sp<SkData> data = SkData::MakeUninitialized(size);
+  ASSERT_EQ(SkBase64::Decode(b64, b64_size, data->writable_data(), &size),
+            SkBase64::kNoError);
+
+  auto capture = LayerTreeCapture::Deserialize(data, queue);
+  ASSERT_NE(capture, nullptr);
+  ASSERT_EQ(capture->frames().size(), 2u);
+  for (const auto& frame : capture->frames()) {
+    ASSERT_EQ(frame.frame_size, SkISize::Make(100, 100));
+    auto* root = static_cast<ContainerLayer*>(frame.root_layer.get());
+    ASSERT_EQ(root->layers().size(), 1u);
+    const PictureLayer* picture_layer = root->layers()[0]->as_picture_layer();
+    ASSERT_NE(picture_layer, nullptr);
+    ASSERT_NE(picture_layer->picture(), nullptr);
+    ASSERT_EQ(picture_layer->picture()->cullRect(),
+              SkRect::MakeXYWH(0, 0, 80, 80));
+  }
+
+  DestroyShell(std::move(shell));
+}
+
 TEST_F(ShellTest, DiscardLayerTreeOnResize) {
   auto settings = CreateSettingsForFixture();
 
@@ -2850,6 +2964,66 @@ TEST_F(ShellTest, Spawn) {
   ASSERT_FALSE(DartVMRef::IsInstanceRunning());
 }
 
+TEST_F(ShellTest, SpawnSharesRasterCacheBudget) {
+  auto settings = CreateSettingsForFixture();
+  settings.shared_raster_cache_max_bytes = 1 << 20;
+  auto shell = CreateShell(settings);
+  ASSERT_TRUE(ValidateShell(shell.get()));
+
+  auto configuration = RunConfiguration::InferFromSettings(settings);
+  ASSERT_TRUE(configuration.IsValid());
+  configuration.SetEntrypoint("fixturesAreFunctionalMain");
+  auto second_configuration = RunConfiguration::InferFromSettings(settings);
+  ASSERT_TRUE(second_configuration.IsValid());
+  second_configuration.SetEntrypoint("fixturesAreFunctionalMain");
+
+  fml::CountDownLatch main_latch(2);
+  AddNativeCallback(
+      "SayHiFromFixturesAreFunctionalMain",
+      CREATE_NATIVE_ENTRY([&](auto args) { main_latch.CountDown(); }));
+
+  RunEngine(shell.get(), std::move(configuration));
+
+  PostSync(
+      shell->GetTaskRunners().GetPlatformTaskRunner(),
+      [this, &spawner = shell, &second_configuration, &main_latch]() {
+        MockPlatformViewDelegate platform_view_delegate;
+        auto spawn = spawner->Spawn(
+            std::move(second_configuration), "/",
+            [&platform_view_delegate](Shell& shell) {
+              auto result = std::make_unique<MockPlatformView>(
+                  platform_view_delegate, shell.GetTaskRunners());
+              ON_CALL(*result, CreateRenderingSurface())
+                  .WillByDefault(::testing::Invoke(
+                      [] { return std::make_unique<MockSurface>(); }));
+              return result;
+            },
+            [](Shell& shell) { return std::make_unique<Rasterizer>(shell); });
+        ASSERT_NE(nullptr, spawn.get());
+        ASSERT_TRUE(ValidateShell(spawn.get()));
+
+        PostSync(spawner->GetTaskRunners().GetRasterTaskRunner(),
+                 [&spawner, &spawn] {
+                   const auto& budget = spawner->GetRasterizer()
+                                            ->compositor_context()
+                                            ->raster_cache()
+                                            .budget();
+                   ASSERT_TRUE(budget);
+                   EXPECT_EQ(budget->GetMaxBytes(), 1u << 20);
+                   EXPECT_EQ(budget->GetCacheCount(), 2u);
+                   EXPECT_EQ(budget, spawn->GetRasterizer()
+                                         ->compositor_context()
+                                         ->raster_cache()
+                                         .budget());
+                 });
+
+        main_latch.Wait();
+        DestroyShell(std::move(spawn));
+      });
+
+  DestroyShell(std::move(shell));
+}
+
 TEST_F(ShellTest, SpawnWithDartEntrypointArgs) {
   auto settings = CreateSettingsForFixture();
   auto shell = CreateShell(settings);
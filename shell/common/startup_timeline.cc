@@ -0,0 +1,143 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/startup_timeline.h"
+
+#include <algorithm>
+
+#include "flutter/fml/logging.h"
+
+namespace flutter {
+
+StartupTimeline::ScopedPhase::ScopedPhase(StartupTimeline& timeline,
+                                          StartupPhase phase)
+    : timeline_(timeline), phase_(phase), start_(fml::TimePoint::Now()) {}
+
+StartupTimeline::ScopedPhase::~ScopedPhase() {
+  timeline_.RecordPhase(phase_, start_, fml::TimePoint::Now());
+}
+
+StartupTimeline::StartupTimeline() = default;
+
+StartupTimeline::~StartupTimeline() = default;
+
+const char* StartupTimeline::GetPhaseName(StartupPhase phase) {
+  switch (phase) {
+    case StartupPhase::kVMBoot:
+      return "VMBoot";
+    case StartupPhase::kPlatformView:
+      return "PlatformView";
+    case StartupPhase::kRasterizer:
+      return "Rasterizer";
+    case StartupPhase::kIOManager:
+      return "IOManager";
+    case StartupPhase::kEngine:
+      return "Engine";
+    case StartupPhase::kSetup:
+      return "Setup";
+    case StartupPhase::kFontManager:
+      return "FontManager";
+    case StartupPhase::kFontSetup:
+      return "FontSetup";
+    case StartupPhase::kCount:
+      break;
+  }
+  FML_UNREACHABLE();
+}
+
+std::vector<StartupPhase> StartupTimeline::GetDependencies(
+    StartupPhase phase) {
+  switch (phase) {
+    case StartupPhase::kVMBoot:
+      return {};
+    case StartupPhase::kPlatformView:
+    case StartupPhase::kRasterizer:
+      // Started by the shell once the VM is running.
+      return {StartupPhase::kVMBoot};
+    case StartupPhase::kIOManager:
+      // Needs the platform view to create the resource context.
+      return {StartupPhase::kPlatformView};
+    case StartupPhase::kFontManager:
+      // Posted to the raster thread after the rasterizer is created there.
+      return {StartupPhase::kRasterizer};
+    case StartupPhase::kEngine:
+      // Waits for the IO manager and the snapshot delegate of the rasterizer.
+      return {StartupPhase::kVMBoot, StartupPhase::kPlatformView,
+              StartupPhase::kIOManager, StartupPhase::kRasterizer};
+    case StartupPhase::kSetup:
+      return {StartupPhase::kPlatformView, StartupPhase::kRasterizer,
+              StartupPhase::kIOManager, StartupPhase::kEngine};
+    case StartupPhase::kFontSetup:
+      // Posted to the UI thread by the setup, where it blocks until the font
+      // manager has been loaded.
+      return {StartupPhase::kSetup, StartupPhase::kFontManager};
+    case StartupPhase::kCount:
+      break;
+  }
+  FML_UNREACHABLE();
+}
+
+void StartupTimeline::RecordPhase(StartupPhase phase,
+                                  fml::TimePoint start,
+                                  fml::TimePoint end) {
+  FML_DCHECK(phase != StartupPhase::kCount);
+  std::scoped_lock lock(mutex_);
+  phases_[static_cast<size_t>(phase)] = {start, end};
+}
+
+bool StartupTimeline::HasPhase(StartupPhase phase) const {
+  return GetInterval(phase).has_value();
+}
+
+fml::TimePoint StartupTimeline::GetStartTime(StartupPhase phase) const {
+  auto interval = GetInterval(phase);
+  return interval ? interval->start : fml::TimePoint();
+}
+
+fml::TimePoint StartupTimeline::GetEndTime(StartupPhase phase) const {
+  auto interval = GetInterval(phase);
+  return interval ? interval->end : fml::TimePoint();
+}
+
+fml::TimeDelta StartupTimeline::GetDuration(StartupPhase phase) const {
+  auto interval = GetInterval(phase);
+  return interval ? interval->end - interval->start : fml::TimeDelta::Zero();
+}
+
+std::vector<StartupPhase> StartupTimeline::GetCriticalPath(
+    StartupPhase last) const {
+  std::vector<StartupPhase> path;
+  std::optional<StartupPhase> phase;
+  if (HasPhase(last)) {
+    phase = last;
+  }
+  while (phase) {
+    path.push_back(*phase);
+    std::optional<StartupPhase> latest;
+    for (StartupPhase dependency : GetDependencies(*phase)) {
+      if (HasPhase(dependency) &&
+          (!latest || GetEndTime(dependency) > GetEndTime(*latest))) {
+        latest = dependency;
+      }
+    }
+    phase = latest;
+  }
+  std::reverse(path.begin(), path.end());
+  return path;
+}
+
+std::vector<StartupPhase> StartupTimeline::GetCriticalPath() const {
+  return GetCriticalPath(HasPhase(StartupPhase::kFontSetup)
+                             ? StartupPhase::kFontSetup
+                             : StartupPhase::kSetup);
+}
+
+std::optional<StartupTimeline::Interval> StartupTimeline::GetInterval(
+    StartupPhase phase) const {
+  FML_DCHECK(phase != StartupPhase::kCount);
+  std::scoped_lock lock(mutex_);
+  return phases_[static_cast<size_t>(phase)];
+}
+
+}  // namespace flutter
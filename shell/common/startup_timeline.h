@@ -0,0 +1,120 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_STARTUP_TIMELINE_H_
+#define FLUTTER_SHELL_COMMON_STARTUP_TIMELINE_H_
+
+#include <array>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace flutter {
+
+/// The steps of shell startup. Some of them run concurrently on different
+/// threads; |StartupTimeline::GetDependencies| describes which steps wait for
+/// which.
+enum class StartupPhase {
+  // Booting the Dart VM and mapping its snapshots. Only happens for the first
+  // shell in the process.
+  kVMBoot,
+  // Creating the platform view and the vsync waiter on the platform thread.
+  kPlatformView,
+  // Creating the rasterizer on the raster thread.
+  kRasterizer,
+  // Creating the IO manager and its resource context on the IO thread.
+  kIOManager,
+  // Creating the engine and the root isolate's runtime on the UI thread.
+  kEngine,
+  // Handing the subsystems over to the shell.
+  kSetup,
+  // Loading the default font manager, which scans the system fonts. Runs on
+  // the raster thread after the rasterizer, in parallel with the other steps.
+  kFontManager,
+  // Handing the default font manager to the engine on the UI thread after
+  // setup, which waits for it to be loaded.
+  kFontSetup,
+  kCount,
+};
+
+//------------------------------------------------------------------------------
+/// Records when each phase of shell startup began and ended, so that startup
+/// can be profiled and its critical path determined. This class is thread
+/// safe.
+///
+class StartupTimeline {
+ public:
+  static constexpr size_t kPhaseCount =
+      static_cast<size_t>(StartupPhase::kCount);
+
+  /// Records the duration of a phase for as long as it is in scope.
+  class ScopedPhase {
+   public:
+    ScopedPhase(StartupTimeline& timeline, StartupPhase phase);
+
+    ~ScopedPhase();
+
+   private:
+    StartupTimeline& timeline_;
+    const StartupPhase phase_;
+    const fml::TimePoint start_;
+
+    FML_DISALLOW_COPY_AND_ASSIGN(ScopedPhase);
+  };
+
+  StartupTimeline();
+
+  ~StartupTimeline();
+
+  /// A short name for |phase|, suitable for reports.
+  static const char* GetPhaseName(StartupPhase phase);
+
+  /// The phases that must end before |phase| can start.
+  static std::vector<StartupPhase> GetDependencies(StartupPhase phase);
+
+  void RecordPhase(StartupPhase phase,
+                   fml::TimePoint start,
+                   fml::TimePoint end);
+
+  bool HasPhase(StartupPhase phase) const;
+
+  fml::TimePoint GetStartTime(StartupPhase phase) const;
+
+  fml::TimePoint GetEndTime(StartupPhase phase) const;
+
+  fml::TimeDelta GetDuration(StartupPhase phase) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns the chain of recorded phases that determined when
+  ///             |last| ended, ordered from the earliest phase to |last|.
+  ///             Going backwards from |last|, each step picks the dependency
+  ///             that ended last.
+  ///
+  std::vector<StartupPhase> GetCriticalPath(StartupPhase last) const;
+
+  /// The critical path of the last phase of startup that was recorded:
+  /// |kFontSetup| once the engine has its font manager, |kSetup| before.
+  std::vector<StartupPhase> GetCriticalPath() const;
+
+ private:
+  struct Interval {
+    fml::TimePoint start;
+    fml::TimePoint end;
+  };
+
+  mutable std::mutex mutex_;
+  std::array<std::optional<Interval>, kPhaseCount> phases_;
+
+  std::optional<Interval> GetInterval(StartupPhase phase) const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(StartupTimeline);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_STARTUP_TIMELINE_H_
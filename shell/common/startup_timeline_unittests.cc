@@ -0,0 +1,92 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/startup_timeline.h"
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+fml::TimePoint At(int64_t milliseconds) {
+  return fml::TimePoint::FromEpochDelta(
+      fml::TimeDelta::FromMilliseconds(milliseconds));
+}
+
+}  // namespace
+
+TEST(StartupTimelineTest, RecordsPhases) {
+  StartupTimeline timeline;
+  EXPECT_FALSE(timeline.HasPhase(StartupPhase::kEngine));
+  EXPECT_EQ(timeline.GetDuration(StartupPhase::kEngine),
+            fml::TimeDelta::Zero());
+
+  timeline.RecordPhase(StartupPhase::kEngine, At(10), At(25));
+  EXPECT_TRUE(timeline.HasPhase(StartupPhase::kEngine));
+  EXPECT_EQ(timeline.GetStartTime(StartupPhase::kEngine), At(10));
+  EXPECT_EQ(timeline.GetEndTime(StartupPhase::kEngine), At(25));
+  EXPECT_EQ(timeline.GetDuration(StartupPhase::kEngine),
+            fml::TimeDelta::FromMilliseconds(15));
+}
+
+TEST(StartupTimelineTest, CriticalPathFollowsLatestDependency) {
+  StartupTimeline timeline;
+  timeline.RecordPhase(StartupPhase::kVMBoot, At(0), At(10));
+  timeline.RecordPhase(StartupPhase::kRasterizer, At(10), At(40));
+  timeline.RecordPhase(StartupPhase::kPlatformView, At(10), At(15));
+  timeline.RecordPhase(StartupPhase::kIOManager, At(15), At(20));
+  timeline.RecordPhase(StartupPhase::kEngine, At(40), At(50));
+  timeline.RecordPhase(StartupPhase::kSetup, At(50), At(52));
+  // Runs in parallel, so it is not on the critical path of the setup.
+  timeline.RecordPhase(StartupPhase::kFontManager, At(40), At(100));
+
+  EXPECT_EQ(timeline.GetCriticalPath(),
+            std::vector<StartupPhase>(
+                {StartupPhase::kVMBoot, StartupPhase::kRasterizer,
+                 StartupPhase::kEngine, StartupPhase::kSetup}));
+}
+
+TEST(StartupTimelineTest, CriticalPathIncludesFontManagerThatIsWaitedFor) {
+  StartupTimeline timeline;
+  timeline.RecordPhase(StartupPhase::kVMBoot, At(0), At(10));
+  timeline.RecordPhase(StartupPhase::kRasterizer, At(10), At(40));
+  timeline.RecordPhase(StartupPhase::kPlatformView, At(10), At(15));
+  timeline.RecordPhase(StartupPhase::kIOManager, At(15), At(20));
+  timeline.RecordPhase(StartupPhase::kEngine, At(40), At(50));
+  timeline.RecordPhase(StartupPhase::kSetup, At(50), At(52));
+  timeline.RecordPhase(StartupPhase::kFontManager, At(40), At(100));
+  // The UI thread blocks until the font manager has been loaded.
+  timeline.RecordPhase(StartupPhase::kFontSetup, At(52), At(101));
+
+  EXPECT_EQ(timeline.GetCriticalPath(),
+            std::vector<StartupPhase>(
+                {StartupPhase::kVMBoot, StartupPhase::kRasterizer,
+                 StartupPhase::kFontManager, StartupPhase::kFontSetup}));
+  EXPECT_EQ(timeline.GetCriticalPath(StartupPhase::kSetup),
+            std::vector<StartupPhase>(
+                {StartupPhase::kVMBoot, StartupPhase::kRasterizer,
+                 StartupPhase::kEngine, StartupPhase::kSetup}));
+}
+
+TEST(StartupTimelineTest, CriticalPathSkipsMissingPhases) {
+  StartupTimeline timeline;
+  EXPECT_TRUE(timeline.GetCriticalPath().empty());
+
+  // The VM was already running, so the boot is not recorded.
+  timeline.RecordPhase(StartupPhase::kPlatformView, At(0), At(5));
+  timeline.RecordPhase(StartupPhase::kIOManager, At(5), At(30));
+  timeline.RecordPhase(StartupPhase::kRasterizer, At(0), At(20));
+  timeline.RecordPhase(StartupPhase::kEngine, At(30), At(35));
+  timeline.RecordPhase(StartupPhase::kSetup, At(35), At(36));
+
+  EXPECT_EQ(timeline.GetCriticalPath(),
+            std::vector<StartupPhase>(
+                {StartupPhase::kPlatformView, StartupPhase::kIOManager,
+                 StartupPhase::kEngine, StartupPhase::kSetup}));
+}
+
+}  // namespace testing
+}  // namespace flutter
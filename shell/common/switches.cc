@@ -410,6 +410,14 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
   settings.enable_skparagraph =
       command_line.HasOption(FlagForSwitch(Switch::EnableSkParagraph));
 
+  settings.enable_predictive_frame_scheduling = command_line.HasOption(
+      FlagForSwitch(Switch::EnablePredictiveFrameScheduling));
+
+  settings.prefetch_snapshot_pages =
+      command_line.HasOption(FlagForSwitch(Switch::PrefetchSnapshotPages));
+  command_line.GetOptionValue(FlagForSwitch(Switch::SnapshotPageProfilePath),
+                              &settings.snapshot_page_profile_path);
+
   settings.prefetched_default_font_manager = command_line.HasOption(
       FlagForSwitch(Switch::PrefetchedDefaultFontManager));
 
@@ -455,6 +463,22 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
                                 &old_gen_heap_size);
     settings.old_gen_heap_size = std::stoi(old_gen_heap_size);
   }
+
+  std::string shared_raster_cache_size;
+  if (command_line.GetOptionValue(FlagForSwitch(Switch::SharedRasterCacheSize),
+                                  &shared_raster_cache_size)) {
+    settings.shared_raster_cache_max_bytes =
+        std::stoull(shared_raster_cache_size) << 20;
+  }
+  settings.raster_cache_admit_display_lists_by_cost = command_line.HasOption(
+      FlagForSwitch(Switch::RasterCacheAdmitDisplayListsByCost));
+  std::string raster_cache_scale_bucket_step;
+  if (command_line.GetOptionValue(
+          FlagForSwitch(Switch::RasterCacheScaleBucketStep),
+          &raster_cache_scale_bucket_step)) {
+    settings.raster_cache_scale_bucket_step =
+        std::stof(raster_cache_scale_bucket_step);
+  }
   return settings;
 }
 
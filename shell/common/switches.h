@@ -214,6 +214,35 @@ DEF_SWITCH(OldGenHeapSize,
 DEF_SWITCH(EnableSkParagraph,
            "enable-skparagraph",
            "Selects the SkParagraph implementation of the text layout engine.")
+DEF_SWITCH(EnablePredictiveFrameScheduling,
+           "enable-predictive-frame-scheduling",
+           "Starts building frames as late as the timings of recent frames "
+           "allow instead of at vsync, to reduce input latency.")
+DEF_SWITCH(PrefetchSnapshotPages,
+           "prefetch-snapshot-pages",
+           "Reads the pages of the Dart snapshots into memory on a background "
+           "thread during startup, instead of faulting them in as they are "
+           "first used.")
+DEF_SWITCH(SnapshotPageProfilePath,
+           "snapshot-page-profile-path",
+           "The file that records which snapshot pages were used by the first "
+           "frames, so that later runs with --prefetch-snapshot-pages only "
+           "read those.")
+DEF_SWITCH(SharedRasterCacheSize,
+           "shared-raster-cache-size",
+           "The size limit in megabytes of the raster caches of this engine "
+           "and of the engines spawned from it together. By default, each "
+           "raster cache grows without bound.")
+DEF_SWITCH(RasterCacheAdmitDisplayListsByCost,
+           "raster-cache-admit-display-lists-by-cost",
+           "Decides which display lists the raster cache keeps by their "
+           "estimated rendering cost on the backend instead of by their op "
+           "count.")
+DEF_SWITCH(RasterCacheScaleBucketStep,
+           "raster-cache-scale-bucket-step",
+           "When greater than 1, display lists drawn at nearby scales share "
+           "raster cache entries rasterized at powers of this step, e.g. 2 or "
+           "1.1, so that zoom animations can draw from the raster cache.")
 
 DEF_SWITCHES_END
 
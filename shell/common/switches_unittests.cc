@@ -46,5 +46,41 @@ TEST(SwitchesTest, SkiaTraceAllowlistFlag) {
 #endif
 }
 
+TEST(SwitchesTest, SharedRasterCacheSize) {
+  fml::CommandLine command_line =
+      fml::CommandLineFromInitializerList({"command"});
+  Settings settings = SettingsFromCommandLine(command_line);
+  EXPECT_EQ(settings.shared_raster_cache_max_bytes, 0u);
+
+  command_line = fml::CommandLineFromInitializerList(
+      {"command", "--shared-raster-cache-size=64"});
+  settings = SettingsFromCommandLine(command_line);
+  EXPECT_EQ(settings.shared_raster_cache_max_bytes, 64u << 20);
+}
+
+TEST(SwitchesTest, RasterCacheAdmitDisplayListsByCost) {
+  fml::CommandLine command_line =
+      fml::CommandLineFromInitializerList({"command"});
+  Settings settings = SettingsFromCommandLine(command_line);
+  EXPECT_FALSE(settings.raster_cache_admit_display_lists_by_cost);
+
+  command_line = fml::CommandLineFromInitializerList(
+      {"command", "--raster-cache-admit-display-lists-by-cost"});
+  settings = SettingsFromCommandLine(command_line);
+  EXPECT_TRUE(settings.raster_cache_admit_display_lists_by_cost);
+}
+
+TEST(SwitchesTest, RasterCacheScaleBucketStep) {
+  fml::CommandLine command_line =
+      fml::CommandLineFromInitializerList({"command"});
+  Settings settings = SettingsFromCommandLine(command_line);
+  EXPECT_EQ(settings.raster_cache_scale_bucket_step, 0.0f);
+
+  command_line = fml::CommandLineFromInitializerList(
+      {"command", "--raster-cache-scale-bucket-step=1.5"});
+  settings = SettingsFromCommandLine(command_line);
+  EXPECT_EQ(settings.raster_cache_scale_bucket_step, 1.5f);
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -119,6 +119,25 @@ void VsyncWaiter::FireCallback(fml::TimePoint frame_start_time,
     return;
   }
 
+  fml::TimePoint callback_time = frame_start_time;
+  if (callback && frame_time_predictor_) {
+    callback_time = frame_start_time +
+                    frame_time_predictor_->GetFrameStartDelay(
+                        frame_start_time, frame_target_time);
+  }
+  const bool late_latch = callback_time > frame_start_time;
+  if (late_latch) {
+    // Run the secondary callbacks, which dispatch pending pointer data, right
+    // before the frame so that it sees the latest input. Dart microtasks are
+    // not paused as that would hold them back for the whole delay.
+    for (auto& secondary_callback : secondary_callbacks) {
+      task_runners_.GetUITaskRunner()->PostTaskForTime(
+          std::move(secondary_callback), callback_time);
+    }
+    secondary_callbacks.clear();
+    pause_secondary_tasks = false;
+  }
+
   if (callback) {
     auto flow_identifier = fml::tracing::TraceNonce();
     if (pause_secondary_tasks) {
@@ -136,21 +155,25 @@ void VsyncWaiter::FireCallback(fml::TimePoint frame_start_time,
     fml::TaskQueueId ui_task_queue_id =
         task_runners_.GetUITaskRunner()->GetTaskQueueId();
 
-    task_runners_.GetUITaskRunner()->PostTask(
-        [ui_task_queue_id, callback, flow_identifier, frame_start_time,
-         frame_target_time, pause_secondary_tasks]() {
-          FML_TRACE_EVENT("flutter", kVsyncTraceName, "StartTime",
-                          frame_start_time, "TargetTime", frame_target_time);
-          std::unique_ptr<FrameTimingsRecorder> frame_timings_recorder =
-              std::make_unique<FrameTimingsRecorder>();
-          frame_timings_recorder->RecordVsync(frame_start_time,
-                                              frame_target_time);
-          callback(std::move(frame_timings_recorder));
-          TRACE_FLOW_END("flutter", kVsyncFlowName, flow_identifier);
-          if (pause_secondary_tasks) {
-            ResumeDartMicroTasks(ui_task_queue_id);
-          }
-        });
+    auto task = [ui_task_queue_id, callback, flow_identifier, frame_start_time,
+                 frame_target_time, pause_secondary_tasks]() {
+      FML_TRACE_EVENT("flutter", kVsyncTraceName, "StartTime", frame_start_time,
+                      "TargetTime", frame_target_time);
+      std::unique_ptr<FrameTimingsRecorder> frame_timings_recorder =
+          std::make_unique<FrameTimingsRecorder>();
+      frame_timings_recorder->RecordVsync(frame_start_time, frame_target_time);
+      callback(std::move(frame_timings_recorder));
+      TRACE_FLOW_END("flutter", kVsyncFlowName, flow_identifier);
+      if (pause_secondary_tasks) {
+        ResumeDartMicroTasks(ui_task_queue_id);
+      }
+    };
+    if (late_latch) {
+      task_runners_.GetUITaskRunner()->PostTaskForTime(std::move(task),
+                                                       callback_time);
+    } else {
+      task_runners_.GetUITaskRunner()->PostTask(std::move(task));
+    }
   }
 
   for (auto& secondary_callback : secondary_callbacks) {
@@ -159,6 +182,11 @@ void VsyncWaiter::FireCallback(fml::TimePoint frame_start_time,
   }
 }
 
+void VsyncWaiter::SetFrameTimePredictor(
+    std::shared_ptr<FrameTimePredictor> predictor) {
+  frame_time_predictor_ = std::move(predictor);
+}
+
 void VsyncWaiter::PauseDartMicroTasks() {
   auto ui_task_queue_id = task_runners_.GetUITaskRunner()->GetTaskQueueId();
   auto task_queues = fml::MessageLoopTaskQueues::GetInstance();
@@ -13,6 +13,7 @@
 #include "flutter/common/task_runners.h"
 #include "flutter/flow/frame_timings.h"
 #include "flutter/fml/time/time_point.h"
+#include "flutter/shell/common/frame_time_predictor.h"
 
 namespace flutter {
 
@@ -32,6 +33,14 @@ class VsyncWaiter : public std::enable_shared_from_this<VsyncWaiter> {
   /// |Animator::ScheduleMaybeClearTraceFlowIds|.
   void ScheduleSecondaryCallback(uintptr_t id, const fml::closure& callback);
 
+  /// Start frames at the time predicted by |predictor| instead of at vsync.
+  ///
+  /// The frame callback and the secondary callbacks are delayed until just
+  /// before the frame has to start to meet its deadline, so that pointer data
+  /// that arrives in the meantime is latched into the frame. Must be called
+  /// before the first vsync is requested.
+  void SetFrameTimePredictor(std::shared_ptr<FrameTimePredictor> predictor);
+
  protected:
   // On some backends, the |FireCallback| needs to be made from a static C
   // method.
@@ -75,6 +84,7 @@ class VsyncWaiter : public std::enable_shared_from_this<VsyncWaiter> {
   std::mutex callback_mutex_;
   Callback callback_;
   std::unordered_map<uintptr_t, fml::closure> secondary_callbacks_;
+  std::shared_ptr<FrameTimePredictor> frame_time_predictor_;
 
   void PauseDartMicroTasks();
   static void ResumeDartMicroTasks(fml::TaskQueueId ui_task_queue_id);
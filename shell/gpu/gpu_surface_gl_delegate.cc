@@ -16,8 +16,8 @@ bool GPUSurfaceGLDelegate::GLContextFBOResetAfterPresent() const {
   return false;
 }
 
-SurfaceFrame::FramebufferInfo GPUSurfaceGLDelegate::GLContextFramebufferInfo()
-    const {
+SurfaceFrame::FramebufferInfo GPUSurfaceGLDelegate::GLContextFramebufferInfo(
+    uint32_t fbo_id) const {
   SurfaceFrame::FramebufferInfo res;
   res.supports_readback = true;
   return res;
@@ -5,6 +5,8 @@
 #ifndef FLUTTER_SHELL_GPU_GPU_SURFACE_GL_DELEGATE_H_
 #define FLUTTER_SHELL_GPU_GPU_SURFACE_GL_DELEGATE_H_
 
+#include <optional>
+
 #include "flutter/common/graphics/gl_context_switch.h"
 #include "flutter/flow/embedded_views.h"
 #include "flutter/fml/macros.h"
@@ -20,6 +22,21 @@ struct GLFrameInfo {
   uint32_t height;
 };
 
+// A structure to represent the information passed to the embedder when the
+// main GL surface is presented.
+struct GLPresentInfo {
+  uint32_t fbo_id;
+
+  // The area of the surface that changed since the previous frame. When
+  // unspecified, the entire surface must be considered damaged.
+  std::optional<SkIRect> frame_damage;
+
+  // The area of the presented framebuffer that changed since that same
+  // framebuffer was last presented. When unspecified, the entire framebuffer
+  // must be considered damaged.
+  std::optional<SkIRect> buffer_damage;
+};
+
 class GPUSurfaceGLDelegate {
  public:
   ~GPUSurfaceGLDelegate();
@@ -33,7 +50,7 @@ class GPUSurfaceGLDelegate {
 
   // Called to present the main GL surface. This is only called for the main GL
   // context and not any of the contexts dedicated for IO.
-  virtual bool GLContextPresent(uint32_t fbo_id) = 0;
+  virtual bool GLContextPresent(const GLPresentInfo& present_info) = 0;
 
   // The ID of the main window bound framebuffer. Typically FBO0.
   virtual intptr_t GLContextFBO(GLFrameInfo frame_info) const = 0;
@@ -45,8 +62,11 @@ class GPUSurfaceGLDelegate {
   // rendering subsequent frames.
   virtual bool GLContextFBOResetAfterPresent() const;
 
-  // Returns framebuffer info for current backbuffer
-  virtual SurfaceFrame::FramebufferInfo GLContextFramebufferInfo() const;
+  // Returns framebuffer info for the backbuffer backed by the given FBO. To
+  // enable partial repaint, delegates must report the existing damage of the
+  // backbuffer here.
+  virtual SurfaceFrame::FramebufferInfo GLContextFramebufferInfo(
+      uint32_t fbo_id) const;
 
   // A transformation applied to the onscreen surface before the canvas is
   // flushed.
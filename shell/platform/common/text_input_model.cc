@@ -36,7 +36,7 @@ TextInputModel::~TextInputModel() = default;
 void TextInputModel::SetText(const std::string& text) {
   std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t>
       utf16_converter;
-  text_ = utf16_converter.from_bytes(text);
+  text_ = TextRope(utf16_converter.from_bytes(text));
   selection_ = TextRange(0);
   composing_range_ = TextRange(0);
 }
@@ -292,16 +292,11 @@ bool TextInputModel::MoveCursorBack() {
 std::string TextInputModel::GetText() const {
   std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t>
       utf8_converter;
-  return utf8_converter.to_bytes(text_);
+  return utf8_converter.to_bytes(text_.ToString());
 }
 
 int TextInputModel::GetCursorOffset() const {
-  // Measure the length of the current text up to the selection extent.
-  // There is probably a much more efficient way of doing this.
-  auto leading_text = text_.substr(0, selection_.extent());
-  std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t>
-      utf8_converter;
-  return utf8_converter.to_bytes(leading_text).size();
+  return text_.Utf8Offset(selection_.extent());
 }
 
 }  // namespace flutter
@@ -9,12 +9,15 @@
 #include <string>
 
 #include "flutter/shell/platform/common/text_range.h"
+#include "flutter/shell/platform/common/text_rope.h"
 
 namespace flutter {
 
 // Handles underlying text input state, using a simple ASCII model.
 //
-// Ignores special states like "insert mode" for now.
+// The text is held in a |TextRope|, so that edits and cursor offset queries
+// stay fast in large documents. Ignores special states like "insert mode" for
+// now.
 class TextInputModel {
  public:
   TextInputModel();
@@ -176,6 +179,8 @@ class TextInputModel {
 
   // Gets the cursor position as a byte offset in UTF-8 string returned from
   // GetText().
+  //
+  // Unlike GetText(), this does not depend on the length of the text.
   int GetCursorOffset() const;
 
   // Returns a range covering the entire text.
@@ -192,6 +197,17 @@ class TextInputModel {
   // Whether multi-step input composing mode is active.
   bool composing() const { return composing_; }
 
+  // The range of the current text that |AddText| or |UpdateComposingText|
+  // replace with new text.
+  //
+  // This is the selection if it is not collapsed, as it is deleted first, and
+  // otherwise the composing range in composing mode or the selection outside
+  // of it. |UpdateComposingText| leaves the text unchanged if both |text| and
+  // the composing range are empty, which callers must handle themselves.
+  TextRange GetReplacedRange() const {
+    return composing_ && selection_.collapsed() ? composing_range_ : selection_;
+  }
+
  private:
   // Deletes the current selection, if any.
   //
@@ -207,7 +223,7 @@ class TextInputModel {
     return composing_ ? composing_range_ : text_range();
   }
 
-  std::u16string text_;
+  TextRope text_;
   TextRange selection_ = TextRange(0);
   TextRange composing_range_ = TextRange(0);
   bool composing_ = false;
@@ -0,0 +1,59 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/common/text_input_model.h"
+
+#include "flutter/benchmarking/benchmarking.h"
+
+namespace flutter {
+
+// Creates a model holding a document of the given length in bytes, with the
+// cursor in the middle.
+static std::unique_ptr<TextInputModel> CreateModel(int64_t length) {
+  std::string line = "The quick brown fox jumps over the lazy dog.\n";
+  std::string text;
+  text.reserve(length + line.length());
+  while (static_cast<int64_t>(text.length()) < length) {
+    text += line;
+  }
+  auto model = std::make_unique<TextInputModel>();
+  model->SetText(text);
+  model->SetSelection(TextRange(text.length() / 2));
+  return model;
+}
+
+static void BM_TypeIntoDocument(benchmark::State& state) {
+  auto model = CreateModel(state.range(0));
+  while (state.KeepRunning()) {
+    model->AddCodePoint('a');
+    benchmark::DoNotOptimize(model->GetCursorOffset());
+  }
+}
+BENCHMARK(BM_TypeIntoDocument)->Range(1 << 10, 4 << 20);
+
+static void BM_TypeAndDeleteInDocument(benchmark::State& state) {
+  auto model = CreateModel(state.range(0));
+  while (state.KeepRunning()) {
+    model->AddText(u"ab");
+    model->Backspace();
+    model->MoveCursorBack();
+    model->Delete();
+  }
+}
+BENCHMARK(BM_TypeAndDeleteInDocument)->Range(1 << 10, 4 << 20);
+
+static void BM_ComposeInDocument(benchmark::State& state) {
+  auto model = CreateModel(state.range(0));
+  while (state.KeepRunning()) {
+    model->BeginComposing();
+    model->UpdateComposingText(u"k");
+    model->UpdateComposingText(u"ka");
+    model->UpdateComposingText(u"か");
+    model->CommitComposing();
+    model->EndComposing();
+  }
+}
+BENCHMARK(BM_ComposeInDocument)->Range(1 << 10, 4 << 20);
+
+}  // namespace flutter
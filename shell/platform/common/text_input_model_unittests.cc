@@ -1688,6 +1688,33 @@ TEST(TextInputModel, SelectToEndEndReverseComposing) {
   EXPECT_STREQ(model->GetText().c_str(), "ABCDE");
 }
 
+TEST(TextInputModel, GetReplacedRange) {
+  auto model = std::make_unique<TextInputModel>();
+  model->SetText("ABCDE");
+  EXPECT_TRUE(model->SetSelection(TextRange(1, 3)));
+  EXPECT_EQ(model->GetReplacedRange(), TextRange(1, 3));
+  EXPECT_TRUE(model->SetSelection(TextRange(2)));
+  EXPECT_EQ(model->GetReplacedRange(), TextRange(2));
+  model->BeginComposing();
+  model->UpdateComposingText("xy");
+  EXPECT_EQ(model->GetReplacedRange(), TextRange(2, 4));
+}
+
+TEST(TextInputModel, GetReplacedRangeComposingOverSelection) {
+  auto model = std::make_unique<TextInputModel>();
+  model->SetText("ABCDE");
+  EXPECT_TRUE(model->SetSelection(TextRange(1, 4)));
+  model->BeginComposing();
+  // The composing range is still collapsed, but the selection is deleted by
+  // the first update.
+  EXPECT_EQ(model->composing_range(), TextRange(1));
+  EXPECT_EQ(model->GetReplacedRange(), TextRange(1, 4));
+  model->UpdateComposingText("x");
+  EXPECT_STREQ(model->GetText().c_str(), "AxE");
+  EXPECT_EQ(model->composing_range(), TextRange(1, 2));
+  EXPECT_EQ(model->GetReplacedRange(), TextRange(1, 2));
+}
+
 TEST(TextInputModel, GetCursorOffset) {
   auto model = std::make_unique<TextInputModel>();
   // These characters take 1, 2, 3 and 4 bytes in UTF-8.
@@ -0,0 +1,287 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/common/text_rope.h"
+
+#include <algorithm>
+
+#include "flutter/fml/logging.h"
+
+namespace flutter {
+
+namespace {
+
+// Returns the number of bytes |code_unit| takes up in UTF-8. Each half of a
+// surrogate pair accounts for half of the four bytes of the code point.
+size_t Utf8Length(char16_t code_unit) {
+  if (code_unit < 0x80) {
+    return 1;
+  }
+  if (code_unit < 0x800 || (code_unit & 0xF800) == 0xD800) {
+    return 2;
+  }
+  return 3;
+}
+
+size_t Utf8Length(const char16_t* text, size_t length) {
+  size_t utf8_length = 0;
+  for (size_t i = 0; i < length; i++) {
+    utf8_length += Utf8Length(text[i]);
+  }
+  return utf8_length;
+}
+
+}  // namespace
+
+struct TextRope::Node {
+  Node(std::u16string node_text, uint32_t node_priority)
+      : text(std::move(node_text)), priority(node_priority) {
+    UpdateText();
+  }
+
+  // Recomputes the cached UTF-8 length of |text|, then the subtree totals.
+  void UpdateText() {
+    text_utf8_length = Utf8Length(text.data(), text.length());
+    Update();
+  }
+
+  // Recomputes the subtree totals from the children.
+  void Update() {
+    length = text.length();
+    utf8_length = text_utf8_length;
+    if (left) {
+      length += left->length;
+      utf8_length += left->utf8_length;
+    }
+    if (right) {
+      length += right->length;
+      utf8_length += right->utf8_length;
+    }
+  }
+
+  size_t left_length() const { return left ? left->length : 0; }
+
+  std::u16string text;
+  size_t text_utf8_length = 0;
+  uint32_t priority;
+
+  // Totals for the subtree rooted at this node.
+  size_t length = 0;
+  size_t utf8_length = 0;
+
+  std::unique_ptr<Node> left;
+  std::unique_ptr<Node> right;
+};
+
+TextRope::TextRope() = default;
+
+TextRope::TextRope(const std::u16string& text) : root_(Build(text)) {}
+
+TextRope::~TextRope() = default;
+
+TextRope::TextRope(TextRope&& other) = default;
+
+TextRope& TextRope::operator=(TextRope&& other) = default;
+
+size_t TextRope::length() const {
+  return root_ ? root_->length : 0;
+}
+
+char16_t TextRope::at(size_t position) const {
+  FML_DCHECK(position < length());
+  const Node* node = root_.get();
+  while (node) {
+    size_t left_length = node->left_length();
+    if (position < left_length) {
+      node = node->left.get();
+    } else if (position < left_length + node->text.length()) {
+      return node->text[position - left_length];
+    } else {
+      position -= left_length + node->text.length();
+      node = node->right.get();
+    }
+  }
+  return 0;
+}
+
+void TextRope::insert(size_t position, const std::u16string& text) {
+  replace(position, 0, text);
+}
+
+void TextRope::erase(size_t position, size_t length) {
+  replace(position, length, std::u16string());
+}
+
+void TextRope::replace(size_t position,
+                       size_t length,
+                       const std::u16string& text) {
+  FML_DCHECK(position <= this->length());
+  length = std::min(length, this->length() - position);
+  if (length == 0 && text.empty()) {
+    return;
+  }
+  // Typing and deleting characters usually stays within one chunk.
+  if (root_ && ReplaceInChunk(root_.get(), position, length, text)) {
+    return;
+  }
+  std::unique_ptr<Node> left;
+  std::unique_ptr<Node> middle;
+  std::unique_ptr<Node> right;
+  Split(std::move(root_), position, &left, &right);
+  Split(std::move(right), length, &middle, &right);
+  root_ = Merge(Merge(std::move(left), Build(text)), std::move(right));
+}
+
+std::u16string TextRope::substr(size_t position, size_t length) const {
+  std::u16string result;
+  if (position >= this->length()) {
+    return result;
+  }
+  length = std::min(length, this->length() - position);
+  result.reserve(length);
+  AppendRange(root_.get(), position, position + length, &result);
+  return result;
+}
+
+std::u16string TextRope::ToString() const {
+  return substr(0, length());
+}
+
+size_t TextRope::Utf8Offset(size_t position) const {
+  FML_DCHECK(position <= length());
+  size_t offset = 0;
+  const Node* node = root_.get();
+  while (node && position > 0) {
+    size_t left_length = node->left_length();
+    if (position <= left_length) {
+      node = node->left.get();
+      continue;
+    }
+    if (node->left) {
+      offset += node->left->utf8_length;
+    }
+    position -= left_length;
+    if (position <= node->text.length()) {
+      return offset + Utf8Length(node->text.data(), position);
+    }
+    offset += node->text_utf8_length;
+    position -= node->text.length();
+    node = node->right.get();
+  }
+  return offset;
+}
+
+void TextRope::Split(std::unique_ptr<Node> node,
+                     size_t position,
+                     std::unique_ptr<Node>* left,
+                     std::unique_ptr<Node>* right) {
+  if (!node) {
+    left->reset();
+    right->reset();
+    return;
+  }
+  size_t left_length = node->left_length();
+  size_t text_end = left_length + node->text.length();
+  if (position <= left_length) {
+    Split(std::move(node->left), position, left, &node->left);
+    node->Update();
+    *right = std::move(node);
+  } else if (position >= text_end) {
+    Split(std::move(node->right), position - text_end, &node->right, right);
+    node->Update();
+    *left = std::move(node);
+  } else {
+    // The split point is inside this chunk. The second half takes over the
+    // right subtree and keeps the priority, so both halves remain valid heaps.
+    size_t offset = position - left_length;
+    auto tail =
+        std::make_unique<Node>(node->text.substr(offset), node->priority);
+    tail->right = std::move(node->right);
+    tail->Update();
+    node->text.resize(offset);
+    node->UpdateText();
+    *left = std::move(node);
+    *right = std::move(tail);
+  }
+}
+
+std::unique_ptr<TextRope::Node> TextRope::Merge(std::unique_ptr<Node> left,
+                                                std::unique_ptr<Node> right) {
+  if (!left) {
+    return right;
+  }
+  if (!right) {
+    return left;
+  }
+  if (left->priority > right->priority) {
+    left->right = Merge(std::move(left->right), std::move(right));
+    left->Update();
+    return left;
+  }
+  right->left = Merge(std::move(left), std::move(right->left));
+  right->Update();
+  return right;
+}
+
+bool TextRope::ReplaceInChunk(Node* node,
+                              size_t position,
+                              size_t length,
+                              const std::u16string& text) {
+  size_t left_length = node->left_length();
+  size_t text_end = left_length + node->text.length();
+  bool replaced = false;
+  if (position >= left_length && position + length <= text_end) {
+    if (node->text.length() - length + text.length() > kMaxChunkLength) {
+      return false;
+    }
+    node->text.replace(position - left_length, length, text);
+    node->UpdateText();
+    return true;
+  }
+  if (position + length <= left_length && node->left) {
+    replaced = ReplaceInChunk(node->left.get(), position, length, text);
+  } else if (position >= text_end && node->right) {
+    replaced =
+        ReplaceInChunk(node->right.get(), position - text_end, length, text);
+  }
+  if (replaced) {
+    node->Update();
+  }
+  return replaced;
+}
+
+void TextRope::AppendRange(const Node* node,
+                           size_t start,
+                           size_t end,
+                           std::u16string* result) {
+  if (!node || start >= end) {
+    return;
+  }
+  size_t left_length = node->left_length();
+  size_t text_end = left_length + node->text.length();
+  if (start < left_length) {
+    AppendRange(node->left.get(), start, std::min(end, left_length), result);
+  }
+  size_t text_start = std::max(start, left_length);
+  if (text_start < std::min(end, text_end)) {
+    result->append(node->text, text_start - left_length,
+                   std::min(end, text_end) - text_start);
+  }
+  if (end > text_end) {
+    AppendRange(node->right.get(), std::max(start, text_end) - text_end,
+                end - text_end, result);
+  }
+}
+
+std::unique_ptr<TextRope::Node> TextRope::Build(const std::u16string& text) {
+  std::unique_ptr<Node> root;
+  for (size_t start = 0; start < text.length(); start += kMaxChunkLength) {
+    root = Merge(std::move(root),
+                 std::make_unique<Node>(text.substr(start, kMaxChunkLength),
+                                        priorities_()));
+  }
+  return root;
+}
+
+}  // namespace flutter
@@ -0,0 +1,102 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_COMMON_TEXT_ROPE_H_
+#define FLUTTER_SHELL_PLATFORM_COMMON_TEXT_ROPE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+
+namespace flutter {
+
+// A UTF-16 string that supports editing large texts.
+//
+// The text is stored in chunks of limited length, held in a balanced tree
+// (a treap ordered by position). Edits, random access and conversion of
+// positions to UTF-8 offsets take time logarithmic in the length of the text;
+// only edits that cross a chunk boundary allocate new chunks.
+//
+// Positions and lengths are in UTF-16 code units, as in std::u16string.
+class TextRope {
+ public:
+  TextRope();
+  explicit TextRope(const std::u16string& text);
+  ~TextRope();
+
+  TextRope(TextRope&& other);
+  TextRope& operator=(TextRope&& other);
+
+  // The length of the text in UTF-16 code units.
+  size_t length() const;
+
+  // Whether the text is empty.
+  bool empty() const { return length() == 0; }
+
+  // Returns the code unit at |position|, which must be less than |length()|.
+  char16_t at(size_t position) const;
+
+  // Inserts |text| before |position|.
+  void insert(size_t position, const std::u16string& text);
+
+  // Removes |length| code units starting at |position|.
+  void erase(size_t position, size_t length);
+
+  // Replaces |length| code units starting at |position| with |text|.
+  void replace(size_t position, size_t length, const std::u16string& text);
+
+  // Returns |length| code units starting at |position|. The range is clamped
+  // to the end of the text.
+  std::u16string substr(size_t position, size_t length) const;
+
+  // Returns the whole text.
+  std::u16string ToString() const;
+
+  // Returns the length in bytes of the UTF-8 encoding of the first |position|
+  // code units.
+  size_t Utf8Offset(size_t position) const;
+
+  // The maximum number of code units stored in a single chunk.
+  static constexpr size_t kMaxChunkLength = 1024;
+
+ private:
+  struct Node;
+
+  // Splits |node| so that |left| holds the first |position| code units and
+  // |right| holds the rest.
+  static void Split(std::unique_ptr<Node> node,
+                    size_t position,
+                    std::unique_ptr<Node>* left,
+                    std::unique_ptr<Node>* right);
+
+  // Concatenates two trees.
+  static std::unique_ptr<Node> Merge(std::unique_ptr<Node> left,
+                                     std::unique_ptr<Node> right);
+
+  // Replaces a range in place if it lies within a single chunk that has room
+  // for |text|. Returns false if the tree must be restructured instead.
+  static bool ReplaceInChunk(Node* node,
+                             size_t position,
+                             size_t length,
+                             const std::u16string& text);
+
+  // Appends the code units of |node| in the range [start, end), relative to
+  // the start of the subtree, to |result|.
+  static void AppendRange(const Node* node,
+                          size_t start,
+                          size_t end,
+                          std::u16string* result);
+
+  // Builds a tree of chunks holding |text|.
+  std::unique_ptr<Node> Build(const std::u16string& text);
+
+  std::unique_ptr<Node> root_;
+  std::minstd_rand priorities_;
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_PLATFORM_COMMON_TEXT_ROPE_H_
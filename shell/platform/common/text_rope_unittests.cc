@@ -0,0 +1,93 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/common/text_rope.h"
+
+#include <random>
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+
+TEST(TextRope, Empty) {
+  TextRope rope;
+  EXPECT_TRUE(rope.empty());
+  EXPECT_EQ(rope.length(), 0u);
+  EXPECT_EQ(rope.ToString(), u"");
+  EXPECT_EQ(rope.Utf8Offset(0), 0u);
+}
+
+TEST(TextRope, InsertAndErase) {
+  TextRope rope(u"ABCDE");
+  rope.insert(2, u"xyz");
+  EXPECT_EQ(rope.ToString(), u"ABxyzCDE");
+  rope.erase(1, 3);
+  EXPECT_EQ(rope.ToString(), u"AzCDE");
+  rope.replace(4, 1, u"FG");
+  EXPECT_EQ(rope.ToString(), u"AzCDFG");
+  EXPECT_EQ(rope.at(2), u'C');
+  EXPECT_EQ(rope.substr(1, 3), u"zCD");
+  EXPECT_EQ(rope.substr(4, 10), u"FG");
+}
+
+TEST(TextRope, EraseClampsToEnd) {
+  TextRope rope(u"ABCDE");
+  rope.erase(3, 10);
+  EXPECT_EQ(rope.ToString(), u"ABC");
+}
+
+TEST(TextRope, Utf8Offset) {
+  // 1, 2, 3 and 4 byte characters.
+  TextRope rope(u"Aé中\U0001f604B");
+  EXPECT_EQ(rope.length(), 6u);
+  EXPECT_EQ(rope.Utf8Offset(1), 1u);
+  EXPECT_EQ(rope.Utf8Offset(2), 3u);
+  EXPECT_EQ(rope.Utf8Offset(3), 6u);
+  EXPECT_EQ(rope.Utf8Offset(5), 10u);
+  EXPECT_EQ(rope.Utf8Offset(6), 11u);
+}
+
+TEST(TextRope, SpansChunks) {
+  std::u16string text(TextRope::kMaxChunkLength * 3 + 7, u'a');
+  TextRope rope(text);
+  EXPECT_EQ(rope.length(), text.length());
+
+  size_t position = TextRope::kMaxChunkLength - 2;
+  std::u16string inserted(TextRope::kMaxChunkLength + 5, u'b');
+  rope.insert(position, inserted);
+  text.insert(position, inserted);
+  EXPECT_EQ(rope.ToString(), text);
+
+  rope.erase(10, TextRope::kMaxChunkLength * 2);
+  text.erase(10, TextRope::kMaxChunkLength * 2);
+  EXPECT_EQ(rope.ToString(), text);
+  EXPECT_EQ(rope.Utf8Offset(rope.length()), text.length());
+}
+
+TEST(TextRope, MatchesStringAfterRandomEdits) {
+  std::minstd_rand random(42);
+  std::u16string text;
+  TextRope rope;
+  for (int i = 0; i < 2000; i++) {
+    size_t position = random() % (text.length() + 1);
+    if (random() % 3 == 0) {
+      size_t length = random() % 64;
+      rope.erase(position, length);
+      text.erase(position, length);
+    } else {
+      std::u16string inserted(random() % (i % 100 == 0 ? 3000 : 4),
+                              static_cast<char16_t>(u'a' + i % 26));
+      rope.insert(position, inserted);
+      text.insert(position, inserted);
+    }
+    ASSERT_EQ(rope.length(), text.length());
+  }
+  EXPECT_EQ(rope.ToString(), text);
+  for (size_t position = 0; position < text.length(); position += 97) {
+    EXPECT_EQ(rope.at(position), text[position]);
+    EXPECT_EQ(rope.substr(position, 50), text.substr(position, 50));
+  }
+}
+
+}  // namespace flutter
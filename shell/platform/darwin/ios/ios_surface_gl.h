@@ -38,13 +38,14 @@ class IOSSurfaceGL final : public IOSSurface, public GPUSurfaceGLDelegate {
   bool GLContextClearCurrent() override;
 
   // |GPUSurfaceGLDelegate|
-  bool GLContextPresent(uint32_t fbo_id) override;
+  bool GLContextPresent(const GLPresentInfo& present_info) override;
 
   // |GPUSurfaceGLDelegate|
   intptr_t GLContextFBO(GLFrameInfo frame_info) const override;
 
   // |GPUSurfaceGLDelegate|
-  SurfaceFrame::FramebufferInfo GLContextFramebufferInfo() const override;
+  SurfaceFrame::FramebufferInfo GLContextFramebufferInfo(
+      uint32_t fbo_id) const override;
 
   // |GPUSurfaceGLDelegate|
   bool AllowsDrawingWhenGpuDisabled() const override;
@@ -56,7 +56,7 @@ intptr_t IOSSurfaceGL::GLContextFBO(GLFrameInfo frame_info) const {
 }
 
 // |GPUSurfaceGLDelegate|
-SurfaceFrame::FramebufferInfo IOSSurfaceGL::GLContextFramebufferInfo() const {
+SurfaceFrame::FramebufferInfo IOSSurfaceGL::GLContextFramebufferInfo(uint32_t fbo_id) const {
   SurfaceFrame::FramebufferInfo res;
   // The onscreen surface wraps a GL renderbuffer, which is extremely slow to read on iOS.
   // Certain filter effects, in particular BackdropFilter, require making a copy of
@@ -86,7 +86,7 @@ bool IOSSurfaceGL::GLContextClearCurrent() {
 }
 
 // |GPUSurfaceGLDelegate|
-bool IOSSurfaceGL::GLContextPresent(uint32_t fbo_id) {
+bool IOSSurfaceGL::GLContextPresent(const GLPresentInfo& present_info) {
   TRACE_EVENT0("flutter", "IOSSurfaceGL::GLContextPresent");
   return IsValid() && render_target_->PresentRenderBuffer();
 }
@@ -128,6 +128,13 @@ static bool IsOpenGLRendererConfigValid(const FlutterRendererConfig* config) {
     return false;
   }
 
+  // Partial repaint is only useful if the embedder can be told which areas
+  // were damaged when the frame is presented.
+  if (SAFE_EXISTS(open_gl_config, populate_existing_damage) &&
+      !SAFE_EXISTS(open_gl_config, present_with_info)) {
+    return false;
+  }
+
   return true;
 }
 
@@ -196,6 +203,20 @@ static void* DefaultGLProcResolver(const char* name) {
 }
 #endif  // OS_LINUX || OS_WIN
 
+#ifdef SHELL_ENABLE_GL
+static FlutterRect SkIRectToFlutterRect(const SkIRect& rect) {
+  return FlutterRect{static_cast<double>(rect.fLeft),
+                     static_cast<double>(rect.fTop),
+                     static_cast<double>(rect.fRight),
+                     static_cast<double>(rect.fBottom)};
+}
+
+static SkIRect FlutterRectToSkIRect(const FlutterRect& rect) {
+  return SkRect::MakeLTRB(rect.left, rect.top, rect.right, rect.bottom)
+      .roundOut();
+}
+#endif  // SHELL_ENABLE_GL
+
 static flutter::Shell::CreateCallback<flutter::PlatformView>
 InferOpenGLPlatformViewCreationCallback(
     const FlutterRendererConfig* config,
@@ -215,15 +236,34 @@ InferOpenGLPlatformViewCreationCallback(
   auto gl_clear_current = [ptr = config->open_gl.clear_current,
                            user_data]() -> bool { return ptr(user_data); };
 
-  auto gl_present = [present = config->open_gl.present,
-                     present_with_info = config->open_gl.present_with_info,
-                     user_data](uint32_t fbo_id) -> bool {
+  auto gl_present =
+      [present = config->open_gl.present,
+       present_with_info = config->open_gl.present_with_info,
+       user_data](const flutter::GLPresentInfo& gl_present_info) -> bool {
     if (present) {
       return present(user_data);
     } else {
+      // Unspecified damage is reported as zero rects, which the embedder must
+      // treat as the entire surface being damaged.
+      FlutterRect frame_damage_rect = {};
+      FlutterRect buffer_damage_rect = {};
+
       FlutterPresentInfo present_info = {};
       present_info.struct_size = sizeof(FlutterPresentInfo);
-      present_info.fbo_id = fbo_id;
+      present_info.fbo_id = gl_present_info.fbo_id;
+      present_info.frame_damage.struct_size = sizeof(FlutterDamage);
+      present_info.buffer_damage.struct_size = sizeof(FlutterDamage);
+      if (gl_present_info.frame_damage.has_value()) {
+        frame_damage_rect = SkIRectToFlutterRect(*gl_present_info.frame_damage);
+        present_info.frame_damage.num_rects = 1;
+        present_info.frame_damage.damage = &frame_damage_rect;
+      }
+      if (gl_present_info.buffer_damage.has_value()) {
+        buffer_damage_rect =
+            SkIRectToFlutterRect(*gl_present_info.buffer_damage);
+        present_info.buffer_damage.num_rects = 1;
+        present_info.buffer_damage.damage = &buffer_damage_rect;
+      }
       return present_with_info(user_data, &present_info);
     }
   };
@@ -289,6 +329,29 @@ InferOpenGLPlatformViewCreationCallback(
 #endif
   }
 
+  std::function<std::optional<SkIRect>(intptr_t)>
+      gl_populate_existing_damage = nullptr;
+  if (SAFE_ACCESS(open_gl_config, populate_existing_damage, nullptr) !=
+      nullptr) {
+    gl_populate_existing_damage =
+        [ptr = config->open_gl.populate_existing_damage,
+         user_data](intptr_t fbo_id) -> std::optional<SkIRect> {
+      FlutterDamage existing_damage = {};
+      existing_damage.struct_size = sizeof(FlutterDamage);
+      ptr(user_data, fbo_id, &existing_damage);
+
+      // The engine tracks damage as a single rect, so union everything the
+      // embedder reported.
+      SkIRect damage = SkIRect::MakeEmpty();
+      for (size_t i = 0; existing_damage.damage != nullptr &&
+                         i < existing_damage.num_rects;
+           i++) {
+        damage.join(FlutterRectToSkIRect(existing_damage.damage[i]));
+      }
+      return damage;
+    };
+  }
+
   bool fbo_reset_after_present =
       SAFE_ACCESS(open_gl_config, fbo_reset_after_present, false);
 
@@ -300,6 +363,7 @@ InferOpenGLPlatformViewCreationCallback(
       gl_make_resource_current_callback,   // gl_make_resource_current_callback
       gl_surface_transformation_callback,  // gl_surface_transformation_callback
       gl_proc_resolver,                    // gl_proc_resolver
+      gl_populate_existing_damage,         // gl_populate_existing_damage
   };
 
   return fml::MakeCopyable(
@@ -990,6 +1054,10 @@ FlutterEngineResult FlutterEngineInitialize(size_t version,
   settings.assets_path = args->assets_path;
   settings.leak_vm = !SAFE_ACCESS(args, shutdown_dart_vm_when_done, false);
   settings.old_gen_heap_size = SAFE_ACCESS(args, dart_old_gen_heap_size, -1);
+  if (SAFE_ACCESS(args, raster_cache_max_bytes, 0) > 0) {
+    settings.shared_raster_cache_max_bytes =
+        SAFE_ACCESS(args, raster_cache_max_bytes, 0);
+  }
 
   if (!flutter::DartVM::IsRunningPrecompiledCode()) {
     // Verify the assets path contains Dart 2 kernel assets.
@@ -352,6 +352,17 @@ typedef struct {
   FlutterSize lower_left_corner_radius;
 } FlutterRoundedRect;
 
+/// A region represented by a collection of non-overlapping rectangles.
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterDamage).
+  size_t struct_size;
+  /// Number of rectangles in `damage`.
+  size_t num_rects;
+  /// The rectangles that make up the damaged region. The pointer is owned by
+  /// whoever populated the struct.
+  FlutterRect* damage;
+} FlutterDamage;
+
 /// This information is passed to the embedder when requesting a frame buffer
 /// object.
 ///
@@ -376,6 +387,15 @@ typedef struct {
   size_t struct_size;
   /// Id of the fbo backing the surface that was presented.
   uint32_t fbo_id;
+  /// The area of the surface that changed since the previous frame. Embedders
+  /// that can present partial updates (for instance via
+  /// `eglSwapBuffersWithDamageKHR`) only need to recompose this area. If
+  /// `num_rects` is zero, the entire surface must be considered damaged.
+  FlutterDamage frame_damage;
+  /// The area of the fbo that changed since the same fbo was last presented
+  /// (for instance via `eglSetDamageRegionKHR`). If `num_rects` is zero, the
+  /// entire fbo must be considered damaged.
+  FlutterDamage buffer_damage;
 } FlutterPresentInfo;
 
 /// Callback for when a surface is presented.
@@ -383,6 +403,15 @@ typedef bool (*BoolPresentInfoCallback)(
     void* /* user data */,
     const FlutterPresentInfo* /* present info */);
 
+/// Callback for when the engine asks the embedder for the existing damage of
+/// the frame buffer object it is about to render into.
+///
+/// See: \ref FlutterOpenGLRendererConfig.populate_existing_damage.
+typedef void (*FlutterFrameBufferWithDamageCallback)(
+    void* /* user data */,
+    const intptr_t /* fbo id */,
+    FlutterDamage* /* existing damage */);
+
 typedef struct {
   /// The size of this struct. Must be sizeof(FlutterOpenGLRendererConfig).
   size_t struct_size;
@@ -441,6 +470,16 @@ typedef struct {
   /// `FlutterPresentInfo` struct that the embedder can use to release any
   /// resources. The return value indicates success of the present call.
   BoolPresentInfoCallback present_with_info;
+  /// Specifying this callback enables partial repaint. Before rendering each
+  /// frame the engine asks the embedder for the area of the given fbo that
+  /// lags behind the front buffer, which is typically computed from the buffer
+  /// age (`EGL_EXT_buffer_age`) and the `buffer_damage` of previous
+  /// presentations. The embedder must populate `existing_damage`; the engine
+  /// copies the rects right after the callback returns, so they may live in
+  /// storage owned by the embedder and reused. Populating zero rects means
+  /// the fbo is up to date. To force a full repaint, report the entire fbo as
+  /// damaged. This callback is optional and requires `present_with_info`.
+  FlutterFrameBufferWithDamageCallback populate_existing_damage;
 } FlutterOpenGLRendererConfig;
 
 /// Alias for id<MTLDevice>.
@@ -1589,6 +1628,13 @@ typedef struct {
   //
   // The first argument is the `user_data` from `FlutterEngineInitialize`.
   OnPreEngineRestartCallback on_pre_engine_restart_callback;
+
+  /// The size limit in bytes of the raster cache of the engine. The cache
+  /// stops rasterizing new entries while it is over the limit, and shrinks as
+  /// its unused entries are evicted. If zero, the size given with the
+  /// `--shared-raster-cache-size` switch in `command_line_argv` is used, and
+  /// without it, the raster cache grows without bound.
+  size_t raster_cache_max_bytes;
 } FlutterProjectArgs;
 
 #ifndef FLUTTER_ENGINE_NO_PROTOTYPES
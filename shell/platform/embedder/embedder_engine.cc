@@ -9,6 +9,8 @@
 
 namespace flutter {
 
+static constexpr int kNumProfilerSamplesPerSec = 5;
+
 struct ShellArgs {
   Settings settings;
   Shell::CreateCallback<PlatformView> on_create_platform_view;
@@ -57,14 +59,79 @@ bool EmbedderEngine::LaunchShell() {
   // shell again.
   shell_args_.reset();
 
+  if (IsValid()) {
+    StartProfiler();
+  }
+
   return IsValid();
 }
 
 bool EmbedderEngine::CollectShell() {
+  StopProfiler();
   shell_.reset();
   return IsValid();
 }
 
+void EmbedderEngine::StartProfiler() {
+#if OS_LINUX && (FLUTTER_RUNTIME_MODE == FLUTTER_RUNTIME_MODE_DEBUG || \
+                 FLUTTER_RUNTIME_MODE == FLUTTER_RUNTIME_MODE_PROFILE)
+  const std::string& label = task_runners_.GetLabel();
+  profiler_thread_ = std::make_unique<fml::Thread>(label + ".profiler");
+  profiler_metrics_ = std::make_shared<ProfilerMetricsLinux>();
+
+  // Thread names are truncated by the kernel, so the engine threads are
+  // identified by the task runners instead.
+  auto register_thread = [metrics = profiler_metrics_](
+                             const fml::RefPtr<fml::TaskRunner>& task_runner,
+                             std::string name) {
+    task_runner->PostTask([metrics, name = std::move(name)]() {
+      metrics->RegisterCurrentThread(name);
+    });
+  };
+  register_thread(task_runners_.GetPlatformTaskRunner(), "platform");
+  register_thread(task_runners_.GetUITaskRunner(), "ui");
+  register_thread(task_runners_.GetRasterTaskRunner(), "raster");
+  register_thread(task_runners_.GetIOTaskRunner(), "io");
+
+  profiler_ = std::make_unique<SamplingProfiler>(
+      label.c_str(), profiler_thread_->GetTaskRunner(),
+      [metrics = profiler_metrics_,
+       raster_task_runner = task_runners_.GetRasterTaskRunner(),
+       rasterizer = shell_->GetRasterizer()]() {
+        // The caches can only be inspected on the raster thread. The sample
+        // reports their size as of the previous sample.
+        raster_task_runner->PostTask([metrics, rasterizer]() {
+          if (!rasterizer) {
+            return;
+          }
+          const RasterCache& raster_cache =
+              rasterizer->compositor_context()->raster_cache();
+          CacheUsageInfo cache_usage;
+          cache_usage.raster_cache_usage =
+              (raster_cache.EstimateLayerCacheByteSize() +
+               raster_cache.EstimatePictureCacheByteSize()) /
+              (1024.0 * 1024.0);
+          cache_usage.resource_cache_usage =
+              rasterizer->GetResourceCacheBytes().value_or(0) /
+              (1024.0 * 1024.0);
+          metrics->SetCacheUsage(cache_usage);
+        });
+        return metrics->GenerateSample();
+      },
+      kNumProfilerSamplesPerSec);
+  profiler_->Start();
+#endif
+}
+
+void EmbedderEngine::StopProfiler() {
+#if OS_LINUX
+  // The profiler must stop before the rasterizer it samples is collected.
+  profiler_.reset();
+  profiler_thread_.reset();
+  profiler_metrics_.reset();
+#endif  // OS_LINUX
+}
+
 bool EmbedderEngine::RunRootIsolate() {
   if (!IsValid() || !run_configuration_.IsValid()) {
     return false;
@@ -8,12 +8,20 @@
 #include <memory>
 #include <unordered_map>
 
+#include "flutter/fml/build_config.h"
 #include "flutter/fml/macros.h"
+#include "flutter/fml/thread.h"
 #include "flutter/shell/common/shell.h"
 #include "flutter/shell/common/thread_host.h"
 #include "flutter/shell/platform/embedder/embedder.h"
 #include "flutter/shell/platform/embedder/embedder_external_texture_resolver.h"
 #include "flutter/shell/platform/embedder/embedder_thread_host.h"
+#include "flutter/shell/profiling/sampling_profiler.h"
+
+#if OS_LINUX
+#include "flutter/shell/profiling/profiler_metrics_linux.h"
+#endif  // OS_LINUX
+
 namespace flutter {
 
 struct ShellArgs;
@@ -90,6 +98,15 @@ class EmbedderEngine {
   std::unique_ptr<ShellArgs> shell_args_;
   std::unique_ptr<Shell> shell_;
   std::unique_ptr<EmbedderExternalTextureResolver> external_texture_resolver_;
+#if OS_LINUX
+  std::unique_ptr<fml::Thread> profiler_thread_;
+  std::shared_ptr<ProfilerMetricsLinux> profiler_metrics_;
+  std::unique_ptr<SamplingProfiler> profiler_;
+#endif  // OS_LINUX
+
+  void StartProfiler();
+
+  void StopProfiler();
 
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderEngine);
 };
@@ -45,8 +45,8 @@ bool EmbedderSurfaceGL::GLContextClearCurrent() {
 }
 
 // |GPUSurfaceGLDelegate|
-bool EmbedderSurfaceGL::GLContextPresent(uint32_t fbo_id) {
-  return gl_dispatch_table_.gl_present_callback(fbo_id);
+bool EmbedderSurfaceGL::GLContextPresent(const GLPresentInfo& present_info) {
+  return gl_dispatch_table_.gl_present_callback(present_info);
 }
 
 // |GPUSurfaceGLDelegate|
@@ -59,6 +59,18 @@ bool EmbedderSurfaceGL::GLContextFBOResetAfterPresent() const {
   return fbo_reset_after_present_;
 }
 
+// |GPUSurfaceGLDelegate|
+SurfaceFrame::FramebufferInfo EmbedderSurfaceGL::GLContextFramebufferInfo(
+    uint32_t fbo_id) const {
+  auto info = GPUSurfaceGLDelegate::GLContextFramebufferInfo(fbo_id);
+  auto callback = gl_dispatch_table_.gl_populate_existing_damage;
+  if (callback) {
+    info.supports_partial_repaint = true;
+    info.existing_damage = callback(fbo_id);
+  }
+  return info;
+}
+
 // |GPUSurfaceGLDelegate|
 SkMatrix EmbedderSurfaceGL::GLContextSurfaceTransformation() const {
   auto callback = gl_dispatch_table_.gl_surface_transformation_callback;
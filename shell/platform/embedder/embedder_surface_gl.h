@@ -16,14 +16,17 @@ class EmbedderSurfaceGL final : public EmbedderSurface,
                                 public GPUSurfaceGLDelegate {
  public:
   struct GLDispatchTable {
-    std::function<bool(void)> gl_make_current_callback;           // required
-    std::function<bool(void)> gl_clear_current_callback;          // required
-    std::function<bool(uint32_t)> gl_present_callback;            // required
-    std::function<intptr_t(GLFrameInfo)> gl_fbo_callback;         // required
+    std::function<bool(void)> gl_make_current_callback;   // required
+    std::function<bool(void)> gl_clear_current_callback;  // required
+    std::function<bool(const GLPresentInfo&)>
+        gl_present_callback;                               // required
+    std::function<intptr_t(GLFrameInfo)> gl_fbo_callback;  // required
     std::function<bool(void)> gl_make_resource_current_callback;  // optional
     std::function<SkMatrix(void)>
         gl_surface_transformation_callback;              // optional
     std::function<void*(const char*)> gl_proc_resolver;  // optional
+    std::function<std::optional<SkIRect>(intptr_t)>
+        gl_populate_existing_damage;  // optional
   };
 
   EmbedderSurfaceGL(
@@ -56,7 +59,7 @@ class EmbedderSurfaceGL final : public EmbedderSurface,
   bool GLContextClearCurrent() override;
 
   // |GPUSurfaceGLDelegate|
-  bool GLContextPresent(uint32_t fbo_id) override;
+  bool GLContextPresent(const GLPresentInfo& present_info) override;
 
   // |GPUSurfaceGLDelegate|
   intptr_t GLContextFBO(GLFrameInfo frame_info) const override;
@@ -64,6 +67,10 @@ class EmbedderSurfaceGL final : public EmbedderSurface,
   // |GPUSurfaceGLDelegate|
   bool GLContextFBOResetAfterPresent() const override;
 
+  // |GPUSurfaceGLDelegate|
+  SurfaceFrame::FramebufferInfo GLContextFramebufferInfo(
+      uint32_t fbo_id) const override;
+
   // |GPUSurfaceGLDelegate|
   SkMatrix GLContextSurfaceTransformation() const override;
 
@@ -63,6 +63,11 @@ class EmbedderConfigBuilder {
   // test this behavior.
   void SetOpenGLPresentCallBack();
 
+  // Used to set an `open_gl.populate_existing_damage` callback, which enables
+  // partial repaint. The damage reported to the engine can be customized via
+  // `EmbedderTestContextGL::SetGLPopulateExistingDamageCallback`.
+  void SetOpenGLPopulateExistingDamageCallBack();
+
   void SetAssetsPath();
 
   void SetSnapshots();
@@ -3140,8 +3140,104 @@ TEST_F(EmbedderTest, PresentInfoContainsValidFBOId) {
   const uint32_t window_fbo_id =
       static_cast<EmbedderTestContextGL&>(context).GetWindowFBOId();
   static_cast<EmbedderTestContextGL&>(context).SetGLPresentCallback(
-      [window_fbo_id = window_fbo_id, &frame_latch](uint32_t fbo_id) {
-        ASSERT_EQ(fbo_id, window_fbo_id);
+      [window_fbo_id = window_fbo_id,
+       &frame_latch](const FlutterPresentInfo& present_info) {
+        ASSERT_EQ(present_info.fbo_id, window_fbo_id);
+
+        frame_latch.CountDown();
+      });
+
+  frame_latch.Wait();
+}
+
+TEST_F(EmbedderTest, PresentInfoReportsNoDamageWithoutPartialRepaint) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kOpenGLContext);
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetOpenGLRendererConfig(SkISize::Make(1024, 600));
+  builder.SetDartEntrypoint("push_frames_over_and_over");
+
+  auto engine = builder.LaunchEngine();
+
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 1024;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+  ASSERT_TRUE(engine.is_valid());
+
+  fml::CountDownLatch frame_latch(3);
+
+  context.AddNativeCallback("SignalNativeTest",
+                            CREATE_NATIVE_ENTRY([&](Dart_NativeArguments args) {
+                              /* Nothing to do. */
+                            }));
+
+  static_cast<EmbedderTestContextGL&>(context).SetGLPresentCallback(
+      [&frame_latch](const FlutterPresentInfo& present_info) {
+        // Without partial repaint the embedder must assume the entire surface
+        // is damaged, which is signaled by the absence of damage rects.
+        ASSERT_EQ(present_info.frame_damage.num_rects, 0u);
+        ASSERT_EQ(present_info.buffer_damage.num_rects, 0u);
+
+        frame_latch.CountDown();
+      });
+
+  frame_latch.Wait();
+}
+
+TEST_F(EmbedderTest, PresentInfoReportsDamageWithPartialRepaint) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kOpenGLContext);
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetOpenGLRendererConfig(SkISize::Make(1024, 600));
+  builder.SetOpenGLPopulateExistingDamageCallBack();
+  builder.SetDartEntrypoint("push_frames_over_and_over");
+
+  auto engine = builder.LaunchEngine();
+
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 1024;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+  ASSERT_TRUE(engine.is_valid());
+
+  fml::CountDownLatch frame_latch(3);
+
+  context.AddNativeCallback("SignalNativeTest",
+                            CREATE_NATIVE_ENTRY([&](Dart_NativeArguments args) {
+                              /* Nothing to do. */
+                            }));
+
+  const uint32_t window_fbo_id =
+      static_cast<EmbedderTestContextGL&>(context).GetWindowFBOId();
+  static_cast<EmbedderTestContextGL&>(context)
+      .SetGLPopulateExistingDamageCallback(
+          [window_fbo_id](intptr_t fbo_id, FlutterDamage* existing_damage) {
+            ASSERT_EQ(fbo_id, static_cast<intptr_t>(window_fbo_id));
+            // The test surface is single buffered, so the fbo never lags
+            // behind the front buffer.
+            existing_damage->num_rects = 0;
+            existing_damage->damage = nullptr;
+          });
+
+  static_cast<EmbedderTestContextGL&>(context).SetGLPresentCallback(
+      [&frame_latch](const FlutterPresentInfo& present_info) {
+        ASSERT_EQ(present_info.frame_damage.num_rects, 1u);
+        ASSERT_EQ(present_info.buffer_damage.num_rects, 1u);
+
+        // Identical frames may produce empty damage, but the damage may never
+        // extend past the surface.
+        const FlutterRect& frame_damage = present_info.frame_damage.damage[0];
+        ASSERT_GE(frame_damage.left, 0.0);
+        ASSERT_GE(frame_damage.top, 0.0);
+        ASSERT_LE(frame_damage.right, 1024.0);
+        ASSERT_LE(frame_damage.bottom, 600.0);
 
         frame_latch.CountDown();
       });
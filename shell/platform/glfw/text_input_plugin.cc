@@ -4,8 +4,10 @@
 
 #include "flutter/shell/platform/glfw/text_input_plugin.h"
 
+#include <codecvt>
 #include <cstdint>
 #include <iostream>
+#include <locale>
 
 #include "flutter/shell/platform/common/json_method_codec.h"
 
@@ -19,11 +21,14 @@ static constexpr char kMultilineInputType[] = "TextInputType.multiline";
 
 static constexpr char kUpdateEditingStateMethod[] =
     "TextInputClient.updateEditingState";
+static constexpr char kUpdateEditingStateWithDeltasMethod[] =
+    "TextInputClient.updateEditingStateWithDeltas";
 static constexpr char kPerformActionMethod[] = "TextInputClient.performAction";
 
 static constexpr char kTextInputAction[] = "inputAction";
 static constexpr char kTextInputType[] = "inputType";
 static constexpr char kTextInputTypeName[] = "name";
+static constexpr char kEnableDeltaModel[] = "enableDeltaModel";
 static constexpr char kComposingBaseKey[] = "composingBase";
 static constexpr char kComposingExtentKey[] = "composingExtent";
 static constexpr char kSelectionAffinityKey[] = "selectionAffinity";
@@ -32,6 +37,11 @@ static constexpr char kSelectionBaseKey[] = "selectionBase";
 static constexpr char kSelectionExtentKey[] = "selectionExtent";
 static constexpr char kSelectionIsDirectionalKey[] = "selectionIsDirectional";
 static constexpr char kTextKey[] = "text";
+static constexpr char kDeltasKey[] = "deltas";
+static constexpr char kDeltaOldTextKey[] = "oldText";
+static constexpr char kDeltaTextKey[] = "deltaText";
+static constexpr char kDeltaStartKey[] = "deltaStart";
+static constexpr char kDeltaEndKey[] = "deltaEnd";
 
 static constexpr char kChannelName[] = "flutter/textinput";
 
@@ -45,6 +55,14 @@ void TextInputPlugin::CharHook(GLFWwindow* window, unsigned int code_point) {
   if (active_model_ == nullptr) {
     return;
   }
+  if (enable_delta_model_) {
+    std::wstring_convert<std::codecvt_utf8<char32_t>, char32_t> utf8_converter;
+    TextEditingDelta delta(active_model_->GetText(), active_model_->selection(),
+                           utf8_converter.to_bytes(code_point));
+    active_model_->AddCodePoint(code_point);
+    SendStateUpdateWithDelta(*active_model_, delta);
+    return;
+  }
   active_model_->AddCodePoint(code_point);
   SendStateUpdate(*active_model_);
 }
@@ -78,15 +96,20 @@ void TextInputPlugin::KeyboardHook(GLFWwindow* window,
         SendStateUpdate(*active_model_);
         break;
       case GLFW_KEY_BACKSPACE:
-        if (active_model_->Backspace()) {
-          SendStateUpdate(*active_model_);
+      case GLFW_KEY_DELETE: {
+        std::string text_before_change;
+        if (enable_delta_model_) {
+          text_before_change = active_model_->GetText();
         }
-        break;
-      case GLFW_KEY_DELETE:
-        if (active_model_->Delete()) {
-          SendStateUpdate(*active_model_);
+        size_t length_before_change = active_model_->text_range().length();
+        bool deleted = key == GLFW_KEY_BACKSPACE ? active_model_->Backspace()
+                                                 : active_model_->Delete();
+        if (deleted) {
+          SendDeletion(*active_model_, text_before_change,
+                       length_before_change);
         }
         break;
+      }
       case GLFW_KEY_ENTER:
         EnterPressed(active_model_.get());
         break;
@@ -142,6 +165,11 @@ void TextInputPlugin::HandleMethodCall(
       return;
     }
     client_id_ = client_id_json.GetInt();
+    auto enable_delta_model_json = client_config.FindMember(kEnableDeltaModel);
+    enable_delta_model_ =
+        enable_delta_model_json != client_config.MemberEnd() &&
+        enable_delta_model_json->value.IsBool() &&
+        enable_delta_model_json->value.GetBool();
     input_action_ = "";
     auto input_action_json = client_config.FindMember(kTextInputAction);
     if (input_action_json != client_config.MemberEnd() &&
@@ -226,10 +254,63 @@ void TextInputPlugin::SendStateUpdate(const TextInputModel& model) {
   channel_->InvokeMethod(kUpdateEditingStateMethod, std::move(args));
 }
 
+void TextInputPlugin::SendStateUpdateWithDelta(const TextInputModel& model,
+                                               const TextEditingDelta& delta) {
+  auto args = std::make_unique<rapidjson::Document>(rapidjson::kArrayType);
+  auto& allocator = args->GetAllocator();
+  args->PushBack(client_id_, allocator);
+
+  TextRange selection = model.selection();
+  rapidjson::Value delta_json(rapidjson::kObjectType);
+  delta_json.AddMember(
+      kDeltaOldTextKey,
+      rapidjson::Value(delta.old_text(), allocator).Move(), allocator);
+  delta_json.AddMember(
+      kDeltaTextKey, rapidjson::Value(delta.delta_text(), allocator).Move(),
+      allocator);
+  delta_json.AddMember(kDeltaStartKey, delta.delta_start(), allocator);
+  delta_json.AddMember(kDeltaEndKey, delta.delta_end(), allocator);
+  delta_json.AddMember(kComposingBaseKey, -1, allocator);
+  delta_json.AddMember(kComposingExtentKey, -1, allocator);
+  delta_json.AddMember(kSelectionAffinityKey, kAffinityDownstream, allocator);
+  delta_json.AddMember(kSelectionBaseKey, selection.base(), allocator);
+  delta_json.AddMember(kSelectionExtentKey, selection.extent(), allocator);
+  delta_json.AddMember(kSelectionIsDirectionalKey, false, allocator);
+
+  rapidjson::Value deltas(rapidjson::kArrayType);
+  deltas.PushBack(delta_json, allocator);
+  rapidjson::Value object(rapidjson::kObjectType);
+  object.AddMember(kDeltasKey, deltas, allocator);
+  args->PushBack(object, allocator);
+
+  channel_->InvokeMethod(kUpdateEditingStateWithDeltasMethod, std::move(args));
+}
+
+void TextInputPlugin::SendDeletion(const TextInputModel& model,
+                                   const std::string& text_before_change,
+                                   size_t length_before_change) {
+  if (!enable_delta_model_) {
+    SendStateUpdate(model);
+    return;
+  }
+  // Deleting text leaves the cursor at the start of the deleted range.
+  size_t start = model.selection().start();
+  size_t deleted_length = length_before_change - model.text_range().length();
+  SendStateUpdateWithDelta(
+      model, TextEditingDelta(text_before_change,
+                              TextRange(start, start + deleted_length), ""));
+}
+
 void TextInputPlugin::EnterPressed(TextInputModel* model) {
   if (input_type_ == kMultilineInputType) {
-    model->AddCodePoint('\n');
-    SendStateUpdate(*model);
+    if (enable_delta_model_) {
+      TextEditingDelta delta(model->GetText(), model->selection(), "\n");
+      model->AddCodePoint('\n');
+      SendStateUpdateWithDelta(*model, delta);
+    } else {
+      model->AddCodePoint('\n');
+      SendStateUpdate(*model);
+    }
   }
   auto args = std::make_unique<rapidjson::Document>(rapidjson::kArrayType);
   auto& allocator = args->GetAllocator();
@@ -10,6 +10,7 @@
 
 #include "flutter/shell/platform/common/client_wrapper/include/flutter/binary_messenger.h"
 #include "flutter/shell/platform/common/client_wrapper/include/flutter/method_channel.h"
+#include "flutter/shell/platform/common/text_editing_delta.h"
 #include "flutter/shell/platform/common/text_input_model.h"
 #include "flutter/shell/platform/glfw/keyboard_hook_handler.h"
 #include "flutter/shell/platform/glfw/public/flutter_glfw.h"
@@ -41,6 +42,19 @@ class TextInputPlugin : public KeyboardHookHandler {
   // Sends the current state of the given model to the Flutter engine.
   void SendStateUpdate(const TextInputModel& model);
 
+  // Sends a text change to the Flutter engine, along with the current
+  // selection of the given model.
+  //
+  // Only used if the client enabled the delta model.
+  void SendStateUpdateWithDelta(const TextInputModel& model,
+                                const TextEditingDelta& delta);
+
+  // Sends the deletion made by an edit of the model, given the text and
+  // length before the edit.
+  void SendDeletion(const TextInputModel& model,
+                    const std::string& text_before_change,
+                    size_t length_before_change);
+
   // Sends an action triggered by the Enter key to the Flutter engine.
   void EnterPressed(TextInputModel* model);
 
@@ -65,6 +79,9 @@ class TextInputPlugin : public KeyboardHookHandler {
   // An action requested by the user on the input client. See available options:
   // https://api.flutter.dev/flutter/services/TextInputAction-class.html
   std::string input_action_;
+
+  // Whether to send text changes as deltas instead of the whole text.
+  bool enable_delta_model_ = false;
 };
 
 }  // namespace flutter
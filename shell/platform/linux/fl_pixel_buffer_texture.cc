@@ -7,10 +7,41 @@
 #include <epoxy/gl.h>
 #include <gmodule.h>
 
+#include <cstring>
+
 #include "flutter/shell/platform/linux/fl_pixel_buffer_texture_private.h"
 
+// Number of pixel unpack buffers uploads are streamed through. The driver can
+// still be reading from one while the next is written.
+static constexpr guint kPixelBufferCount = 3;
+
+// Pixel buffers are in RGBA format.
+static constexpr size_t kBytesPerPixel = 4;
+
+// A range of rows of the pixel buffer, [start, end).
+typedef struct {
+  uint32_t start;
+  uint32_t end;
+} RowRange;
+
 typedef struct {
   GLuint texture_id;
+
+  // Size of the storage allocated for @texture_id.
+  uint32_t texture_width;
+  uint32_t texture_height;
+
+  // Pixel unpack buffers, created on first use.
+  gboolean use_pixel_buffer_objects;
+  GLuint pixel_buffers[kPixelBufferCount];
+  guint next_pixel_buffer;
+
+  // Protects @dirty_rows, which can be added to from any thread.
+  GMutex mutex;
+
+  // Sorted, non-overlapping #RowRange of the rows changed since the last
+  // upload. Empty if the whole buffer should be uploaded.
+  GArray* dirty_rows;
 } FlPixelBufferTexturePrivate;
 
 // Added here to stop the compiler from optimising this function away.
@@ -36,10 +67,26 @@ static void fl_pixel_buffer_texture_dispose(GObject* object) {
     glDeleteTextures(1, &priv->texture_id);
     priv->texture_id = 0;
   }
+  if (priv->pixel_buffers[0] != 0) {
+    glDeleteBuffers(kPixelBufferCount, priv->pixel_buffers);
+    memset(priv->pixel_buffers, 0, sizeof(priv->pixel_buffers));
+  }
 
   G_OBJECT_CLASS(fl_pixel_buffer_texture_parent_class)->dispose(object);
 }
 
+static void fl_pixel_buffer_texture_finalize(GObject* object) {
+  FlPixelBufferTexture* self = FL_PIXEL_BUFFER_TEXTURE(object);
+  FlPixelBufferTexturePrivate* priv =
+      reinterpret_cast<FlPixelBufferTexturePrivate*>(
+          fl_pixel_buffer_texture_get_instance_private(self));
+
+  g_mutex_clear(&priv->mutex);
+  g_array_unref(priv->dirty_rows);
+
+  G_OBJECT_CLASS(fl_pixel_buffer_texture_parent_class)->finalize(object);
+}
+
 static void check_gl_error(int line) {
   GLenum err = glGetError();
   if (err) {
@@ -47,6 +94,65 @@ static void check_gl_error(int line) {
   }
 }
 
+// Takes the rows changed since the last upload.
+static GArray* take_dirty_rows(FlPixelBufferTexturePrivate* priv) {
+  g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&priv->mutex);
+  GArray* dirty_rows = priv->dirty_rows;
+  priv->dirty_rows = g_array_new(FALSE, FALSE, sizeof(RowRange));
+  return dirty_rows;
+}
+
+// Checks if uploads can be streamed through pixel unpack buffers.
+static gboolean pixel_buffer_objects_supported() {
+  // glMapBufferRange is required to write into the buffers without waiting
+  // for the GPU.
+  return epoxy_gl_version() >= 30;
+}
+
+// Uploads rows of @buffer into the bound texture.
+static void upload_rows(FlPixelBufferTexturePrivate* priv,
+                        const uint8_t* buffer,
+                        uint32_t width,
+                        RowRange rows) {
+  const uint8_t* data = buffer + rows.start * width * kBytesPerPixel;
+  size_t size = (rows.end - rows.start) * width * kBytesPerPixel;
+
+  if (priv->use_pixel_buffer_objects && pixel_buffer_objects_supported()) {
+    if (priv->pixel_buffers[0] == 0) {
+      glGenBuffers(kPixelBufferCount, priv->pixel_buffers);
+      check_gl_error(__LINE__);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER,
+                 priv->pixel_buffers[priv->next_pixel_buffer]);
+    priv->next_pixel_buffer = (priv->next_pixel_buffer + 1) % kPixelBufferCount;
+    // Respecifying the storage lets the driver hand out new memory instead of
+    // waiting for a previous upload from this buffer to complete.
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    void* mapped =
+        glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size,
+                         GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (mapped != nullptr) {
+      memcpy(mapped, data, size);
+      gboolean unmapped = glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+      if (unmapped) {
+        // The texture is updated asynchronously from the bound buffer.
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, rows.start, width,
+                        rows.end - rows.start, GL_RGBA, GL_UNSIGNED_BYTE,
+                        nullptr);
+        check_gl_error(__LINE__);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return;
+      }
+    }
+    check_gl_error(__LINE__);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  }
+
+  glTexSubImage2D(GL_TEXTURE_2D, 0, 0, rows.start, width,
+                  rows.end - rows.start, GL_RGBA, GL_UNSIGNED_BYTE, data);
+  check_gl_error(__LINE__);
+}
+
 gboolean fl_pixel_buffer_texture_populate(FlPixelBufferTexture* texture,
                                           uint32_t width,
                                           uint32_t height,
@@ -80,9 +186,26 @@ gboolean fl_pixel_buffer_texture_populate(FlPixelBufferTexture* texture,
     glBindTexture(GL_TEXTURE_2D, priv->texture_id);
     check_gl_error(__LINE__);
   }
-  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA,
-               GL_UNSIGNED_BYTE, buffer);
-  check_gl_error(__LINE__);
+
+  g_autoptr(GArray) dirty_rows = take_dirty_rows(priv);
+  if (width != priv->texture_width || height != priv->texture_height) {
+    // (Re)allocate the storage. The whole buffer is uploaded with it.
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA,
+                 GL_UNSIGNED_BYTE, buffer);
+    check_gl_error(__LINE__);
+    priv->texture_width = width;
+    priv->texture_height = height;
+  } else if (dirty_rows->len == 0) {
+    upload_rows(priv, buffer, width, {0, height});
+  } else {
+    for (guint i = 0; i < dirty_rows->len; i++) {
+      RowRange rows = g_array_index(dirty_rows, RowRange, i);
+      rows.end = MIN(rows.end, height);
+      if (rows.start < rows.end) {
+        upload_rows(priv, buffer, width, rows);
+      }
+    }
+  }
 
   opengl_texture->target = GL_TEXTURE_2D;
   opengl_texture->name = priv->texture_id;
@@ -98,6 +221,58 @@ gboolean fl_pixel_buffer_texture_populate(FlPixelBufferTexture* texture,
 static void fl_pixel_buffer_texture_class_init(
     FlPixelBufferTextureClass* klass) {
   G_OBJECT_CLASS(klass)->dispose = fl_pixel_buffer_texture_dispose;
+  G_OBJECT_CLASS(klass)->finalize = fl_pixel_buffer_texture_finalize;
+}
+
+static void fl_pixel_buffer_texture_init(FlPixelBufferTexture* self) {
+  FlPixelBufferTexturePrivate* priv =
+      reinterpret_cast<FlPixelBufferTexturePrivate*>(
+          fl_pixel_buffer_texture_get_instance_private(self));
+  g_mutex_init(&priv->mutex);
+  priv->dirty_rows = g_array_new(FALSE, FALSE, sizeof(RowRange));
 }
 
-static void fl_pixel_buffer_texture_init(FlPixelBufferTexture* self) {}
+G_MODULE_EXPORT void fl_pixel_buffer_texture_add_dirty_rect(
+    FlPixelBufferTexture* self,
+    uint32_t x,
+    uint32_t y,
+    uint32_t width,
+    uint32_t height) {
+  g_return_if_fail(FL_IS_PIXEL_BUFFER_TEXTURE(self));
+  FlPixelBufferTexturePrivate* priv =
+      reinterpret_cast<FlPixelBufferTexturePrivate*>(
+          fl_pixel_buffer_texture_get_instance_private(self));
+
+  if (width == 0 || height == 0) {
+    return;
+  }
+
+  // Whole rows are uploaded, so only the rows of the rect are recorded.
+  RowRange rows = {y, y + height};
+  g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&priv->mutex);
+  guint i = 0;
+  while (i < priv->dirty_rows->len) {
+    RowRange* existing = &g_array_index(priv->dirty_rows, RowRange, i);
+    if (existing->end < rows.start) {
+      i++;
+    } else if (existing->start > rows.end) {
+      break;
+    } else {
+      // Merge overlapping and adjacent ranges.
+      rows.start = MIN(rows.start, existing->start);
+      rows.end = MAX(rows.end, existing->end);
+      g_array_remove_index(priv->dirty_rows, i);
+    }
+  }
+  g_array_insert_val(priv->dirty_rows, i, rows);
+}
+
+G_MODULE_EXPORT void fl_pixel_buffer_texture_set_use_pixel_buffer_objects(
+    FlPixelBufferTexture* self,
+    gboolean use_pixel_buffer_objects) {
+  g_return_if_fail(FL_IS_PIXEL_BUFFER_TEXTURE(self));
+  FlPixelBufferTexturePrivate* priv =
+      reinterpret_cast<FlPixelBufferTexturePrivate*>(
+          fl_pixel_buffer_texture_get_instance_private(self));
+  priv->use_pixel_buffer_objects = use_pixel_buffer_objects;
+}
@@ -12,6 +12,8 @@
 
 #include <epoxy/gl.h>
 
+#include <vector>
+
 static constexpr uint32_t BUFFER_WIDTH = 4u;
 static constexpr uint32_t BUFFER_HEIGHT = 4u;
 static constexpr uint32_t REAL_BUFFER_WIDTH = 2u;
@@ -86,3 +88,118 @@ TEST(FlPixelBufferTextureTest, PopulateTexture) {
   EXPECT_EQ(opengl_texture.width, REAL_BUFFER_WIDTH);
   EXPECT_EQ(opengl_texture.height, REAL_BUFFER_HEIGHT);
 }
+
+typedef struct {
+  GLint yoffset;
+  GLsizei height;
+} Upload;
+
+static int tex_image_2d_count = 0;
+static std::vector<Upload> tex_sub_image_2d_uploads;
+
+static void record_tex_image_2d(GLenum target,
+                                GLint level,
+                                GLint internalformat,
+                                GLsizei width,
+                                GLsizei height,
+                                GLint border,
+                                GLenum format,
+                                GLenum type,
+                                const void* pixels) {
+  tex_image_2d_count++;
+}
+
+static void record_tex_sub_image_2d(GLenum target,
+                                    GLint level,
+                                    GLint xoffset,
+                                    GLint yoffset,
+                                    GLsizei width,
+                                    GLsizei height,
+                                    GLenum format,
+                                    GLenum type,
+                                    const void* pixels) {
+  EXPECT_EQ(xoffset, 0);
+  EXPECT_EQ(width, static_cast<GLsizei>(REAL_BUFFER_WIDTH));
+  tex_sub_image_2d_uploads.push_back({yoffset, height});
+}
+
+// Records the uploads made by fl_pixel_buffer_texture_populate.
+class FlPixelBufferTextureUploadTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    tex_image_2d_count = 0;
+    tex_sub_image_2d_uploads.clear();
+    tex_image_2d_ = epoxy_glTexImage2D;
+    tex_sub_image_2d_ = epoxy_glTexSubImage2D;
+    epoxy_glTexImage2D = record_tex_image_2d;
+    epoxy_glTexSubImage2D = record_tex_sub_image_2d;
+  }
+
+  void TearDown() override {
+    epoxy_glTexImage2D = tex_image_2d_;
+    epoxy_glTexSubImage2D = tex_sub_image_2d_;
+  }
+
+  static void Populate(FlPixelBufferTexture* texture) {
+    FlutterOpenGLTexture opengl_texture = {0};
+    g_autoptr(GError) error = nullptr;
+    EXPECT_TRUE(fl_pixel_buffer_texture_populate(
+        texture, BUFFER_WIDTH, BUFFER_HEIGHT, &opengl_texture, &error));
+    EXPECT_EQ(error, nullptr);
+  }
+
+ private:
+  decltype(epoxy_glTexImage2D) tex_image_2d_;
+  decltype(epoxy_glTexSubImage2D) tex_sub_image_2d_;
+};
+
+// Test that the texture storage is allocated once and then updated.
+TEST_F(FlPixelBufferTextureUploadTest, ReusesStorage) {
+  g_autoptr(FlPixelBufferTexture) texture =
+      FL_PIXEL_BUFFER_TEXTURE(fl_test_pixel_buffer_texture_new());
+  Populate(texture);
+  EXPECT_EQ(tex_image_2d_count, 1);
+  EXPECT_TRUE(tex_sub_image_2d_uploads.empty());
+
+  Populate(texture);
+  EXPECT_EQ(tex_image_2d_count, 1);
+  ASSERT_EQ(tex_sub_image_2d_uploads.size(), 1u);
+  EXPECT_EQ(tex_sub_image_2d_uploads[0].yoffset, 0);
+  EXPECT_EQ(tex_sub_image_2d_uploads[0].height,
+            static_cast<GLsizei>(REAL_BUFFER_HEIGHT));
+}
+
+// Test that only the rows of the dirty rects are uploaded.
+TEST_F(FlPixelBufferTextureUploadTest, UploadsDirtyRows) {
+  g_autoptr(FlPixelBufferTexture) texture =
+      FL_PIXEL_BUFFER_TEXTURE(fl_test_pixel_buffer_texture_new());
+  Populate(texture);
+
+  fl_pixel_buffer_texture_add_dirty_rect(texture, 1, 1, 1, 1);
+  Populate(texture);
+  ASSERT_EQ(tex_sub_image_2d_uploads.size(), 1u);
+  EXPECT_EQ(tex_sub_image_2d_uploads[0].yoffset, 1);
+  EXPECT_EQ(tex_sub_image_2d_uploads[0].height, 1);
+
+  // Adjacent rects are uploaded together, and rects are clipped to the
+  // buffer.
+  tex_sub_image_2d_uploads.clear();
+  fl_pixel_buffer_texture_add_dirty_rect(texture, 0, 1, 2, 4);
+  fl_pixel_buffer_texture_add_dirty_rect(texture, 0, 0, 1, 1);
+  Populate(texture);
+  ASSERT_EQ(tex_sub_image_2d_uploads.size(), 1u);
+  EXPECT_EQ(tex_sub_image_2d_uploads[0].yoffset, 0);
+  EXPECT_EQ(tex_sub_image_2d_uploads[0].height, 2);
+  EXPECT_EQ(tex_image_2d_count, 1);
+}
+
+// Test that uploads fall back to client memory without pixel buffer objects.
+TEST_F(FlPixelBufferTextureUploadTest, PixelBufferObjectsUnsupported) {
+  g_autoptr(FlPixelBufferTexture) texture =
+      FL_PIXEL_BUFFER_TEXTURE(fl_test_pixel_buffer_texture_new());
+  fl_pixel_buffer_texture_set_use_pixel_buffer_objects(texture, TRUE);
+  Populate(texture);
+  Populate(texture);
+  EXPECT_EQ(tex_image_2d_count, 1);
+  EXPECT_EQ(tex_sub_image_2d_uploads.size(), 1u);
+}
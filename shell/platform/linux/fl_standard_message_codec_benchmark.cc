@@ -0,0 +1,100 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/linux/public/flutter_linux/fl_standard_message_codec.h"
+
+#include "flutter/benchmarking/benchmarking.h"
+
+namespace flutter {
+
+// Creates a map with string keys, as sent by plugins.
+static FlValue* CreateMap(int64_t length) {
+  FlValue* map = fl_value_new_map();
+  for (int64_t i = 0; i < length; i++) {
+    g_autofree gchar* key = g_strdup_printf("key%" G_GINT64_FORMAT, i);
+    fl_value_set_string_take(map, key, fl_value_new_int(i));
+  }
+  return map;
+}
+
+static GBytes* EncodeMessage(FlValue* value) {
+  g_autoptr(FlStandardMessageCodec) codec = fl_standard_message_codec_new();
+  return fl_message_codec_encode_message(FL_MESSAGE_CODEC(codec), value,
+                                         nullptr);
+}
+
+static void BM_EncodeMap(benchmark::State& state) {
+  g_autoptr(FlStandardMessageCodec) codec = fl_standard_message_codec_new();
+  g_autoptr(FlValue) map = CreateMap(state.range(0));
+  while (state.KeepRunning()) {
+    g_autoptr(GBytes) message =
+        fl_message_codec_encode_message(FL_MESSAGE_CODEC(codec), map, nullptr);
+    benchmark::DoNotOptimize(message);
+  }
+}
+BENCHMARK(BM_EncodeMap)->Range(8, 4096);
+
+static void BM_DecodeMap(benchmark::State& state) {
+  g_autoptr(FlStandardMessageCodec) codec = fl_standard_message_codec_new();
+  g_autoptr(FlValue) map = CreateMap(state.range(0));
+  g_autoptr(GBytes) message = EncodeMessage(map);
+  while (state.KeepRunning()) {
+    g_autoptr(FlValue) value = fl_message_codec_decode_message(
+        FL_MESSAGE_CODEC(codec), message, nullptr);
+    benchmark::DoNotOptimize(value);
+  }
+}
+BENCHMARK(BM_DecodeMap)->Range(8, 4096);
+
+static void BM_LookupMap(benchmark::State& state) {
+  g_autoptr(FlValue) map = CreateMap(state.range(0));
+  g_autofree gchar* key =
+      g_strdup_printf("key%" G_GINT64_FORMAT, state.range(0) - 1);
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(fl_value_lookup_string(map, key));
+  }
+}
+BENCHMARK(BM_LookupMap)->Range(8, 4096);
+
+static void BM_EqualMap(benchmark::State& state) {
+  g_autoptr(FlValue) map1 = CreateMap(state.range(0));
+  g_autoptr(FlValue) map2 = CreateMap(state.range(0));
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(fl_value_equal(map1, map2));
+  }
+}
+BENCHMARK(BM_EqualMap)->Range(8, 4096);
+
+static void BM_DecodeUint8List(benchmark::State& state) {
+  g_autoptr(FlStandardMessageCodec) codec = fl_standard_message_codec_new();
+  size_t length = state.range(0);
+  g_autofree uint8_t* data = static_cast<uint8_t*>(g_malloc0(length));
+  g_autoptr(FlValue) list = fl_value_new_uint8_list(data, length);
+  g_autoptr(GBytes) message = EncodeMessage(list);
+  while (state.KeepRunning()) {
+    g_autoptr(FlValue) value = fl_message_codec_decode_message(
+        FL_MESSAGE_CODEC(codec), message, nullptr);
+    benchmark::DoNotOptimize(value);
+  }
+  state.SetBytesProcessed(state.iterations() * length);
+}
+BENCHMARK(BM_DecodeUint8List)->Range(64, 16 << 20);
+
+static void BM_DecodeFloatList(benchmark::State& state) {
+  g_autoptr(FlStandardMessageCodec) codec = fl_standard_message_codec_new();
+  size_t length = state.range(0);
+  g_autofree double* data =
+      static_cast<double*>(g_malloc0(sizeof(double) * length));
+  g_autoptr(FlValue) list = fl_value_new_float_list(data, length);
+  g_autoptr(GBytes) message = EncodeMessage(list);
+  while (state.KeepRunning()) {
+    g_autoptr(FlValue) value = fl_message_codec_decode_message(
+        FL_MESSAGE_CODEC(codec), message, nullptr);
+    benchmark::DoNotOptimize(value);
+  }
+  state.SetBytesProcessed(state.iterations() * length * sizeof(double));
+}
+BENCHMARK(BM_DecodeFloatList)->Range(8, 2 << 20);
+
+}  // namespace flutter
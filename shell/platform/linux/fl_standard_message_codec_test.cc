@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include "flutter/shell/platform/linux/public/flutter_linux/fl_standard_message_codec.h"
+#include "flutter/shell/platform/linux/fl_value_private.h"
 #include "flutter/shell/platform/linux/testing/fl_test.h"
 #include "gtest/gtest.h"
 
@@ -416,6 +417,28 @@ TEST(FlStandardMessageCodecTest, DecodeUint8ListShortData2) {
                      FL_MESSAGE_CODEC_ERROR_OUT_OF_DATA);
 }
 
+TEST(FlStandardMessageCodecTest, DecodeLargeInt32List) {
+  int32_t data[1024];
+  for (int i = 0; i < 1024; i++) {
+    data[i] = i;
+  }
+  g_autoptr(FlValue) list = fl_value_new_int32_list(data, 1024);
+  g_autoptr(FlStandardMessageCodec) codec = fl_standard_message_codec_new();
+  g_autoptr(GError) error = nullptr;
+  g_autoptr(GBytes) message =
+      fl_message_codec_encode_message(FL_MESSAGE_CODEC(codec), list, &error);
+  ASSERT_NE(message, nullptr);
+  g_autoptr(FlValue) value =
+      fl_message_codec_decode_message(FL_MESSAGE_CODEC(codec), message, &error);
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(error, nullptr);
+
+  // The list references the message instead of copying it, and keeps it alive.
+  EXPECT_TRUE(fl_value_is_borrowed(value));
+  g_clear_pointer(&message, g_bytes_unref);
+  EXPECT_TRUE(fl_value_equal(value, list));
+}
+
 TEST(FlStandardMessageCodecTest, EncodeInt32ListEmpty) {
   g_autoptr(FlValue) value = fl_value_new_int32_list(nullptr, 0);
   g_autofree gchar* hex_string = encode_message(value);
@@ -6,6 +6,9 @@
 
 #include <gtk/gtk.h>
 
+#include <memory>
+
+#include "flutter/shell/platform/common/text_editing_delta.h"
 #include "flutter/shell/platform/common/text_input_model.h"
 #include "flutter/shell/platform/linux/public/flutter_linux/fl_json_method_codec.h"
 #include "flutter/shell/platform/linux/public/flutter_linux/fl_method_channel.h"
@@ -21,6 +24,8 @@ static constexpr char kClearClientMethod[] = "TextInput.clearClient";
 static constexpr char kHideMethod[] = "TextInput.hide";
 static constexpr char kUpdateEditingStateMethod[] =
     "TextInputClient.updateEditingState";
+static constexpr char kUpdateEditingStateWithDeltasMethod[] =
+    "TextInputClient.updateEditingStateWithDeltas";
 static constexpr char kPerformActionMethod[] = "TextInputClient.performAction";
 static constexpr char kSetEditableSizeAndTransform[] =
     "TextInput.setEditableSizeAndTransform";
@@ -29,6 +34,7 @@ static constexpr char kSetMarkedTextRect[] = "TextInput.setMarkedTextRect";
 static constexpr char kInputActionKey[] = "inputAction";
 static constexpr char kTextInputTypeKey[] = "inputType";
 static constexpr char kTextInputTypeNameKey[] = "name";
+static constexpr char kEnableDeltaModel[] = "enableDeltaModel";
 static constexpr char kTextKey[] = "text";
 static constexpr char kSelectionBaseKey[] = "selectionBase";
 static constexpr char kSelectionExtentKey[] = "selectionExtent";
@@ -37,6 +43,12 @@ static constexpr char kSelectionIsDirectionalKey[] = "selectionIsDirectional";
 static constexpr char kComposingBaseKey[] = "composingBase";
 static constexpr char kComposingExtentKey[] = "composingExtent";
 
+static constexpr char kDeltasKey[] = "deltas";
+static constexpr char kDeltaOldTextKey[] = "oldText";
+static constexpr char kDeltaTextKey[] = "deltaText";
+static constexpr char kDeltaStartKey[] = "deltaStart";
+static constexpr char kDeltaEndKey[] = "deltaEnd";
+
 static constexpr char kTransform[] = "transform";
 
 static constexpr char kTextAffinityDownstream[] = "TextAffinity.downstream";
@@ -67,6 +79,9 @@ struct FlTextInputPluginPrivate {
   // The type of the input method.
   FlTextInputType input_type;
 
+  // Whether to send text editing deltas instead of the whole editing state.
+  gboolean enable_delta_model;
+
   // Input method.
   GtkIMContext* im_context;
 
@@ -116,19 +131,13 @@ static void update_editing_state_response_cb(GObject* object,
   }
 }
 
-// Informs Flutter of text input changes.
-static void update_editing_state(FlTextInputPlugin* self) {
+// Adds the selection and composing range of the text model to @value.
+static void set_selection_and_composing(FlTextInputPlugin* self,
+                                        FlValue* value) {
   FlTextInputPluginPrivate* priv = static_cast<FlTextInputPluginPrivate*>(
       fl_text_input_plugin_get_instance_private(self));
 
-  g_autoptr(FlValue) args = fl_value_new_list();
-  fl_value_append_take(args, fl_value_new_int(priv->client_id));
-  g_autoptr(FlValue) value = fl_value_new_map();
-
   flutter::TextRange selection = priv->text_model->selection();
-  fl_value_set_string_take(
-      value, kTextKey,
-      fl_value_new_string(priv->text_model->GetText().c_str()));
   fl_value_set_string_take(value, kSelectionBaseKey,
                            fl_value_new_int(selection.base()));
   fl_value_set_string_take(value, kSelectionExtentKey,
@@ -150,6 +159,21 @@ static void update_editing_state(FlTextInputPlugin* self) {
                            fl_value_new_string(kTextAffinityDownstream));
   fl_value_set_string_take(value, kSelectionIsDirectionalKey,
                            fl_value_new_bool(FALSE));
+}
+
+// Informs Flutter of text input changes.
+static void update_editing_state(FlTextInputPlugin* self) {
+  FlTextInputPluginPrivate* priv = static_cast<FlTextInputPluginPrivate*>(
+      fl_text_input_plugin_get_instance_private(self));
+
+  g_autoptr(FlValue) args = fl_value_new_list();
+  fl_value_append_take(args, fl_value_new_int(priv->client_id));
+  g_autoptr(FlValue) value = fl_value_new_map();
+
+  fl_value_set_string_take(
+      value, kTextKey,
+      fl_value_new_string(priv->text_model->GetText().c_str()));
+  set_selection_and_composing(self, value);
 
   fl_value_append(args, value);
 
@@ -158,6 +182,52 @@ static void update_editing_state(FlTextInputPlugin* self) {
                                   update_editing_state_response_cb, self);
 }
 
+// Called when a response is received from
+// TextInputClient.updateEditingStateWithDeltas()
+static void update_editing_state_with_deltas_response_cb(GObject* object,
+                                                         GAsyncResult* result,
+                                                         gpointer user_data) {
+  g_autoptr(GError) error = nullptr;
+  if (!finish_method(object, result, &error)) {
+    g_warning("Failed to call %s: %s", kUpdateEditingStateWithDeltasMethod,
+              error->message);
+  }
+}
+
+// Informs Flutter of a text input change, sending only the changed text
+// instead of the new text.
+static void update_editing_state_with_delta(
+    FlTextInputPlugin* self,
+    const flutter::TextEditingDelta& delta) {
+  FlTextInputPluginPrivate* priv = static_cast<FlTextInputPluginPrivate*>(
+      fl_text_input_plugin_get_instance_private(self));
+
+  g_autoptr(FlValue) args = fl_value_new_list();
+  fl_value_append_take(args, fl_value_new_int(priv->client_id));
+
+  g_autoptr(FlValue) delta_value = fl_value_new_map();
+  fl_value_set_string_take(delta_value, kDeltaOldTextKey,
+                           fl_value_new_string(delta.old_text().c_str()));
+  fl_value_set_string_take(delta_value, kDeltaTextKey,
+                           fl_value_new_string(delta.delta_text().c_str()));
+  fl_value_set_string_take(delta_value, kDeltaStartKey,
+                           fl_value_new_int(delta.delta_start()));
+  fl_value_set_string_take(delta_value, kDeltaEndKey,
+                           fl_value_new_int(delta.delta_end()));
+  set_selection_and_composing(self, delta_value);
+
+  g_autoptr(FlValue) deltas = fl_value_new_list();
+  fl_value_append(deltas, delta_value);
+  g_autoptr(FlValue) value = fl_value_new_map();
+  fl_value_set_string(value, kDeltasKey, deltas);
+
+  fl_value_append(args, value);
+
+  fl_method_channel_invoke_method(
+      priv->channel, kUpdateEditingStateWithDeltasMethod, args, nullptr,
+      update_editing_state_with_deltas_response_cb, self);
+}
+
 // Called when a response is received from TextInputClient.performAction()
 static void perform_action_response_cb(GObject* object,
                                        GAsyncResult* result,
@@ -205,23 +275,53 @@ static void im_preedit_changed_cb(FlTextInputPlugin* self) {
   gint cursor_offset = 0;
   gtk_im_context_get_preedit_string(priv->im_context, &buf, nullptr,
                                     &cursor_offset);
-  cursor_offset += priv->text_model->composing_range().base();
+  std::string text_before_change;
+  flutter::TextRange replaced_range = priv->text_model->composing_range();
+  if (priv->enable_delta_model) {
+    text_before_change = priv->text_model->GetText();
+    // An empty update before anything was composed leaves the text alone.
+    // Otherwise a selection is deleted along with the composing text.
+    if (buf[0] != '\0' || !replaced_range.collapsed()) {
+      replaced_range = priv->text_model->GetReplacedRange();
+    }
+  }
   priv->text_model->UpdateComposingText(buf);
+  // The cursor offset is relative to the composing text, which starts where
+  // a deleted selection started.
+  cursor_offset += priv->text_model->composing_range().base();
   priv->text_model->SetSelection(
       flutter::TextRange(cursor_offset, cursor_offset));
 
-  update_editing_state(self);
+  if (priv->enable_delta_model) {
+    update_editing_state_with_delta(
+        self, flutter::TextEditingDelta(text_before_change, replaced_range,
+                                        buf));
+  } else {
+    update_editing_state(self);
+  }
 }
 
 // Signal handler for GtkIMContext::commit
 static void im_commit_cb(FlTextInputPlugin* self, const gchar* text) {
   FlTextInputPluginPrivate* priv = static_cast<FlTextInputPluginPrivate*>(
       fl_text_input_plugin_get_instance_private(self));
+  std::string text_before_change;
+  if (priv->enable_delta_model) {
+    text_before_change = priv->text_model->GetText();
+  }
+  flutter::TextRange replaced_range = priv->text_model->GetReplacedRange();
   priv->text_model->AddText(text);
   if (priv->text_model->composing()) {
     priv->text_model->CommitComposing();
   }
-  update_editing_state(self);
+
+  if (priv->enable_delta_model) {
+    update_editing_state_with_delta(
+        self, flutter::TextEditingDelta(text_before_change, replaced_range,
+                                        text));
+  } else {
+    update_editing_state(self);
+  }
 }
 
 // Signal handler for GtkIMContext::preedit-end
@@ -229,7 +329,12 @@ static void im_preedit_end_cb(FlTextInputPlugin* self) {
   FlTextInputPluginPrivate* priv = static_cast<FlTextInputPluginPrivate*>(
       fl_text_input_plugin_get_instance_private(self));
   priv->text_model->EndComposing();
-  update_editing_state(self);
+  if (priv->enable_delta_model) {
+    update_editing_state_with_delta(
+        self, flutter::TextEditingDelta(priv->text_model->GetText()));
+  } else {
+    update_editing_state(self);
+  }
 }
 
 // Signal handler for GtkIMContext::retrieve-surrounding
@@ -250,6 +355,8 @@ static gboolean im_delete_surrounding_cb(FlTextInputPlugin* self,
   FlTextInputPluginPrivate* priv = static_cast<FlTextInputPluginPrivate*>(
       fl_text_input_plugin_get_instance_private(self));
   if (priv->text_model->DeleteSurrounding(offset, n_chars)) {
+    // The model does not report which range was deleted, so the whole state
+    // is sent even when the delta model is enabled.
     update_editing_state(self);
   }
   return TRUE;
@@ -274,6 +381,13 @@ static FlMethodResponse* set_client(FlTextInputPlugin* self, FlValue* args) {
     priv->input_action = g_strdup(fl_value_get_string(input_action_value));
   }
 
+  FlValue* enable_delta_model_value =
+      fl_value_lookup_string(config_value, kEnableDeltaModel);
+  priv->enable_delta_model =
+      enable_delta_model_value != nullptr &&
+      fl_value_get_type(enable_delta_model_value) == FL_VALUE_TYPE_BOOL &&
+      fl_value_get_bool(enable_delta_model_value);
+
   // Reset the input type, then set only if appropriate.
   priv->input_type = FL_TEXT_INPUT_TYPE_TEXT;
   FlValue* input_type_value =
@@ -525,6 +639,8 @@ static gboolean fl_text_input_plugin_filter_keypress_default(
   gboolean do_action = FALSE;
   // Handle navigation keys.
   gboolean changed = FALSE;
+  // The text inserted by the enter key, if the delta model is enabled.
+  std::unique_ptr<flutter::TextEditingDelta> newline_delta;
   if (event->is_press) {
     switch (event->keyval) {
       case GDK_KEY_End:
@@ -539,6 +655,11 @@ static gboolean fl_text_input_plugin_filter_keypress_default(
       case GDK_KEY_KP_Enter:
       case GDK_KEY_ISO_Enter:
         if (priv->input_type == FL_TEXT_INPUT_TYPE_MULTILINE) {
+          if (priv->enable_delta_model) {
+            newline_delta = std::make_unique<flutter::TextEditingDelta>(
+                priv->text_model->GetText(),
+                priv->text_model->GetReplacedRange(), "\n");
+          }
           priv->text_model->AddCodePoint('\n');
           changed = TRUE;
         }
@@ -565,7 +686,14 @@ static gboolean fl_text_input_plugin_filter_keypress_default(
   }
 
   if (changed) {
-    update_editing_state(self);
+    if (!priv->enable_delta_model) {
+      update_editing_state(self);
+    } else if (newline_delta) {
+      update_editing_state_with_delta(self, *newline_delta);
+    } else {
+      update_editing_state_with_delta(
+          self, flutter::TextEditingDelta(priv->text_model->GetText()));
+    }
   }
   if (do_action) {
     perform_action(self);
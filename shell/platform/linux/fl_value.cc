@@ -8,6 +8,16 @@
 
 #include <cstring>
 
+#include "flutter/shell/platform/linux/fl_value_private.h"
+
+// Maps with at least this many entries are indexed by a hash table.
+static constexpr guint kMapIndexMinimumLength = 16;
+
+// Typed lists of at least this many bytes reference the #GBytes they are
+// created from instead of copying it. Smaller lists are copied so that they
+// don't keep a large message alive.
+static constexpr size_t kBorrowMinimumSize = 1024;
+
 struct _FlValue {
   FlValueType type;
   int ref_count;
@@ -37,30 +47,40 @@ typedef struct {
   FlValue parent;
   uint8_t* values;
   size_t values_length;
+  // The #GBytes @values points into, or %NULL if @values is owned.
+  GBytes* bytes;
 } FlValueUint8List;
 
 typedef struct {
   FlValue parent;
   int32_t* values;
   size_t values_length;
+  // The #GBytes @values points into, or %NULL if @values is owned.
+  GBytes* bytes;
 } FlValueInt32List;
 
 typedef struct {
   FlValue parent;
   int64_t* values;
   size_t values_length;
+  // The #GBytes @values points into, or %NULL if @values is owned.
+  GBytes* bytes;
 } FlValueInt64List;
 
 typedef struct {
   FlValue parent;
   float* values;
   size_t values_length;
+  // The #GBytes @values points into, or %NULL if @values is owned.
+  GBytes* bytes;
 } FlValueFloat32List;
 
 typedef struct {
   FlValue parent;
   double* values;
   size_t values_length;
+  // The #GBytes @values points into, or %NULL if @values is owned.
+  GBytes* bytes;
 } FlValueFloatList;
 
 typedef struct {
@@ -72,6 +92,8 @@ typedef struct {
   FlValue parent;
   GPtrArray* keys;
   GPtrArray* values;
+  // Index of each key in @keys, created when a large map is first looked up.
+  GHashTable* index;
 } FlValueMap;
 
 static FlValue* fl_value_new(FlValueType type, size_t size) {
@@ -86,14 +108,69 @@ static void fl_value_destroy(gpointer value) {
   fl_value_unref(static_cast<FlValue*>(value));
 }
 
+// Hashes a value consistently with fl_value_equal().
+static guint fl_value_hash(gconstpointer value) {
+  FlValue* self = static_cast<FlValue*>(const_cast<gpointer>(value));
+  switch (self->type) {
+    case FL_VALUE_TYPE_NULL:
+      return 0;
+    case FL_VALUE_TYPE_BOOL:
+      return fl_value_get_bool(self) ? 1 : 0;
+    case FL_VALUE_TYPE_INT: {
+      int64_t v = fl_value_get_int(self);
+      return g_int64_hash(&v);
+    }
+    case FL_VALUE_TYPE_FLOAT: {
+      double v = fl_value_get_float(self);
+      // 0.0 and -0.0 are equal but have a different representation.
+      return v == 0.0 ? 0 : g_double_hash(&v);
+    }
+    case FL_VALUE_TYPE_STRING:
+      return g_str_hash(fl_value_get_string(self));
+    case FL_VALUE_TYPE_UINT8_LIST:
+    case FL_VALUE_TYPE_INT32_LIST:
+    case FL_VALUE_TYPE_INT64_LIST:
+    case FL_VALUE_TYPE_FLOAT32_LIST:
+    case FL_VALUE_TYPE_FLOAT_LIST:
+      return self->type * 31 + static_cast<guint>(fl_value_get_length(self));
+    case FL_VALUE_TYPE_LIST:
+    case FL_VALUE_TYPE_MAP:
+      // Lists and maps can be modified after they are used as a key, so only
+      // hash what can't change.
+      return self->type;
+  }
+  return 0;
+}
+
+// Helper function to match GEqualFunc type.
+static gboolean fl_value_equal_func(gconstpointer a, gconstpointer b) {
+  return fl_value_equal(static_cast<FlValue*>(const_cast<gpointer>(a)),
+                        static_cast<FlValue*>(const_cast<gpointer>(b)));
+}
+
 // Finds the index of a key in a FlValueMap.
-// FIXME(robert-ancell) This is highly inefficient, and should be optimized if
-// necessary.
 static ssize_t fl_value_lookup_index(FlValue* self, FlValue* key) {
   g_return_val_if_fail(self->type == FL_VALUE_TYPE_MAP, -1);
 
-  for (size_t i = 0; i < fl_value_get_length(self); i++) {
-    FlValue* k = fl_value_get_map_key(self, i);
+  FlValueMap* v = reinterpret_cast<FlValueMap*>(self);
+  if (v->index == nullptr && v->keys->len >= kMapIndexMinimumLength) {
+    v->index = g_hash_table_new(fl_value_hash, fl_value_equal_func);
+    for (guint i = 0; i < v->keys->len; i++) {
+      g_hash_table_insert(v->index, g_ptr_array_index(v->keys, i),
+                          GUINT_TO_POINTER(i));
+    }
+  }
+
+  if (v->index != nullptr) {
+    gpointer index;
+    if (g_hash_table_lookup_extended(v->index, key, nullptr, &index)) {
+      return GPOINTER_TO_UINT(index);
+    }
+    return -1;
+  }
+
+  for (size_t i = 0; i < v->keys->len; i++) {
+    FlValue* k = static_cast<FlValue*>(g_ptr_array_index(v->keys, i));
     if (fl_value_equal(k, key)) {
       return i;
     }
@@ -101,6 +178,15 @@ static ssize_t fl_value_lookup_index(FlValue* self, FlValue* key) {
   return -1;
 }
 
+// Frees the elements of a typed list.
+static void free_typed_list_values(gpointer values, GBytes* bytes) {
+  if (bytes != nullptr) {
+    g_bytes_unref(bytes);
+  } else {
+    g_free(values);
+  }
+}
+
 // Converts an integer to a string and adds it to the buffer.
 static void int_to_string(int64_t value, GString* buffer) {
   g_string_append_printf(buffer, "%" G_GINT64_FORMAT, value);
@@ -289,10 +375,8 @@ G_MODULE_EXPORT FlValue* fl_value_new_uint8_list(const uint8_t* data,
 }
 
 G_MODULE_EXPORT FlValue* fl_value_new_uint8_list_from_bytes(GBytes* data) {
-  gsize length;
-  const uint8_t* d =
-      static_cast<const uint8_t*>(g_bytes_get_data(data, &length));
-  return fl_value_new_uint8_list(d, length);
+  return fl_value_new_typed_list_from_bytes(FL_VALUE_TYPE_UINT8_LIST, data, 0,
+                                            g_bytes_get_size(data));
 }
 
 G_MODULE_EXPORT FlValue* fl_value_new_int32_list(const int32_t* data,
@@ -335,6 +419,67 @@ G_MODULE_EXPORT FlValue* fl_value_new_float_list(const double* data,
   return reinterpret_cast<FlValue*>(self);
 }
 
+FlValue* fl_value_new_typed_list_from_bytes(FlValueType type,
+                                            GBytes* bytes,
+                                            size_t offset,
+                                            size_t length) {
+  size_t element_size;
+  switch (type) {
+    case FL_VALUE_TYPE_UINT8_LIST:
+      element_size = sizeof(uint8_t);
+      break;
+    case FL_VALUE_TYPE_INT32_LIST:
+      element_size = sizeof(int32_t);
+      break;
+    case FL_VALUE_TYPE_INT64_LIST:
+      element_size = sizeof(int64_t);
+      break;
+    case FL_VALUE_TYPE_FLOAT32_LIST:
+      element_size = sizeof(float);
+      break;
+    case FL_VALUE_TYPE_FLOAT_LIST:
+      element_size = sizeof(double);
+      break;
+    default:
+      g_return_val_if_reached(nullptr);
+  }
+  g_return_val_if_fail(
+      offset + element_size * length <= g_bytes_get_size(bytes), nullptr);
+
+  const uint8_t* data =
+      static_cast<const uint8_t*>(g_bytes_get_data(bytes, nullptr)) + offset;
+
+  // The elements can only be read in place if they are aligned.
+  if (element_size * length < kBorrowMinimumSize ||
+      reinterpret_cast<uintptr_t>(data) % element_size != 0) {
+    switch (type) {
+      case FL_VALUE_TYPE_UINT8_LIST:
+        return fl_value_new_uint8_list(data, length);
+      case FL_VALUE_TYPE_INT32_LIST:
+        return fl_value_new_int32_list(reinterpret_cast<const int32_t*>(data),
+                                       length);
+      case FL_VALUE_TYPE_INT64_LIST:
+        return fl_value_new_int64_list(reinterpret_cast<const int64_t*>(data),
+                                       length);
+      case FL_VALUE_TYPE_FLOAT32_LIST:
+        return fl_value_new_float32_list(reinterpret_cast<const float*>(data),
+                                         length);
+      default:
+        return fl_value_new_float_list(reinterpret_cast<const double*>(data),
+                                       length);
+    }
+  }
+
+  // All typed lists have the same layout, and the elements are never
+  // modified, so the values can point into the #GBytes.
+  FlValueUint8List* self = reinterpret_cast<FlValueUint8List*>(
+      fl_value_new(type, sizeof(FlValueUint8List)));
+  self->values = const_cast<uint8_t*>(data);
+  self->values_length = length;
+  self->bytes = g_bytes_ref(bytes);
+  return reinterpret_cast<FlValue*>(self);
+}
+
 G_MODULE_EXPORT FlValue* fl_value_new_list() {
   FlValueList* self = reinterpret_cast<FlValueList*>(
       fl_value_new(FL_VALUE_TYPE_LIST, sizeof(FlValueList)));
@@ -382,27 +527,27 @@ G_MODULE_EXPORT void fl_value_unref(FlValue* self) {
     }
     case FL_VALUE_TYPE_UINT8_LIST: {
       FlValueUint8List* v = reinterpret_cast<FlValueUint8List*>(self);
-      g_free(v->values);
+      free_typed_list_values(v->values, v->bytes);
       break;
     }
     case FL_VALUE_TYPE_INT32_LIST: {
       FlValueInt32List* v = reinterpret_cast<FlValueInt32List*>(self);
-      g_free(v->values);
+      free_typed_list_values(v->values, v->bytes);
       break;
     }
     case FL_VALUE_TYPE_INT64_LIST: {
       FlValueInt64List* v = reinterpret_cast<FlValueInt64List*>(self);
-      g_free(v->values);
+      free_typed_list_values(v->values, v->bytes);
       break;
     }
     case FL_VALUE_TYPE_FLOAT32_LIST: {
       FlValueFloat32List* v = reinterpret_cast<FlValueFloat32List*>(self);
-      g_free(v->values);
+      free_typed_list_values(v->values, v->bytes);
       break;
     }
     case FL_VALUE_TYPE_FLOAT_LIST: {
       FlValueFloatList* v = reinterpret_cast<FlValueFloatList*>(self);
-      g_free(v->values);
+      free_typed_list_values(v->values, v->bytes);
       break;
     }
     case FL_VALUE_TYPE_LIST: {
@@ -414,6 +559,9 @@ G_MODULE_EXPORT void fl_value_unref(FlValue* self) {
       FlValueMap* v = reinterpret_cast<FlValueMap*>(self);
       g_ptr_array_unref(v->keys);
       g_ptr_array_unref(v->values);
+      if (v->index != nullptr) {
+        g_hash_table_unref(v->index);
+      }
       break;
     }
     case FL_VALUE_TYPE_NULL:
@@ -586,9 +734,16 @@ G_MODULE_EXPORT void fl_value_set_take(FlValue* self,
   FlValueMap* v = reinterpret_cast<FlValueMap*>(self);
   ssize_t index = fl_value_lookup_index(self, key);
   if (index < 0) {
+    if (v->index != nullptr) {
+      g_hash_table_insert(v->index, key, GUINT_TO_POINTER(v->keys->len));
+    }
     g_ptr_array_add(v->keys, key);
     g_ptr_array_add(v->values, value);
   } else {
+    if (v->index != nullptr) {
+      // Replace the key in the index before the old key is freed.
+      g_hash_table_replace(v->index, key, GUINT_TO_POINTER(index));
+    }
     fl_value_destroy(v->keys->pdata[index]);
     v->keys->pdata[index] = key;
     fl_value_destroy(v->values->pdata[index]);
@@ -783,3 +938,18 @@ G_MODULE_EXPORT gchar* fl_value_to_string(FlValue* value) {
   value_to_string(value, buffer);
   return g_string_free(buffer, FALSE);
 }
+
+gboolean fl_value_is_borrowed(FlValue* self) {
+  g_return_val_if_fail(self != nullptr, FALSE);
+
+  switch (self->type) {
+    case FL_VALUE_TYPE_UINT8_LIST:
+    case FL_VALUE_TYPE_INT32_LIST:
+    case FL_VALUE_TYPE_INT64_LIST:
+    case FL_VALUE_TYPE_FLOAT32_LIST:
+    case FL_VALUE_TYPE_FLOAT_LIST:
+      return reinterpret_cast<FlValueUint8List*>(self)->bytes != nullptr;
+    default:
+      return FALSE;
+  }
+}
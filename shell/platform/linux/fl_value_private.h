@@ -0,0 +1,43 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_LINUX_FL_VALUE_PRIVATE_H_
+#define FLUTTER_SHELL_PLATFORM_LINUX_FL_VALUE_PRIVATE_H_
+
+#include "flutter/shell/platform/linux/public/flutter_linux/fl_value.h"
+
+G_BEGIN_DECLS
+
+/**
+ * fl_value_new_typed_list_from_bytes:
+ * @type: the type of list to create, one of %FL_VALUE_TYPE_UINT8_LIST,
+ * %FL_VALUE_TYPE_INT32_LIST, %FL_VALUE_TYPE_INT64_LIST,
+ * %FL_VALUE_TYPE_FLOAT32_LIST or %FL_VALUE_TYPE_FLOAT_LIST.
+ * @bytes: a #GBytes containing the list.
+ * @offset: offset of the first element in @bytes.
+ * @length: number of elements in the list.
+ *
+ * Creates a typed list from the native endian elements in @bytes. Large,
+ * aligned lists reference @bytes instead of copying the data.
+ *
+ * Returns: a new #FlValue.
+ */
+FlValue* fl_value_new_typed_list_from_bytes(FlValueType type,
+                                            GBytes* bytes,
+                                            size_t offset,
+                                            size_t length);
+
+/**
+ * fl_value_is_borrowed:
+ * @value: an #FlValue.
+ *
+ * Checks if a typed list references the #GBytes it was created from.
+ *
+ * Returns: %TRUE if the list does not own a copy of its elements.
+ */
+gboolean fl_value_is_borrowed(FlValue* value);
+
+G_END_DECLS
+
+#endif  // FLUTTER_SHELL_PLATFORM_LINUX_FL_VALUE_PRIVATE_H_
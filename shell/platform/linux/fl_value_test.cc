@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include "flutter/shell/platform/linux/public/flutter_linux/fl_value.h"
+#include "flutter/shell/platform/linux/fl_value_private.h"
 
 #include <gmodule.h>
 
@@ -253,6 +254,41 @@ TEST(FlValueTest, Uint8ListEmptyNotEqual) {
   EXPECT_FALSE(fl_value_equal(value1, value2));
 }
 
+TEST(FlValueTest, Uint8ListFromBytes) {
+  g_autofree uint8_t* data = static_cast<uint8_t*>(g_malloc(4096));
+  for (int i = 0; i < 4096; i++) {
+    data[i] = i;
+  }
+  g_autoptr(GBytes) bytes = g_bytes_new_take(g_steal_pointer(&data), 4096);
+  g_autoptr(FlValue) value = fl_value_new_uint8_list_from_bytes(bytes);
+  ASSERT_EQ(fl_value_get_type(value), FL_VALUE_TYPE_UINT8_LIST);
+  ASSERT_EQ(fl_value_get_length(value), static_cast<size_t>(4096));
+  EXPECT_EQ(fl_value_get_uint8_list(value)[255], 255);
+  // Large lists reference the data instead of copying it.
+  EXPECT_TRUE(fl_value_is_borrowed(value));
+  EXPECT_EQ(fl_value_get_uint8_list(value), g_bytes_get_data(bytes, nullptr));
+}
+
+TEST(FlValueTest, Uint8ListFromSmallBytes) {
+  uint8_t data[] = {0x00, 0x01, 0xFE, 0xFF};
+  g_autoptr(GBytes) bytes = g_bytes_new(data, 4);
+  g_autoptr(FlValue) value = fl_value_new_uint8_list_from_bytes(bytes);
+  ASSERT_EQ(fl_value_get_length(value), static_cast<size_t>(4));
+  EXPECT_EQ(fl_value_get_uint8_list(value)[2], 0xFE);
+  EXPECT_FALSE(fl_value_is_borrowed(value));
+}
+
+TEST(FlValueTest, Int32ListFromUnalignedBytes) {
+  g_autofree uint8_t* data = static_cast<uint8_t*>(g_malloc0(4097));
+  g_autoptr(GBytes) bytes = g_bytes_new_take(g_steal_pointer(&data), 4097);
+  g_autoptr(FlValue) value = fl_value_new_typed_list_from_bytes(
+      FL_VALUE_TYPE_INT32_LIST, bytes, 1, 1024);
+  ASSERT_EQ(fl_value_get_type(value), FL_VALUE_TYPE_INT32_LIST);
+  ASSERT_EQ(fl_value_get_length(value), static_cast<size_t>(1024));
+  // Unaligned elements are copied.
+  EXPECT_FALSE(fl_value_is_borrowed(value));
+}
+
 TEST(FlValueTest, Uint8ListToString) {
   uint8_t data[] = {0x00, 0x01, 0xFE, 0xFF};
   g_autoptr(FlValue) value = fl_value_new_uint8_list(data, 4);
@@ -669,6 +705,49 @@ TEST(FlValueTest, MapLookup) {
   ASSERT_EQ(v, nullptr);
 }
 
+TEST(FlValueTest, MapLookupLarge) {
+  g_autoptr(FlValue) value = fl_value_new_map();
+  for (int i = 0; i < 100; i++) {
+    g_autofree gchar* key = g_strdup_printf("key%d", i);
+    fl_value_set_string_take(value, key, fl_value_new_int(i));
+  }
+  for (int i = 0; i < 100; i++) {
+    g_autofree gchar* key = g_strdup_printf("key%d", i);
+    FlValue* v = fl_value_lookup_string(value, key);
+    ASSERT_NE(v, nullptr);
+    EXPECT_EQ(fl_value_get_int(v), i);
+  }
+  EXPECT_EQ(fl_value_lookup_string(value, "key100"), nullptr);
+
+  // Keys added and replaced after the first lookup are found.
+  fl_value_set_string_take(value, "key100", fl_value_new_int(100));
+  fl_value_set_string_take(value, "key50", fl_value_new_int(-50));
+  ASSERT_EQ(fl_value_get_length(value), static_cast<size_t>(101));
+  EXPECT_EQ(fl_value_get_int(fl_value_lookup_string(value, "key100")), 100);
+  EXPECT_EQ(fl_value_get_int(fl_value_lookup_string(value, "key50")), -50);
+  EXPECT_STREQ(fl_value_get_string(fl_value_get_map_key(value, 50)), "key50");
+}
+
+TEST(FlValueTest, MapLookupLargeKeyTypes) {
+  g_autoptr(FlValue) value = fl_value_new_map();
+  for (int i = 0; i < 100; i++) {
+    fl_value_set_take(value, fl_value_new_int(i), fl_value_new_int(i));
+  }
+  g_autoptr(FlValue) list_key = fl_value_new_list();
+  fl_value_set(value, list_key, list_key);
+  fl_value_set_take(value, fl_value_new_float(0.0), fl_value_new_null());
+
+  g_autoptr(FlValue) int_key = fl_value_new_int(42);
+  EXPECT_EQ(fl_value_get_int(fl_value_lookup(value, int_key)), 42);
+  // Lists used as keys may be modified after they are added.
+  fl_value_append_take(list_key, fl_value_new_int(1));
+  g_autoptr(FlValue) other_list_key = fl_value_new_list();
+  fl_value_append_take(other_list_key, fl_value_new_int(1));
+  EXPECT_EQ(fl_value_lookup(value, other_list_key), list_key);
+  g_autoptr(FlValue) negative_zero_key = fl_value_new_float(-0.0);
+  EXPECT_NE(fl_value_lookup(value, negative_zero_key), nullptr);
+}
+
 TEST(FlValueTest, MapLookupString) {
   g_autoptr(FlValue) value = fl_value_new_map();
   fl_value_set_string_take(value, "one", fl_value_new_int(1));
@@ -790,6 +869,19 @@ TEST(FlValueTest, MapEqualDifferentOrder) {
   EXPECT_TRUE(fl_value_equal(value1, value2));
 }
 
+TEST(FlValueTest, MapEqualLarge) {
+  g_autoptr(FlValue) value1 = fl_value_new_map();
+  g_autoptr(FlValue) value2 = fl_value_new_map();
+  for (int i = 0; i < 100; i++) {
+    fl_value_set_take(value1, fl_value_new_int(i), fl_value_new_int(i));
+    fl_value_set_take(value2, fl_value_new_int(99 - i),
+                      fl_value_new_int(99 - i));
+  }
+  EXPECT_TRUE(fl_value_equal(value1, value2));
+  fl_value_set_take(value2, fl_value_new_int(0), fl_value_new_int(1));
+  EXPECT_FALSE(fl_value_equal(value1, value2));
+}
+
 TEST(FlValueTest, MapEmptyEqual) {
   g_autoptr(FlValue) value1 = fl_value_new_map();
   g_autoptr(FlValue) value2 = fl_value_new_map();
@@ -102,6 +102,44 @@ struct _FlPixelBufferTextureClass {
                           GError** error);
 };
 
+/**
+ * fl_pixel_buffer_texture_add_dirty_rect:
+ * @texture: an #FlPixelBufferTexture.
+ * @x: left edge of the changed region in pixels.
+ * @y: top edge of the changed region in pixels.
+ * @width: width of the changed region in pixels.
+ * @height: height of the changed region in pixels.
+ *
+ * Marks a region of the pixel buffer as changed since the last frame. Call
+ * this before fl_texture_registrar_mark_texture_frame_available() for each
+ * changed region. Only the rows containing these regions are uploaded for the
+ * next frame. If no region is marked, the whole pixel buffer is uploaded.
+ *
+ * This method can be called from any thread.
+ */
+void fl_pixel_buffer_texture_add_dirty_rect(FlPixelBufferTexture* texture,
+                                            uint32_t x,
+                                            uint32_t y,
+                                            uint32_t width,
+                                            uint32_t height);
+
+/**
+ * fl_pixel_buffer_texture_set_use_pixel_buffer_objects:
+ * @texture: an #FlPixelBufferTexture.
+ * @use_pixel_buffer_objects: %TRUE to upload pixels through pixel buffer
+ * objects.
+ *
+ * Sets whether pixels are uploaded through a ring of OpenGL pixel buffer
+ * objects. The upload then completes asynchronously, which is faster for
+ * large pixel buffers that change every frame, such as video frames. This
+ * requires OpenGL 3.0 or OpenGL ES 3.0 and is ignored otherwise.
+ *
+ * Call this before registering @texture.
+ */
+void fl_pixel_buffer_texture_set_use_pixel_buffer_objects(
+    FlPixelBufferTexture* texture,
+    gboolean use_pixel_buffer_objects);
+
 G_END_DECLS
 
 #endif  // FLUTTER_SHELL_PLATFORM_LINUX_FL_PIXEL_BUFFER_TEXTURE_H_
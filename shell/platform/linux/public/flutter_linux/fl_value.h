@@ -153,8 +153,9 @@ FlValue* fl_value_new_uint8_list(const uint8_t* value, size_t value_length);
  * fl_value_new_uint8_list_from_bytes:
  * @value: a #GBytes.
  *
- * Creates an ordered list containing 8 bit unsigned integers. The data is
- * copied. The equivalent Dart type is a Uint8List.
+ * Creates an ordered list containing 8 bit unsigned integers. Large lists
+ * keep a reference to @value instead of copying the data. The equivalent Dart
+ * type is a Uint8List.
  *
  * Returns: a new #FlValue.
  */
@@ -6,7 +6,9 @@
 
 #include <windows.h>
 
+#include <codecvt>
 #include <cstdint>
+#include <locale>
 
 #include "flutter/shell/platform/common/json_method_codec.h"
 
@@ -23,11 +25,14 @@ static constexpr char kMultilineInputType[] = "TextInputType.multiline";
 
 static constexpr char kUpdateEditingStateMethod[] =
     "TextInputClient.updateEditingState";
+static constexpr char kUpdateEditingStateWithDeltasMethod[] =
+    "TextInputClient.updateEditingStateWithDeltas";
 static constexpr char kPerformActionMethod[] = "TextInputClient.performAction";
 
 static constexpr char kTextInputAction[] = "inputAction";
 static constexpr char kTextInputType[] = "inputType";
 static constexpr char kTextInputTypeName[] = "name";
+static constexpr char kEnableDeltaModel[] = "enableDeltaModel";
 static constexpr char kComposingBaseKey[] = "composingBase";
 static constexpr char kComposingExtentKey[] = "composingExtent";
 static constexpr char kSelectionAffinityKey[] = "selectionAffinity";
@@ -41,6 +46,11 @@ static constexpr char kYKey[] = "y";
 static constexpr char kWidthKey[] = "width";
 static constexpr char kHeightKey[] = "height";
 static constexpr char kTransformKey[] = "transform";
+static constexpr char kDeltasKey[] = "deltas";
+static constexpr char kDeltaOldTextKey[] = "oldText";
+static constexpr char kDeltaTextKey[] = "deltaText";
+static constexpr char kDeltaStartKey[] = "deltaStart";
+static constexpr char kDeltaEndKey[] = "deltaEnd";
 
 static constexpr char kChannelName[] = "flutter/textinput";
 
@@ -48,12 +58,30 @@ static constexpr char kBadArgumentError[] = "Bad Arguments";
 static constexpr char kInternalConsistencyError[] =
     "Internal Consistency Error";
 
+namespace {
+
+std::string Utf8FromUtf16(const std::u16string& text) {
+  std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t>
+      utf8_converter;
+  return utf8_converter.to_bytes(text);
+}
+
+}  // namespace
+
 namespace flutter {
 
 void TextInputPlugin::TextHook(const std::u16string& text) {
   if (active_model_ == nullptr) {
     return;
   }
+  if (enable_delta_model_) {
+    TextEditingDelta delta(active_model_->GetText(),
+                           active_model_->GetReplacedRange(),
+                           Utf8FromUtf16(text));
+    active_model_->AddText(text);
+    SendStateUpdateWithDelta(*active_model_, delta);
+    return;
+  }
   active_model_->AddText(text);
   SendStateUpdate(*active_model_);
 }
@@ -150,11 +178,21 @@ void TextInputPlugin::ComposeChangeHook(const std::u16string& text,
   if (active_model_ == nullptr) {
     return;
   }
+  std::unique_ptr<TextEditingDelta> delta;
+  if (enable_delta_model_) {
+    delta = std::make_unique<TextEditingDelta>(
+        active_model_->GetText(), active_model_->GetReplacedRange(),
+        Utf8FromUtf16(text));
+  }
   active_model_->AddText(text);
   cursor_pos += active_model_->composing_range().base();
   active_model_->UpdateComposingText(text);
   active_model_->SetSelection(TextRange(cursor_pos, cursor_pos));
-  SendStateUpdate(*active_model_);
+  if (delta) {
+    SendStateUpdateWithDelta(*active_model_, *delta);
+  } else {
+    SendStateUpdate(*active_model_);
+  }
 }
 
 void TextInputPlugin::HandleMethodCall(
@@ -191,6 +229,11 @@ void TextInputPlugin::HandleMethodCall(
       return;
     }
     client_id_ = client_id_json.GetInt();
+    auto enable_delta_model_json = client_config.FindMember(kEnableDeltaModel);
+    enable_delta_model_ =
+        enable_delta_model_json != client_config.MemberEnd() &&
+        enable_delta_model_json->value.IsBool() &&
+        enable_delta_model_json->value.GetBool();
     input_action_ = "";
     auto input_action_json = client_config.FindMember(kTextInputAction);
     if (input_action_json != client_config.MemberEnd() &&
@@ -356,10 +399,53 @@ void TextInputPlugin::SendStateUpdate(const TextInputModel& model) {
   channel_->InvokeMethod(kUpdateEditingStateMethod, std::move(args));
 }
 
+void TextInputPlugin::SendStateUpdateWithDelta(const TextInputModel& model,
+                                               const TextEditingDelta& delta) {
+  auto args = std::make_unique<rapidjson::Document>(rapidjson::kArrayType);
+  auto& allocator = args->GetAllocator();
+  args->PushBack(client_id_, allocator);
+
+  rapidjson::Value delta_json(rapidjson::kObjectType);
+  delta_json.AddMember(
+      kDeltaOldTextKey,
+      rapidjson::Value(delta.old_text(), allocator).Move(), allocator);
+  delta_json.AddMember(
+      kDeltaTextKey, rapidjson::Value(delta.delta_text(), allocator).Move(),
+      allocator);
+  delta_json.AddMember(kDeltaStartKey, delta.delta_start(), allocator);
+  delta_json.AddMember(kDeltaEndKey, delta.delta_end(), allocator);
+
+  TextRange selection = model.selection();
+  delta_json.AddMember(kSelectionAffinityKey, kAffinityDownstream, allocator);
+  delta_json.AddMember(kSelectionBaseKey, selection.base(), allocator);
+  delta_json.AddMember(kSelectionExtentKey, selection.extent(), allocator);
+  delta_json.AddMember(kSelectionIsDirectionalKey, false, allocator);
+
+  int composing_base = model.composing() ? model.composing_range().base() : -1;
+  int composing_extent =
+      model.composing() ? model.composing_range().extent() : -1;
+  delta_json.AddMember(kComposingBaseKey, composing_base, allocator);
+  delta_json.AddMember(kComposingExtentKey, composing_extent, allocator);
+
+  rapidjson::Value deltas(rapidjson::kArrayType);
+  deltas.PushBack(delta_json, allocator);
+  rapidjson::Value object(rapidjson::kObjectType);
+  object.AddMember(kDeltasKey, deltas, allocator);
+  args->PushBack(object, allocator);
+
+  channel_->InvokeMethod(kUpdateEditingStateWithDeltasMethod, std::move(args));
+}
+
 void TextInputPlugin::EnterPressed(TextInputModel* model) {
   if (input_type_ == kMultilineInputType) {
-    model->AddText(std::u16string({u'\n'}));
-    SendStateUpdate(*model);
+    if (enable_delta_model_) {
+      TextEditingDelta delta(model->GetText(), model->GetReplacedRange(), "\n");
+      model->AddText(std::u16string({u'\n'}));
+      SendStateUpdateWithDelta(*model, delta);
+    } else {
+      model->AddText(std::u16string({u'\n'}));
+      SendStateUpdate(*model);
+    }
   }
   auto args = std::make_unique<rapidjson::Document>(rapidjson::kArrayType);
   auto& allocator = args->GetAllocator();
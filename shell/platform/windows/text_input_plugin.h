@@ -13,6 +13,7 @@
 #include "flutter/shell/platform/common/client_wrapper/include/flutter/method_channel.h"
 #include "flutter/shell/platform/common/geometry.h"
 #include "flutter/shell/platform/common/json_method_codec.h"
+#include "flutter/shell/platform/common/text_editing_delta.h"
 #include "flutter/shell/platform/common/text_input_model.h"
 #include "flutter/shell/platform/windows/keyboard_handler_base.h"
 #include "flutter/shell/platform/windows/text_input_plugin_delegate.h"
@@ -50,6 +51,13 @@ class TextInputPlugin {
   // Sends the current state of the given model to the Flutter engine.
   void SendStateUpdate(const TextInputModel& model);
 
+  // Sends a text change to the Flutter engine, along with the current
+  // selection and composing range of the given model.
+  //
+  // Only used if the client enabled the delta model.
+  void SendStateUpdateWithDelta(const TextInputModel& model,
+                                const TextEditingDelta& delta);
+
   // Sends an action triggered by the Enter key to the Flutter engine.
   void EnterPressed(TextInputModel* model);
 
@@ -82,6 +90,9 @@ class TextInputPlugin {
   // https://api.flutter.dev/flutter/services/TextInputAction-class.html
   std::string input_action_;
 
+  // Whether to send text changes as deltas instead of the whole text.
+  bool enable_delta_model_ = false;
+
   // The smallest rect, in local coordinates, of the text in the composing
   // range, or of the caret in the case where there is no current composing
   // range. This value is updated via `TextInput.setMarkedTextRect` messages
@@ -137,5 +137,101 @@ TEST(TextInputPluginTest, VerifyComposingSendStateUpdate) {
   EXPECT_TRUE(sent_message);
 }
 
+// Verify that the embedder sends text editing deltas to the framework if the
+// client enabled the delta model.
+TEST(TextInputPluginTest, SendsDeltasWhenDeltaModelEnabled) {
+  std::unique_ptr<MethodCall<rapidjson::Document>> sent_call;
+  auto& codec = JsonMethodCodec::GetInstance();
+  TestBinaryMessenger messenger(
+      [&sent_call, &codec](const std::string& channel, const uint8_t* message,
+                           size_t message_size, BinaryReply reply) {
+        sent_call = codec.DecodeMethodCall(message, message_size);
+      });
+  BinaryReply reply_handler = [](const uint8_t* reply, size_t reply_size) {};
+
+  EmptyTextInputPluginDelegate delegate;
+  TextInputPlugin handler(&messenger, &delegate);
+
+  auto arguments = std::make_unique<rapidjson::Document>(rapidjson::kArrayType);
+  auto& allocator = arguments->GetAllocator();
+  arguments->PushBack(42, allocator);
+  rapidjson::Value config(rapidjson::kObjectType);
+  config.AddMember("inputAction", "done", allocator);
+  config.AddMember("inputType", "text", allocator);
+  config.AddMember("enableDeltaModel", true, allocator);
+  arguments->PushBack(config, allocator);
+  auto message =
+      codec.EncodeMethodCall({"TextInput.setClient", std::move(arguments)});
+  messenger.SimulateEngineMessage("flutter/textinput", message->data(),
+                                  message->size(), reply_handler);
+
+  handler.TextHook(u"a");
+  handler.TextHook(u"b");
+  ASSERT_NE(sent_call, nullptr);
+  EXPECT_EQ(sent_call->method_name(),
+            "TextInputClient.updateEditingStateWithDeltas");
+  const rapidjson::Value& delta = (*sent_call->arguments())[1]["deltas"][0];
+  EXPECT_STREQ(delta["oldText"].GetString(), "a");
+  EXPECT_STREQ(delta["deltaText"].GetString(), "b");
+  EXPECT_EQ(delta["deltaStart"].GetInt(), 1);
+  EXPECT_EQ(delta["deltaEnd"].GetInt(), 1);
+  EXPECT_EQ(delta["selectionBase"].GetInt(), 2);
+  EXPECT_EQ(delta["selectionExtent"].GetInt(), 2);
+}
+
+// Verify that composing over a selection sends a delta that replaces the
+// selection, which is deleted before the composing text is inserted.
+TEST(TextInputPluginTest, ComposingDeltaReplacesSelection) {
+  std::unique_ptr<MethodCall<rapidjson::Document>> sent_call;
+  auto& codec = JsonMethodCodec::GetInstance();
+  TestBinaryMessenger messenger(
+      [&sent_call, &codec](const std::string& channel, const uint8_t* message,
+                           size_t message_size, BinaryReply reply) {
+        sent_call = codec.DecodeMethodCall(message, message_size);
+      });
+  BinaryReply reply_handler = [](const uint8_t* reply, size_t reply_size) {};
+
+  EmptyTextInputPluginDelegate delegate;
+  TextInputPlugin handler(&messenger, &delegate);
+
+  auto arguments = std::make_unique<rapidjson::Document>(rapidjson::kArrayType);
+  auto& allocator = arguments->GetAllocator();
+  arguments->PushBack(42, allocator);
+  rapidjson::Value config(rapidjson::kObjectType);
+  config.AddMember("inputAction", "done", allocator);
+  config.AddMember("inputType", "text", allocator);
+  config.AddMember("enableDeltaModel", true, allocator);
+  arguments->PushBack(config, allocator);
+  auto message =
+      codec.EncodeMethodCall({"TextInput.setClient", std::move(arguments)});
+  messenger.SimulateEngineMessage("flutter/textinput", message->data(),
+                                  message->size(), reply_handler);
+
+  auto state = std::make_unique<rapidjson::Document>(rapidjson::kObjectType);
+  auto& state_allocator = state->GetAllocator();
+  state->AddMember("text", "abcd", state_allocator);
+  state->AddMember("selectionBase", 1, state_allocator);
+  state->AddMember("selectionExtent", 3, state_allocator);
+  state->AddMember("composingBase", -1, state_allocator);
+  state->AddMember("composingExtent", -1, state_allocator);
+  message = codec.EncodeMethodCall(
+      {"TextInput.setEditingState", std::move(state)});
+  messenger.SimulateEngineMessage("flutter/textinput", message->data(),
+                                  message->size(), reply_handler);
+
+  handler.ComposeBeginHook();
+  handler.ComposeChangeHook(u"x", 1);
+  ASSERT_NE(sent_call, nullptr);
+  EXPECT_EQ(sent_call->method_name(),
+            "TextInputClient.updateEditingStateWithDeltas");
+  const rapidjson::Value& delta = (*sent_call->arguments())[1]["deltas"][0];
+  EXPECT_STREQ(delta["oldText"].GetString(), "abcd");
+  EXPECT_STREQ(delta["deltaText"].GetString(), "x");
+  EXPECT_EQ(delta["deltaStart"].GetInt(), 1);
+  EXPECT_EQ(delta["deltaEnd"].GetInt(), 3);
+  EXPECT_EQ(delta["composingBase"].GetInt(), 1);
+  EXPECT_EQ(delta["composingExtent"].GetInt(), 2);
+}
+
 }  // namespace testing
 }  // namespace flutter
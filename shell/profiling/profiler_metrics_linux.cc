@@ -0,0 +1,285 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/profiling/profiler_metrics_linux.h"
+
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+
+#include "flutter/fml/eintr_wrapper.h"
+#include "flutter/fml/logging.h"
+
+namespace flutter {
+namespace {
+
+constexpr double kKiloBytesPerMegaByte = 1024.0;
+constexpr char kWorkerThreadPrefix[] = "io.worker.";
+constexpr char kWorkerThreadName[] = "worker";
+constexpr char kOtherThreadName[] = "other";
+
+fml::UniqueFD OpenProcFile(const std::string& path) {
+  return fml::UniqueFD{
+      FML_HANDLE_EINTR(::open(path.c_str(), O_RDONLY | O_CLOEXEC))};
+}
+
+// Reads the current contents of a procfs file that is kept open.
+bool ReadProcFile(const fml::UniqueFD& fd, std::string* contents) {
+  if (!fd.is_valid()) {
+    return false;
+  }
+  contents->clear();
+  char buffer[4096];
+  off_t offset = 0;
+  while (true) {
+    ssize_t read = FML_HANDLE_EINTR(
+        ::pread(fd.get(), buffer, sizeof(buffer), offset));
+    if (read < 0) {
+      return false;
+    }
+    if (read == 0) {
+      return true;
+    }
+    contents->append(buffer, read);
+    offset += read;
+  }
+}
+
+}  // namespace
+
+ProfilerMetricsLinux::ProfilerMetricsLinux()
+    : ticks_per_second_(::sysconf(_SC_CLK_TCK)),
+      num_cores_(std::max(::sysconf(_SC_NPROCESSORS_ONLN), 1l)),
+      process_stat_fd_(OpenProcFile("/proc/self/stat")),
+      smaps_rollup_fd_(OpenProcFile("/proc/self/smaps_rollup")),
+      task_dir_(::opendir("/proc/self/task")) {
+  // smaps_rollup is only available since Linux 4.14.
+  if (!smaps_rollup_fd_.is_valid()) {
+    statm_fd_ = OpenProcFile("/proc/self/statm");
+  }
+}
+
+ProfilerMetricsLinux::~ProfilerMetricsLinux() {
+  if (task_dir_) {
+    ::closedir(task_dir_);
+  }
+}
+
+ProfileSample ProfilerMetricsLinux::GenerateSample() {
+  ProfileSample sample;
+  sample.cpu_usage = CpuUsage();
+  sample.memory_usage = MemoryUsage();
+  std::scoped_lock lock(mutex_);
+  sample.cache_usage = cache_usage_;
+  return sample;
+}
+
+void ProfilerMetricsLinux::RegisterCurrentThread(std::string thread_name) {
+  pid_t tid = static_cast<pid_t>(::syscall(SYS_gettid));
+  std::scoped_lock lock(mutex_);
+  registered_threads_[tid] = std::move(thread_name);
+}
+
+void ProfilerMetricsLinux::SetCacheUsage(CacheUsageInfo cache_usage) {
+  std::scoped_lock lock(mutex_);
+  cache_usage_ = cache_usage;
+}
+
+std::optional<uint64_t> ProfilerMetricsLinux::ParseCpuTicks(
+    const std::string& stat,
+    std::string* thread_name) {
+  // The thread name is the second field. It is enclosed in parentheses and may
+  // contain spaces and parentheses itself.
+  size_t name_start = stat.find('(');
+  size_t name_end = stat.rfind(')');
+  if (name_start == std::string::npos || name_end == std::string::npos ||
+      name_end < name_start) {
+    return std::nullopt;
+  }
+  if (thread_name) {
+    *thread_name = stat.substr(name_start + 1, name_end - name_start - 1);
+  }
+
+  // utime and stime are the 14th and 15th fields, the 11th and 12th after the
+  // thread name.
+  std::istringstream fields(stat.substr(name_end + 1));
+  std::string field;
+  for (int i = 0; i < 11; i++) {
+    if (!(fields >> field)) {
+      return std::nullopt;
+    }
+  }
+  uint64_t utime = 0;
+  uint64_t stime = 0;
+  if (!(fields >> utime >> stime)) {
+    return std::nullopt;
+  }
+  return utime + stime;
+}
+
+std::optional<MemoryUsageInfo> ProfilerMetricsLinux::ParseSmapsRollup(
+    const std::string& smaps_rollup) {
+  std::optional<uint64_t> rss_kb;
+  std::optional<uint64_t> private_dirty_kb;
+  std::istringstream lines(smaps_rollup);
+  std::string line;
+  while (std::getline(lines, line)) {
+    std::istringstream fields(line);
+    std::string key;
+    uint64_t value_kb = 0;
+    if (!(fields >> key >> value_kb)) {
+      continue;
+    }
+    if (key == "Rss:") {
+      rss_kb = value_kb;
+    } else if (key == "Private_Dirty:") {
+      private_dirty_kb = value_kb;
+    }
+  }
+  if (!rss_kb || !private_dirty_kb || *private_dirty_kb > *rss_kb) {
+    return std::nullopt;
+  }
+  MemoryUsageInfo memory_usage;
+  memory_usage.dirty_memory_usage = *private_dirty_kb / kKiloBytesPerMegaByte;
+  memory_usage.owned_shared_memory_usage =
+      (*rss_kb - *private_dirty_kb) / kKiloBytesPerMegaByte;
+  return memory_usage;
+}
+
+std::string ProfilerMetricsLinux::ThreadNameForTid(
+    pid_t tid,
+    const std::string& comm) const {
+  {
+    std::scoped_lock lock(mutex_);
+    auto registered = registered_threads_.find(tid);
+    if (registered != registered_threads_.end()) {
+      return registered->second;
+    }
+  }
+  // The kernel truncates thread names to 15 characters, which is enough to
+  // recognize the worker threads but not the names of the engine threads.
+  if (comm.rfind(kWorkerThreadPrefix, 0) == 0) {
+    return kWorkerThreadName;
+  }
+  return kOtherThreadName;
+}
+
+std::optional<CpuUsageInfo> ProfilerMetricsLinux::CpuUsage() {
+  std::string contents;
+  if (!ReadProcFile(process_stat_fd_, &contents)) {
+    return std::nullopt;
+  }
+  std::optional<uint64_t> process_cpu_ticks = ParseCpuTicks(contents, nullptr);
+  if (!process_cpu_ticks || !task_dir_) {
+    return std::nullopt;
+  }
+
+  for (auto& thread : threads_) {
+    thread.second.alive = false;
+  }
+  std::map<std::string, uint64_t> thread_ticks;
+  uint32_t num_threads = 0;
+  // Rewinding the directory stream makes it list the current threads without
+  // opening the directory again.
+  ::rewinddir(task_dir_);
+  while (dirent* entry = ::readdir(task_dir_)) {
+    pid_t tid = static_cast<pid_t>(std::atoi(entry->d_name));
+    if (tid <= 0) {
+      continue;
+    }
+    num_threads++;
+
+    bool is_new_thread = false;
+    auto found = threads_.find(tid);
+    if (found == threads_.end()) {
+      ThreadStat stat;
+      stat.fd = OpenProcFile("/proc/self/task/" + std::string{entry->d_name} +
+                             "/stat");
+      found = threads_.emplace(tid, std::move(stat)).first;
+      is_new_thread = true;
+    }
+    ThreadStat& stat = found->second;
+    std::string comm;
+    std::optional<uint64_t> cpu_ticks;
+    if (ReadProcFile(stat.fd, &contents)) {
+      cpu_ticks = ParseCpuTicks(contents, &comm);
+    }
+    if (!cpu_ticks) {
+      continue;
+    }
+    stat.alive = true;
+    if (!is_new_thread) {
+      // The CPU time a thread spent before it was first sampled is not
+      // attributed to it.
+      thread_ticks[stat.thread_name] += *cpu_ticks - stat.cpu_ticks;
+    }
+    if (is_new_thread || stat.thread_name == kOtherThreadName) {
+      // Threads may be registered after they were first sampled.
+      stat.thread_name = ThreadNameForTid(tid, comm);
+    }
+    stat.cpu_ticks = *cpu_ticks;
+  }
+
+  // The CPU time of threads that exited since the last sample is only
+  // accounted for in the total.
+  for (auto it = threads_.begin(); it != threads_.end();) {
+    it = it->second.alive ? std::next(it) : threads_.erase(it);
+  }
+
+  const fml::TimePoint now = fml::TimePoint::Now();
+  std::optional<uint64_t> last_process_cpu_ticks = process_cpu_ticks_;
+  const fml::TimeDelta elapsed = now - last_sample_time_;
+  process_cpu_ticks_ = process_cpu_ticks;
+  last_sample_time_ = now;
+  if (!last_process_cpu_ticks || elapsed <= fml::TimeDelta::Zero()) {
+    return std::nullopt;
+  }
+
+  // Percentage of the time of all cores, see `CpuUsageInfo`.
+  const double ticks_to_usage =
+      100.0 / (elapsed.ToSecondsF() * ticks_per_second_ * num_cores_);
+  CpuUsageInfo cpu_usage;
+  cpu_usage.num_threads = num_threads;
+  cpu_usage.total_cpu_usage =
+      (*process_cpu_ticks - *last_process_cpu_ticks) * ticks_to_usage;
+  for (const auto& ticks : thread_ticks) {
+    cpu_usage.thread_cpu_usage.push_back(
+        {ticks.first, ticks.second * ticks_to_usage});
+  }
+  return cpu_usage;
+}
+
+std::optional<MemoryUsageInfo> ProfilerMetricsLinux::MemoryUsage() {
+  std::string contents;
+  if (ReadProcFile(smaps_rollup_fd_, &contents)) {
+    return ParseSmapsRollup(contents);
+  }
+
+  // Without smaps_rollup, approximate the dirty memory with the resident
+  // memory that is not backed by a file.
+  if (!ReadProcFile(statm_fd_, &contents)) {
+    return std::nullopt;
+  }
+  std::istringstream fields(contents);
+  uint64_t size_pages = 0;
+  uint64_t resident_pages = 0;
+  uint64_t shared_pages = 0;
+  if (!(fields >> size_pages >> resident_pages >> shared_pages) ||
+      shared_pages > resident_pages) {
+    return std::nullopt;
+  }
+  const double page_size_mb =
+      ::sysconf(_SC_PAGESIZE) / (kKiloBytesPerMegaByte * 1024.0);
+  MemoryUsageInfo memory_usage;
+  memory_usage.dirty_memory_usage =
+      (resident_pages - shared_pages) * page_size_mb;
+  memory_usage.owned_shared_memory_usage = shared_pages * page_size_mb;
+  return memory_usage;
+}
+
+}  // namespace flutter
@@ -0,0 +1,107 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PROFILING_PROFILER_METRICS_LINUX_H_
+#define FLUTTER_SHELL_PROFILING_PROFILER_METRICS_LINUX_H_
+
+#include <dirent.h>
+#include <sys/types.h>
+
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_point.h"
+#include "flutter/fml/unique_fd.h"
+#include "flutter/shell/profiling/sampling_profiler.h"
+
+namespace flutter {
+
+/**
+ * @brief Utility class that gathers profiling metrics used by
+ * `flutter::SamplingProfiler` from procfs.
+ *
+ * The files read on every sample are kept open and re-read from the start, so
+ * that sampling only costs a few `pread` calls. CPU usage is attributed to the
+ * threads registered with `RegisterCurrentThread`, to the engine's worker
+ * threads, and to all other threads of the process.
+ *
+ * `GenerateSample` must always be called on the same thread. The other
+ * methods are thread safe.
+ *
+ * @see flutter::SamplingProfiler
+ */
+class ProfilerMetricsLinux {
+ public:
+  ProfilerMetricsLinux();
+
+  ~ProfilerMetricsLinux();
+
+  ProfileSample GenerateSample();
+
+  /**
+   * @brief Attributes the CPU time of the calling thread to `thread_name`,
+   * e.g. "ui" or "raster".
+   */
+  void RegisterCurrentThread(std::string thread_name);
+
+  /**
+   * @brief Sets the cache usage reported by subsequent samples. The caches
+   * can only be inspected on the raster thread, so they are pushed to this
+   * object instead of being polled.
+   */
+  void SetCacheUsage(CacheUsageInfo cache_usage);
+
+  /**
+   * @brief Parses the user and system CPU time, in clock ticks, from the
+   * contents of a `/proc/<pid>/stat` or `/proc/<pid>/task/<tid>/stat` file.
+   * Also returns the name of the thread if `thread_name` is not null.
+   */
+  static std::optional<uint64_t> ParseCpuTicks(const std::string& stat,
+                                               std::string* thread_name);
+
+  /**
+   * @brief Parses the contents of `/proc/<pid>/smaps_rollup`.
+   */
+  static std::optional<MemoryUsageInfo> ParseSmapsRollup(
+      const std::string& smaps_rollup);
+
+ private:
+  struct ThreadStat {
+    fml::UniqueFD fd;
+    std::string thread_name;
+    uint64_t cpu_ticks = 0;
+    bool alive = false;
+  };
+
+  std::optional<CpuUsageInfo> CpuUsage();
+
+  std::optional<MemoryUsageInfo> MemoryUsage();
+
+  std::string ThreadNameForTid(pid_t tid, const std::string& comm) const;
+
+  const double ticks_per_second_;
+  const double num_cores_;
+
+  fml::UniqueFD process_stat_fd_;
+  fml::UniqueFD smaps_rollup_fd_;
+  fml::UniqueFD statm_fd_;
+  DIR* task_dir_ = nullptr;
+  std::map<pid_t, ThreadStat> threads_;
+  std::optional<uint64_t> process_cpu_ticks_;
+  fml::TimePoint last_sample_time_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<pid_t, std::string> registered_threads_;
+  std::optional<CacheUsageInfo> cache_usage_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ProfilerMetricsLinux);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_PROFILING_PROFILER_METRICS_LINUX_H_
@@ -0,0 +1,91 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/profiling/profiler_metrics_linux.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "flutter/testing/testing.h"
+
+namespace flutter {
+namespace testing {
+
+TEST(ProfilerMetricsLinuxTest, ParsesCpuTicks) {
+  // The thread name may contain spaces and parentheses.
+  const std::string stat =
+      "1234 (io.worker.1 (x)) S 1 1234 1234 0 -1 4194560 1000 0 0 0 "
+      "25 17 0 0 20 0 12 0 100 1000000 500 18446744073709551615";
+  std::string thread_name;
+  std::optional<uint64_t> cpu_ticks =
+      ProfilerMetricsLinux::ParseCpuTicks(stat, &thread_name);
+  ASSERT_TRUE(cpu_ticks.has_value());
+  EXPECT_EQ(*cpu_ticks, 42u);
+  EXPECT_EQ(thread_name, "io.worker.1 (x)");
+
+  EXPECT_FALSE(ProfilerMetricsLinux::ParseCpuTicks("", nullptr).has_value());
+  EXPECT_FALSE(
+      ProfilerMetricsLinux::ParseCpuTicks("1234 (ui) S 1 2", nullptr)
+          .has_value());
+}
+
+TEST(ProfilerMetricsLinuxTest, ParsesSmapsRollup) {
+  const std::string smaps_rollup =
+      "55a0c0000000-7ffd5f9ff000 ---p 00000000 00:00 0  [rollup]\n"
+      "Rss:               10240 kB\n"
+      "Pss:                8192 kB\n"
+      "Shared_Clean:       2048 kB\n"
+      "Private_Clean:      1024 kB\n"
+      "Private_Dirty:      7168 kB\n";
+  std::optional<MemoryUsageInfo> memory_usage =
+      ProfilerMetricsLinux::ParseSmapsRollup(smaps_rollup);
+  ASSERT_TRUE(memory_usage.has_value());
+  EXPECT_EQ(memory_usage->dirty_memory_usage, 7.0);
+  EXPECT_EQ(memory_usage->owned_shared_memory_usage, 3.0);
+
+  EXPECT_FALSE(ProfilerMetricsLinux::ParseSmapsRollup("Rss: 10240 kB\n")
+                   .has_value());
+}
+
+TEST(ProfilerMetricsLinuxTest, AttributesCpuUsageToRegisteredThreads) {
+  ProfilerMetricsLinux metrics;
+  metrics.RegisterCurrentThread("test");
+
+  // CPU usage is computed from the difference between two samples.
+  ProfileSample first_sample = metrics.GenerateSample();
+  EXPECT_FALSE(first_sample.cpu_usage.has_value());
+  ASSERT_TRUE(first_sample.memory_usage.has_value());
+  EXPECT_GT(first_sample.memory_usage->dirty_memory_usage, 0.0);
+  EXPECT_FALSE(first_sample.cache_usage.has_value());
+
+  // Spin long enough for the clock ticks of this thread to advance.
+  auto start = std::chrono::steady_clock::now();
+  volatile uint64_t counter = 0;
+  while (std::chrono::steady_clock::now() - start <
+         std::chrono::milliseconds(100)) {
+    counter = counter + 1;
+  }
+
+  CacheUsageInfo cache_usage;
+  cache_usage.raster_cache_usage = 1.0;
+  cache_usage.resource_cache_usage = 2.0;
+  metrics.SetCacheUsage(cache_usage);
+
+  ProfileSample sample = metrics.GenerateSample();
+  ASSERT_TRUE(sample.cpu_usage.has_value());
+  EXPECT_GT(sample.cpu_usage->total_cpu_usage, 0.0);
+  EXPECT_GE(sample.cpu_usage->num_threads, 1u);
+  const auto& threads = sample.cpu_usage->thread_cpu_usage;
+  auto test_thread =
+      std::find_if(threads.begin(), threads.end(), [](const auto& thread) {
+        return thread.thread_name == "test";
+      });
+  ASSERT_NE(test_thread, threads.end());
+  EXPECT_GT(test_thread->cpu_usage, 0.0);
+  ASSERT_TRUE(sample.cache_usage.has_value());
+  EXPECT_EQ(sample.cache_usage->resource_cache_usage, 2.0);
+}
+
+}  // namespace testing
+}  // namespace flutter
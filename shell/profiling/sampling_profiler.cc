@@ -4,6 +4,8 @@
 
 #include "flutter/shell/profiling/sampling_profiler.h"
 
+#include <algorithm>
+
 namespace flutter {
 
 SamplingProfiler::SamplingProfiler(
@@ -33,7 +35,7 @@ void SamplingProfiler::Start() {
   auto task_delay = fml::TimeDelta::FromSecondsF(delay_between_samples);
   UpdateObservatoryThreadName();
   is_running_ = true;
-  SampleRepeatedly(task_delay);
+  SampleRepeatedly(task_delay, fml::TimeDelta::Zero());
 }
 
 void SamplingProfiler::Stop() {
@@ -45,13 +47,26 @@ void SamplingProfiler::Stop() {
   is_running_ = false;
 }
 
-void SamplingProfiler::SampleRepeatedly(fml::TimeDelta task_delay) const {
+fml::TimeDelta SamplingProfiler::DelayAfterSample(
+    fml::TimeDelta task_delay,
+    fml::TimeDelta sample_duration) {
+  const fml::TimeDelta min_delay = fml::TimeDelta::FromSecondsF(
+      sample_duration.ToSecondsF() / kMaxSamplingOverhead);
+  return std::max(task_delay, min_delay);
+}
+
+void SamplingProfiler::SampleRepeatedly(
+    fml::TimeDelta task_delay,
+    fml::TimeDelta last_sample_duration) const {
   profiler_task_runner_->PostDelayedTask(
       [profiler = this, task_delay = task_delay, sampler = sampler_,
        &shutdown_latch = shutdown_latch_]() {
         // TODO(kaushikiska): consider buffering these every n seconds to
         // avoid spamming the trace buffer.
+        const fml::TimePoint sample_start = fml::TimePoint::Now();
         const ProfileSample usage = sampler();
+        const fml::TimeDelta sample_duration =
+            fml::TimePoint::Now() - sample_start;
         if (usage.cpu_usage) {
           const auto& cpu_usage = usage.cpu_usage;
           std::string total_cpu_usage =
@@ -60,6 +75,14 @@ void SamplingProfiler::SampleRepeatedly(fml::TimeDelta task_delay) const {
           TRACE_EVENT_INSTANT2("flutter::profiling", "CpuUsage",
                                "total_cpu_usage", total_cpu_usage.c_str(),
                                "num_threads", num_threads.c_str());
+          for (const auto& thread_usage : cpu_usage->thread_cpu_usage) {
+            std::string thread_cpu_usage =
+                std::to_string(thread_usage.cpu_usage);
+            TRACE_EVENT_INSTANT2("flutter::profiling", "ThreadCpuUsage",
+                                 "thread_name",
+                                 thread_usage.thread_name.c_str(),
+                                 "cpu_usage", thread_cpu_usage.c_str());
+          }
         }
         if (usage.memory_usage) {
           std::string dirty_memory_usage =
@@ -77,13 +100,27 @@ void SamplingProfiler::SampleRepeatedly(fml::TimeDelta task_delay) const {
           TRACE_EVENT_INSTANT1("flutter::profiling", "GpuUsage", "gpu_usage",
                                gpu_usage.c_str());
         }
+        if (usage.cache_usage) {
+          std::string raster_cache_usage =
+              std::to_string(usage.cache_usage->raster_cache_usage);
+          std::string resource_cache_usage =
+              std::to_string(usage.cache_usage->resource_cache_usage);
+          TRACE_EVENT_INSTANT2("flutter::profiling", "CacheUsage",
+                               "raster_cache_usage", raster_cache_usage.c_str(),
+                               "resource_cache_usage",
+                               resource_cache_usage.c_str());
+        }
+        std::string sampling_overhead =
+            std::to_string(sample_duration.ToMicroseconds());
+        TRACE_EVENT_INSTANT1("flutter::profiling", "SamplingOverhead",
+                             "sample_duration_us", sampling_overhead.c_str());
         if (shutdown_latch.load()) {
           shutdown_latch.load()->Signal();
         } else {
-          profiler->SampleRepeatedly(task_delay);
+          profiler->SampleRepeatedly(task_delay, sample_duration);
         }
       },
-      task_delay);
+      DelayAfterSample(task_delay, last_sample_duration));
 }
 
 void SamplingProfiler::UpdateObservatoryThreadName() const {
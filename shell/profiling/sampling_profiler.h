@@ -9,6 +9,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "flutter/fml/synchronization/count_down_latch.h"
 #include "flutter/fml/task_runner.h"
@@ -16,6 +17,16 @@
 
 namespace flutter {
 
+/**
+ * @brief CPU usage of a group of threads, such as the raster thread or the
+ * worker threads. `cpu_usage` uses the same scale as
+ * `CpuUsageInfo::total_cpu_usage`.
+ */
+struct ThreadCpuUsageInfo {
+  std::string thread_name;
+  double cpu_usage;
+};
+
 /**
  * @brief CPU usage stats. `num_threads` is the number of threads owned by the
  * process. It is to be noted that this is not per shell, there can be multiple
@@ -28,6 +39,7 @@ namespace flutter {
 struct CpuUsageInfo {
   uint32_t num_threads;
   double total_cpu_usage;
+  std::vector<ThreadCpuUsageInfo> thread_cpu_usage;
 };
 
 /**
@@ -43,6 +55,16 @@ struct MemoryUsageInfo {
   double owned_shared_memory_usage;
 };
 
+/**
+ * @brief Memory (in MB) held by the caches of the rasterizer.
+ * `raster_cache_usage` is the size of the images in the `RasterCache` and
+ * `resource_cache_usage` the size of Skia's GPU resource cache.
+ */
+struct CacheUsageInfo {
+  double raster_cache_usage;
+  double resource_cache_usage;
+};
+
 /**
  * @brief Polled information related to the usage of the GPU.
  */
@@ -61,6 +83,7 @@ struct ProfileSample {
   std::optional<CpuUsageInfo> cpu_usage;
   std::optional<MemoryUsageInfo> memory_usage;
   std::optional<GpuUsageInfo> gpu_usage;
+  std::optional<CacheUsageInfo> cache_usage;
 };
 
 /**
@@ -78,9 +101,18 @@ using Sampler = std::function<ProfileSample(void)>;
  * represented by `ProfileSample`. These profiling metrics are then posted to
  * the observatory timeline.
  *
+ * The time spent in the `Sampler` is posted along with the metrics. If it
+ * exceeds `kMaxSamplingOverhead` of the time between samples, the samples are
+ * spaced out so that the profiler does not skew the metrics it collects.
  */
 class SamplingProfiler {
  public:
+  /**
+   * @brief The fraction of the profiler thread's time that may be spent
+   * sampling.
+   */
+  static constexpr double kMaxSamplingOverhead = 0.01;
+
   /**
    * @brief Construct a new Sampling Profiler object
    *
@@ -108,6 +140,13 @@ class SamplingProfiler {
 
   void Stop();
 
+  /**
+   * @brief Returns the delay before the next sample, given the configured
+   * delay between samples and the time it took to collect the last sample.
+   */
+  static fml::TimeDelta DelayAfterSample(fml::TimeDelta task_delay,
+                                         fml::TimeDelta sample_duration);
+
  private:
   const std::string thread_label_;
   const fml::RefPtr<fml::TaskRunner> profiler_task_runner_;
@@ -116,7 +155,8 @@ class SamplingProfiler {
   bool is_running_ = false;
   std::atomic<fml::AutoResetWaitableEvent*> shutdown_latch_ = nullptr;
 
-  void SampleRepeatedly(fml::TimeDelta task_delay) const;
+  void SampleRepeatedly(fml::TimeDelta task_delay,
+                        fml::TimeDelta last_sample_duration) const;
 
   /**
    * @brief This doesn't update the underlying OS thread name for the thread
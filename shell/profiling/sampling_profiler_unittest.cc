@@ -61,4 +61,19 @@ TEST(SamplingProfilerTest, DeleteAfterStart) {
   ASSERT_EQ(invoke_count_at_delete, invoke_count.load());
 }
 
+TEST(SamplingProfilerTest, DelayAfterSampleBoundsOverhead) {
+  const fml::TimeDelta task_delay = fml::TimeDelta::FromMilliseconds(200);
+
+  // Cheap samples keep the requested sampling rate.
+  EXPECT_EQ(SamplingProfiler::DelayAfterSample(
+                task_delay, fml::TimeDelta::FromMicroseconds(100)),
+            task_delay);
+
+  // Expensive samples stretch the interval so that sampling takes at most 1%
+  // of the profiler thread.
+  EXPECT_EQ(SamplingProfiler::DelayAfterSample(
+                task_delay, fml::TimeDelta::FromMilliseconds(5)),
+            fml::TimeDelta::FromMilliseconds(500));
+}
+
 }  // namespace flutter
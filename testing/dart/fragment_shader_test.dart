@@ -134,6 +134,21 @@ void main() {
     expect(a, notEquals(b));
     expect(a.hashCode, notEquals(b.hashCode));
   });
+
+  test('programs compiled concurrently from the same spirv render green', () async {
+    final ByteBuffer spirv = spvFile('general_shaders', 'functions.spv')
+        .readAsBytesSync().buffer;
+    final List<FragmentProgram> programs = await Future.wait(<Future<FragmentProgram>>[
+      FragmentProgram.compile(spirv: spirv),
+      FragmentProgram.compile(spirv: spirv),
+    ]);
+    for (final FragmentProgram program in programs) {
+      final Shader shader = program.shader(
+        floatUniforms: Float32List.fromList(<double>[1]),
+      );
+      await _expectShaderRendersGreen(shader);
+    }
+  });
 }
 
 // Expect that all of the spirv shaders in this folder render green.
@@ -28,6 +28,7 @@
 #include "flutter/fml/trace_event.h"
 #include "font_skia.h"
 #include "minikin/Layout.h"
+#include "minikin/MinikinInternal.h"
 #include "txt/platform.h"
 #include "txt/text_style.h"
 
@@ -99,10 +100,12 @@ size_t FontCollection::GetFontManagersCount() const {
 
 void FontCollection::SetupDefaultFontManager(
     uint32_t font_initialization_data) {
+  std::scoped_lock lock(minikin::gMinikinLock);
   default_font_manager_ = GetDefaultFontManager(font_initialization_data);
 }
 
 void FontCollection::SetDefaultFontManager(sk_sp<SkFontMgr> font_manager) {
+  std::scoped_lock lock(minikin::gMinikinLock);
   default_font_manager_ = font_manager;
 
 #if FLUTTER_ENABLE_SKSHAPER
@@ -111,6 +114,7 @@ void FontCollection::SetDefaultFontManager(sk_sp<SkFontMgr> font_manager) {
 }
 
 void FontCollection::SetAssetFontManager(sk_sp<SkFontMgr> font_manager) {
+  std::scoped_lock lock(minikin::gMinikinLock);
   asset_font_manager_ = font_manager;
 
 #if FLUTTER_ENABLE_SKSHAPER
@@ -119,6 +123,7 @@ void FontCollection::SetAssetFontManager(sk_sp<SkFontMgr> font_manager) {
 }
 
 void FontCollection::SetDynamicFontManager(sk_sp<SkFontMgr> font_manager) {
+  std::scoped_lock lock(minikin::gMinikinLock);
   dynamic_font_manager_ = font_manager;
 
 #if FLUTTER_ENABLE_SKSHAPER
@@ -127,6 +132,7 @@ void FontCollection::SetDynamicFontManager(sk_sp<SkFontMgr> font_manager) {
 }
 
 void FontCollection::SetTestFontManager(sk_sp<SkFontMgr> font_manager) {
+  std::scoped_lock lock(minikin::gMinikinLock);
   test_font_manager_ = font_manager;
 
 #if FLUTTER_ENABLE_SKSHAPER
@@ -149,7 +155,9 @@ std::vector<sk_sp<SkFontMgr>> FontCollection::GetFontManagerOrder() const {
 }
 
 void FontCollection::DisableFontFallback() {
+  std::scoped_lock lock(minikin::gMinikinLock);
   enable_font_fallback_ = false;
+  paragraph_cache_.Clear();
 
 #if FLUTTER_ENABLE_SKSHAPER
   if (skt_collection_) {
@@ -162,6 +170,7 @@ std::shared_ptr<minikin::FontCollection>
 FontCollection::GetMinikinFontCollectionForFamilies(
     const std::vector<std::string>& font_families,
     const std::string& locale) {
+  std::scoped_lock lock(minikin::gMinikinLock);
   // Look inside the font collections cache first.
   FamilyKey family_key(font_families, locale);
   auto cached = font_collections_cache_.find(family_key);
@@ -318,6 +327,7 @@ std::shared_ptr<minikin::FontFamily> FontCollection::CreateMinikinFontFamily(
 const std::shared_ptr<minikin::FontFamily>& FontCollection::MatchFallbackFont(
     uint32_t ch,
     std::string locale) {
+  std::scoped_lock lock(minikin::gMinikinLock);
   // Check if the ch's matched font has been cached. We cache the results of
   // this method as repeated matchFamilyStyleCharacter calls can become
   // extremely laggy when typing a large number of complex emojis.
@@ -382,7 +392,9 @@ FontCollection::GetFallbackFontFamily(const sk_sp<SkFontMgr>& manager,
 }
 
 void FontCollection::ClearFontFamilyCache() {
+  std::scoped_lock lock(minikin::gMinikinLock);
   font_collections_cache_.clear();
+  paragraph_cache_.Clear();
 
 #if FLUTTER_ENABLE_SKSHAPER
   if (skt_collection_) {
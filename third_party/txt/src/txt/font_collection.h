@@ -29,6 +29,7 @@
 #include "third_party/skia/include/core/SkFontMgr.h"
 #include "third_party/skia/include/core/SkRefCnt.h"
 #include "txt/asset_font_manager.h"
+#include "txt/paragraph_cache.h"
 #include "txt/text_style.h"
 
 #if FLUTTER_ENABLE_SKSHAPER
@@ -37,6 +38,9 @@
 
 namespace txt {
 
+// Paragraphs may be laid out on several isolates at once, so the font caches
+// are guarded by minikin's global lock. The fallback font provider is called
+// by minikin while that lock is held.
 class FontCollection : public std::enable_shared_from_this<FontCollection> {
  public:
   FontCollection();
@@ -68,6 +72,10 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
   // Remove all entries in the font family cache.
   void ClearFontFamilyCache();
 
+  // Layouts shared by paragraphs using this collection. Entries are removed
+  // whenever the fonts of the collection change.
+  ParagraphCache& GetParagraphCache() { return paragraph_cache_; }
+
 #if FLUTTER_ENABLE_SKSHAPER
 
   // Construct a Skia text layout FontCollection based on this collection.
@@ -107,6 +115,7 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
   std::unordered_map<std::string, std::vector<std::string>>
       fallback_fonts_for_locale_;
   bool enable_font_fallback_;
+  ParagraphCache paragraph_cache_;
 
 #if FLUTTER_ENABLE_SKSHAPER
   // An equivalent font collection usable by the Skia text shaper library.
@@ -0,0 +1,231 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "paragraph_cache.h"
+
+#include <string_view>
+
+#include "flutter/fml/hash_combine.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace txt {
+
+namespace {
+
+// TextStyle::equals ignores properties that only affect painting or that are
+// checked separately by its callers. A cached layout can only be shared if
+// every property matches.
+bool TextStylesMatch(const TextStyle& a, const TextStyle& b) {
+  return a.equals(b) && a.font_size == b.font_size &&
+         a.text_baseline == b.text_baseline &&
+         a.has_background == b.has_background &&
+         a.background == b.background &&
+         a.has_foreground == b.has_foreground &&
+         a.font_features.GetFontFeatures() ==
+             b.font_features.GetFontFeatures();
+}
+
+bool ParagraphStylesMatch(const ParagraphStyle& a, const ParagraphStyle& b) {
+  return a.font_weight == b.font_weight && a.font_style == b.font_style &&
+         a.font_family == b.font_family && a.font_size == b.font_size &&
+         a.height == b.height &&
+         a.has_height_override == b.has_height_override &&
+         a.text_height_behavior == b.text_height_behavior &&
+         a.strut_enabled == b.strut_enabled &&
+         a.strut_font_weight == b.strut_font_weight &&
+         a.strut_font_style == b.strut_font_style &&
+         a.strut_font_families == b.strut_font_families &&
+         a.strut_font_size == b.strut_font_size &&
+         a.strut_height == b.strut_height &&
+         a.strut_has_height_override == b.strut_has_height_override &&
+         a.strut_half_leading == b.strut_half_leading &&
+         a.strut_leading == b.strut_leading &&
+         a.force_strut_height == b.force_strut_height &&
+         a.text_align == b.text_align &&
+         a.text_direction == b.text_direction && a.max_lines == b.max_lines &&
+         a.ellipsis == b.ellipsis && a.locale == b.locale &&
+         a.break_strategy == b.break_strategy;
+}
+
+}  // namespace
+
+ParagraphCacheKey::ParagraphCacheKey(const std::vector<uint16_t>& text,
+                                     const StyledRuns& runs,
+                                     const ParagraphStyle& paragraph_style)
+    : text_(text), paragraph_style_(paragraph_style) {
+  styles_.reserve(runs.style_count());
+  for (size_t i = 0; i < runs.style_count(); ++i) {
+    styles_.push_back(runs.GetStyle(i));
+  }
+  runs_.reserve(runs.size());
+  for (size_t i = 0; i < runs.size(); ++i) {
+    StyledRuns::Run run = runs.GetRun(i);
+    runs_.push_back(Run{runs.GetStyleIndex(run.style), run.start, run.end});
+  }
+
+  hash_ = fml::HashCombine(
+      std::hash<std::u16string_view>{}(std::u16string_view(
+          reinterpret_cast<const char16_t*>(text_.data()), text_.size())),
+      runs_.size(), styles_.size(), paragraph_style_.max_lines);
+  for (const Run& run : runs_) {
+    fml::HashCombineSeed(hash_, run.style_index, run.start, run.end);
+  }
+  for (const TextStyle& style : styles_) {
+    fml::HashCombineSeed(hash_, style.font_size, style.color);
+  }
+}
+
+bool ParagraphCacheKey::operator==(const ParagraphCacheKey& other) const {
+  if (hash_ != other.hash_ || text_ != other.text_ ||
+      runs_.size() != other.runs_.size() ||
+      styles_.size() != other.styles_.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < runs_.size(); ++i) {
+    if (runs_[i].style_index != other.runs_[i].style_index ||
+        runs_[i].start != other.runs_[i].start ||
+        runs_[i].end != other.runs_[i].end) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < styles_.size(); ++i) {
+    if (!TextStylesMatch(styles_[i], other.styles_[i])) {
+      return false;
+    }
+  }
+  return ParagraphStylesMatch(paragraph_style_, other.paragraph_style_);
+}
+
+ParagraphCache::ParagraphCache(size_t max_bytes) : max_bytes_(max_bytes) {}
+
+ParagraphCache::~ParagraphCache() = default;
+
+std::shared_ptr<const ParagraphCache::Layout> ParagraphCache::Find(
+    const ParagraphCacheKey& key,
+    double width) {
+  std::scoped_lock lock(mutex_);
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    for (const WidthBucket& bucket : it->second.buckets) {
+      if (width >= bucket.min_width && width <= bucket.max_width) {
+        hit_count_++;
+        TraceStatsToTimeline();
+        lru_.splice(lru_.begin(), lru_, it->second.lru_position);
+        return bucket.layout;
+      }
+    }
+  }
+  miss_count_++;
+  TraceStatsToTimeline();
+  return nullptr;
+}
+
+void ParagraphCache::Insert(ParagraphCacheKey key,
+                            double min_width,
+                            double max_width,
+                            std::shared_ptr<const Layout> layout,
+                            size_t byte_size) {
+  if (byte_size > max_bytes_) {
+    return;
+  }
+  std::scoped_lock lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    it = entries_.emplace(std::move(key), Entry{}).first;
+    lru_.push_front(&it->first);
+    it->second.lru_position = lru_.begin();
+  } else {
+    lru_.splice(lru_.begin(), lru_, it->second.lru_position);
+  }
+
+  Entry& entry = it->second;
+  auto& buckets = entry.buckets;
+  // Drop layouts that the new one makes redundant, e.g. because another
+  // paragraph with the same content was laid out concurrently.
+  for (auto bucket = buckets.begin(); bucket != buckets.end();) {
+    if (bucket->min_width >= min_width && bucket->max_width <= max_width) {
+      entry.byte_size -= bucket->byte_size;
+      byte_size_ -= bucket->byte_size;
+      bucket = buckets.erase(bucket);
+    } else {
+      ++bucket;
+    }
+  }
+  if (buckets.size() == kMaxLayoutsPerKey) {
+    entry.byte_size -= buckets.front().byte_size;
+    byte_size_ -= buckets.front().byte_size;
+    buckets.erase(buckets.begin());
+  }
+  buckets.push_back(
+      WidthBucket{min_width, max_width, std::move(layout), byte_size});
+  entry.byte_size += byte_size;
+  byte_size_ += byte_size;
+
+  EvictIfNeeded();
+  TraceStatsToTimeline();
+}
+
+void ParagraphCache::EvictIfNeeded() {
+  while (byte_size_ > max_bytes_ && !lru_.empty()) {
+    auto it = entries_.find(*lru_.back());
+    FML_DCHECK(it != entries_.end());
+    byte_size_ -= it->second.byte_size;
+    lru_.pop_back();
+    entries_.erase(it);
+  }
+}
+
+void ParagraphCache::Clear() {
+  std::scoped_lock lock(mutex_);
+  entries_.clear();
+  lru_.clear();
+  byte_size_ = 0;
+  TraceStatsToTimeline();
+}
+
+size_t ParagraphCache::GetEntryCount() const {
+  std::scoped_lock lock(mutex_);
+  return entries_.size();
+}
+
+size_t ParagraphCache::GetByteSize() const {
+  std::scoped_lock lock(mutex_);
+  return byte_size_;
+}
+
+size_t ParagraphCache::GetHitCount() const {
+  std::scoped_lock lock(mutex_);
+  return hit_count_;
+}
+
+size_t ParagraphCache::GetMissCount() const {
+  std::scoped_lock lock(mutex_);
+  return miss_count_;
+}
+
+void ParagraphCache::TraceStatsToTimeline() const {
+#if !FLUTTER_RELEASE
+  FML_TRACE_COUNTER("flutter",                                        //
+                    "ParagraphCache", reinterpret_cast<int64_t>(this),  //
+                    "Hits", hit_count_,                                 //
+                    "Misses", miss_count_,                              //
+                    "Entries", entries_.size(),                         //
+                    "KBytes", byte_size_ / 1024);
+#endif  // !FLUTTER_RELEASE
+}
+
+}  // namespace txt
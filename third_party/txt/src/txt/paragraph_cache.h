@@ -0,0 +1,139 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LIB_TXT_SRC_PARAGRAPH_CACHE_H_
+#define LIB_TXT_SRC_PARAGRAPH_CACHE_H_
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "paragraph_style.h"
+#include "styled_runs.h"
+#include "text_style.h"
+
+namespace txt {
+
+// Identifies the content of a paragraph. Two paragraphs with equal keys produce
+// identical layouts when laid out with the same width.
+class ParagraphCacheKey {
+ public:
+  ParagraphCacheKey(const std::vector<uint16_t>& text,
+                    const StyledRuns& runs,
+                    const ParagraphStyle& paragraph_style);
+
+  bool operator==(const ParagraphCacheKey& other) const;
+
+  struct Hasher {
+    size_t operator()(const ParagraphCacheKey& key) const { return key.hash_; }
+  };
+
+ private:
+  struct Run {
+    size_t style_index;
+    size_t start;
+    size_t end;
+  };
+
+  std::vector<uint16_t> text_;
+  std::vector<TextStyle> styles_;
+  std::vector<Run> runs_;
+  ParagraphStyle paragraph_style_;
+  size_t hash_;
+};
+
+// Caches the results of ParagraphTxt::Layout so that paragraphs with identical
+// content, such as repeated labels in a list, share their line metrics and
+// text blobs instead of shaping and breaking the same text again.
+//
+// Entries are evicted in least recently used order once the estimated size of
+// all entries exceeds the byte budget. This class is thread safe.
+class ParagraphCache {
+ public:
+  // The immutable results of laying out a paragraph. Defined by ParagraphTxt.
+  struct Layout;
+
+  static constexpr size_t kDefaultMaxBytes = 4 * 1024 * 1024;
+  static constexpr size_t kMaxLayoutsPerKey = 4;
+
+  explicit ParagraphCache(size_t max_bytes = kDefaultMaxBytes);
+
+  ~ParagraphCache();
+
+  // Returns a layout of the paragraph identified by |key| that is valid for
+  // |width|, or nullptr.
+  std::shared_ptr<const Layout> Find(const ParagraphCacheKey& key,
+                                     double width);
+
+  // Stores |layout| as valid for all widths in [min_width, max_width],
+  // accounting |byte_size| bytes for it. At most kMaxLayoutsPerKey layouts
+  // of the same paragraph are kept.
+  void Insert(ParagraphCacheKey key,
+              double min_width,
+              double max_width,
+              std::shared_ptr<const Layout> layout,
+              size_t byte_size);
+
+  // Remove all entries, e.g. because the available fonts have changed.
+  void Clear();
+
+  size_t GetEntryCount() const;
+
+  size_t GetByteSize() const;
+
+  size_t GetHitCount() const;
+
+  size_t GetMissCount() const;
+
+ private:
+  struct WidthBucket {
+    double min_width;
+    double max_width;
+    std::shared_ptr<const Layout> layout;
+    size_t byte_size;
+  };
+
+  struct Entry {
+    // Most recently inserted last.
+    std::vector<WidthBucket> buckets;
+    size_t byte_size = 0;
+    std::list<const ParagraphCacheKey*>::iterator lru_position;
+  };
+
+  void EvictIfNeeded();
+
+  void TraceStatsToTimeline() const;
+
+  const size_t max_bytes_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<ParagraphCacheKey, Entry, ParagraphCacheKey::Hasher>
+      entries_;
+  // Keys of |entries_|, most recently used first.
+  std::list<const ParagraphCacheKey*> lru_;
+  size_t byte_size_ = 0;
+  size_t hit_count_ = 0;
+  size_t miss_count_ = 0;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ParagraphCache);
+};
+
+}  // namespace txt
+
+#endif  // LIB_TXT_SRC_PARAGRAPH_CACHE_H_
@@ -24,10 +24,12 @@
 #include <limits>
 #include <map>
 #include <numeric>
+#include <optional>
 #include <utility>
 #include <vector>
 
 #include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
 #include "font_collection.h"
 #include "font_skia.h"
 #include "minikin/FontLanguageListCache.h"
@@ -675,6 +677,19 @@ void ParagraphTxt::Layout(double width) {
 
   needs_layout_ = false;
 
+  ParagraphCache* cache = GetParagraphCache();
+  std::optional<ParagraphCacheKey> cache_key;
+  if (cache) {
+    cache_key.emplace(text_, runs_, paragraph_style_);
+    std::shared_ptr<const ParagraphCache::Layout> cached_layout =
+        cache->Find(*cache_key, width_);
+    if (cached_layout) {
+      TRACE_EVENT0("flutter", "ParagraphTxt::ApplyCachedLayout");
+      ApplyCachedLayout(*cached_layout);
+      return;
+    }
+  }
+
   records_.clear();
   glyph_lines_.clear();
   code_unit_runs_.clear();
@@ -1187,6 +1202,145 @@ void ParagraphTxt::Layout(double width) {
             });
 
   longest_line_ = max_right_ - min_left_;
+
+  if (cache) {
+    UpdateParagraphCache(cache, std::move(*cache_key));
+  }
+}
+
+ParagraphCache* ParagraphTxt::GetParagraphCache() const {
+  // Placeholders are sized by the framework, so paragraphs containing them
+  // are not shared.
+  if (!font_collection_ || text_.empty() || !inline_placeholders_.empty()) {
+    return nullptr;
+  }
+  return &font_collection_->GetParagraphCache();
+}
+
+namespace {
+
+PaintRecord CopyPaintRecord(const PaintRecord& record) {
+  return PaintRecord(record.style(), record.offset(), sk_ref_sp(record.text()),
+                     record.metrics(), record.line(), record.x_start(),
+                     record.x_end(), record.isGhost(),
+                     record.GetPlaceholderRun());
+}
+
+// Rewrites the style pointers in |line_metrics| and |code_unit_runs| using
+// |remap_style|.
+template <typename CodeUnitRun, typename RemapStyle>
+void RemapStyles(std::vector<LineMetrics>& line_metrics,
+                 std::vector<CodeUnitRun>& code_unit_runs,
+                 RemapStyle remap_style) {
+  for (LineMetrics& line : line_metrics) {
+    for (auto& [index, run_metrics] : line.run_metrics) {
+      run_metrics.text_style = remap_style(run_metrics.text_style);
+    }
+  }
+  for (CodeUnitRun& run : code_unit_runs) {
+    run.style = remap_style(run.style);
+  }
+}
+
+}  // namespace
+
+void ParagraphTxt::UpdateParagraphCache(ParagraphCache* cache,
+                                        ParagraphCacheKey key) {
+  TRACE_EVENT0("flutter", "ParagraphTxt::UpdateParagraphCache");
+  auto layout = std::make_shared<ParagraphCache::Layout>();
+  for (size_t i = 0; i < runs_.style_count(); ++i) {
+    layout->styles.push_back(runs_.GetStyle(i));
+  }
+  layout->line_metrics = line_metrics_;
+  layout->final_line_count = final_line_count_;
+  layout->line_widths = line_widths_;
+  layout->records.reserve(records_.size());
+  for (const PaintRecord& record : records_) {
+    layout->records.push_back(CopyPaintRecord(record));
+  }
+  layout->did_exceed_max_lines = did_exceed_max_lines_;
+  layout->strut = strut_;
+  layout->max_right = max_right_;
+  layout->min_left = min_left_;
+  for (const GlyphLine& glyph_line : glyph_lines_) {
+    layout->glyph_lines.push_back(glyph_line);
+  }
+  layout->code_unit_runs = code_unit_runs_;
+  layout->longest_line = longest_line_;
+  layout->max_intrinsic_width = max_intrinsic_width_;
+  layout->min_intrinsic_width = min_intrinsic_width_;
+  layout->alphabetic_baseline = alphabetic_baseline_;
+  layout->ideographic_baseline = ideographic_baseline_;
+  RemapStyles(layout->line_metrics, layout->code_unit_runs,
+              [&](const TextStyle* style) {
+                return &layout->styles[runs_.GetStyleIndex(*style)];
+              });
+
+  // The layout of left aligned paragraphs that did not need to wrap any line
+  // is the same for any width that fits the longest line.
+  double min_width = width_;
+  double max_width = width_;
+  bool wrapped = std::any_of(
+      line_metrics_.begin(), line_metrics_.end(),
+      [](const LineMetrics& line) { return !line.hard_break; });
+  if (paragraph_style_.effective_align() == TextAlign::left &&
+      paragraph_style_.ellipsis.empty() && !wrapped &&
+      max_intrinsic_width_ <= width_) {
+    min_width = max_intrinsic_width_;
+    max_width = std::numeric_limits<double>::infinity();
+  }
+
+  // Estimate the memory retained by the layout. Each glyph is stored in a text
+  // blob, a glyph line and a code unit run.
+  size_t glyph_count = 0;
+  for (const GlyphLine& glyph_line : glyph_lines_) {
+    glyph_count += glyph_line.positions.size();
+  }
+  size_t run_metrics_count = 0;
+  for (const LineMetrics& line : line_metrics_) {
+    run_metrics_count += line.run_metrics.size();
+  }
+  size_t byte_size =
+      sizeof(ParagraphCache::Layout) +
+      sizeof(TextStyle) * layout->styles.size() +
+      sizeof(LineMetrics) * line_metrics_.size() +
+      (sizeof(RunMetrics) + sizeof(size_t)) * run_metrics_count +
+      sizeof(PaintRecord) * records_.size() +
+      sizeof(CodeUnitRun) * code_unit_runs_.size() +
+      (sizeof(GlyphPosition) * 2 + sizeof(SkGlyphID) + sizeof(SkPoint)) *
+          glyph_count;
+
+  cache->Insert(std::move(key), min_width, max_width, std::move(layout),
+                byte_size);
+}
+
+void ParagraphTxt::ApplyCachedLayout(const ParagraphCache::Layout& layout) {
+  line_metrics_ = layout.line_metrics;
+  final_line_count_ = layout.final_line_count;
+  line_widths_ = layout.line_widths;
+  records_.clear();
+  records_.reserve(layout.records.size());
+  for (const PaintRecord& record : layout.records) {
+    records_.push_back(CopyPaintRecord(record));
+  }
+  did_exceed_max_lines_ = layout.did_exceed_max_lines;
+  strut_ = layout.strut;
+  max_right_ = layout.max_right;
+  min_left_ = layout.min_left;
+  glyph_lines_.clear();
+  for (const GlyphLine& glyph_line : layout.glyph_lines) {
+    glyph_lines_.push_back(glyph_line);
+  }
+  code_unit_runs_ = layout.code_unit_runs;
+  inline_placeholder_code_unit_runs_.clear();
+  longest_line_ = layout.longest_line;
+  max_intrinsic_width_ = layout.max_intrinsic_width;
+  min_intrinsic_width_ = layout.min_intrinsic_width;
+  alphabetic_baseline_ = layout.alphabetic_baseline;
+  ideographic_baseline_ = layout.ideographic_baseline;
+  RemapStyles(line_metrics_, code_unit_runs_, [&](const TextStyle* style) {
+    return &runs_.GetStyle(style - layout.styles.data());
+  });
 }
 
 void ParagraphTxt::UpdateLineMetrics(const SkFontMetrics& metrics,
@@ -28,6 +28,7 @@
 #include "minikin/LineBreaker.h"
 #include "paint_record.h"
 #include "paragraph.h"
+#include "paragraph_cache.h"
 #include "paragraph_style.h"
 #include "placeholder_run.h"
 #include "run_metrics.h"
@@ -128,6 +129,7 @@ class ParagraphTxt : public Paragraph {
 
  private:
   friend class ParagraphBuilderTxt;
+  friend struct ParagraphCache::Layout;
   FRIEND_TEST(ParagraphTest, SimpleParagraph);
   FRIEND_TEST(ParagraphTest, SimpleParagraphSmall);
   FRIEND_TEST(ParagraphTest, SimpleRedParagraph);
@@ -164,6 +166,7 @@ class ParagraphTxt : public Paragraph {
   FRIEND_TEST(ParagraphTest, GetGlyphPositionAtCoordinateSegfault);
   FRIEND_TEST(ParagraphTest, KhmerLineBreaker);
   FRIEND_TEST(ParagraphTest, TextHeightBehaviorRectsParagraph);
+  FRIEND_TEST(ParagraphTest, IdenticalParagraphsShareLayout);
 
   // Starting data to layout.
   std::vector<uint16_t> text_;
@@ -330,6 +333,17 @@ class ParagraphTxt : public Paragraph {
         : x_start(x_s), y_start(y_s), x_end(x_e), y_end(y_e) {}
   };
 
+  // Returns the cache shared by paragraphs using the same font collection, or
+  // nullptr if the layout of this paragraph can not be shared.
+  ParagraphCache* GetParagraphCache() const;
+
+  // Stores the results of the last Layout() in |cache|.
+  void UpdateParagraphCache(ParagraphCache* cache, ParagraphCacheKey key);
+
+  // Restores the results of laying out another paragraph with identical
+  // content.
+  void ApplyCachedLayout(const ParagraphCache::Layout& layout);
+
   // Passes in the text and Styled Runs. text_ and runs_ will later be passed
   // into breaker_ in InitBreaker(), which is called in Layout().
   void SetText(std::vector<uint16_t> text, StyledRuns runs);
@@ -404,6 +418,28 @@ class ParagraphTxt : public Paragraph {
   FML_DISALLOW_COPY_AND_ASSIGN(ParagraphTxt);
 };
 
+struct ParagraphCache::Layout {
+  // Copies of the styles of the paragraph that was laid out. The TextStyle
+  // pointers in |line_metrics| and |code_unit_runs| point into this vector.
+  std::vector<TextStyle> styles;
+
+  std::vector<LineMetrics> line_metrics;
+  size_t final_line_count;
+  std::vector<double> line_widths;
+  std::vector<PaintRecord> records;
+  bool did_exceed_max_lines;
+  ParagraphTxt::StrutMetrics strut;
+  double max_right;
+  double min_left;
+  std::vector<ParagraphTxt::GlyphLine> glyph_lines;
+  std::vector<ParagraphTxt::CodeUnitRun> code_unit_runs;
+  double longest_line;
+  double max_intrinsic_width;
+  double min_intrinsic_width;
+  double alphabetic_baseline;
+  double ideographic_baseline;
+};
+
 }  // namespace txt
 
 #endif  // LIB_TXT_SRC_PARAGRAPH_TXT_H_
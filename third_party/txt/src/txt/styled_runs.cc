@@ -51,6 +51,12 @@ const TextStyle& StyledRuns::GetStyle(size_t style_index) const {
   return styles_[style_index];
 }
 
+size_t StyledRuns::GetStyleIndex(const TextStyle& style) const {
+  FML_DCHECK(&style >= styles_.data() &&
+             &style < styles_.data() + styles_.size());
+  return &style - styles_.data();
+}
+
 void StyledRuns::StartRun(size_t style_index, size_t start) {
   EndRunIfNeeded(start);
   runs_.push_back(IndexedRun{style_index, start, start});
@@ -52,6 +52,11 @@ class StyledRuns {
 
   const TextStyle& GetStyle(size_t style_index) const;
 
+  size_t style_count() const { return styles_.size(); }
+
+  // Returns the index of a style returned by GetStyle() or GetRun().
+  size_t GetStyleIndex(const TextStyle& style) const;
+
   void StartRun(size_t style_index, size_t start);
 
   void EndRunIfNeeded(size_t end);
@@ -7111,4 +7111,117 @@ TEST_F(ParagraphTest, MixedTextHeightBehaviorRectsParagraph) {
 
   ASSERT_TRUE(Snapshot());
 }
+
+TEST_F(ParagraphTest, IdenticalParagraphsShareLayout) {
+  const char* text = "Buy now";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  auto font_collection = GetTestFontCollection();
+  ParagraphCache& cache = font_collection->GetParagraphCache();
+
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  auto build_paragraph = [&]() {
+    txt::ParagraphBuilderTxt builder(paragraph_style, font_collection);
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text);
+    builder.Pop();
+    return BuildParagraph(builder);
+  };
+
+  auto paragraph1 = build_paragraph();
+  paragraph1->Layout(GetTestCanvasWidth());
+  EXPECT_EQ(cache.GetMissCount(), 1ull);
+  EXPECT_EQ(cache.GetEntryCount(), 1ull);
+
+  auto paragraph2 = build_paragraph();
+  paragraph2->Layout(GetTestCanvasWidth());
+  EXPECT_EQ(cache.GetHitCount(), 1ull);
+
+  ASSERT_EQ(paragraph1->records_.size(), paragraph2->records_.size());
+  for (size_t i = 0; i < paragraph1->records_.size(); ++i) {
+    // Text blobs are shared between the paragraphs.
+    EXPECT_EQ(paragraph1->records_[i].text(), paragraph2->records_[i].text());
+    EXPECT_EQ(paragraph1->records_[i].offset(),
+              paragraph2->records_[i].offset());
+  }
+  EXPECT_EQ(paragraph1->GetHeight(), paragraph2->GetHeight());
+  EXPECT_EQ(paragraph1->GetMaxIntrinsicWidth(),
+            paragraph2->GetMaxIntrinsicWidth());
+  EXPECT_EQ(paragraph2->GetMaxWidth(), GetTestCanvasWidth());
+
+  // Styles referenced by the metrics belong to the paragraph itself.
+  ASSERT_EQ(paragraph2->GetLineMetrics().size(), 1ull);
+  for (const auto& [index, run_metrics] :
+       paragraph2->GetLineMetrics()[0].run_metrics) {
+    EXPECT_EQ(run_metrics.text_style, &paragraph2->runs_.GetStyle(1));
+  }
+  for (const auto& code_unit_run : paragraph2->code_unit_runs_) {
+    EXPECT_EQ(code_unit_run.style, &paragraph2->runs_.GetStyle(1));
+  }
+
+  // The text fits on one line, so any width that fits it reuses the layout.
+  auto paragraph3 = build_paragraph();
+  paragraph3->Layout(paragraph1->GetMaxIntrinsicWidth() + 10);
+  EXPECT_EQ(cache.GetHitCount(), 2ull);
+  EXPECT_EQ(paragraph3->GetMaxWidth(),
+            floor(paragraph1->GetMaxIntrinsicWidth() + 10));
+
+  // A different style is laid out again.
+  text_style.font_size = 20;
+  auto paragraph4 = build_paragraph();
+  paragraph4->Layout(GetTestCanvasWidth());
+  EXPECT_EQ(cache.GetHitCount(), 2ull);
+  EXPECT_EQ(cache.GetMissCount(), 2ull);
+  EXPECT_EQ(cache.GetEntryCount(), 2ull);
+
+  font_collection->ClearFontFamilyCache();
+  EXPECT_EQ(cache.GetEntryCount(), 0ull);
+  EXPECT_EQ(cache.GetByteSize(), 0ull);
+}
+
+TEST_F(ParagraphTest, ParagraphCacheWrappedTextUsesExactWidth) {
+  const char* text =
+      "This paragraph is long enough that it has to wrap onto several lines "
+      "when laid out with a narrow width.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  auto font_collection = GetTestFontCollection();
+  ParagraphCache& cache = font_collection->GetParagraphCache();
+
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  auto build_paragraph = [&]() {
+    txt::ParagraphBuilderTxt builder(paragraph_style, font_collection);
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text);
+    builder.Pop();
+    return BuildParagraph(builder);
+  };
+
+  auto paragraph1 = build_paragraph();
+  paragraph1->Layout(150);
+  ASSERT_GT(paragraph1->GetLineCount(), 1ull);
+
+  auto paragraph2 = build_paragraph();
+  paragraph2->Layout(200);
+  EXPECT_EQ(cache.GetHitCount(), 0ull);
+
+  auto paragraph3 = build_paragraph();
+  paragraph3->Layout(150.5);
+  EXPECT_EQ(cache.GetHitCount(), 1ull);
+  EXPECT_EQ(paragraph1->GetLineCount(), paragraph3->GetLineCount());
+  EXPECT_EQ(paragraph1->GetHeight(), paragraph3->GetHeight());
+}
+
 }  // namespace txt